@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexAdminQuotaModel.h"
+
+#include <QTest>
+
+/**
+ * Times the model of all users' quotas on generated data sets of 5000
+ * to 50000 users: loading, refreshing with a few or many changed users,
+ * sorting, filtering and scrolling through all rows as a ListView does.
+ *
+ * ctest only checks that every case works. For numbers, run the binary
+ * by hand, e.g. with '-iterations 10' and '-csv'.
+ */
+class LliurexAdminQuotaModelBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void sortedByUsage();
+
+    void load_data();
+    void load();
+    void refresh_data();
+    void refresh();
+    void sort_data();
+    void sort();
+    void filter_data();
+    void filter();
+    void scroll_data();
+    void scroll();
+
+private:
+    void addSizes();
+};
+
+namespace {
+    const qint64 GiB = qint64(1024) * 1024 * 1024;
+
+    /**
+     * Quotas of @p count users on /home. Every @p changeEvery th user
+     * wrote @p extra more bytes.
+     */
+    QVector<LliurexQuotaEntry> users(int count, int changeEvery = 0, qint64 extra = 0)
+    {
+        QVector<LliurexQuotaEntry> entries;
+        entries.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            LliurexQuotaEntry entry;
+            entry.type = LliurexQuotaEntry::UserQuota;
+            entry.id = 10000 + i;
+            entry.name = QStringLiteral("user%1").arg(i);
+            entry.group = QStringLiteral("class%1").arg(i % 40);
+            entry.mountPoint = QStringLiteral("/home");
+            // a spread of usages, not in id order
+            entry.used = (qint64(i) * 7919 % 1000) * GiB / 500;
+            if (changeEvery > 0 && i % changeEvery == 0) {
+                entry.used += extra;
+            }
+            entry.softLimit = GiB + GiB / 2;
+            entry.hardLimit = 2 * GiB;
+            entries.append(entry);
+        }
+        return entries;
+    }
+
+    void fetchAll(LliurexAdminQuotaModel &model)
+    {
+        while (model.canFetchMore(QModelIndex())) {
+            model.fetchMore(QModelIndex());
+        }
+    }
+}
+
+void LliurexAdminQuotaModelBenchmark::addSizes()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("5000") << 5000;
+    QTest::newRow("20000") << 20000;
+    QTest::newRow("50000") << 50000;
+}
+
+void LliurexAdminQuotaModelBenchmark::sortedByUsage()
+{
+    LliurexAdminQuotaModel model;
+    model.setEntries(users(1000));
+    fetchAll(model);
+    QCOMPARE(model.rowCount(QModelIndex()), 1000);
+
+    const int usageRole = model.roleNames().key("usage");
+    int last = 100;
+    for (int row = 0; row < model.rowCount(QModelIndex()); ++row) {
+        const int usage = model.data(model.index(row, 0), usageRole).toInt();
+        QVERIFY(usage <= last);
+        last = usage;
+    }
+}
+
+void LliurexAdminQuotaModelBenchmark::load_data()
+{
+    addSizes();
+}
+
+void LliurexAdminQuotaModelBenchmark::load()
+{
+    QFETCH(int, count);
+    const QVector<LliurexQuotaEntry> entries = users(count);
+
+    QBENCHMARK {
+        LliurexAdminQuotaModel model;
+        model.setEntries(entries);
+    }
+}
+
+void LliurexAdminQuotaModelBenchmark::refresh_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("changeEvery");
+
+    for (int count : {5000, 20000, 50000}) {
+        QTest::newRow(qPrintable(QStringLiteral("unchanged %1").arg(count))) << count << 0;
+        QTest::newRow(qPrintable(QStringLiteral("1% changed %1").arg(count))) << count << 100;
+        QTest::newRow(qPrintable(QStringLiteral("all changed %1").arg(count))) << count << 1;
+    }
+}
+
+void LliurexAdminQuotaModelBenchmark::refresh()
+{
+    QFETCH(int, count);
+    QFETCH(int, changeEvery);
+
+    // the changed users wrote 100 MiB, which moves them in the order
+    const QVector<LliurexQuotaEntry> first = users(count);
+    const QVector<LliurexQuotaEntry> second = users(count, changeEvery, 100 * 1024 * 1024);
+
+    LliurexAdminQuotaModel model;
+    model.setEntries(first);
+    // the view scrolled through a few batches
+    for (int i = 0; i < 5; ++i) {
+        model.fetchMore(QModelIndex());
+    }
+
+    bool odd = false;
+    QBENCHMARK {
+        model.setEntries(odd ? first : second);
+        odd = !odd;
+    }
+    QCOMPARE(model.totalCount(), count);
+}
+
+void LliurexAdminQuotaModelBenchmark::sort_data()
+{
+    addSizes();
+}
+
+void LliurexAdminQuotaModelBenchmark::sort()
+{
+    QFETCH(int, count);
+
+    LliurexAdminQuotaModel model;
+    model.setEntries(users(count));
+
+    bool odd = false;
+    QBENCHMARK {
+        model.setSortKey(odd ? LliurexAdminQuotaModel::SortByUsage : LliurexAdminQuotaModel::SortByName);
+        odd = !odd;
+    }
+}
+
+void LliurexAdminQuotaModelBenchmark::filter_data()
+{
+    addSizes();
+}
+
+void LliurexAdminQuotaModelBenchmark::filter()
+{
+    QFETCH(int, count);
+
+    LliurexAdminQuotaModel model;
+    model.setEntries(users(count));
+
+    // typing a name letter by letter, then clearing the field
+    const QStringList texts = {QStringLiteral("u"), QStringLiteral("us"), QStringLiteral("user1"),
+                               QStringLiteral("user12"), QString()};
+    QBENCHMARK {
+        for (const QString &text : texts) {
+            model.setFilterText(text);
+        }
+    }
+
+    model.setFilterText(QStringLiteral("user12"));
+    QVERIFY(model.totalCount() > 0);
+    QVERIFY(model.totalCount() < count);
+}
+
+void LliurexAdminQuotaModelBenchmark::scroll_data()
+{
+    addSizes();
+}
+
+void LliurexAdminQuotaModelBenchmark::scroll()
+{
+    QFETCH(int, count);
+
+    LliurexAdminQuotaModel model;
+    model.setEntries(users(count));
+    const QList<int> roles = model.roleNames().keys();
+
+    // a ListView scrolled to the end: every batch is fetched and every
+    // row read once, as its delegate is created
+    int rows = 0;
+    QBENCHMARK {
+        model.clear();
+        model.setEntries(users(count));
+        rows = 0;
+        while (model.canFetchMore(QModelIndex())) {
+            const int first = model.rowCount(QModelIndex());
+            model.fetchMore(QModelIndex());
+            for (int row = first; row < model.rowCount(QModelIndex()); ++row) {
+                const QModelIndex index = model.index(row, 0);
+                for (int role : roles) {
+                    model.data(index, role);
+                }
+                ++rows;
+            }
+        }
+    }
+    QCOMPARE(rows, count);
+}
+
+QTEST_GUILESS_MAIN(LliurexAdminQuotaModelBenchmark)
+
+#include "LliurexAdminQuotaModelBenchmark.moc"
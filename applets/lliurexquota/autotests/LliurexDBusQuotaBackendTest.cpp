@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexDBusQuotaBackend.h"
+#include "LliurexQuotaDBus.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QTemporaryFile>
+#include <QTest>
+
+#include <unistd.h>
+
+/**
+ * Stand-in for the backend reading lliurex-quota or NFS, answering with
+ * a single entry that tells it apart.
+ */
+class LliurexStubQuotaBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    QString name() const override { return QStringLiteral("stub"); }
+    bool isAvailable() const override { return true; }
+
+    void requestQuota() override
+    {
+        ++requests;
+        LliurexQuotaEntry entry;
+        entry.name = QStringLiteral("stub");
+        emit quotaReady(QVector<LliurexQuotaEntry>{entry});
+    }
+
+    int requests = 0;
+};
+
+/**
+ * Runs LliurexDBusQuotaBackend against lliurex-quota-service on the
+ * session bus, with the quotas of the service read from a fake file.
+ * Skipped without a session bus.
+ */
+class LliurexDBusQuotaBackendTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+
+    void serviceAnswers();
+    void emptyAnswerAsksFallback();
+
+private:
+    void writeQuotas(const QByteArray &quotas);
+    void startService();
+    LliurexDBusQuotaBackend *createBackend();
+
+    QScopedPointer<QProcess> m_service;
+    QScopedPointer<QTemporaryFile> m_quotas;
+    QScopedPointer<LliurexDBusQuotaBackend> m_backend;
+    LliurexStubQuotaBackend *m_fallback = nullptr;
+};
+
+void LliurexDBusQuotaBackendTest::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("no D-Bus session bus");
+    }
+    qputenv("LLIUREX_QUOTA_SERVICE_BUS", "session");
+    qRegisterMetaType<QVector<LliurexQuotaEntry>>();
+}
+
+void LliurexDBusQuotaBackendTest::writeQuotas(const QByteArray &quotas)
+{
+    if (!m_quotas) {
+        m_quotas.reset(new QTemporaryFile);
+        QVERIFY(m_quotas->open());
+    }
+    // the service reads the file again on every sweep
+    QFile file(m_quotas->fileName());
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(quotas);
+}
+
+void LliurexDBusQuotaBackendTest::startService()
+{
+    m_service.reset(new QProcess);
+    m_service->setProcessChannelMode(QProcess::ForwardedChannels);
+    m_service->start(QStringLiteral(LLIUREX_QUOTA_SERVICE),
+                     QStringList{QStringLiteral("--session"),
+                                 QStringLiteral("--fake"), m_quotas->fileName(),
+                                 QStringLiteral("--interval"), QStringLiteral("1")});
+    QVERIFY(m_service->waitForStarted());
+
+    // the service takes its name after the first sweep
+    QDBusConnectionInterface *interface = QDBusConnection::sessionBus().interface();
+    QTRY_VERIFY_WITH_TIMEOUT(interface->isServiceRegistered(LliurexQuotaDBus::serviceName), 5000);
+}
+
+LliurexDBusQuotaBackend *LliurexDBusQuotaBackendTest::createBackend()
+{
+    m_fallback = new LliurexStubQuotaBackend;
+    m_backend.reset(new LliurexDBusQuotaBackend(m_fallback));
+    return m_backend.data();
+}
+
+void LliurexDBusQuotaBackendTest::cleanup()
+{
+    m_backend.reset();
+    m_fallback = nullptr;
+    if (m_service) {
+        m_service->kill();
+        m_service->waitForFinished();
+        m_service.reset();
+    }
+    m_quotas.reset();
+}
+
+void LliurexDBusQuotaBackendTest::serviceAnswers()
+{
+    writeQuotas("u," + QByteArray::number(getuid()) + ",me,/home,1024,2048,4096\n");
+    startService();
+
+    LliurexDBusQuotaBackend *backend = createBackend();
+    // the bus daemon is asked without blocking, the fallback serves meanwhile
+    QCOMPARE(backend->name(), QStringLiteral("stub"));
+    QTRY_COMPARE(backend->name(), QStringLiteral("dbus"));
+    QVERIFY(backend->pushesUpdates());
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].mountPoint, QStringLiteral("/home"));
+    QCOMPARE(entries[0].used, qint64(1024) * 1024);
+    QCOMPARE(m_fallback->requests, 0);
+}
+
+void LliurexDBusQuotaBackendTest::emptyAnswerAsksFallback()
+{
+    // the service only knows the quota of somebody else, as on a client
+    // whose quota comes from lliurex-quota or NFS
+    const QByteArray other = "u," + QByteArray::number(getuid() + 12345) + ",other,/home,1024,2048,4096\n";
+    writeQuotas(other);
+    startService();
+
+    LliurexDBusQuotaBackend *backend = createBackend();
+    QTRY_COMPARE(backend->name(), QStringLiteral("dbus"));
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy pushes(backend, &LliurexQuotaBackend::pushesUpdatesChanged);
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    QCOMPARE(ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>().at(0).name, QStringLiteral("stub"));
+    QCOMPARE(m_fallback->requests, 1);
+    QCOMPARE(backend->name(), QStringLiteral("stub"));
+    QVERIFY(!backend->pushesUpdates());
+    QCOMPARE(pushes.count(), 1);
+
+    // further polls go to the fallback without asking the service first
+    backend->requestQuota();
+    QCOMPARE(m_fallback->requests, 2);
+    QCOMPARE(ready.count(), 2);
+
+    // a quota of ours showing up in the service hands the backend back to it
+    writeQuotas(other + "u," + QByteArray::number(getuid()) + ",me,/srv,1024,2048,4096\n");
+    QTRY_COMPARE_WITH_TIMEOUT(backend->name(), QStringLiteral("dbus"), 5000);
+    QTRY_COMPARE_WITH_TIMEOUT(ready.count(), 3, 5000);
+    const QVector<LliurexQuotaEntry> entries = ready.at(2).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].mountPoint, QStringLiteral("/srv"));
+    QVERIFY(backend->pushesUpdates());
+    QCOMPARE(m_fallback->requests, 2);
+}
+
+QTEST_GUILESS_MAIN(LliurexDBusQuotaBackendTest)
+
+#include "LliurexDBusQuotaBackendTest.moc"
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDiskScanner.h"
+#include "LliurexDiskUsageModel.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <algorithm>
+#include <functional>
+
+#include <sys/stat.h>
+
+/**
+ * Runs LliurexDiskScanner on generated trees: checks its ranking against
+ * a full recompute of the directory sizes, and times walks of wide and
+ * flat trees with one to sixteen workers.
+ *
+ * The trees stay in the page cache, so the numbers are those of a warm
+ * local walk; ctest only checks that every case works. For numbers, run
+ * the binary by hand, e.g. with '-iterations 5' and '-csv'.
+ */
+class LliurexDiskScannerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void largestFirst();
+    void rankingMatchesRecompute();
+    void missingFolder();
+
+    void scan_data();
+    void scan();
+};
+
+namespace {
+    const qint64 Block = 4096;
+
+    /**
+     * Creates @p directories directories below @p root, ten per parent,
+     * each with @p filesPerDirectory files: one of sizeOf(i) bytes, the
+     * others empty. Returns the number of files.
+     */
+    int generateTree(const QString &root, int directories, int filesPerDirectory,
+                     const std::function<qint64(int)> &sizeOf)
+    {
+        QStringList paths;
+        int files = 0;
+        for (int i = 0; i < directories; ++i) {
+            // directory i is below directory (i - 1) / 10, the first ten below the root
+            const QString parent = i < 10 ? root : paths.at((i - 10) / 10);
+            const QString path = parent + QStringLiteral("/d%1").arg(i);
+            if (!QDir().mkdir(path)) {
+                return -1;
+            }
+            paths.append(path);
+
+            for (int j = 0; j < filesPerDirectory; ++j) {
+                QFile file(path + QStringLiteral("/f%1").arg(j));
+                if (!file.open(QIODevice::WriteOnly)) {
+                    return -1;
+                }
+                if (j == 0) {
+                    file.write(QByteArray(int(sizeOf(i)), 'x'));
+                }
+                ++files;
+            }
+        }
+        return files;
+    }
+
+    /**
+     * The bytes below every directory under @p root, counted as the
+     * scanner does: allocated blocks of everything inside it.
+     */
+    QHash<QString, qint64> recompute(const QString &root)
+    {
+        QHash<QString, qint64> totals;
+        QDirIterator it(root, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            struct stat st;
+            if (lstat(QFile::encodeName(path).constData(), &st) != 0) {
+                continue;
+            }
+            if (S_ISDIR(st.st_mode) && !totals.contains(path)) {
+                totals.insert(path, 0);
+            }
+            for (QString directory = QFileInfo(path).path(); directory != root; directory = QFileInfo(directory).path()) {
+                totals[directory] += qint64(st.st_blocks) * 512;
+            }
+        }
+        return totals;
+    }
+
+    bool scan(LliurexDiskScanner &scanner, const QString &path)
+    {
+        QSignalSpy finished(&scanner, &LliurexDiskScanner::finished);
+        scanner.start(path);
+        return finished.wait(60000);
+    }
+}
+
+void LliurexDiskScannerBenchmark::largestFirst()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = QDir(dir.path()).canonicalPath();
+
+    QVERIFY(QDir(root).mkpath(QStringLiteral("big/inner")));
+    QVERIFY(QDir(root).mkpath(QStringLiteral("small")));
+    const QList<QPair<QString, qint64>> files = {
+        {QStringLiteral("big/data"), 256 * Block},
+        {QStringLiteral("big/inner/data"), 128 * Block},
+        {QStringLiteral("small/data"), Block},
+        {QStringLiteral("top"), 64 * Block},
+    };
+    for (const auto &file : files) {
+        QFile out(root + QLatin1Char('/') + file.first);
+        QVERIFY(out.open(QIODevice::WriteOnly));
+        out.write(QByteArray(int(file.second), 'x'));
+    }
+
+    LliurexDiskScanner scanner;
+    QVERIFY(scan(scanner, dir.path()));
+    QCOMPARE(scanner.rootPath(), root);
+    QCOMPARE(scanner.running(), false);
+    QCOMPARE(scanner.scannedFiles(), qint64(files.size()));
+    QCOMPARE(scanner.errorCount(), qint64(0));
+
+    LliurexDiskUsageModel *model = scanner.model();
+    const int pathRole = model->roleNames().key("path");
+    const int sizeRole = model->roleNames().key("size");
+    const int directoryRole = model->roleNames().key("isDirectory");
+    QVERIFY(model->rowCount(QModelIndex()) >= 6);
+    QCOMPARE(model->data(model->index(0, 0), pathRole).toString(), root + QStringLiteral("/big"));
+    QVERIFY(model->data(model->index(0, 0), directoryRole).toBool());
+
+    qint64 last = model->data(model->index(0, 0), sizeRole).toLongLong();
+    for (int row = 1; row < model->rowCount(QModelIndex()); ++row) {
+        const qint64 size = model->data(model->index(row, 0), sizeRole).toLongLong();
+        QVERIFY(size <= last);
+        last = size;
+    }
+}
+
+void LliurexDiskScannerBenchmark::rankingMatchesRecompute()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = QDir(dir.path()).canonicalPath();
+
+    // every leaf a different size, so the ranking has no ties
+    QVERIFY(generateTree(root, 150, 3, [](int i) { return (i + 1) * Block; }) > 0);
+
+    const QHash<QString, qint64> totals = recompute(root);
+    QVector<qint64> expected;
+    for (auto it = totals.constBegin(); it != totals.constEnd(); ++it) {
+        expected.append(it.value());
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<qint64>());
+
+    for (int workers : {1, 4, 16}) {
+        LliurexDiskScanner scanner;
+        scanner.setWorkerCount(workers);
+        QVERIFY(scan(scanner, root));
+
+        LliurexDiskUsageModel *model = scanner.model();
+        const int pathRole = model->roleNames().key("path");
+        const int sizeRole = model->roleNames().key("size");
+        const int directoryRole = model->roleNames().key("isDirectory");
+
+        QVector<qint64> ranked;
+        for (int row = 0; row < model->rowCount(QModelIndex()); ++row) {
+            const QModelIndex index = model->index(row, 0);
+            if (!model->data(index, directoryRole).toBool()) {
+                continue;
+            }
+            const QString path = model->data(index, pathRole).toString();
+            const qint64 size = model->data(index, sizeRole).toLongLong();
+            QCOMPARE(size, totals.value(path, -1));
+            ranked.append(size);
+        }
+
+        QVERIFY(!ranked.isEmpty());
+        QCOMPARE(ranked, expected.mid(0, ranked.size()));
+        QCOMPARE(ranked.size(), qMin(expected.size(), 25));
+    }
+}
+
+void LliurexDiskScannerBenchmark::missingFolder()
+{
+    LliurexDiskScanner scanner;
+    QVERIFY(scan(scanner, QStringLiteral("/nonexistent/lliurex-quota-test")));
+    QCOMPARE(scanner.running(), false);
+    QVERIFY(scanner.rootPath().isEmpty());
+    QCOMPARE(scanner.model()->rowCount(QModelIndex()), 0);
+}
+
+void LliurexDiskScannerBenchmark::scan_data()
+{
+    QTest::addColumn<int>("directories");
+    QTest::addColumn<int>("filesPerDirectory");
+    QTest::addColumn<int>("workers");
+
+    for (int workers : {1, 4, 16}) {
+        QTest::newRow(qPrintable(QStringLiteral("wide 2000x10, %1 workers").arg(workers))) << 2000 << 10 << workers;
+    }
+    QTest::newRow("flat 1x20000, 4 workers") << 1 << 20000 << 4;
+}
+
+void LliurexDiskScannerBenchmark::scan()
+{
+    QFETCH(int, directories);
+    QFETCH(int, filesPerDirectory);
+    QFETCH(int, workers);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const int files = generateTree(dir.path(), directories, filesPerDirectory,
+                                   [](int i) { return (i % 8 + 1) * Block; });
+    QCOMPARE(files, directories * filesPerDirectory);
+
+    LliurexDiskScanner scanner;
+    scanner.setWorkerCount(workers);
+    QBENCHMARK {
+        QVERIFY(scan(scanner, dir.path()));
+    }
+    QCOMPARE(scanner.scannedFiles(), qint64(files));
+}
+
+QTEST_GUILESS_MAIN(LliurexDiskScannerBenchmark)
+
+#include "LliurexDiskScannerBenchmark.moc"
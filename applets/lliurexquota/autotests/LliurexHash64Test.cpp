@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexHash64.h"
+
+#include <QTest>
+
+/**
+ * Checks LliurexHash64 against XXH64 values of the reference
+ * implementation, for every path through the tail and stripe code, and
+ * streamed input against the one-shot hash.
+ */
+class LliurexHash64Test : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void hash_data();
+    void hash();
+    void chunks_data();
+    void chunks();
+    void resultInBetween();
+};
+
+namespace {
+    // PRIME32_1, the seed of the sanity checks of xxHash itself
+    const quint64 Seed = Q_UINT64_C(2654435761);
+
+    /**
+     * Input byte i is i * 7 + 1: no zeros, no repeating stripes.
+     */
+    QByteArray input(int length)
+    {
+        QByteArray data(length, Qt::Uninitialized);
+        for (int i = 0; i < length; ++i) {
+            data[i] = char(i * 7 + 1);
+        }
+        return data;
+    }
+}
+
+void LliurexHash64Test::hash_data()
+{
+    QTest::addColumn<int>("length");
+    QTest::addColumn<quint64>("seed");
+    QTest::addColumn<quint64>("expected");
+
+    // computed with xxHash 0.8
+    QTest::newRow("empty") << 0 << Q_UINT64_C(0) << Q_UINT64_C(0xEF46DB3751D8E999);
+    QTest::newRow("empty, seed") << 0 << Seed << Q_UINT64_C(0xAC75FDA2929B17EF);
+    QTest::newRow("1") << 1 << Q_UINT64_C(0) << Q_UINT64_C(0x8A4127811B21E730);
+    QTest::newRow("1, seed") << 1 << Seed << Q_UINT64_C(0x211AE13247CE135F);
+    QTest::newRow("3") << 3 << Q_UINT64_C(0) << Q_UINT64_C(0xB6E6C910C2FD373A);
+    QTest::newRow("3, seed") << 3 << Seed << Q_UINT64_C(0x0CCDB2C7C2850613);
+    QTest::newRow("4") << 4 << Q_UINT64_C(0) << Q_UINT64_C(0x22EDA2CF6AF4C124);
+    QTest::newRow("4, seed") << 4 << Seed << Q_UINT64_C(0x446BE1F3228ED3C3);
+    QTest::newRow("7") << 7 << Q_UINT64_C(0) << Q_UINT64_C(0x34084D91A233A751);
+    QTest::newRow("7, seed") << 7 << Seed << Q_UINT64_C(0x5410E6030DAF84B3);
+    QTest::newRow("8") << 8 << Q_UINT64_C(0) << Q_UINT64_C(0xC6F1803A5E0B3222);
+    QTest::newRow("8, seed") << 8 << Seed << Q_UINT64_C(0xB872C2FB02E71655);
+    QTest::newRow("31") << 31 << Q_UINT64_C(0) << Q_UINT64_C(0x6AB1C40E29F50073);
+    QTest::newRow("31, seed") << 31 << Seed << Q_UINT64_C(0xBB6D29B38190A8FF);
+    QTest::newRow("32") << 32 << Q_UINT64_C(0) << Q_UINT64_C(0x5A0756FBE9ECD3D1);
+    QTest::newRow("32, seed") << 32 << Seed << Q_UINT64_C(0x0518CC93BC88A896);
+    QTest::newRow("33") << 33 << Q_UINT64_C(0) << Q_UINT64_C(0xDC50CDC37BB9C183);
+    QTest::newRow("33, seed") << 33 << Seed << Q_UINT64_C(0x157CE0E9C56B5988);
+    QTest::newRow("100") << 100 << Q_UINT64_C(0) << Q_UINT64_C(0xD248BFC5208B0B16);
+    QTest::newRow("100, seed") << 100 << Seed << Q_UINT64_C(0xBCCF07579AF475CD);
+    QTest::newRow("1000") << 1000 << Q_UINT64_C(0) << Q_UINT64_C(0x6BE03ACBF959C413);
+    QTest::newRow("1000, seed") << 1000 << Seed << Q_UINT64_C(0x24399EECC271C158);
+}
+
+void LliurexHash64Test::hash()
+{
+    QFETCH(int, length);
+    QFETCH(quint64, seed);
+    QFETCH(quint64, expected);
+
+    const QByteArray data = input(length);
+    QCOMPARE(LliurexHash64::hash(data.constData(), data.size(), seed), expected);
+
+    LliurexHash64 hash(seed);
+    hash.addData(data.constData(), data.size());
+    QCOMPARE(hash.result(), expected);
+}
+
+void LliurexHash64Test::chunks_data()
+{
+    QTest::addColumn<int>("chunk");
+
+    for (int chunk : {1, 3, 5, 8, 31, 32, 33, 64, 100}) {
+        QTest::newRow(qPrintable(QString::number(chunk))) << chunk;
+    }
+}
+
+void LliurexHash64Test::chunks()
+{
+    QFETCH(int, chunk);
+
+    const QByteArray data = input(1000);
+    for (int length : {0, 3, 7, 31, 32, 33, 100, 1000}) {
+        for (quint64 seed : {Q_UINT64_C(0), Seed}) {
+            LliurexHash64 hash(seed);
+            for (int offset = 0; offset < length; offset += chunk) {
+                hash.addData(data.constData() + offset, qMin(chunk, length - offset));
+            }
+            QCOMPARE(hash.result(), LliurexHash64::hash(data.constData(), length, seed));
+        }
+    }
+}
+
+void LliurexHash64Test::resultInBetween()
+{
+    const QByteArray data = input(100);
+    LliurexHash64 hash;
+    hash.addData(data.constData(), 40);
+    QCOMPARE(hash.result(), LliurexHash64::hash(data.constData(), 40));
+
+    // asking for the result does not end the stream
+    hash.addData(data.constData() + 40, 60);
+    QCOMPARE(hash.result(), Q_UINT64_C(0xD248BFC5208B0B16));
+}
+
+QTEST_GUILESS_MAIN(LliurexHash64Test)
+
+#include "LliurexHash64Test.moc"
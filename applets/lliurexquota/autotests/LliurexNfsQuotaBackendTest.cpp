@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexNfsQuotaBackend.h"
+
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QTemporaryFile>
+#include <QTest>
+#include <QUdpSocket>
+
+/**
+ * Stand-in for the backend rquotad cannot replace, answering with a
+ * single entry that tells it apart.
+ */
+class LliurexStubQuotaBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    QString name() const override { return QStringLiteral("stub"); }
+    bool isAvailable() const override { return true; }
+
+    void requestQuota() override
+    {
+        ++requests;
+        LliurexQuotaEntry entry;
+        entry.name = QStringLiteral("stub");
+        emit quotaReady(QVector<LliurexQuotaEntry>{entry});
+    }
+
+    int requests = 0;
+};
+
+/**
+ * Runs LliurexNfsQuotaBackend against loadtest/fake-rquotad, listening
+ * on 127.0.0.1, with the NFS mounts read from a file of our own.
+ */
+class LliurexNfsQuotaBackendTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+
+    void answer();
+    void hostName();
+    void noQuotaAsksFallback();
+    void timeoutAsksFallback();
+    void nfs4Root();
+
+private:
+    void startServer(const QProcessEnvironment &env = QProcessEnvironment::systemEnvironment());
+    LliurexNfsQuotaBackend *createBackend(const QByteArray &mountInfo, quint16 port = 0);
+
+    QScopedPointer<QProcess> m_server;
+    QScopedPointer<QTemporaryFile> m_mountInfo;
+    QScopedPointer<LliurexNfsQuotaBackend> m_backend;
+    LliurexStubQuotaBackend *m_fallback = nullptr;
+    quint16 m_port = 0;
+};
+
+void LliurexNfsQuotaBackendTest::startServer(const QProcessEnvironment &env)
+{
+    // a port free a moment ago
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    m_port = probe.localPort();
+    probe.close();
+
+    m_server.reset(new QProcess);
+    m_server->setProcessEnvironment(env);
+    m_server->start(QStringLiteral("python3"), QStringList{QStringLiteral(LLIUREX_FAKE_RQUOTAD), QString::number(m_port)});
+    QVERIFY(m_server->waitForStarted());
+}
+
+LliurexNfsQuotaBackend *LliurexNfsQuotaBackendTest::createBackend(const QByteArray &mountInfo, quint16 port)
+{
+    m_mountInfo.reset(new QTemporaryFile);
+    m_mountInfo->open();
+    m_mountInfo->write(mountInfo);
+    m_mountInfo->flush();
+
+    // the backend reads both when it is created, calls sent before the
+    // server listens are sent again
+    qputenv("LLIUREX_NFS_MOUNTINFO", QFile::encodeName(m_mountInfo->fileName()));
+    qputenv("LLIUREX_RQUOTA_PORT", QByteArray::number(port ? port : m_port));
+    m_fallback = new LliurexStubQuotaBackend;
+    m_backend.reset(new LliurexNfsQuotaBackend(m_fallback));
+    return m_backend.data();
+}
+
+void LliurexNfsQuotaBackendTest::cleanup()
+{
+    m_backend.reset();
+    m_fallback = nullptr;
+    if (m_server) {
+        m_server->kill();
+        m_server->waitForFinished();
+        m_server.reset();
+    }
+    m_mountInfo.reset();
+    qunsetenv("LLIUREX_NFS_MOUNTINFO");
+    qunsetenv("LLIUREX_RQUOTA_PORT");
+    qunsetenv("LLIUREX_NFS4_ROOT");
+}
+
+void LliurexNfsQuotaBackendTest::answer()
+{
+    startServer();
+    LliurexNfsQuotaBackend *backend = createBackend("40 25 0:50 / /home/alice rw - nfs4 127.0.0.1:/home/alice rw,addr=127.0.0.1\n");
+    QVERIFY(backend->isAvailable());
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy unchanged(backend, &LliurexQuotaBackend::quotaUnchanged);
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].mountPoint, QStringLiteral("/home/alice"));
+    QCOMPARE(entries[0].used, qint64(524288) * 1024);
+    QCOMPARE(entries[0].hardLimit, qint64(1048576) * 1024);
+    QCOMPARE(backend->name(), QStringLiteral("nfs"));
+
+    // the same answer again
+    backend->requestQuota();
+    QVERIFY(unchanged.wait(5000));
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(failed.count(), 0);
+    QCOMPARE(m_fallback->requests, 0);
+}
+
+void LliurexNfsQuotaBackendTest::hostName()
+{
+    startServer();
+    // no addr= option: the server is looked up when asked
+    LliurexNfsQuotaBackend *backend = createBackend("40 25 0:50 / /home/alice rw - nfs localhost:/home/alice rw\n");
+    QCOMPARE(LliurexNfsQuotaBackend::nfsMounts().size(), 1);
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].used, qint64(524288) * 1024);
+    QCOMPARE(m_fallback->requests, 0);
+}
+
+void LliurexNfsQuotaBackendTest::noQuotaAsksFallback()
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("LLIUREX_FAKE_RQUOTA_STATUS"), QStringLiteral("2"));
+    startServer(env);
+    LliurexNfsQuotaBackend *backend = createBackend("40 25 0:50 / /home/alice rw - nfs 127.0.0.1:/home/alice rw,addr=127.0.0.1\n");
+
+    // a group quota looks like no quota to rquotad, an empty list would hide it
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].name, QStringLiteral("stub"));
+    QCOMPARE(m_fallback->requests, 1);
+    QCOMPARE(backend->name(), QStringLiteral("stub"));
+}
+
+void LliurexNfsQuotaBackendTest::timeoutAsksFallback()
+{
+    // nothing listens on the port of a server never started
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    const quint16 port = probe.localPort();
+    probe.close();
+    LliurexNfsQuotaBackend *backend = createBackend("40 25 0:50 / /home/alice rw - nfs 127.0.0.1:/home/alice rw,addr=127.0.0.1\n", port);
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+    backend->requestQuota();
+    QVERIFY(ready.wait(10000));
+    QCOMPARE(failed.count(), 0);
+    QCOMPARE(m_fallback->requests, 1);
+
+    // the next polls go to the fallback right away, not through the timeout
+    backend->requestQuota();
+    QCOMPARE(m_fallback->requests, 2);
+    QCOMPARE(ready.count(), 2);
+}
+
+void LliurexNfsQuotaBackendTest::nfs4Root()
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("LLIUREX_FAKE_RQUOTA_EXPORT"), QStringLiteral("/srv/nfs4/home/alice"));
+    startServer(env);
+
+    // the client sees /home/alice below the pseudo-root, rquotad knows /srv/nfs4/home/alice
+    qputenv("LLIUREX_NFS4_ROOT", "/srv/nfs4/");
+    LliurexNfsQuotaBackend *backend = createBackend("40 25 0:50 / /home/alice rw - nfs4 127.0.0.1:/home/alice rw,addr=127.0.0.1\n");
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    backend->requestQuota();
+    QVERIFY(ready.wait(5000));
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].used, qint64(524288) * 1024);
+    QCOMPARE(m_fallback->requests, 0);
+}
+
+QTEST_GUILESS_MAIN(LliurexNfsQuotaBackendTest)
+
+#include "LliurexNfsQuotaBackendTest.moc"
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexPollScheduler.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <algorithm>
+
+namespace {
+    /**
+     * A clock that only moves when told to.
+     */
+    class ManualClock : public LliurexPollScheduler::Clock
+    {
+    public:
+        explicit ManualClock(qint64 *time)
+            : m_time(time)
+        {
+        }
+
+        qint64 now() const override
+        {
+            return *m_time;
+        }
+
+    private:
+        qint64 *m_time;
+    };
+
+    const qint64 Minute = 60 * 1000;
+    const qint64 Hour = 60 * Minute;
+}
+
+class LliurexPollSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void policyInterval_data();
+    void policyInterval();
+    void jitterBounds_data();
+    void jitterBounds();
+    void hostPhaseSpreadsClients();
+    void growthRate();
+    void growthRateIgnoresCloseSamples();
+    void fastGrowthPollsOften();
+    void safetyInterval();
+    void startupDelay();
+    void pausedDoesNotPoll();
+    void resumeCatchesUp();
+
+private:
+    LliurexPollScheduler *m_scheduler = nullptr;
+    qint64 m_time = 0;
+};
+
+void LliurexPollSchedulerTest::init()
+{
+    m_time = 0;
+    m_scheduler = new LliurexPollScheduler;
+    m_scheduler->setClock(new ManualClock(&m_time));
+    m_scheduler->setHostSeed(4711);
+}
+
+void LliurexPollSchedulerTest::cleanup()
+{
+    delete m_scheduler;
+    m_scheduler = nullptr;
+}
+
+void LliurexPollSchedulerTest::policyInterval_data()
+{
+    QTest::addColumn<int>("usage");
+    QTest::addColumn<double>("growthRate");
+    QTest::addColumn<qint64>("interval");
+
+    QTest::newRow("empty") << 0 << 0.0 << 5 * Minute;
+    QTest::newRow("stable under 50%") << 49 << 0.0 << 5 * Minute;
+    QTest::newRow("shrinking") << 40 << -20.0 << 5 * Minute;
+    QTest::newRow("50%") << 50 << 0.0 << 2 * Minute;
+    QTest::newRow("slow growth") << 10 << 0.5 << 2 * Minute;
+    QTest::newRow("75%") << 75 << 0.0 << Minute;
+    QTest::newRow("growth") << 10 << 2.0 << Minute;
+    QTest::newRow("attention threshold") << 90 << 0.0 << 30 * 1000ll;
+    QTest::newRow("full") << 100 << 0.0 << 30 * 1000ll;
+    QTest::newRow("fast growth") << 10 << 10.0 << 30 * 1000ll;
+}
+
+void LliurexPollSchedulerTest::policyInterval()
+{
+    QFETCH(int, usage);
+    QFETCH(double, growthRate);
+    QFETCH(qint64, interval);
+    QCOMPARE(qint64(LliurexPollScheduler::policyInterval(usage, growthRate)), interval);
+}
+
+void LliurexPollSchedulerTest::jitterBounds_data()
+{
+    QTest::addColumn<int>("usage");
+
+    QTest::newRow("stable") << 10;
+    QTest::newRow("high") << 80;
+    QTest::newRow("critical") << 95;
+}
+
+void LliurexPollSchedulerTest::jitterBounds()
+{
+    QFETCH(int, usage);
+
+    m_scheduler->reportUsage(usage);
+    const int base = LliurexPollScheduler::policyInterval(usage, 0.0);
+    // host jitter of +-10% plus random jitter of +-5%
+    for (int i = 0; i < 1000; ++i) {
+        const int interval = m_scheduler->nextInterval();
+        QVERIFY2(interval >= base * 0.85 && interval <= base * 1.15, qPrintable(QString::number(interval)));
+    }
+}
+
+void LliurexPollSchedulerTest::hostPhaseSpreadsClients()
+{
+    // a classroom of hosts must not share one interval
+    QVector<int> intervals;
+    for (quint32 seed = 1; seed <= 30; ++seed) {
+        LliurexPollScheduler scheduler;
+        scheduler.setHostSeed(seed * 2654435761u);
+        intervals.append(scheduler.nextInterval());
+    }
+    std::sort(intervals.begin(), intervals.end());
+    const int distinct = std::unique(intervals.begin(), intervals.end()) - intervals.begin();
+    QVERIFY(distinct > 20);
+    QVERIFY(intervals.last() - intervals.first() > LliurexPollScheduler::policyInterval(0, 0.0) / 10);
+}
+
+void LliurexPollSchedulerTest::growthRate()
+{
+    m_scheduler->reportUsage(10);
+    QCOMPARE(m_scheduler->growthRate(), 0.0);
+
+    // 10% in one hour, smoothed with the previous rate of 0
+    m_time += Hour;
+    m_scheduler->reportUsage(20);
+    QCOMPARE(m_scheduler->growthRate(), 5.0);
+
+    m_time += Hour;
+    m_scheduler->reportUsage(30);
+    QCOMPARE(m_scheduler->growthRate(), 7.5);
+
+    // stable again: the rate decays
+    m_time += Hour;
+    m_scheduler->reportUsage(30);
+    QCOMPARE(m_scheduler->growthRate(), 3.75);
+}
+
+void LliurexPollSchedulerTest::growthRateIgnoresCloseSamples()
+{
+    m_scheduler->reportUsage(10);
+    m_time += 1000;
+    m_scheduler->reportUsage(90);
+    QCOMPARE(m_scheduler->growthRate(), 0.0);
+}
+
+void LliurexPollSchedulerTest::fastGrowthPollsOften()
+{
+    m_scheduler->reportUsage(10);
+    m_time += 10 * Minute;
+    m_scheduler->reportUsage(20);
+
+    // 60% per hour, halved by the smoothing, is still fast
+    QVERIFY(m_scheduler->growthRate() >= 10.0);
+    QVERIFY(m_scheduler->nextInterval() <= 30 * 1000 * 1.15);
+}
+
+void LliurexPollSchedulerTest::safetyInterval()
+{
+    m_scheduler->reportUsage(95);
+    m_scheduler->setSafetyInterval(15 * Minute);
+    const int interval = m_scheduler->nextInterval();
+    QVERIFY(interval >= 15 * Minute * 0.85 && interval <= 15 * Minute * 1.15);
+
+    m_scheduler->setSafetyInterval(0);
+    QVERIFY(m_scheduler->nextInterval() <= 30 * 1000 * 1.15);
+}
+
+void LliurexPollSchedulerTest::startupDelay()
+{
+    for (int i = 0; i < 100; ++i) {
+        const int delay = m_scheduler->startupDelay(60 * 1000);
+        QVERIFY(delay >= 0 && delay <= 60 * 1000);
+    }
+}
+
+void LliurexPollSchedulerTest::pausedDoesNotPoll()
+{
+    QSignalSpy spy(m_scheduler, &LliurexPollScheduler::pollRequested);
+    m_scheduler->setPaused(true);
+    m_scheduler->start(0);
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 0);
+
+    // locked right after a poll was scheduled
+    m_scheduler->stop();
+    m_scheduler->setPaused(false);
+    m_scheduler->start(0);
+    m_scheduler->setPaused(true);
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 0);
+}
+
+void LliurexPollSchedulerTest::resumeCatchesUp()
+{
+    QSignalSpy spy(m_scheduler, &LliurexPollScheduler::pollRequested);
+    m_scheduler->start(0);
+    QVERIFY(spy.wait(1000));
+    m_scheduler->reportUsage(10);
+
+    m_scheduler->setPaused(true);
+    // a locked screen over the whole interval makes the next poll overdue
+    m_time += 10 * Minute;
+    m_scheduler->setPaused(false);
+    // the catch-up poll is spread over a few seconds
+    QVERIFY(spy.wait(6000));
+    QCOMPARE(spy.count(), 2);
+}
+
+QTEST_GUILESS_MAIN(LliurexPollSchedulerTest)
+
+#include "LliurexPollSchedulerTest.moc"
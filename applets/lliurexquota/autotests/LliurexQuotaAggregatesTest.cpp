@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaAggregates.h"
+
+#include <QDebug>
+#include <QMap>
+#include <QTest>
+
+#include <algorithm>
+
+/**
+ * Checks LliurexQuotaAggregates, which is kept up to date from the
+ * difference between two data sets, against the same numbers computed
+ * from scratch, over a series of generated refreshes where users write,
+ * change groups, enter and leave their grace period, appear and vanish.
+ */
+class LliurexQuotaAggregatesTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void percentiles();
+
+    void matchesRecompute_data();
+    void matchesRecompute();
+
+    void clear();
+};
+
+namespace {
+    const qint64 GiB = qint64(1024) * 1024 * 1024;
+    const qint64 Now = 1700000000;
+
+    /**
+     * Quotas of up to @p count users on /home as refresh @p generation
+     * sees them, the same for every run.
+     */
+    QVector<LliurexQuotaEntry> users(int count, int generation)
+    {
+        QVector<LliurexQuotaEntry> entries;
+        for (int i = 0; i < count; ++i) {
+            // some users come and go
+            if ((i + generation) % 13 == 0) {
+                continue;
+            }
+            LliurexQuotaEntry entry;
+            entry.type = LliurexQuotaEntry::UserQuota;
+            entry.id = 10000 + i;
+            entry.name = QStringLiteral("user%1").arg(i);
+            entry.mountPoint = QStringLiteral("/home");
+            // every fifth user moves to another group now and then
+            entry.group = QStringLiteral("class%1").arg((i + (i % 5 == 0 ? generation / 2 : 0)) % 40);
+
+            // a spread of usages, a seventh of the users writing every time
+            entry.used = (qint64(i) * 7919 % 1000) * GiB / 400;
+            if (i % 7 == generation % 7) {
+                entry.used += generation * GiB / 8;
+            }
+            if (i % 17 == 0) {
+                // no limits at all
+            } else if (i % 19 == 0) {
+                entry.hardLimit = 2 * GiB;
+            } else {
+                entry.softLimit = GiB + GiB / 2;
+                entry.hardLimit = 2 * GiB + (i % 3) * GiB / 4;
+            }
+            // over the soft limit: a grace period that ran out, runs, or is not known
+            if (entry.softLimit > 0 && entry.used > entry.softLimit) {
+                entry.graceTime = (i + generation) % 3 == 2 ? 0 : Now + ((i + generation) % 3 - 1) * 3600 + i;
+            }
+            entries.append(entry);
+        }
+
+        // the order of the rows is the source's, not stable across refreshes
+        if (generation % 2) {
+            std::reverse(entries.begin(), entries.end());
+        }
+        return entries;
+    }
+
+    /**
+     * The numbers of LliurexQuotaAggregates, computed from scratch.
+     */
+    struct Recompute {
+        explicit Recompute(const QVector<LliurexQuotaEntry> &entries)
+        {
+            for (const LliurexQuotaEntry &entry : entries) {
+                usages.append(entry.usage());
+                const bool overSoft = entry.softLimit > 0 && entry.used > entry.softLimit;
+                if (overSoft) {
+                    ++overSoftLimit;
+                    if (entry.graceTime > Now) {
+                        ++inGrace;
+                    }
+                }
+                if (entry.hardLimit > 0 && entry.used >= entry.hardLimit) {
+                    ++overHardLimit;
+                }
+
+                LliurexQuotaAggregates::GroupTotals &totals = groups[entry.group];
+                totals.group = entry.group;
+                ++totals.quotas;
+                totals.used += entry.used;
+                totals.limit += entry.hardLimit > 0 ? entry.hardLimit : entry.softLimit;
+                if (overSoft) {
+                    ++totals.overSoftLimit;
+                }
+            }
+            std::sort(usages.begin(), usages.end());
+        }
+
+        int usagePercentile(int percent) const
+        {
+            if (usages.isEmpty()) {
+                return 0;
+            }
+            // nearest rank
+            const int rank = qMax(1, (usages.size() * percent + 99) / 100);
+            return usages[rank - 1];
+        }
+
+        QVector<int> usages;
+        int overSoftLimit = 0;
+        int overHardLimit = 0;
+        int inGrace = 0;
+        QMap<QString, LliurexQuotaAggregates::GroupTotals> groups;
+    };
+
+    void compare(const LliurexQuotaAggregates &aggregates, const QVector<LliurexQuotaEntry> &entries)
+    {
+        const Recompute expected(entries);
+
+        QCOMPARE(aggregates.count(), entries.size());
+        for (int percent : {0, 1, 10, 50, 90, 99, 100}) {
+            QCOMPARE(aggregates.usagePercentile(percent), expected.usagePercentile(percent));
+        }
+        QCOMPARE(aggregates.overSoftLimit(), expected.overSoftLimit);
+        QCOMPARE(aggregates.overHardLimit(), expected.overHardLimit);
+        QCOMPARE(aggregates.inGrace(Now), expected.inGrace);
+
+        const QVector<LliurexQuotaAggregates::GroupTotals> totals = aggregates.groupTotals();
+        QCOMPARE(totals.size(), expected.groups.size());
+        for (int i = 0; i < totals.size(); ++i) {
+            if (i > 0) {
+                QVERIFY(totals[i - 1].used >= totals[i].used);
+            }
+            QVERIFY(expected.groups.contains(totals[i].group));
+            const LliurexQuotaAggregates::GroupTotals &group = expected.groups[totals[i].group];
+            QCOMPARE(totals[i].quotas, group.quotas);
+            QCOMPARE(totals[i].used, group.used);
+            QCOMPARE(totals[i].limit, group.limit);
+            QCOMPARE(totals[i].overSoftLimit, group.overSoftLimit);
+        }
+    }
+}
+
+void LliurexQuotaAggregatesTest::empty()
+{
+    LliurexQuotaAggregates aggregates;
+    QCOMPARE(aggregates.count(), 0);
+    QCOMPARE(aggregates.usagePercentile(50), 0);
+    QCOMPARE(aggregates.overSoftLimit(), 0);
+    QCOMPARE(aggregates.inGrace(Now), 0);
+    QVERIFY(aggregates.groupTotals().isEmpty());
+}
+
+void LliurexQuotaAggregatesTest::percentiles()
+{
+    // usages 10, 20, ..., 100 percent of a 1 GiB limit
+    QVector<LliurexQuotaEntry> entries;
+    for (int i = 1; i <= 10; ++i) {
+        LliurexQuotaEntry entry;
+        entry.id = i;
+        entry.mountPoint = QStringLiteral("/home");
+        entry.hardLimit = GiB;
+        entry.used = GiB * i / 10;
+        entries.append(entry);
+    }
+
+    LliurexQuotaAggregates aggregates;
+    aggregates.apply(entries);
+    QCOMPARE(aggregates.usagePercentile(0), 10);
+    QCOMPARE(aggregates.usagePercentile(10), 10);
+    QCOMPARE(aggregates.usagePercentile(11), 20);
+    QCOMPARE(aggregates.usagePercentile(50), 50);
+    QCOMPARE(aggregates.usagePercentile(100), 100);
+    QCOMPARE(aggregates.overHardLimit(), 1);
+}
+
+void LliurexQuotaAggregatesTest::matchesRecompute_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("5000") << 5000;
+}
+
+void LliurexQuotaAggregatesTest::matchesRecompute()
+{
+    QFETCH(int, count);
+
+    LliurexQuotaAggregates aggregates;
+    for (int generation = 0; generation < 30; ++generation) {
+        const QVector<LliurexQuotaEntry> entries = users(count, generation);
+        aggregates.apply(entries);
+        compare(aggregates, entries);
+        if (QTest::currentTestFailed()) {
+            qWarning() << "after refresh" << generation;
+            return;
+        }
+    }
+
+    // the same data again changes nothing
+    const QVector<LliurexQuotaEntry> entries = users(count, 29);
+    aggregates.apply(entries);
+    compare(aggregates, entries);
+
+    // and all users gone leaves no group behind
+    aggregates.apply(QVector<LliurexQuotaEntry>());
+    compare(aggregates, QVector<LliurexQuotaEntry>());
+}
+
+void LliurexQuotaAggregatesTest::clear()
+{
+    LliurexQuotaAggregates aggregates;
+    aggregates.apply(users(200, 0));
+    aggregates.clear();
+    compare(aggregates, QVector<LliurexQuotaEntry>());
+
+    // and it fills up again as if new
+    const QVector<LliurexQuotaEntry> entries = users(200, 1);
+    aggregates.apply(entries);
+    compare(aggregates, entries);
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaAggregatesTest)
+
+#include "LliurexQuotaAggregatesTest.moc"
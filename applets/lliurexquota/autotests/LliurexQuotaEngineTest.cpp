@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexQuotaEngine.h"
+#include "LliurexDirectoryIndex.h"
+#include "LliurexReclaimAnalyzer.h"
+
+#include <QFile>
+#include <QPointer>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+/**
+ * Acquires LliurexQuotaEngine as the views of the applets do, with the
+ * home folder and the caches in temporary directories, and checks that
+ * the views share one engine and that its expensive parts are only
+ * created when first asked for.
+ */
+class LliurexQuotaEngineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void shared();
+    void lazyDirectoryIndex();
+    void lazyReclaimAnalyzer();
+
+private:
+    QTemporaryDir m_home;
+    QByteArray m_homeVariable;
+};
+
+void LliurexQuotaEngineTest::initTestCase()
+{
+    QVERIFY(m_home.isValid());
+    QStandardPaths::setTestModeEnabled(true);
+
+    // the index and the analyzer walk the whole home folder
+    m_homeVariable = qgetenv("HOME");
+    qputenv("HOME", QFile::encodeName(m_home.path()));
+}
+
+void LliurexQuotaEngineTest::cleanupTestCase()
+{
+    qputenv("HOME", m_homeVariable);
+}
+
+void LliurexQuotaEngineTest::shared()
+{
+    QSharedPointer<LliurexQuotaEngine> first = LliurexQuotaEngine::acquire();
+    QSharedPointer<LliurexQuotaEngine> second = LliurexQuotaEngine::acquire();
+    QVERIFY(first);
+    QCOMPARE(second.data(), first.data());
+    QCOMPARE(second->model(), first->model());
+
+    // the engine lives as long as one view holds it
+    QPointer<LliurexQuotaEngine> engine = first.data();
+    first.reset();
+    QVERIFY(engine);
+    second.reset();
+    QVERIFY(!engine);
+
+    // and the next view gets a new one
+    QSharedPointer<LliurexQuotaEngine> third = LliurexQuotaEngine::acquire();
+    QVERIFY(third);
+    QCOMPARE(third.data(), LliurexQuotaEngine::acquire().data());
+}
+
+void LliurexQuotaEngineTest::lazyDirectoryIndex()
+{
+    QSharedPointer<LliurexQuotaEngine> engine = LliurexQuotaEngine::acquire();
+    QVERIFY(engine->findChildren<LliurexDirectoryIndex *>().isEmpty());
+
+    LliurexDirectoryIndex *index = engine->directoryIndex();
+    QVERIFY(index);
+    QCOMPARE(engine->directoryIndex(), index);
+    QCOMPARE(engine->findChildren<LliurexDirectoryIndex *>().size(), 1);
+
+    // a second view shares the index too
+    QCOMPARE(LliurexQuotaEngine::acquire()->directoryIndex(), index);
+}
+
+void LliurexQuotaEngineTest::lazyReclaimAnalyzer()
+{
+    QSharedPointer<LliurexQuotaEngine> engine = LliurexQuotaEngine::acquire();
+    QVERIFY(engine->findChildren<LliurexReclaimAnalyzer *>().isEmpty());
+
+    LliurexReclaimAnalyzer *analyzer = engine->reclaimAnalyzer();
+    QVERIFY(analyzer);
+    QCOMPARE(engine->reclaimAnalyzer(), analyzer);
+    QCOMPARE(engine->findChildren<LliurexReclaimAnalyzer *>().size(), 1);
+    QVERIFY(engine->findChildren<LliurexDirectoryIndex *>().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaEngineTest)
+
+#include "LliurexQuotaEngineTest.moc"
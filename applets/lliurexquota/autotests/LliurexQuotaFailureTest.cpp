@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexCircuitBreaker.h"
+#include "LliurexProcessQuotaBackend.h"
+#include "LliurexToolLocator.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QTest>
+
+/**
+ * Runs LliurexProcessQuotaBackend against stand-ins for lliurex-quota
+ * that answer, fail or hang, and drives LliurexCircuitBreaker through
+ * the failures a sick quota server causes.
+ */
+class LliurexQuotaFailureTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+
+    void answer();
+    void requestJoinsRunningQuery();
+    void nonZeroExit();
+    void hungToolIsKilled();
+    void requestWhileHung();
+
+    void breakerOpensAfterFailures();
+    void breakerProbe();
+    void breakerBackoffGrows();
+
+private:
+    LliurexProcessQuotaBackend *createBackend(const QString &tool);
+
+    QScopedPointer<LliurexToolLocator> m_locator;
+    QScopedPointer<LliurexProcessQuotaBackend> m_backend;
+};
+
+LliurexProcessQuotaBackend *LliurexQuotaFailureTest::createBackend(const QString &tool)
+{
+    // the backend reads the tool when it is created
+    qputenv("LLIUREX_QUOTA_TOOL", QFile::encodeName(tool));
+    m_locator.reset(new LliurexToolLocator(QStringList{tool}));
+    m_backend.reset(new LliurexProcessQuotaBackend(m_locator.data()));
+    // short enough for a test, the tools that answer do so at once
+    m_backend->setDeadline(500, 500);
+    return m_backend.data();
+}
+
+void LliurexQuotaFailureTest::cleanup()
+{
+    m_backend.reset();
+    m_locator.reset();
+    qunsetenv("LLIUREX_QUOTA_TOOL");
+    qunsetenv("LLIUREX_FAKE_QUOTA_CHURN");
+    qunsetenv("LLIUREX_FAKE_QUOTA_LATENCY_MS");
+    qunsetenv("LLIUREX_FAKE_QUOTA_EXIT");
+}
+
+void LliurexQuotaFailureTest::answer()
+{
+    qputenv("LLIUREX_FAKE_QUOTA_CHURN", "0");
+    LliurexProcessQuotaBackend *backend = createBackend(QStringLiteral(LLIUREX_FAKE_QUOTA));
+    QVERIFY(backend->isAvailable());
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy unchanged(backend, &LliurexQuotaBackend::quotaUnchanged);
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+
+    backend->requestQuota();
+    QVERIFY(ready.wait());
+    const QVector<LliurexQuotaEntry> entries = ready.at(0).at(0).value<QVector<LliurexQuotaEntry>>();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].used, qint64(524288) * 1024);
+    QCOMPARE(entries[0].hardLimit, qint64(1048576) * 1024);
+
+    // the same output again
+    backend->requestQuota();
+    QVERIFY(unchanged.wait());
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(failed.count(), 0);
+}
+
+void LliurexQuotaFailureTest::requestJoinsRunningQuery()
+{
+    qputenv("LLIUREX_FAKE_QUOTA_LATENCY_MS", "200");
+    LliurexProcessQuotaBackend *backend = createBackend(QStringLiteral(LLIUREX_FAKE_QUOTA));
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    backend->requestQuota();
+    backend->requestQuota();
+    backend->requestQuota();
+    QVERIFY(ready.wait());
+
+    // one run answered all three requests
+    QTest::qWait(400);
+    QCOMPARE(ready.count(), 1);
+}
+
+void LliurexQuotaFailureTest::nonZeroExit()
+{
+    qputenv("LLIUREX_FAKE_QUOTA_EXIT", "3");
+    LliurexProcessQuotaBackend *backend = createBackend(QStringLiteral(LLIUREX_TEST_DATA_DIR "/lliurex-quota-fail"));
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+    backend->requestQuota();
+    QVERIFY(failed.wait());
+    QVERIFY(failed.at(0).at(0).toString().contains(QLatin1String("code 3")));
+
+    // the record printed before failing is not taken
+    QCOMPARE(ready.count(), 0);
+}
+
+void LliurexQuotaFailureTest::hungToolIsKilled()
+{
+    LliurexProcessQuotaBackend *backend = createBackend(QStringLiteral(LLIUREX_TEST_DATA_DIR "/lliurex-quota-hang"));
+
+    QSignalSpy ready(backend, &LliurexQuotaBackend::quotaReady);
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+
+    QElapsedTimer timer;
+    timer.start();
+    backend->requestQuota();
+    // SIGTERM after the deadline is ignored, SIGKILL after the grace is not
+    QVERIFY(failed.wait(5000));
+    QVERIFY(timer.elapsed() >= 1000);
+    QVERIFY(failed.at(0).at(0).toString().contains(QLatin1String("timed out")));
+    QCOMPARE(ready.count(), 0);
+}
+
+void LliurexQuotaFailureTest::requestWhileHung()
+{
+    LliurexProcessQuotaBackend *backend = createBackend(QStringLiteral(LLIUREX_TEST_DATA_DIR "/lliurex-quota-hang"));
+
+    QSignalSpy failed(backend, &LliurexQuotaBackend::quotaFailed);
+    backend->requestQuota();
+
+    // before the deadline the request joins the run, no second process
+    backend->requestQuota();
+    QCOMPARE(failed.count(), 0);
+
+    // once it is being terminated, requests fail right away
+    QTest::qWait(700);
+    backend->requestQuota();
+    QCOMPARE(failed.count(), 1);
+
+    // and the run itself fails once killed
+    QVERIFY(failed.wait(5000));
+    QCOMPARE(failed.count(), 2);
+}
+
+void LliurexQuotaFailureTest::breakerOpensAfterFailures()
+{
+    LliurexCircuitBreaker breaker;
+    breaker.setFailureThreshold(3);
+    breaker.setBackoff(60 * 1000, 10 * 60 * 1000);
+
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(breaker.allowRequest());
+        breaker.recordFailure();
+        QCOMPARE(breaker.state(), LliurexCircuitBreaker::Closed);
+    }
+
+    // a success in between starts counting again
+    breaker.recordSuccess();
+    breaker.recordFailure();
+    breaker.recordFailure();
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::Closed);
+
+    breaker.recordFailure();
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::Open);
+    QVERIFY(!breaker.allowRequest());
+}
+
+void LliurexQuotaFailureTest::breakerProbe()
+{
+    LliurexCircuitBreaker breaker;
+    breaker.setFailureThreshold(1);
+    breaker.setBackoff(50, 50);
+
+    QSignalSpy probeDue(&breaker, &LliurexCircuitBreaker::probeDue);
+    breaker.recordFailure();
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::Open);
+
+    QVERIFY(probeDue.wait(1000));
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::HalfOpen);
+
+    // exactly one probe is let through
+    QVERIFY(breaker.allowRequest());
+    QVERIFY(!breaker.allowRequest());
+
+    // its failure opens the breaker again, its success closes it
+    breaker.recordFailure();
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::Open);
+    QVERIFY(probeDue.wait(1000));
+    QVERIFY(breaker.allowRequest());
+    breaker.recordSuccess();
+    QCOMPARE(breaker.state(), LliurexCircuitBreaker::Closed);
+    QVERIFY(breaker.allowRequest());
+    QVERIFY(breaker.allowRequest());
+}
+
+void LliurexQuotaFailureTest::breakerBackoffGrows()
+{
+    LliurexCircuitBreaker breaker;
+    breaker.setFailureThreshold(1);
+    breaker.setBackoff(100, 400);
+
+    // equal jitter: every backoff lies between half and all of it
+    QSignalSpy probeDue(&breaker, &LliurexCircuitBreaker::probeDue);
+    const int backoffs[] = {100, 200, 400, 400};
+    for (int backoff : backoffs) {
+        QElapsedTimer timer;
+        timer.start();
+        breaker.recordFailure();
+        QVERIFY(probeDue.wait(2 * backoff));
+        QVERIFY2(timer.elapsed() >= backoff / 2 - 10, qPrintable(QString::number(timer.elapsed())));
+        QVERIFY(breaker.allowRequest());
+    }
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaFailureTest)
+
+#include "LliurexQuotaFailureTest.moc"
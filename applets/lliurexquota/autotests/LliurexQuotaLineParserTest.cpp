@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexQuotaLineParser.h"
+
+#include <QTest>
+
+/**
+ * Feeds LliurexQuotaLineParser single records and whole outputs of
+ * 'lliurex-quota -mq', in one piece and split at every byte.
+ */
+class LliurexQuotaLineParserTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void parseLine_data();
+    void parseLine();
+    void splitAnywhere();
+    void lineEnds();
+    void unterminatedLastLine();
+    void overlongLine();
+    void fingerprint();
+};
+
+namespace {
+    const QByteArray Output = "True,lliurex,182,0\n"
+                              "True,alumnes,524288,1048576\n"
+                              "Quota disabled for profes\n"
+                              "\n"
+                              "True,profes,1024,2048\n";
+
+    LliurexQuotaLineParser parsed(const QByteArray &output)
+    {
+        LliurexQuotaLineParser parser;
+        parser.feed(output.constData(), output.size());
+        parser.finish();
+        return parser;
+    }
+}
+
+void LliurexQuotaLineParserTest::parseLine_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<qint64>("used");
+    QTest::addColumn<qint64>("hardLimit");
+
+    QTest::newRow("record") << QByteArray("True,lliurex,182,0") << true << QStringLiteral("lliurex") << qint64(182 * 1024) << qint64(0);
+    QTest::newRow("limit") << QByteArray("True,alumnes,512,1024") << true << QStringLiteral("alumnes") << qint64(512 * 1024) << qint64(1024 * 1024);
+    QTest::newRow("empty tokens") << QByteArray("True,,alumnes,,512,1024,") << true << QStringLiteral("alumnes") << qint64(512 * 1024) << qint64(1024 * 1024);
+    QTest::newRow("blanks") << QByteArray("True,alumnes, 512 ,\t1024") << true << QStringLiteral("alumnes") << qint64(512 * 1024) << qint64(1024 * 1024);
+    QTest::newRow("no number") << QByteArray("True,alumnes,many,1024") << true << QStringLiteral("alumnes") << qint64(0) << qint64(1024 * 1024);
+    QTest::newRow("overflow") << QByteArray("True,alumnes,99999999999999999999,1") << true << QStringLiteral("alumnes") << qint64(0) << qint64(1024);
+    QTest::newRow("false") << QByteArray("False,alumnes,512,1024") << false << QString() << qint64(0) << qint64(0);
+    QTest::newRow("lower case") << QByteArray("true,alumnes,512,1024") << false << QString() << qint64(0) << qint64(0);
+    QTest::newRow("too few") << QByteArray("True,alumnes,512") << false << QString() << qint64(0) << qint64(0);
+    QTest::newRow("too many") << QByteArray("True,alumnes,512,1024,0") << false << QString() << qint64(0) << qint64(0);
+    QTest::newRow("text") << QByteArray("Quota disabled") << false << QString() << qint64(0) << qint64(0);
+}
+
+void LliurexQuotaLineParserTest::parseLine()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(bool, valid);
+
+    LliurexQuotaEntry entry;
+    QCOMPARE(LliurexQuotaLineParser::parseLine(line.constData(), line.constData() + line.size(), &entry), valid);
+    if (!valid) {
+        return;
+    }
+
+    QFETCH(QString, name);
+    QFETCH(qint64, used);
+    QFETCH(qint64, hardLimit);
+    QCOMPARE(entry.type, LliurexQuotaEntry::GroupQuota);
+    QCOMPARE(entry.name, name);
+    QCOMPARE(entry.group, name);
+    QCOMPARE(entry.used, used);
+    QCOMPARE(entry.hardLimit, hardLimit);
+}
+
+void LliurexQuotaLineParserTest::splitAnywhere()
+{
+    const LliurexQuotaLineParser whole = parsed(Output);
+    QCOMPARE(whole.entries().size(), 3);
+    QCOMPARE(whole.rejectedLines(), 1);
+
+    // as QProcess delivers it, in chunks cut at any byte
+    for (int split = 0; split <= Output.size(); ++split) {
+        LliurexQuotaLineParser parser;
+        parser.feed(Output.constData(), split);
+        parser.feed(Output.constData() + split, Output.size() - split);
+        parser.finish();
+        QCOMPARE(parser.entries(), whole.entries());
+        QCOMPARE(parser.rejectedLines(), whole.rejectedLines());
+        QCOMPARE(parser.fingerprint(), whole.fingerprint());
+    }
+
+    LliurexQuotaLineParser parser;
+    for (const char c : Output) {
+        parser.feed(&c, 1);
+    }
+    parser.finish();
+    QCOMPARE(parser.entries(), whole.entries());
+}
+
+void LliurexQuotaLineParserTest::lineEnds()
+{
+    QByteArray output = Output;
+    output.replace('\n', "\r\n");
+    const LliurexQuotaLineParser parser = parsed(output);
+    QCOMPARE(parser.entries(), parsed(Output).entries());
+    QCOMPARE(parser.rejectedLines(), 1);
+}
+
+void LliurexQuotaLineParserTest::unterminatedLastLine()
+{
+    LliurexQuotaLineParser parser;
+    const QByteArray output = "True,lliurex,182,0\nTrue,profes,1024,2048";
+    parser.feed(output.constData(), output.size());
+    QCOMPARE(parser.entries().size(), 1);
+
+    parser.finish();
+    QCOMPARE(parser.entries().size(), 2);
+    QCOMPARE(parser.entries().at(1).name, QStringLiteral("profes"));
+}
+
+void LliurexQuotaLineParserTest::overlongLine()
+{
+    // dropped without being buffered, even when it comes in pieces
+    const QByteArray garbage(10000, 'x');
+    LliurexQuotaLineParser parser;
+    for (int offset = 0; offset < garbage.size(); offset += 1000) {
+        parser.feed(garbage.constData() + offset, 1000);
+    }
+    const QByteArray rest = "\nTrue,lliurex,182,0\n";
+    parser.feed(rest.constData(), rest.size());
+    parser.finish();
+
+    QCOMPARE(parser.rejectedLines(), 1);
+    QCOMPARE(parser.entries().size(), 1);
+    QCOMPARE(parser.entries().at(0).name, QStringLiteral("lliurex"));
+}
+
+void LliurexQuotaLineParserTest::fingerprint()
+{
+    const quint64 fingerprint = parsed(Output).fingerprint();
+    QCOMPARE(parsed(Output).fingerprint(), fingerprint);
+    QVERIFY(parsed(QByteArray(Output).replace("182", "183")).fingerprint() != fingerprint);
+    // the length counts too, a trailing empty line changes the output
+    QVERIFY(parsed(Output + '\n').fingerprint() != fingerprint);
+
+    LliurexQuotaLineParser parser = parsed(Output);
+    parser.reset();
+    QVERIFY(parser.entries().isEmpty());
+    QCOMPARE(parser.fingerprint(), parsed(QByteArray()).fingerprint());
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaLineParserTest)
+
+#include "LliurexQuotaLineParserTest.moc"
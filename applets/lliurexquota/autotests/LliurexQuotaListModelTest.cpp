@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexQuotaFormatter.h"
+#include "LliurexQuotaListModel.h"
+
+#include <QSignalSpy>
+#include <QTest>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+#include <QAbstractItemModelTester>
+#endif
+
+/**
+ * Applies the ChangeSets of LliurexQuotaListModel::diff() to a model
+ * watched by QAbstractItemModelTester, and checks both the rows and the
+ * signals: rows are moved as little as possible, and only what changed
+ * is announced.
+ */
+class LliurexQuotaListModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void reorder_data();
+    void reorder();
+    void insertBetween();
+    void removeAll();
+    void updateOnly();
+
+private:
+    void update(const QStringList &mountPoints, const QString &grown = QString());
+    QStringList mountPoints() const;
+
+    LliurexQuotaListModel *m_model = nullptr;
+    QVector<LliurexQuotaListModel::Row> m_rows;
+};
+
+void LliurexQuotaListModelTest::init()
+{
+    m_model = new LliurexQuotaListModel(this);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+    new QAbstractItemModelTester(m_model, QAbstractItemModelTester::FailureReportingMode::QtTest, m_model);
+#endif
+    m_rows.clear();
+}
+
+void LliurexQuotaListModelTest::cleanup()
+{
+    delete m_model;
+    m_model = nullptr;
+}
+
+void LliurexQuotaListModelTest::update(const QStringList &mountPoints, const QString &grown)
+{
+    LliurexQuotaFormatter formatter;
+    QVector<LliurexQuotaListModel::Row> rows;
+    for (const QString &mountPoint : mountPoints) {
+        LliurexQuotaItem item;
+        item.setMountPoint(mountPoint);
+        item.setUsed(mountPoint == grown ? 3 * 1024 * 1024 : 1024 * 1024);
+        item.setHardLimit(4 * 1024 * 1024);
+        rows.append(LliurexQuotaListModel::makeRow(item, formatter));
+    }
+
+    // the pipeline keeps the rows of the model the same way
+    m_model->applyChanges(LliurexQuotaListModel::diff(m_rows, rows));
+    m_rows = LliurexQuotaListModel::uniqueRows(rows);
+}
+
+QStringList LliurexQuotaListModelTest::mountPoints() const
+{
+    const int role = m_model->roleNames().key("mountPoint");
+    QStringList mountPoints;
+    for (int row = 0; row < m_model->rowCount(QModelIndex()); ++row) {
+        mountPoints.append(m_model->data(m_model->index(row), role).toString());
+    }
+    return mountPoints;
+}
+
+void LliurexQuotaListModelTest::reorder_data()
+{
+    QTest::addColumn<QStringList>("before");
+    QTest::addColumn<QStringList>("after");
+    QTest::addColumn<int>("moves");
+
+    const QStringList abcde{QStringLiteral("/a"), QStringLiteral("/b"), QStringLiteral("/c"),
+                            QStringLiteral("/d"), QStringLiteral("/e")};
+    QTest::newRow("unchanged") << abcde << abcde << 0;
+    QTest::newRow("last to front") << abcde
+        << QStringList{QStringLiteral("/e"), QStringLiteral("/a"), QStringLiteral("/b"), QStringLiteral("/c"), QStringLiteral("/d")} << 1;
+    QTest::newRow("first to back") << abcde
+        << QStringList{QStringLiteral("/b"), QStringLiteral("/c"), QStringLiteral("/d"), QStringLiteral("/e"), QStringLiteral("/a")} << 1;
+    QTest::newRow("pairs swapped") << abcde
+        << QStringList{QStringLiteral("/b"), QStringLiteral("/a"), QStringLiteral("/d"), QStringLiteral("/c"), QStringLiteral("/e")} << 2;
+    QTest::newRow("reversed") << abcde
+        << QStringList{QStringLiteral("/e"), QStringLiteral("/d"), QStringLiteral("/c"), QStringLiteral("/b"), QStringLiteral("/a")} << 4;
+}
+
+void LliurexQuotaListModelTest::reorder()
+{
+    QFETCH(QStringList, before);
+    QFETCH(QStringList, after);
+    QFETCH(int, moves);
+
+    update(before);
+    QSignalSpy moved(m_model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy inserted(m_model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(m_model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(m_model, &QAbstractItemModel::dataChanged);
+
+    update(after);
+    QCOMPARE(mountPoints(), after);
+    QCOMPARE(moved.count(), moves);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 0);
+}
+
+void LliurexQuotaListModelTest::insertBetween()
+{
+    update(QStringList{QStringLiteral("/a"), QStringLiteral("/d")});
+    QSignalSpy moved(m_model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy inserted(m_model, &QAbstractItemModel::rowsInserted);
+
+    const QStringList after{QStringLiteral("/a"), QStringLiteral("/b"), QStringLiteral("/c"), QStringLiteral("/d")};
+    update(after);
+    QCOMPARE(mountPoints(), after);
+    QCOMPARE(moved.count(), 0);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 1);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 2);
+}
+
+void LliurexQuotaListModelTest::removeAll()
+{
+    update(QStringList{QStringLiteral("/a"), QStringLiteral("/b"), QStringLiteral("/c")});
+    QSignalSpy removed(m_model, &QAbstractItemModel::rowsRemoved);
+
+    update(QStringList());
+    QCOMPARE(m_model->rowCount(QModelIndex()), 0);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 0);
+    QCOMPARE(removed.at(0).at(2).toInt(), 2);
+}
+
+void LliurexQuotaListModelTest::updateOnly()
+{
+    const QStringList mounts{QStringLiteral("/a"), QStringLiteral("/b"), QStringLiteral("/c")};
+    update(mounts);
+    QSignalSpy moved(m_model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy inserted(m_model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(m_model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(m_model, &QAbstractItemModel::dataChanged);
+
+    update(mounts, QStringLiteral("/b"));
+    QCOMPARE(mountPoints(), mounts);
+    QCOMPARE(moved.count(), 0);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toModelIndex().row(), 1);
+    QCOMPARE(changed.at(0).at(1).toModelIndex().row(), 1);
+    const QVector<int> roles = changed.at(0).at(2).value<QVector<int>>();
+    QVERIFY(roles.contains(m_model->roleNames().key("used")));
+    QVERIFY(!roles.contains(m_model->roleNames().key("mountPoint")));
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaListModelTest)
+
+#include "LliurexQuotaListModelTest.moc"
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexQuotaMetrics.h"
+
+#include <QFile>
+#include <QHash>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <limits>
+
+/**
+ * Records into the process wide LliurexQuotaMetrics and checks the
+ * histogram buckets, the snapshot and the Prometheus text format.
+ * Every test uses histograms of its own, the metrics are never reset.
+ */
+class LliurexQuotaMetricsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void buckets_data();
+    void buckets();
+    void counters();
+    void prometheusText();
+    void textfile();
+};
+
+namespace {
+    QVariantMap histogram(const char *name)
+    {
+        return LliurexQuotaMetrics::instance().snapshot().value(QLatin1String(name)).toMap();
+    }
+
+    quint64 bucket(const char *name, const QString &bound)
+    {
+        return histogram(name).value(QStringLiteral("buckets")).toMap().value(bound).toULongLong();
+    }
+}
+
+void LliurexQuotaMetricsTest::buckets_data()
+{
+    QTest::addColumn<quint64>("value");
+    QTest::addColumn<QString>("bound");
+
+    QTest::newRow("0") << quint64(0) << QStringLiteral("1");
+    QTest::newRow("1") << quint64(1) << QStringLiteral("1");
+    QTest::newRow("2") << quint64(2) << QStringLiteral("4");
+    QTest::newRow("4") << quint64(4) << QStringLiteral("4");
+    QTest::newRow("5") << quint64(5) << QStringLiteral("16");
+    QTest::newRow("16") << quint64(16) << QStringLiteral("16");
+    QTest::newRow("17") << quint64(17) << QStringLiteral("64");
+    QTest::newRow("4^15") << (quint64(1) << 30) << QStringLiteral("1073741824");
+    QTest::newRow("4^15 + 1") << (quint64(1) << 30) + 1 << QStringLiteral("+Inf");
+    QTest::newRow("max") << std::numeric_limits<quint64>::max() << QStringLiteral("+Inf");
+}
+
+void LliurexQuotaMetricsTest::buckets()
+{
+    QFETCH(quint64, value);
+    QFETCH(QString, bound);
+
+    const QVariantMap before = histogram("parse_time_microseconds");
+    const quint64 inBucket = bucket("parse_time_microseconds", bound);
+    QCOMPARE(before.value(QStringLiteral("buckets")).toMap().size(), LliurexQuotaMetrics::BucketCount + 1);
+
+    LliurexQuotaMetrics::instance().record(LliurexQuotaMetrics::ParseTime, value);
+
+    const QVariantMap after = histogram("parse_time_microseconds");
+    QCOMPARE(bucket("parse_time_microseconds", bound), inBucket + 1);
+    QCOMPARE(after.value(QStringLiteral("count")).toULongLong(), before.value(QStringLiteral("count")).toULongLong() + 1);
+    QCOMPARE(after.value(QStringLiteral("sum")).toULongLong(), before.value(QStringLiteral("sum")).toULongLong() + value);
+}
+
+void LliurexQuotaMetricsTest::counters()
+{
+    LliurexQuotaMetrics &metrics = LliurexQuotaMetrics::instance();
+    const quint64 before = metrics.snapshot().value(QStringLiteral("failures_total")).toULongLong();
+    metrics.add(LliurexQuotaMetrics::Failures);
+    metrics.add(LliurexQuotaMetrics::Failures, 3);
+    QCOMPARE(metrics.snapshot().value(QStringLiteral("failures_total")).toULongLong(), before + 4);
+}
+
+void LliurexQuotaMetricsTest::prometheusText()
+{
+    LliurexQuotaMetrics &metrics = LliurexQuotaMetrics::instance();
+    metrics.record(LliurexQuotaMetrics::StdoutBytes, 3);
+    metrics.record(LliurexQuotaMetrics::StdoutBytes, 20);
+    metrics.record(LliurexQuotaMetrics::StdoutBytes, 5000);
+    metrics.add(LliurexQuotaMetrics::Crashes, 2);
+
+    const QString text = QString::fromUtf8(metrics.prometheusText());
+    QVERIFY(text.endsWith(QLatin1Char('\n')));
+
+    // every sample follows the TYPE line of its family
+    const QRegularExpression typeLine(QStringLiteral("^# TYPE (lliurexquota_[a-z_]+) (counter|histogram)$"));
+    const QRegularExpression sampleLine(QStringLiteral("^(lliurexquota_[a-z_]+)\\{uid=\"\\d+\"(?:,le=\"([0-9]+|\\+Inf)\")?\\} (\\d+)$"));
+    QString family;
+    QHash<QString, quint64> values;
+    int types = 0;
+    for (const QString &line : text.split(QLatin1Char('\n'), QString::SkipEmptyParts)) {
+        const QRegularExpressionMatch type = typeLine.match(line);
+        if (type.hasMatch()) {
+            family = type.captured(1);
+            ++types;
+            continue;
+        }
+        const QRegularExpressionMatch sample = sampleLine.match(line);
+        QVERIFY2(sample.hasMatch(), qPrintable(line));
+        QVERIFY2(sample.captured(1).startsWith(family), qPrintable(line));
+        const QString key = sample.captured(2).isEmpty() ? sample.captured(1) : sample.captured(1) + QLatin1Char(' ') + sample.captured(2);
+        values.insert(key, sample.captured(3).toULongLong());
+    }
+    QCOMPARE(types, int(LliurexQuotaMetrics::CounterCount + LliurexQuotaMetrics::HistogramCount));
+
+    QCOMPARE(values.value(QStringLiteral("lliurexquota_crashes_total")), quint64(2));
+
+    // buckets are cumulative, up to +Inf which equals the count
+    const QString name = QStringLiteral("lliurexquota_stdout_bytes");
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 1")), quint64(0));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 4")), quint64(1));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 16")), quint64(1));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 64")), quint64(2));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 4096")), quint64(2));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket 16384")), quint64(3));
+    QCOMPARE(values.value(name + QStringLiteral("_bucket +Inf")), quint64(3));
+    QCOMPARE(values.value(name + QStringLiteral("_count")), quint64(3));
+    QCOMPARE(values.value(name + QStringLiteral("_sum")), quint64(5023));
+}
+
+void LliurexQuotaMetricsTest::textfile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/lliurexquota.prom");
+
+    qunsetenv("LLIUREX_QUOTA_METRICS_TEXTFILE");
+    LliurexQuotaMetrics::instance().writeTextfile();
+    QVERIFY(!QFile::exists(fileName));
+
+    qputenv("LLIUREX_QUOTA_METRICS_TEXTFILE", QFile::encodeName(fileName));
+    LliurexQuotaMetrics::instance().writeTextfile();
+    qunsetenv("LLIUREX_QUOTA_METRICS_TEXTFILE");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), LliurexQuotaMetrics::instance().prometheusText());
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaMetricsTest)
+
+#include "LliurexQuotaMetricsTest.moc"
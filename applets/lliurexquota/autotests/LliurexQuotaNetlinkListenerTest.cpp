@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaNetlinkListener.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+/**
+ * Feeds synthetic VFS_DQUOT messages to the listener, no quota file
+ * system or netlink socket is needed.
+ */
+class LliurexQuotaNetlinkListenerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void userWarning();
+    void groupWarning();
+    void otherIdsIgnored_data();
+    void otherIdsIgnored();
+    void noWarningIgnored();
+    void severalMessages();
+    void truncatedDatagram();
+    void isExceeded_data();
+    void isExceeded();
+
+private:
+    LliurexQuotaNetlinkListener *m_listener = nullptr;
+};
+
+void LliurexQuotaNetlinkListenerTest::init()
+{
+    m_listener = new LliurexQuotaNetlinkListener;
+    m_listener->setIds(1000, QVector<uint>() << 100 << 200);
+}
+
+void LliurexQuotaNetlinkListenerTest::cleanup()
+{
+    delete m_listener;
+    m_listener = nullptr;
+}
+
+void LliurexQuotaNetlinkListenerTest::userWarning()
+{
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    m_listener->processDatagram(m_listener->createWarningDatagram(
+        0, 1000, LliurexQuotaNetlinkListener::BlockHardLimitReached, 8, 1));
+
+    QCOMPARE(spy.count(), 1);
+    const QList<QVariant> arguments = spy.takeFirst();
+    QCOMPARE(arguments.at(0).toInt(), 0);
+    QCOMPARE(arguments.at(1).toULongLong(), quint64(1000));
+    QCOMPARE(arguments.at(2).toInt(), int(LliurexQuotaNetlinkListener::BlockHardLimitReached));
+    QCOMPARE(arguments.at(3).toUInt(), 8u);
+    QCOMPARE(arguments.at(4).toUInt(), 1u);
+}
+
+void LliurexQuotaNetlinkListenerTest::groupWarning()
+{
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    m_listener->processDatagram(m_listener->createWarningDatagram(
+        1, 200, LliurexQuotaNetlinkListener::BlockBelowSoftLimit));
+
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), 1);
+    QCOMPARE(spy.at(0).at(1).toULongLong(), quint64(200));
+}
+
+void LliurexQuotaNetlinkListenerTest::otherIdsIgnored_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<quint64>("id");
+
+    QTest::newRow("other user") << 0 << quint64(1001);
+    QTest::newRow("user id of a group") << 0 << quint64(100);
+    QTest::newRow("other group") << 1 << quint64(300);
+    QTest::newRow("group id of the user") << 1 << quint64(1000);
+    QTest::newRow("group id above 32 bits") << 1 << (quint64(1) << 32 | 100);
+    QTest::newRow("project") << 2 << quint64(1000);
+}
+
+void LliurexQuotaNetlinkListenerTest::otherIdsIgnored()
+{
+    QFETCH(int, type);
+    QFETCH(quint64, id);
+
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    m_listener->processDatagram(m_listener->createWarningDatagram(
+        type, id, LliurexQuotaNetlinkListener::BlockSoftLimitReached));
+    QCOMPARE(spy.count(), 0);
+}
+
+void LliurexQuotaNetlinkListenerTest::noWarningIgnored()
+{
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    m_listener->processDatagram(m_listener->createWarningDatagram(
+        0, 1000, LliurexQuotaNetlinkListener::NoWarning));
+    QCOMPARE(spy.count(), 0);
+}
+
+void LliurexQuotaNetlinkListenerTest::severalMessages()
+{
+    // the kernel may queue several warnings into one datagram
+    QByteArray datagram;
+    datagram += m_listener->createWarningDatagram(0, 1000, LliurexQuotaNetlinkListener::InodeSoftLimitReached);
+    datagram += m_listener->createWarningDatagram(0, 1001, LliurexQuotaNetlinkListener::InodeSoftLimitReached);
+    datagram += m_listener->createWarningDatagram(1, 100, LliurexQuotaNetlinkListener::BlockGraceExpired);
+
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    m_listener->processDatagram(datagram);
+
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(0).at(2).toInt(), int(LliurexQuotaNetlinkListener::InodeSoftLimitReached));
+    QCOMPARE(spy.at(1).at(2).toInt(), int(LliurexQuotaNetlinkListener::BlockGraceExpired));
+}
+
+void LliurexQuotaNetlinkListenerTest::truncatedDatagram()
+{
+    const QByteArray datagram = m_listener->createWarningDatagram(
+        0, 1000, LliurexQuotaNetlinkListener::BlockHardLimitReached);
+
+    QSignalSpy spy(m_listener, &LliurexQuotaNetlinkListener::quotaWarning);
+    for (int size = 0; size < datagram.size(); ++size) {
+        m_listener->processDatagram(datagram.left(size));
+    }
+    QCOMPARE(spy.count(), 0);
+}
+
+void LliurexQuotaNetlinkListenerTest::isExceeded_data()
+{
+    QTest::addColumn<int>("warning");
+    QTest::addColumn<bool>("exceeded");
+
+    QTest::newRow("none") << int(LliurexQuotaNetlinkListener::NoWarning) << false;
+    QTest::newRow("inode hard") << int(LliurexQuotaNetlinkListener::InodeHardLimitReached) << true;
+    QTest::newRow("inode grace") << int(LliurexQuotaNetlinkListener::InodeGraceExpired) << true;
+    QTest::newRow("inode soft") << int(LliurexQuotaNetlinkListener::InodeSoftLimitReached) << true;
+    QTest::newRow("block hard") << int(LliurexQuotaNetlinkListener::BlockHardLimitReached) << true;
+    QTest::newRow("block grace") << int(LliurexQuotaNetlinkListener::BlockGraceExpired) << true;
+    QTest::newRow("block soft") << int(LliurexQuotaNetlinkListener::BlockSoftLimitReached) << true;
+    QTest::newRow("inode below hard") << int(LliurexQuotaNetlinkListener::InodeBelowHardLimit) << false;
+    QTest::newRow("inode below soft") << int(LliurexQuotaNetlinkListener::InodeBelowSoftLimit) << false;
+    QTest::newRow("block below hard") << int(LliurexQuotaNetlinkListener::BlockBelowHardLimit) << false;
+    QTest::newRow("block below soft") << int(LliurexQuotaNetlinkListener::BlockBelowSoftLimit) << false;
+}
+
+void LliurexQuotaNetlinkListenerTest::isExceeded()
+{
+    QFETCH(int, warning);
+    QFETCH(bool, exceeded);
+    QCOMPARE(LliurexQuotaNetlinkListener::isExceeded(warning), exceeded);
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaNetlinkListenerTest)
+
+#include "LliurexQuotaNetlinkListenerTest.moc"
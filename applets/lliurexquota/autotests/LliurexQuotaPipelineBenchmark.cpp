@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaFormatter.h"
+#include "LliurexQuotaLineParser.h"
+#include "LliurexQuotaListModel.h"
+
+#include <QTest>
+
+/**
+ * Times each stage of the poll pipeline on synthetic data, from 1 to
+ * 100000 quotas: parsing the output of lliurex-quota, building the
+ * display strings, merging the rows into the model and reading them back.
+ *
+ * ctest only checks that every stage works. For numbers, run the binary
+ * by hand, e.g. with '-iterations 20'; '-csv' or '-o results.xml,xml'
+ * give machine readable results to compare across releases.
+ */
+class LliurexQuotaPipelineBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void parse_data();
+    void parse();
+    void format_data();
+    void format();
+    void updateItems_data();
+    void updateItems();
+    void data_data();
+    void data();
+
+private:
+    void addSizes();
+};
+
+namespace {
+    QByteArray quotaOutput(int lines)
+    {
+        QByteArray output;
+        output.reserve(lines * 32);
+        for (int i = 0; i < lines; ++i) {
+            output += "True,group" + QByteArray::number(i) + ',' + QByteArray::number(524288 + i) + ",1048576\n";
+        }
+        return output;
+    }
+
+    /**
+     * @p count quotas on distinct mount points named after @p prefix.
+     * Every @p changeEvery th quota uses @p extra more bytes.
+     */
+    QVector<LliurexQuotaItem> quotaItems(int count, const QString &prefix, int changeEvery = 0, qint64 extra = 0)
+    {
+        QVector<LliurexQuotaEntry> entries;
+        entries.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            LliurexQuotaEntry entry;
+            entry.mountPoint = prefix + QString::number(i);
+            entry.used = (qint64(i) % 1000 + 1) * 1024 * 1024;
+            if (changeEvery > 0 && i % changeEvery == 0) {
+                entry.used += extra;
+            }
+            entry.hardLimit = qint64(2) * 1024 * 1024 * 1024;
+            entries.append(entry);
+        }
+        return LliurexQuotaFormatter::toItems(entries);
+    }
+}
+
+void LliurexQuotaPipelineBenchmark::addSizes()
+{
+    QTest::addColumn<int>("count");
+
+    for (int count : {1, 10, 100, 1000, 10000, 100000}) {
+        QTest::newRow(qPrintable(QString::number(count))) << count;
+    }
+}
+
+void LliurexQuotaPipelineBenchmark::parse_data()
+{
+    addSizes();
+}
+
+void LliurexQuotaPipelineBenchmark::parse()
+{
+    QFETCH(int, count);
+    const QByteArray output = quotaOutput(count);
+
+    LliurexQuotaLineParser parser;
+    QBENCHMARK {
+        // in pipe sized chunks, as QProcess delivers it
+        parser.reset();
+        for (int offset = 0; offset < output.size(); offset += 4096) {
+            parser.feed(output.constData() + offset, qMin(4096, output.size() - offset));
+        }
+        parser.finish();
+    }
+    QCOMPARE(parser.entries().size(), count);
+}
+
+void LliurexQuotaPipelineBenchmark::format_data()
+{
+    addSizes();
+}
+
+void LliurexQuotaPipelineBenchmark::format()
+{
+    QFETCH(int, count);
+    const QVector<LliurexQuotaItem> items = quotaItems(count, QStringLiteral("/home/user"));
+
+    QVector<LliurexQuotaListModel::Row> rows(count);
+    QBENCHMARK {
+        // a new formatter every time: the size cache starts cold
+        LliurexQuotaFormatter formatter;
+        for (int i = 0; i < count; ++i) {
+            rows[i] = LliurexQuotaListModel::makeRow(items.at(i), formatter);
+        }
+    }
+    QVERIFY(!rows.last().used.isEmpty());
+}
+
+void LliurexQuotaPipelineBenchmark::updateItems_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("kind");
+
+    for (int count : {1, 10, 100, 1000, 10000, 100000}) {
+        for (const QString &kind : {QStringLiteral("steady"), QStringLiteral("churn"), QStringLiteral("replace")}) {
+            QTest::newRow(qPrintable(QStringLiteral("%1 %2").arg(kind).arg(count))) << count << kind;
+        }
+    }
+}
+
+void LliurexQuotaPipelineBenchmark::updateItems()
+{
+    QFETCH(int, count);
+    QFETCH(QString, kind);
+
+    // the model switches between two data sets on every update
+    const QVector<LliurexQuotaItem> first = quotaItems(count, QStringLiteral("/home/user"));
+    QVector<LliurexQuotaItem> second;
+    if (kind == QLatin1String("steady")) {
+        second = first;
+    } else if (kind == QLatin1String("churn")) {
+        // every tenth quota grew by 1 MiB
+        second = quotaItems(count, QStringLiteral("/home/user"), 10, 1024 * 1024);
+    } else {
+        second = quotaItems(count, QStringLiteral("/srv/user"));
+    }
+
+    LliurexQuotaListModel model;
+    model.updateItems(first);
+    bool odd = false;
+    QBENCHMARK {
+        model.updateItems(odd ? first : second);
+        odd = !odd;
+    }
+    QCOMPARE(model.rowCount(QModelIndex()), count);
+}
+
+void LliurexQuotaPipelineBenchmark::data_data()
+{
+    addSizes();
+}
+
+void LliurexQuotaPipelineBenchmark::data()
+{
+    QFETCH(int, count);
+
+    LliurexQuotaListModel model;
+    model.updateItems(quotaItems(count, QStringLiteral("/home/user")));
+    const QList<int> roles = model.roleNames().keys();
+
+    // every role of every row, as the delegates of a ListView ask for them
+    int valid = 0;
+    QBENCHMARK {
+        valid = 0;
+        for (int row = 0; row < count; ++row) {
+            const QModelIndex index = model.index(row, 0);
+            for (int role : roles) {
+                valid += model.data(index, role).isValid();
+            }
+        }
+    }
+    QCOMPARE(valid, count * roles.size());
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaPipelineBenchmark)
+
+#include "LliurexQuotaPipelineBenchmark.moc"
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaPipeline.h"
+#include "LliurexToolLocator.h"
+
+#include <QDir>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QStorageInfo>
+#include <QTest>
+
+/**
+ * Runs LliurexQuotaPipeline with the process backend against
+ * loadtest/fake-lliurex-quota, and checks which rows it shows the
+ * reclaimable space of the home folder with.
+ */
+class LliurexQuotaPipelineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void lliurexQuotaRecord();
+    void homeMountPoint();
+
+private:
+    QScopedPointer<LliurexToolLocator> m_locator;
+    QScopedPointer<LliurexQuotaPipeline> m_pipeline;
+};
+
+namespace {
+    const qint64 MiB = 1024 * 1024;
+
+    /**
+     * The reclaimable bytes of the rows @p presentation inserts or
+     * updates, in the order of the changes.
+     */
+    QVector<qint64> reclaimable(const LliurexQuotaPipeline::Presentation &presentation)
+    {
+        QVector<qint64> bytes;
+        for (const LliurexQuotaListModel::Change &change : presentation.changes) {
+            for (const LliurexQuotaListModel::Row &row : change.rows) {
+                bytes.append(row.item.reclaimable());
+            }
+        }
+        return bytes;
+    }
+}
+
+void LliurexQuotaPipelineTest::initTestCase()
+{
+    // the usage history is kept in the cache folder
+    QStandardPaths::setTestModeEnabled(true);
+
+    // the backend reads both when it is created
+    qputenv("LLIUREX_QUOTA_BACKEND", "process");
+    qputenv("LLIUREX_QUOTA_TOOL", LLIUREX_FAKE_QUOTA);
+    qputenv("LLIUREX_FAKE_QUOTA_CHURN", "0");
+}
+
+void LliurexQuotaPipelineTest::init()
+{
+    m_locator.reset(new LliurexToolLocator(QStringList{QStringLiteral(LLIUREX_FAKE_QUOTA)}));
+    m_pipeline.reset(new LliurexQuotaPipeline(m_locator.data()));
+}
+
+void LliurexQuotaPipelineTest::cleanup()
+{
+    m_pipeline.reset();
+    m_locator.reset();
+}
+
+void LliurexQuotaPipelineTest::lliurexQuotaRecord()
+{
+    QSignalSpy presented(m_pipeline.data(), &LliurexQuotaPipeline::presented);
+    m_pipeline->setReclaimable(3 * MiB);
+    m_pipeline->requestQuota();
+    QVERIFY(presented.wait(5000));
+
+    // 'True,group0,524288,1048576': the assigned space, in the home folder
+    // and reported as a group quota
+    LliurexQuotaPipeline::Presentation presentation = presented.takeLast().at(0).value<LliurexQuotaPipeline::Presentation>();
+    QCOMPARE(presentation.kind, LliurexQuotaPipeline::Presentation::Answer);
+    QCOMPARE(presentation.entries.size(), 1);
+    QCOMPARE(presentation.entries[0].type, LliurexQuotaEntry::GroupQuota);
+    QCOMPARE(reclaimable(presentation), QVector<qint64>{3 * MiB});
+
+    // a new size is shown without a poll
+    m_pipeline->setReclaimable(5 * MiB);
+    QVERIFY(presented.wait(5000));
+    presentation = presented.takeLast().at(0).value<LliurexQuotaPipeline::Presentation>();
+    QCOMPARE(presentation.kind, LliurexQuotaPipeline::Presentation::Refresh);
+    QCOMPARE(reclaimable(presentation), QVector<qint64>{5 * MiB});
+}
+
+void LliurexQuotaPipelineTest::homeMountPoint()
+{
+    QVector<LliurexQuotaEntry> entries(2);
+    entries[0].type = LliurexQuotaEntry::GroupQuota;
+    entries[0].mountPoint = QStorageInfo(QDir::homePath()).rootPath();
+    entries[0].used = 100 * MiB;
+    entries[0].hardLimit = 1000 * MiB;
+    entries[1].mountPoint = QStringLiteral("/nonexistent/lliurexquota");
+    entries[1].used = 100 * MiB;
+    entries[1].hardLimit = 1000 * MiB;
+
+    QSignalSpy presented(m_pipeline.data(), &LliurexQuotaPipeline::presented);
+    m_pipeline->setReclaimable(7 * MiB);
+    m_pipeline->present(entries);
+    QVERIFY(presented.wait(5000));
+
+    // whatever the type, only the file system of the home folder counts it
+    const LliurexQuotaPipeline::Presentation presentation = presented.takeLast().at(0).value<LliurexQuotaPipeline::Presentation>();
+    QCOMPARE(presentation.kind, LliurexQuotaPipeline::Presentation::Stale);
+    QCOMPARE(reclaimable(presentation), (QVector<qint64>{7 * MiB, 0}));
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaPipelineTest)
+
+#include "LliurexQuotaPipelineTest.moc"
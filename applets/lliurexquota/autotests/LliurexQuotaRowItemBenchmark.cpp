@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaFormatter.h"
+#include "LliurexQuotaRowItem.h"
+
+#include <KLocalizedContext>
+
+#include <QAbstractListModel>
+#include <QEventLoop>
+#include <QQmlApplicationEngine>
+#include <QQmlContext>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QScopedPointer>
+#include <QSurfaceFormat>
+#include <QTest>
+#include <QTimer>
+
+/**
+ * Scrolls the list of all users' quotas to its end, once with
+ * ListDelegateItem.qml and once with LliurexQuotaRowItem, and times it.
+ *
+ * The scene is rendered as fast as the renderer goes, without vsync, and
+ * the list is moved by a fixed step after each frame, so a pass costs what
+ * creating, binding and drawing the rows that come into view costs.
+ * ctest renders offscreen with the software renderer and only checks that
+ * every case works. For numbers, run the binary by hand on a display, e.g.
+ * with '-iterations 5' and '-csv'.
+ */
+class LliurexQuotaRowItemBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void scroll_data();
+    void scroll();
+};
+
+namespace {
+    const int Rows = 1000;
+    const int Step = 60;        // pixels per frame
+
+    /**
+     * Rows like the ones of LliurexAdminQuotaModel, made up.
+     */
+    class BenchmarkModel : public QAbstractListModel
+    {
+    public:
+        enum {
+            NameRole = Qt::UserRole,
+            MountPointRole,
+            UsageRole,
+            UsedStringRole,
+            IconRole,
+            OverSoftLimitRole
+        };
+
+        explicit BenchmarkModel(int rows) : m_rows(rows) {}
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const override
+        {
+            return parent.isValid() ? 0 : m_rows;
+        }
+
+        QVariant data(const QModelIndex &index, int role) const override
+        {
+            const int row = index.row();
+            // spread over the whole range, but the same for every run
+            const int usage = (row * 37) % 101;
+            switch (role) {
+                case NameRole: return QStringLiteral("user%1").arg(row, 5, 10, QLatin1Char('0'));
+                case MountPointRole: return QStringLiteral("/home");
+                case UsageRole: return usage;
+                case UsedStringRole: return QStringLiteral("%1 MiB of 1 GiB").arg(usage * 1024 / 100);
+                case IconRole: return LliurexQuotaFormatter::iconNameForQuota(usage);
+                case OverSoftLimitRole: return usage > 95;
+            }
+            return QVariant();
+        }
+
+        QHash<int, QByteArray> roleNames() const override
+        {
+            QHash<int, QByteArray> roles;
+            roles[NameRole] = "name";
+            roles[MountPointRole] = "mountPoint";
+            roles[UsageRole] = "usage";
+            roles[UsedStringRole] = "used";
+            roles[IconRole] = "icon";
+            roles[OverSoftLimitRole] = "overSoftLimit";
+            return roles;
+        }
+
+    private:
+        int m_rows;
+    };
+
+    /**
+     * Scrolls @p view from its top to its end, one step per frame of
+     * @p window. Returns the frames rendered, 0 if the end was not reached.
+     */
+    int scrollToEnd(QQuickWindow *window, QQuickItem *view)
+    {
+        view->setProperty("contentY", 0);
+
+        int frames = 0;
+        bool atEnd = false;
+        QEventLoop loop;
+        QTimer timeout;
+        timeout.setSingleShot(true);
+        QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+        const QMetaObject::Connection connection = QObject::connect(window, &QQuickWindow::frameSwapped, &loop, [&]() {
+            ++frames;
+            if (view->property("atYEnd").toBool()) {
+                atEnd = true;
+                loop.quit();
+                return;
+            }
+            view->setProperty("contentY", view->property("contentY").toReal() + Step);
+            window->update();
+        });
+        timeout.start(60000);
+        window->update();
+        loop.exec();
+        QObject::disconnect(connection);
+
+        return atEnd ? frames : 0;
+    }
+}
+
+void LliurexQuotaRowItemBenchmark::initTestCase()
+{
+    // render on the GUI thread and as fast as possible: the frame time is
+    // then what the delegates cost, not the refresh rate of the screen
+    qputenv("QSG_RENDER_LOOP", "basic");
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(0);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    qmlRegisterType<LliurexQuotaRowItem>("org.kde.plasma.private.lliurexquota", 1, 0, "LliurexQuotaRowItem");
+}
+
+void LliurexQuotaRowItemBenchmark::scroll_data()
+{
+    QTest::addColumn<bool>("sceneGraphDelegate");
+
+    QTest::newRow("ListDelegateItem") << false;
+    QTest::newRow("LliurexQuotaRowItem") << true;
+}
+
+void LliurexQuotaRowItemBenchmark::scroll()
+{
+    QFETCH(bool, sceneGraphDelegate);
+
+    BenchmarkModel model(Rows);
+    QQmlApplicationEngine engine;
+    engine.rootContext()->setContextObject(new KLocalizedContext(&engine));
+    engine.rootContext()->setContextProperty(QStringLiteral("rowModel"), &model);
+    engine.rootContext()->setContextProperty(QStringLiteral("sceneGraphDelegate"), sceneGraphDelegate);
+    engine.load(QUrl::fromLocalFile(QStringLiteral(LLIUREX_ROW_ITEM_BENCHMARK_QML)));
+    QVERIFY(!engine.rootObjects().isEmpty());
+
+    QQuickWindow *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+    QVERIFY(window);
+    QQuickItem *view = window->findChild<QQuickItem *>(QStringLiteral("listView"));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+
+    // the first pass builds the scene and loads the fonts and icons
+    QVERIFY(scrollToEnd(window, view) > 0);
+
+    int frames = 0;
+    QBENCHMARK {
+        frames = scrollToEnd(window, view);
+    }
+    QVERIFY(frames > 0);
+}
+
+QTEST_MAIN(LliurexQuotaRowItemBenchmark)
+
+#include "LliurexQuotaRowItemBenchmark.moc"
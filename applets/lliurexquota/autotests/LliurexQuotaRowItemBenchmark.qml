@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+import QtQuick 2.1
+import QtQuick.Window 2.2
+
+import org.kde.plasma.private.lliurexquota 1.0
+
+import "../package/contents/ui"
+
+// scene of LliurexQuotaRowItemBenchmark: the admin list with the
+// delegate chosen by the test, which scrolls it to the end
+Window {
+    width: 400
+    height: 600
+    visible: true
+
+    // what the plasmoid would get from its context
+    QtObject {
+        id: units
+        property int gridUnit: 18
+        property int smallSpacing: 4
+        property QtObject iconSizes: QtObject {
+            property int small: 16
+            property int medium: 32
+        }
+    }
+    QtObject {
+        id: theme
+        property font defaultFont: Qt.font({ pointSize: 10 })
+        property color textColor: "#232629"
+        property color highlightColor: "#3daee9"
+    }
+    QtObject {
+        id: lliurexDiskQuota
+        property QtObject reclaimAnalyzer: QtObject {
+            property bool purging: false
+            property int purgeProgress: 0
+            property var locations: []
+        }
+        function openCleanUpTool(mountPoint) {}
+        function purgeReclaimable(purgeTrash) {}
+    }
+
+    Component {
+        id: listDelegate
+        ListDelegateItem {
+            enabled: false
+            width: listView.width
+            mountPoint: model.mountPoint
+            details: model.name
+            iconName: model.icon
+            usedString: model.used
+            freeString: model.overSoftLimit ? i18n("Over the limit") : ""
+            usage: model.usage
+        }
+    }
+
+    Component {
+        id: rowDelegate
+        LliurexQuotaRowItem {
+            width: listView.width
+            padding: units.smallSpacing
+            spacing: units.gridUnit
+            iconSize: units.iconSizes.medium
+            font: theme.defaultFont
+            textColor: theme.textColor
+            barColor: theme.highlightColor
+            trackColor: Qt.rgba(theme.textColor.r, theme.textColor.g, theme.textColor.b, 0.2)
+            title: model.name
+            note: model.overSoftLimit ? i18n("Over the limit") : ""
+            subtitle: model.used
+            iconName: model.icon
+            usage: model.usage
+        }
+    }
+
+    ListView {
+        id: listView
+        objectName: "listView"
+        anchors.fill: parent
+        model: rowModel
+        delegate: sceneGraphDelegate ? rowDelegate : listDelegate
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexQuotaSnapshot.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+#include <QTest>
+
+/**
+ * Saves LliurexQuotaSnapshot to a temporary directory and reads it back,
+ * also after damaging the file or letting it expire.
+ */
+class LliurexQuotaSnapshotTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void roundTrip();
+    void missingFile();
+    void otherVersion();
+    void truncated();
+    void expired();
+    void replaced();
+
+private:
+    QString fileName() const;
+    LliurexQuotaSnapshot snapshot(int count) const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void LliurexQuotaSnapshotTest::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void LliurexQuotaSnapshotTest::cleanup()
+{
+    m_dir.reset();
+}
+
+QString LliurexQuotaSnapshotTest::fileName() const
+{
+    // the directory is created on saving
+    return m_dir->path() + QStringLiteral("/lliurexquota/snapshot");
+}
+
+LliurexQuotaSnapshot LliurexQuotaSnapshotTest::snapshot(int count) const
+{
+    LliurexQuotaSnapshot snapshot;
+    for (int i = 0; i < count; ++i) {
+        LliurexQuotaEntry entry;
+        entry.type = i % 2 ? LliurexQuotaEntry::GroupQuota : LliurexQuotaEntry::UserQuota;
+        entry.id = 1000 + i;
+        entry.name = QStringLiteral("alumne%1").arg(i);
+        entry.mountPoint = QStringLiteral("/net/server-sync/home/%1").arg(i);
+        entry.group = QStringLiteral("alumnes");
+        entry.used = qint64(i + 1) * 1024 * 1024 * 1024;
+        entry.softLimit = qint64(4) * 1024 * 1024 * 1024;
+        entry.hardLimit = qint64(5) * 1024 * 1024 * 1024;
+        entry.inodesUsed = 100 + i;
+        entry.inodeSoftLimit = 1000;
+        entry.inodeHardLimit = 2000;
+        entry.graceTime = 1700000000 + i;
+        snapshot.entries.append(entry);
+    }
+    // whole milliseconds are stored
+    snapshot.time = QDateTime::fromMSecsSinceEpoch(QDateTime::currentMSecsSinceEpoch() - 60 * 1000);
+    return snapshot;
+}
+
+void LliurexQuotaSnapshotTest::roundTrip()
+{
+    const LliurexQuotaSnapshot saved = snapshot(3);
+    QVERIFY(saved.save(fileName()));
+
+    LliurexQuotaSnapshot loaded;
+    QVERIFY(loaded.load(fileName()));
+    QCOMPARE(loaded.entries, saved.entries);
+    QCOMPARE(loaded.time, saved.time);
+    QCOMPARE(loaded.entries.at(1).type, LliurexQuotaEntry::GroupQuota);
+    QCOMPARE(loaded.entries.at(2).graceTime, qint64(1700000002));
+
+    // no quota at all is a valid snapshot too
+    QVERIFY(snapshot(0).save(fileName()));
+    QVERIFY(loaded.load(fileName()));
+    QVERIFY(loaded.entries.isEmpty());
+}
+
+void LliurexQuotaSnapshotTest::missingFile()
+{
+    LliurexQuotaSnapshot loaded = snapshot(1);
+    QVERIFY(!loaded.load(fileName()));
+    QVERIFY(!loaded.load(QString()));
+    QCOMPARE(loaded.entries.size(), 1);
+}
+
+void LliurexQuotaSnapshotTest::otherVersion()
+{
+    QVERIFY(snapshot(2).save(fileName()));
+
+    // bump the version behind the magic number
+    QFile file(fileName());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QDataStream stream(&file);
+    file.seek(4);
+    stream << quint32(99);
+    file.close();
+
+    LliurexQuotaSnapshot loaded;
+    QVERIFY(!loaded.load(fileName()));
+    QVERIFY(loaded.entries.isEmpty());
+    QVERIFY(!loaded.time.isValid());
+}
+
+void LliurexQuotaSnapshotTest::truncated()
+{
+    QVERIFY(snapshot(2).save(fileName()));
+
+    QFile file(fileName());
+    QVERIFY(file.resize(file.size() - 10));
+
+    LliurexQuotaSnapshot loaded;
+    QVERIFY(!loaded.load(fileName()));
+    QVERIFY(loaded.entries.isEmpty());
+}
+
+void LliurexQuotaSnapshotTest::expired()
+{
+    LliurexQuotaSnapshot saved = snapshot(1);
+    saved.time = QDateTime::currentDateTime().addDays(-6);
+    QVERIFY(saved.save(fileName()));
+    LliurexQuotaSnapshot loaded;
+    QVERIFY(loaded.load(fileName()));
+
+    saved.time = QDateTime::currentDateTime().addDays(-8);
+    QVERIFY(saved.save(fileName()));
+    loaded = LliurexQuotaSnapshot();
+    QVERIFY(!loaded.load(fileName()));
+    QVERIFY(loaded.entries.isEmpty());
+}
+
+void LliurexQuotaSnapshotTest::replaced()
+{
+    QVERIFY(snapshot(3).save(fileName()));
+    QVERIFY(snapshot(1).save(fileName()));
+
+    LliurexQuotaSnapshot loaded;
+    QVERIFY(loaded.load(fileName()));
+    QCOMPARE(loaded.entries.size(), 1);
+}
+
+QTEST_GUILESS_MAIN(LliurexQuotaSnapshotTest)
+
+#include "LliurexQuotaSnapshotTest.moc"
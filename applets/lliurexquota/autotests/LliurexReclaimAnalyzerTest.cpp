@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexReclaimAnalyzer.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Runs LliurexReclaimAnalyzer on a generated home folder: sizes it,
+ * empties it, and checks what is left and what the purge reported.
+ */
+class LliurexReclaimAnalyzerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void purgeCaches();
+    void readOnlyEntryIsKept();
+};
+
+namespace {
+    bool writeFile(const QString &path, int size)
+    {
+        QFile file(path);
+        return QDir().mkpath(QFileInfo(path).path()) && file.open(QIODevice::WriteOnly)
+            && file.write(QByteArray(size, 'x')) == size;
+    }
+
+    qint64 allocated(const QString &path)
+    {
+        struct stat st;
+        if (lstat(QFile::encodeName(path).constData(), &st) != 0) {
+            return 0;
+        }
+        return qint64(st.st_blocks) * 512;
+    }
+
+    /**
+     * Bytes allocated below @p folder, as the analyzer counts them,
+     * without the top-level names starting with one of @p excluded.
+     */
+    qint64 allocatedBelow(const QString &folder, const QStringList &excluded = QStringList())
+    {
+        qint64 total = 0;
+        QDirIterator it(folder, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            const QString top = path.mid(folder.size() + 1).section(QLatin1Char('/'), 0, 0);
+            bool skip = false;
+            for (const QString &name : excluded) {
+                skip = skip || top.startsWith(name);
+            }
+            if (!skip) {
+                total += allocated(path);
+            }
+        }
+        return total;
+    }
+}
+
+void LliurexReclaimAnalyzerTest::purgeCaches()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString home = dir.path();
+
+    QVERIFY(writeFile(home + QStringLiteral("/.cache/app/data"), 64 * 1024));
+    QVERIFY(writeFile(home + QStringLiteral("/.cache/app/sub/more"), 16 * 1024));
+    QVERIFY(writeFile(home + QStringLiteral("/.cache/ksycoca5_en_abc"), 16 * 1024));
+    QVERIFY(writeFile(home + QStringLiteral("/.cache/thumbnails/normal/a.png"), 16 * 1024));
+    QVERIFY(writeFile(home + QStringLiteral("/.local/share/Trash/files/old.txt"), 32 * 1024));
+    QVERIFY(writeFile(home + QStringLiteral("/.local/share/Trash/info/old.txt.trashinfo"), 100));
+
+    // ksycoca and the thumbnails folder are not part of the .cache location,
+    // the thumbnails are a location of their own
+    const qint64 caches = allocatedBelow(home + QStringLiteral("/.cache"), {QStringLiteral("ksycoca5"), QStringLiteral("thumbnails")})
+                        + allocatedBelow(home + QStringLiteral("/.cache/thumbnails"));
+    const qint64 trash = allocatedBelow(home + QStringLiteral("/.local/share/Trash/files"))
+                       + allocatedBelow(home + QStringLiteral("/.local/share/Trash/info"));
+
+    LliurexReclaimAnalyzer analyzer(home);
+    QSignalSpy changed(&analyzer, &LliurexReclaimAnalyzer::reclaimableChanged);
+    analyzer.analyze();
+    QVERIFY(changed.wait(10000));
+    QCOMPARE(analyzer.reclaimable(), caches + trash);
+
+    // the trash is only emptied when asked for
+    QSignalSpy purged(&analyzer, &LliurexReclaimAnalyzer::purged);
+    analyzer.purge(false);
+    QVERIFY(purged.wait(10000));
+    QCOMPARE(purged.at(0).at(0).toLongLong(), caches);
+    QCOMPARE(purged.at(0).at(1).toInt(), 0);
+
+    QVERIFY(!QFileInfo::exists(home + QStringLiteral("/.cache/app")));
+    QVERIFY(QFileInfo::exists(home + QStringLiteral("/.cache/ksycoca5_en_abc")));
+    QVERIFY(QFileInfo::exists(home + QStringLiteral("/.cache/thumbnails")));
+    QVERIFY(!QFileInfo::exists(home + QStringLiteral("/.cache/thumbnails/normal")));
+    QVERIFY(QFileInfo::exists(home + QStringLiteral("/.local/share/Trash/files/old.txt")));
+
+    // and what is left is sized again
+    QVERIFY(changed.wait(10000));
+    QCOMPARE(analyzer.reclaimable(), trash);
+}
+
+void LliurexReclaimAnalyzerTest::readOnlyEntryIsKept()
+{
+    if (geteuid() == 0) {
+        QSKIP("root removes the entries of read-only folders");
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString home = dir.path();
+    const QString locked = home + QStringLiteral("/.cache/locked");
+
+    QVERIFY(writeFile(home + QStringLiteral("/.cache/free/data"), 64 * 1024));
+    QVERIFY(writeFile(locked + QStringLiteral("/data"), 16 * 1024));
+    const qint64 removable = allocated(home + QStringLiteral("/.cache/free")) + allocatedBelow(home + QStringLiteral("/.cache/free"));
+    QVERIFY(QFile::setPermissions(locked, QFile::ReadOwner | QFile::ExeOwner));
+
+    LliurexReclaimAnalyzer analyzer(home);
+    QSignalSpy purged(&analyzer, &LliurexReclaimAnalyzer::purged);
+    analyzer.purge(false);
+    const bool finished = purged.wait(10000);
+    // else the temporary folder cannot be removed
+    QFile::setPermissions(locked, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+    QVERIFY(finished);
+
+    // the file, and the folder holding it
+    QCOMPARE(purged.at(0).at(0).toLongLong(), removable);
+    QCOMPARE(purged.at(0).at(1).toInt(), 2);
+    QVERIFY(QFileInfo::exists(locked + QStringLiteral("/data")));
+    QVERIFY(!QFileInfo::exists(home + QStringLiteral("/.cache/free")));
+}
+
+QTEST_GUILESS_MAIN(LliurexReclaimAnalyzerTest)
+
+#include "LliurexReclaimAnalyzerTest.moc"
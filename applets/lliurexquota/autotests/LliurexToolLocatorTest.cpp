@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexToolLocator.h"
+
+#include <QFile>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+/**
+ * Runs LliurexToolLocator on a $PATH of two temporary directories and
+ * installs and removes tools in them while it watches.
+ */
+class LliurexToolLocatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void searchOrder();
+    void notExecutable();
+    void absolutePath();
+    void installedLater();
+
+private:
+    QString install(const QTemporaryDir &dir, const QString &tool, bool executable = true);
+
+    QByteArray m_path;
+    QScopedPointer<QTemporaryDir> m_first;
+    QScopedPointer<QTemporaryDir> m_second;
+};
+
+void LliurexToolLocatorTest::init()
+{
+    m_first.reset(new QTemporaryDir);
+    m_second.reset(new QTemporaryDir);
+    QVERIFY(m_first->isValid() && m_second->isValid());
+
+    m_path = qgetenv("PATH");
+    qputenv("PATH", QFile::encodeName(m_first->path() + QLatin1Char(':') + m_second->path()));
+}
+
+void LliurexToolLocatorTest::cleanup()
+{
+    qputenv("PATH", m_path);
+    m_first.reset();
+    m_second.reset();
+}
+
+QString LliurexToolLocatorTest::install(const QTemporaryDir &dir, const QString &tool, bool executable)
+{
+    const QString fileName = dir.path() + QLatin1Char('/') + tool;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write("#!/bin/sh\n");
+    file.setPermissions(executable ? QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner
+                                   : QFile::ReadOwner | QFile::WriteOwner);
+    return fileName;
+}
+
+void LliurexToolLocatorTest::searchOrder()
+{
+    const QString tool = QStringLiteral("lliurex-quota");
+    const QString first = install(*m_first, tool);
+    const QString second = install(*m_second, tool);
+
+    LliurexToolLocator locator(QStringList{tool});
+    QSignalSpy changed(&locator, &LliurexToolLocator::toolsChanged);
+
+    // the first directory of $PATH wins
+    QCOMPARE(locator.path(tool), first);
+    QVERIFY(locator.isInstalled(tool));
+
+    // removed there, the next one is found once the burst of changes is over
+    QVERIFY(QFile::remove(first));
+    QVERIFY(changed.wait(5000));
+    QCOMPARE(locator.path(tool), second);
+
+    QVERIFY(!install(*m_first, tool).isEmpty());
+    QVERIFY(changed.wait(5000));
+    QCOMPARE(locator.path(tool), first);
+
+    QVERIFY(QFile::remove(first));
+    QVERIFY(QFile::remove(second));
+    QVERIFY(changed.wait(5000));
+    QVERIFY(locator.path(tool).isEmpty());
+    QVERIFY(!locator.isInstalled(tool));
+}
+
+void LliurexToolLocatorTest::notExecutable()
+{
+    const QString tool = QStringLiteral("quota");
+    install(*m_first, tool, false);
+    const QString second = install(*m_second, tool);
+
+    LliurexToolLocator locator(QStringList{tool});
+    QCOMPARE(locator.path(tool), second);
+}
+
+void LliurexToolLocatorTest::absolutePath()
+{
+    QTemporaryDir elsewhere;
+    QVERIFY(elsewhere.isValid());
+    const QString tool = install(elsewhere, QStringLiteral("lliurex-quota"));
+    install(*m_first, QStringLiteral("lliurex-quota"));
+
+    // outside $PATH, and its directory is watched too
+    LliurexToolLocator locator(QStringList{tool});
+    QSignalSpy changed(&locator, &LliurexToolLocator::toolsChanged);
+    QCOMPARE(locator.path(tool), tool);
+
+    QVERIFY(QFile::remove(tool));
+    QVERIFY(changed.wait(5000));
+    QVERIFY(!locator.isInstalled(tool));
+}
+
+void LliurexToolLocatorTest::installedLater()
+{
+    const QString tool = QStringLiteral("repquota");
+    LliurexToolLocator locator(QStringList{tool});
+    QSignalSpy changed(&locator, &LliurexToolLocator::toolsChanged);
+    QVERIFY(!locator.isInstalled(tool));
+
+    const QString second = install(*m_second, tool);
+    QVERIFY(changed.wait(5000));
+    QCOMPARE(locator.path(tool), second);
+    QCOMPARE(changed.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(LliurexToolLocatorTest)
+
+#include "LliurexToolLocatorTest.moc"
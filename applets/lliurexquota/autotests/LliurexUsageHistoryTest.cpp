@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LliurexUsageHistory.h"
+
+#include <QScopedPointer>
+#include <QTemporaryDir>
+#include <QTest>
+
+/**
+ * Fills a LliurexUsageHistory in a temporary file with samples at
+ * chosen times and checks the rings, the growth rate and what another
+ * instance on the same file sees.
+ */
+class LliurexUsageHistoryTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void wrapAround();
+    void tierPromotion();
+    void rateBeforeTrend();
+    void rateAfterReopen();
+    void shared();
+
+private:
+    QString fileName() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+namespace {
+    const QString Key = QStringLiteral("u1000:/home");
+    const qint64 Start = 1700000000;
+
+    // 1 MiB every quarter of an hour
+    const double Growth = 1024.0 * 1024.0 / (15 * 60);
+
+    /**
+     * Polls every five minutes for @p minutes, growing at Growth.
+     */
+    void poll(LliurexUsageHistory &history, int minutes)
+    {
+        for (qint64 elapsed = 0; elapsed <= minutes * 60; elapsed += 5 * 60) {
+            history.addSample(Key, Start + elapsed, qint64(elapsed * Growth));
+        }
+    }
+}
+
+void LliurexUsageHistoryTest::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void LliurexUsageHistoryTest::cleanup()
+{
+    m_dir.reset();
+}
+
+QString LliurexUsageHistoryTest::fileName() const
+{
+    return m_dir->path() + QStringLiteral("/usage-history");
+}
+
+void LliurexUsageHistoryTest::wrapAround()
+{
+    LliurexUsageHistory history(fileName());
+    QVERIFY(history.isPersistent());
+
+    for (int i = 0; i < 100; ++i) {
+        history.addSample(Key, Start + i, i);
+    }
+
+    // the ring holds the last 64 polls, oldest first
+    const QVector<LliurexUsageHistory::Sample> recent = history.samples(Key, LliurexUsageHistory::RecentTier);
+    QCOMPARE(recent.size(), 64);
+    for (int i = 0; i < recent.size(); ++i) {
+        QCOMPARE(recent[i].time, Start + 36 + i);
+        QCOMPARE(recent[i].used, qint64(36 + i));
+    }
+
+    // a second poll within the same second replaces the newest sample
+    history.addSample(Key, Start + 99, 1000);
+    QCOMPARE(history.samples(Key, LliurexUsageHistory::RecentTier).last().used, qint64(1000));
+    QCOMPARE(history.samples(Key, LliurexUsageHistory::RecentTier).size(), 64);
+}
+
+void LliurexUsageHistoryTest::tierPromotion()
+{
+    LliurexUsageHistory history(fileName());
+    poll(history, 7 * 60);
+
+    QCOMPARE(history.samples(Key, LliurexUsageHistory::RecentTier).size(), 64);
+
+    // every third poll is a quarter of an hour after the previous sample
+    const QVector<LliurexUsageHistory::Sample> quarters = history.samples(Key, LliurexUsageHistory::QuarterHourTier);
+    QCOMPARE(quarters.size(), 29);
+    for (int i = 0; i < quarters.size(); ++i) {
+        QCOMPARE(quarters[i].time, Start + i * 15 * 60);
+    }
+
+    const QVector<LliurexUsageHistory::Sample> sixHours = history.samples(Key, LliurexUsageHistory::SixHourTier);
+    QCOMPARE(sixHours.size(), 2);
+    QCOMPARE(sixHours[0].time, Start);
+    QCOMPARE(sixHours[1].time, Start + 6 * 60 * 60);
+}
+
+void LliurexUsageHistoryTest::rateBeforeTrend()
+{
+    LliurexUsageHistory history(fileName());
+    poll(history, 30);
+
+    // three quarter-hour samples are no trend yet, the smoothed rate stands in
+    double rate = 0;
+    QVERIFY(!history.trend(Key, LliurexUsageHistory::QuarterHourTier, &rate));
+    QVERIFY(history.growthRate(Key) > 0);
+    QVERIFY(history.growthRate(Key) < Growth);
+}
+
+void LliurexUsageHistoryTest::rateAfterReopen()
+{
+    qint64 timeToFull = 0;
+    {
+        LliurexUsageHistory history(fileName());
+        poll(history, 6 * 60);
+        QCOMPARE(history.growthRate(Key), Growth);
+        timeToFull = history.timeToFull(Key, 0, 100 * 1024 * 1024);
+        QVERIFY(qAbs(timeToFull - 100 * 15 * 60) <= 1);
+    }
+
+    LliurexUsageHistory history(fileName());
+    QVERIFY(history.isPersistent());
+    double rate = 0;
+    QVERIFY(history.trend(Key, LliurexUsageHistory::QuarterHourTier, &rate));
+    QCOMPARE(rate, Growth);
+    QCOMPARE(history.growthRate(Key), Growth);
+    QCOMPARE(history.timeToFull(Key, 0, 100 * 1024 * 1024), timeToFull);
+    QCOMPARE(history.samples(Key, LliurexUsageHistory::QuarterHourTier).size(), 25);
+}
+
+void LliurexUsageHistoryTest::shared()
+{
+    // two applets of the same user map the same file
+    LliurexUsageHistory first(fileName());
+    LliurexUsageHistory second(fileName());
+    poll(first, 60);
+
+    const QVector<LliurexUsageHistory::Sample> samples = second.samples(Key, LliurexUsageHistory::RecentTier);
+    QCOMPARE(samples.size(), 13);
+    QCOMPARE(samples.last().time, Start + 60 * 60);
+    QCOMPARE(samples.last().used, qint64(4 * 1024 * 1024));
+    QCOMPARE(second.growthRate(Key), first.growthRate(Key));
+}
+
+QTEST_GUILESS_MAIN(LliurexUsageHistoryTest)
+
+#include "LliurexUsageHistoryTest.moc"
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexProcessQuotaBackend.h"
+#include "LliurexQuotaMetrics.h"
+#include "LliurexToolLocator.h"
+#include "lliurexquota_debug.h"
+
+#include <QStringList>
+#include <QTimer>
+
+namespace {
+    // a run taking longer than this is considered hung
+    const int PollDeadline = 20 * 1000;
+    // time the tool gets to exit after SIGTERM, before SIGKILL
+    const int TerminateGrace = 3 * 1000;
+}
+
+LliurexProcessQuotaBackend::LliurexProcessQuotaBackend(LliurexToolLocator *locator, QObject *parent)
+    : LliurexQuotaBackend(parent)
+    , m_process(new QProcess(this))
+    , m_deadline(new QTimer(this))
+    , m_pollDeadline(PollDeadline)
+    , m_terminateGrace(TerminateGrace)
+    , m_locator(locator)
+    , m_program(program())
+{
+    m_deadline->setSingleShot(true);
+    connect(m_deadline, &QTimer::timeout, this, &LliurexProcessQuotaBackend::deadlineExpired);
+
+    // only stdout is of interest, do not let stderr pile up in memory
+    m_process->setStandardErrorFile(QProcess::nullDevice());
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &LliurexProcessQuotaBackend::readOutput);
+    connect(m_process, (void (QProcess::*)(int, QProcess::ExitStatus))&QProcess::finished,
+            this, &LliurexProcessQuotaBackend::processFinished);
+    connect(m_process, &QProcess::errorOccurred, this, &LliurexProcessQuotaBackend::processError);
+}
+
+QString LliurexProcessQuotaBackend::name() const
+{
+    return QStringLiteral("process");
+}
+
+QString LliurexProcessQuotaBackend::program()
+{
+    const QString tool = QString::fromLocal8Bit(qgetenv("LLIUREX_QUOTA_TOOL"));
+    return tool.isEmpty() ? QStringLiteral("lliurex-quota") : tool;
+}
+
+void LliurexProcessQuotaBackend::setDeadline(int deadline, int terminateGrace)
+{
+    m_pollDeadline = deadline;
+    m_terminateGrace = terminateGrace;
+}
+
+bool LliurexProcessQuotaBackend::isAvailable() const
+{
+    return m_locator->isInstalled(m_program);
+}
+
+void LliurexProcessQuotaBackend::forgetLastResult()
+{
+    m_hasLastFingerprint = false;
+}
+
+void LliurexProcessQuotaBackend::requestQuota()
+{
+    // a run in time will deliver fresh data anyway; restarting a hung tool
+    // would only send another request to a server that is not answering
+    if (m_process->state() != QProcess::NotRunning) {
+        if (m_terminating) {
+            // still not gone after SIGKILL, e.g. stuck in the kernel on NFS
+            emit quotaFailed(QStringLiteral("lliurex-quota cannot be stopped"));
+        }
+        return;
+    }
+
+    m_parser.reset();
+    m_terminating = false;
+    m_parseTime = 0;
+    m_outputSize = 0;
+    m_runTimer.start();
+
+    const QStringList args{
+        QStringLiteral("-mq"),
+    };
+    m_process->start(m_locator->path(m_program), args, QIODevice::ReadOnly);
+    m_deadline->start(m_pollDeadline);
+}
+
+void LliurexProcessQuotaBackend::processError(QProcess::ProcessError error)
+{
+    // all other errors are followed by finished()
+    if (error == QProcess::FailedToStart) {
+        m_deadline->stop();
+        m_hasLastFingerprint = false;
+        emit quotaFailed(QStringLiteral("lliurex-quota failed to start"));
+    }
+}
+
+void LliurexProcessQuotaBackend::deadlineExpired()
+{
+    if (m_process->state() == QProcess::NotRunning) {
+        return;
+    }
+
+    if (!m_terminating) {
+        qCWarning(LLIUREXQUOTA) << m_program << "did not finish in time, terminating it";
+        m_terminating = true;
+        m_process->terminate();
+        m_deadline->start(m_terminateGrace);
+    } else {
+        m_process->kill();
+    }
+}
+
+void LliurexProcessQuotaBackend::readOutput()
+{
+    // consume the output in small chunks instead of collecting all of it
+    char buffer[4096];
+    qint64 size;
+    while ((size = m_process->read(buffer, sizeof(buffer))) > 0) {
+        QElapsedTimer timer;
+        timer.start();
+        m_parser.feed(buffer, int(size));
+        m_parseTime += timer.nsecsElapsed();
+        m_outputSize += size;
+    }
+}
+
+void LliurexProcessQuotaBackend::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    m_deadline->stop();
+
+    LliurexQuotaMetrics &metrics = LliurexQuotaMetrics::instance();
+    metrics.record(LliurexQuotaMetrics::ProcessRuntime, quint64(m_runTimer.nsecsElapsed() / 1000));
+
+    if (m_terminating) {
+        m_hasLastFingerprint = false;
+        metrics.add(LliurexQuotaMetrics::Timeouts);
+        emit quotaFailed(QStringLiteral("lliurex-quota timed out"));
+        return;
+    }
+    if (exitStatus != QProcess::NormalExit) {
+        m_hasLastFingerprint = false;
+        metrics.add(LliurexQuotaMetrics::Crashes);
+        emit quotaFailed(QStringLiteral("lliurex-quota crashed"));
+        return;
+    }
+    if (exitCode != 0) {
+        m_hasLastFingerprint = false;
+        metrics.add(LliurexQuotaMetrics::NonZeroExits);
+        emit quotaFailed(QStringLiteral("lliurex-quota exited with code %1").arg(exitCode));
+        return;
+    }
+
+    readOutput();
+    QElapsedTimer timer;
+    timer.start();
+    m_parser.finish();
+    m_parseTime += timer.nsecsElapsed();
+
+    metrics.record(LliurexQuotaMetrics::StdoutBytes, m_outputSize);
+    metrics.record(LliurexQuotaMetrics::ParseTime, quint64(m_parseTime / 1000));
+    if (m_parser.rejectedLines() > 0) {
+        metrics.add(LliurexQuotaMetrics::ParseRejects, quint64(m_parser.rejectedLines()));
+        qCDebug(LLIUREXQUOTA) << m_parser.rejectedLines() << "lines of lliurex-quota output rejected";
+    }
+
+    const quint64 fingerprint = m_parser.fingerprint();
+    if (m_hasLastFingerprint && fingerprint == m_lastFingerprint) {
+        emit quotaUnchanged();
+        return;
+    }
+    m_lastFingerprint = fingerprint;
+    m_hasLastFingerprint = true;
+
+    emit quotaReady(m_parser.entries());
+}
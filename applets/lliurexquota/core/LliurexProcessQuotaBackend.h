@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_PROCESS_QUOTA_BACKEND_H
+#define PLASMA_LLIUREX_PROCESS_QUOTA_BACKEND_H
+
+#include "LliurexQuotaBackend.h"
+#include "LliurexQuotaLineParser.h"
+
+#include <QElapsedTimer>
+#include <QProcess>
+
+class QTimer;
+class LliurexToolLocator;
+
+/**
+ * Quota backend running the 'lliurex-quota' command line tool.
+ * Each query spawns one process; its output is parsed incrementally while
+ * it arrives, the lines 'True,<group>,<used KiB>,<limit KiB>' are turned
+ * into entries. If the output is byte-identical to the previous one,
+ * quotaUnchanged() is emitted instead of quotaReady().
+ *
+ * A run that does not finish within a deadline, e.g. because the tool
+ * hangs on an unreachable server, is sent SIGTERM, then SIGKILL, and
+ * reported as failed. The tool can be replaced for testing by setting
+ * LLIUREX_QUOTA_TOOL to the path of another program.
+ */
+class LliurexProcessQuotaBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    /**
+     * The tool is looked up through @p locator, which must know program().
+     */
+    LliurexProcessQuotaBackend(LliurexToolLocator *locator, QObject *parent = nullptr);
+
+    QString name() const override;
+    bool isAvailable() const override;
+    void requestQuota() override;
+    void forgetLastResult() override;
+
+    /**
+     * The tool run: LLIUREX_QUOTA_TOOL if set, otherwise 'lliurex-quota'.
+     */
+    static QString program();
+
+    /**
+     * Milliseconds a run may take before it is sent SIGTERM, and the time
+     * it then gets to exit before SIGKILL.
+     */
+    void setDeadline(int deadline, int terminateGrace);
+
+private Q_SLOTS:
+    void readOutput();
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void processError(QProcess::ProcessError error);
+    void deadlineExpired();
+
+private:
+    QProcess *m_process = nullptr;
+    QTimer *m_deadline = nullptr;
+    int m_pollDeadline;
+    int m_terminateGrace;
+    LliurexToolLocator *m_locator = nullptr;
+    QString m_program;
+    bool m_terminating = false;
+    QElapsedTimer m_runTimer;
+    qint64 m_parseTime = 0;       // nanoseconds spent parsing this run
+    quint64 m_outputSize = 0;
+    LliurexQuotaLineParser m_parser;
+    quint64 m_lastFingerprint = 0;
+    bool m_hasLastFingerprint = false;
+};
+
+#endif // PLASMA_LLIUREX_PROCESS_QUOTA_BACKEND_H
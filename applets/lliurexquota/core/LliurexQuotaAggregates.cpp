@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaAggregates.h"
+
+#include <algorithm>
+
+namespace {
+    bool isOverSoftLimit(qint64 used, qint64 softLimit)
+    {
+        return softLimit > 0 && used > softLimit;
+    }
+
+    bool isOverHardLimit(qint64 used, qint64 hardLimit)
+    {
+        return hardLimit > 0 && used >= hardLimit;
+    }
+}
+
+LliurexQuotaAggregates::LliurexQuotaAggregates()
+    : m_usageHistogram(101, 0)
+{
+}
+
+void LliurexQuotaAggregates::clear()
+{
+    m_keys.clear();
+    m_used.clear();
+    m_softLimit.clear();
+    m_hardLimit.clear();
+    m_graceTime.clear();
+    m_usage.clear();
+    m_group.clear();
+    m_seen.clear();
+    m_rows.clear();
+    m_groups.clear();
+
+    m_usageHistogram.fill(0);
+    m_overSoftLimit = 0;
+    m_overHardLimit = 0;
+    m_graceEnds.clear();
+    m_groupTotals.clear();
+}
+
+void LliurexQuotaAggregates::apply(const QVector<LliurexQuotaEntry> &entries)
+{
+    ++m_generation;
+
+    for (const LliurexQuotaEntry &entry : entries) {
+        const QString key = entry.key();
+        auto it = m_rows.constFind(key);
+        if (it == m_rows.constEnd()) {
+            const int row = m_keys.size();
+            m_keys.append(key);
+            m_used.append(0);
+            m_softLimit.append(0);
+            m_hardLimit.append(0);
+            m_graceTime.append(0);
+            m_usage.append(0);
+            m_group.append(0);
+            m_seen.append(m_generation);
+            m_rows.insert(key, row);
+            write(row, entry);
+            account(row, 1);
+            continue;
+        }
+
+        const int row = it.value();
+        m_seen[row] = m_generation;
+        if (sameSample(row, entry)) {
+            continue;
+        }
+        account(row, -1);
+        write(row, entry);
+        account(row, 1);
+    }
+
+    // from the back, so that the row moved into a gap was already seen
+    for (int row = m_keys.size() - 1; row >= 0; --row) {
+        if (m_seen[row] != m_generation) {
+            account(row, -1);
+            removeRow(row);
+        }
+    }
+}
+
+int LliurexQuotaAggregates::groupIndex(const QString &group)
+{
+    auto it = m_groups.constFind(group);
+    if (it != m_groups.constEnd()) {
+        return it.value();
+    }
+
+    // groups are never removed, a group without quotas left has zero totals
+    const int index = m_groupTotals.size();
+    GroupTotals totals;
+    totals.group = group;
+    m_groupTotals.append(totals);
+    m_groups.insert(group, index);
+    return index;
+}
+
+void LliurexQuotaAggregates::write(int row, const LliurexQuotaEntry &entry)
+{
+    m_used[row] = entry.used;
+    m_softLimit[row] = entry.softLimit;
+    m_hardLimit[row] = entry.hardLimit;
+    m_graceTime[row] = entry.graceTime;
+    m_usage[row] = quint8(entry.usage());
+    m_group[row] = groupIndex(entry.group);
+}
+
+bool LliurexQuotaAggregates::sameSample(int row, const LliurexQuotaEntry &entry) const
+{
+    return m_used[row] == entry.used
+        && m_softLimit[row] == entry.softLimit
+        && m_hardLimit[row] == entry.hardLimit
+        && m_graceTime[row] == entry.graceTime
+        && m_groupTotals[m_group[row]].group == entry.group;
+}
+
+void LliurexQuotaAggregates::account(int row, int sign)
+{
+    const qint64 used = m_used[row];
+    const qint64 softLimit = m_softLimit[row];
+    const qint64 hardLimit = m_hardLimit[row];
+
+    m_usageHistogram[m_usage[row]] += sign;
+
+    const bool overSoft = isOverSoftLimit(used, softLimit);
+    if (overSoft) {
+        m_overSoftLimit += sign;
+        const qint64 graceTime = m_graceTime[row];
+        if (graceTime > 0) {
+            int &count = m_graceEnds[graceTime];
+            count += sign;
+            if (count == 0) {
+                m_graceEnds.remove(graceTime);
+            }
+        }
+    }
+    if (isOverHardLimit(used, hardLimit)) {
+        m_overHardLimit += sign;
+    }
+
+    GroupTotals &totals = m_groupTotals[m_group[row]];
+    totals.quotas += sign;
+    totals.used += sign * used;
+    totals.limit += sign * (hardLimit > 0 ? hardLimit : softLimit);
+    if (overSoft) {
+        totals.overSoftLimit += sign;
+    }
+}
+
+void LliurexQuotaAggregates::removeRow(int row)
+{
+    // move the last row into the gap, the order of the rows does not matter
+    const int last = m_keys.size() - 1;
+    m_rows.remove(m_keys[row]);
+    if (row != last) {
+        m_keys[row] = m_keys[last];
+        m_used[row] = m_used[last];
+        m_softLimit[row] = m_softLimit[last];
+        m_hardLimit[row] = m_hardLimit[last];
+        m_graceTime[row] = m_graceTime[last];
+        m_usage[row] = m_usage[last];
+        m_group[row] = m_group[last];
+        m_seen[row] = m_seen[last];
+        m_rows[m_keys[row]] = row;
+    }
+
+    m_keys.removeLast();
+    m_used.removeLast();
+    m_softLimit.removeLast();
+    m_hardLimit.removeLast();
+    m_graceTime.removeLast();
+    m_usage.removeLast();
+    m_group.removeLast();
+    m_seen.removeLast();
+}
+
+int LliurexQuotaAggregates::count() const
+{
+    return m_keys.size();
+}
+
+int LliurexQuotaAggregates::usagePercentile(int percent) const
+{
+    const int total = m_keys.size();
+    if (total == 0) {
+        return 0;
+    }
+
+    // the rank of the percentile, at least the first quota
+    const qint64 rank = qMax<qint64>(1, (qint64(total) * qBound(0, percent, 100) + 99) / 100);
+    qint64 seen = 0;
+    for (int usage = 0; usage < m_usageHistogram.size(); ++usage) {
+        seen += m_usageHistogram[usage];
+        if (seen >= rank) {
+            return usage;
+        }
+    }
+    return 100;
+}
+
+int LliurexQuotaAggregates::overSoftLimit() const
+{
+    return m_overSoftLimit;
+}
+
+int LliurexQuotaAggregates::overHardLimit() const
+{
+    return m_overHardLimit;
+}
+
+int LliurexQuotaAggregates::inGrace(qint64 now) const
+{
+    // few quotas are over their soft limit at a time
+    int count = 0;
+    for (auto it = m_graceEnds.upperBound(now); it != m_graceEnds.constEnd(); ++it) {
+        count += it.value();
+    }
+    return count;
+}
+
+QVector<LliurexQuotaAggregates::GroupTotals> LliurexQuotaAggregates::groupTotals() const
+{
+    QVector<GroupTotals> totals;
+    totals.reserve(m_groupTotals.size());
+    for (const GroupTotals &group : m_groupTotals) {
+        if (group.quotas > 0) {
+            totals.append(group);
+        }
+    }
+    std::sort(totals.begin(), totals.end(), [](const GroupTotals &a, const GroupTotals &b) {
+        return a.used > b.used;
+    });
+    return totals;
+}
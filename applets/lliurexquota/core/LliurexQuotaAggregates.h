@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_AGGREGATES_H
+#define PLASMA_LLIUREX_QUOTA_AGGREGATES_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * Fleet-wide numbers over the quotas of all users: the distribution of
+ * the usage, how many are over their soft limit, at their hard limit or
+ * in their grace period, and totals per group (LliurexQuotaEntry::group).
+ *
+ * The samples are stored column by column, one array per field, and the
+ * aggregates are kept up to date from the difference between two data
+ * sets: apply() only subtracts and adds again the rows whose numbers
+ * changed, so a refresh of tens of thousands of users where a few
+ * hundred wrote something costs a hash lookup per user and nothing more.
+ * The usage is counted in a histogram of whole percents, which answers
+ * any percentile without sorting.
+ */
+class LliurexQuotaAggregates
+{
+public:
+    /**
+     * Sums over the quotas of one group.
+     */
+    struct GroupTotals {
+        QString group;
+        qint64 quotas = 0;
+        qint64 used = 0;
+        qint64 limit = 0;
+        qint64 overSoftLimit = 0;
+    };
+
+    LliurexQuotaAggregates();
+
+    /**
+     * Replaces the samples with @p entries.
+     */
+    void apply(const QVector<LliurexQuotaEntry> &entries);
+
+    void clear();
+
+    /**
+     * Number of quotas.
+     */
+    int count() const;
+
+    /**
+     * Smallest usage in percent that @p percent percent of the quotas do
+     * not exceed; 0 without quotas.
+     */
+    int usagePercentile(int percent) const;
+
+    int overSoftLimit() const;
+
+    /**
+     * Quotas that used up their hard limit.
+     */
+    int overHardLimit() const;
+
+    /**
+     * Quotas over their soft limit whose grace period still runs at
+     * @p now, in epoch seconds. The periods run out without the data
+     * changing, so this is counted when asked.
+     */
+    int inGrace(qint64 now) const;
+
+    /**
+     * Totals of all groups, largest usage first.
+     */
+    QVector<GroupTotals> groupTotals() const;
+
+private:
+    int groupIndex(const QString &group);
+    void write(int row, const LliurexQuotaEntry &entry);
+    bool sameSample(int row, const LliurexQuotaEntry &entry) const;
+    void account(int row, int sign);
+    void removeRow(int row);
+
+    // the samples, one column per field
+    QVector<QString> m_keys;
+    QVector<qint64> m_used;
+    QVector<qint64> m_softLimit;
+    QVector<qint64> m_hardLimit;
+    QVector<qint64> m_graceTime;
+    QVector<quint8> m_usage;
+    QVector<int> m_group;           // index into m_groupTotals
+    QVector<quint32> m_seen;        // generation of the last apply() that had the row
+
+    QHash<QString, int> m_rows;     // LliurexQuotaEntry::key() -> row
+    QHash<QString, int> m_groups;   // group -> index into m_groupTotals
+    quint32 m_generation = 0;
+
+    // the aggregates
+    QVector<int> m_usageHistogram;  // quotas per whole percent, 0 to 100
+    int m_overSoftLimit = 0;
+    int m_overHardLimit = 0;
+    QMap<qint64, int> m_graceEnds;  // end of grace -> quotas over the soft limit
+    QVector<GroupTotals> m_groupTotals;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_AGGREGATES_H
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaBackend.h"
+
+LliurexQuotaBackend::LliurexQuotaBackend(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<LliurexQuotaEntry>();
+    qRegisterMetaType<QVector<LliurexQuotaEntry>>();
+}
+
+LliurexQuotaBackend::~LliurexQuotaBackend()
+{
+}
+
+bool LliurexQuotaBackend::pushesUpdates() const
+{
+    return false;
+}
+
+void LliurexQuotaBackend::forgetLastResult()
+{
+}
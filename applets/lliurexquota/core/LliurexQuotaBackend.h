@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_BACKEND_H
+#define PLASMA_LLIUREX_QUOTA_BACKEND_H
+
+#include <QObject>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * Interface of a source of quota information.
+ * A backend is asked for data through requestQuota() and answers
+ * asynchronously with either quotaReady() or quotaFailed().
+ */
+class LliurexQuotaBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    LliurexQuotaBackend(QObject *parent = nullptr);
+    ~LliurexQuotaBackend() override;
+
+    /**
+     * Short name of the backend, e.g. "quotactl" or "process".
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * Returns true if this backend is able to deliver quota data on this host.
+     */
+    virtual bool isAvailable() const = 0;
+
+    /**
+     * Starts an asynchronous quota query, answered by quotaReady(),
+     * quotaUnchanged() or quotaFailed(). If a query is still running, the
+     * request joins it and its answer serves both; a backend for which it
+     * is cheap may abort the running query and start over instead. A query
+     * hung past its deadline is answered with quotaFailed(), and so is
+     * every request while it still runs.
+     */
+    virtual void requestQuota() = 0;
+
+    /**
+     * Returns true if the backend emits quotaReady() by itself whenever the
+     * quota changes, so that polling is only needed as a safety net.
+     * The default implementation returns false.
+     */
+    virtual bool pushesUpdates() const;
+
+    /**
+     * Forgets the previous result, so that the next query emits quotaReady()
+     * even if nothing changed. The default implementation does nothing.
+     */
+    virtual void forgetLastResult();
+
+Q_SIGNALS:
+    /**
+     * Emitted when a query finished. @p entries holds all quotas found,
+     * an empty list means there are no quota restrictions.
+     */
+    void quotaReady(const QVector<LliurexQuotaEntry> &entries);
+
+    /**
+     * Emitted instead of quotaReady() when a query finished with exactly
+     * the same data as the previous successful one.
+     */
+    void quotaUnchanged();
+
+    /**
+     * Emitted when a query could not be completed.
+     */
+    void quotaFailed(const QString &reason);
+
+    /**
+     * Emitted when the return value of pushesUpdates() changed.
+     */
+    void pushesUpdatesChanged();
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_BACKEND_H
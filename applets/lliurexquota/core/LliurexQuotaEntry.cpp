@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaEntry.h"
+
+LliurexQuotaEntry::LliurexQuotaEntry()
+    : type(UserQuota)
+    , id(0)
+    , used(0)
+    , softLimit(0)
+    , hardLimit(0)
+    , inodesUsed(0)
+    , inodeSoftLimit(0)
+    , inodeHardLimit(0)
+    , graceTime(0)
+{
+}
+
+QString LliurexQuotaEntry::key() const
+{
+    return QStringLiteral("%1:%2:%3").arg(type == GroupQuota ? QLatin1Char('g') : QLatin1Char('u'))
+                                    .arg(name.isEmpty() ? QString::number(id) : name)
+                                    .arg(mountPoint);
+}
+
+qint64 LliurexQuotaEntry::limit() const
+{
+    return hardLimit > 0 ? hardLimit : softLimit;
+}
+
+qint64 LliurexQuotaEntry::freeSize() const
+{
+    return qMax(qint64(0), limit() - used);
+}
+
+int LliurexQuotaEntry::usage() const
+{
+    const qint64 max = limit();
+    if (max <= 0) {
+        return 0;
+    }
+    return qMin(100, qMax(0, qRound(used * 100.0 / max)));
+}
+
+bool LliurexQuotaEntry::operator==(const LliurexQuotaEntry &other) const
+{
+    return type == other.type
+        && id == other.id
+        && name == other.name
+        && mountPoint == other.mountPoint
+        && group == other.group
+        && used == other.used
+        && softLimit == other.softLimit
+        && hardLimit == other.hardLimit
+        && inodesUsed == other.inodesUsed
+        && inodeSoftLimit == other.inodeSoftLimit
+        && inodeHardLimit == other.inodeHardLimit
+        && graceTime == other.graceTime;
+}
+
+bool LliurexQuotaEntry::operator!=(const LliurexQuotaEntry &other) const
+{
+    return ! (*this == other);
+}
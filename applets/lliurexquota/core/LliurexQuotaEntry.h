@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_ENTRY_H
+#define PLASMA_LLIUREX_QUOTA_ENTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QMetaType>
+
+/**
+ * Raw quota numbers of one user or group quota on one file system, as
+ * delivered by a LliurexQuotaBackend. All sizes are in bytes.
+ */
+class LliurexQuotaEntry
+{
+public:
+    enum Type {
+        UserQuota = 0,
+        GroupQuota
+    };
+
+    LliurexQuotaEntry();
+
+    /**
+     * Unique identifier of this quota, built from type, id and mount point.
+     */
+    QString key() const;
+
+    /**
+     * Limit the usage is measured against: the hard limit if set,
+     * otherwise the soft limit. 0 means unlimited.
+     */
+    qint64 limit() const;
+
+    /**
+     * Free bytes until limit() is reached, never negative.
+     */
+    qint64 freeSize() const;
+
+    /**
+     * Usage in percent of limit(), clamped to [0, 100].
+     */
+    int usage() const;
+
+    bool operator==(const LliurexQuotaEntry &other) const;
+    bool operator!=(const LliurexQuotaEntry &other) const;
+
+public:
+    Type type;
+    uint id;                // uid or gid
+    QString name;           // user or group name, may be empty
+    QString mountPoint;     // empty if the source does not report it
+    QString group;          // group the quota counts towards: the group of a group quota,
+                            // the primary group of the user of a user quota; may be empty
+    qint64 used;
+    qint64 softLimit;
+    qint64 hardLimit;
+    qint64 inodesUsed;
+    qint64 inodeSoftLimit;
+    qint64 inodeHardLimit;
+    qint64 graceTime;       // end of the block grace period (epoch seconds), 0 if not running
+};
+
+Q_DECLARE_METATYPE(LliurexQuotaEntry)
+Q_DECLARE_METATYPE(QVector<LliurexQuotaEntry>)
+
+#endif // PLASMA_LLIUREX_QUOTA_ENTRY_H
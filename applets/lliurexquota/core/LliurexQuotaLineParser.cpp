@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaLineParser.h"
+
+#include <cstring>
+#include <limits>
+
+namespace {
+    // longer lines cannot be quota records and are dropped unbuffered
+    const int MaxLineLength = 4096;
+
+    const quint64 FnvOffsetBasis = 14695981039346656037ULL;
+    const quint64 FnvPrime = 1099511628211ULL;
+
+    inline bool isLineEnd(char c)
+    {
+        return c == '\n' || c == '\r';
+    }
+
+    /**
+     * Parses a decimal number, 0 if [begin, end) is not a number.
+     */
+    qint64 parseNumber(const char *begin, const char *end)
+    {
+        while (begin < end && (*begin == ' ' || *begin == '\t')) {
+            ++begin;
+        }
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) {
+            --end;
+        }
+
+        bool negative = false;
+        if (begin < end && (*begin == '-' || *begin == '+')) {
+            negative = *begin == '-';
+            ++begin;
+        }
+        if (begin == end) {
+            return 0;
+        }
+
+        qint64 value = 0;
+        for (; begin < end; ++begin) {
+            if (*begin < '0' || *begin > '9' || value > (std::numeric_limits<qint64>::max() - 9) / 10) {
+                return 0;
+            }
+            value = value * 10 + (*begin - '0');
+        }
+        return negative ? -value : value;
+    }
+}
+
+LliurexQuotaLineParser::LliurexQuotaLineParser()
+{
+    reset();
+}
+
+void LliurexQuotaLineParser::reset()
+{
+    m_partialLine.clear();
+    m_skipPartialLine = false;
+    m_entries.clear();
+    m_rejectedLines = 0;
+    m_fingerprint = FnvOffsetBasis;
+    m_size = 0;
+}
+
+void LliurexQuotaLineParser::feed(const char *data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        m_fingerprint = (m_fingerprint ^ quint8(data[i])) * FnvPrime;
+    }
+    m_size += size;
+
+    const char *begin = data;
+    const char *const end = data + size;
+    while (begin < end) {
+        const char *lineEnd = begin;
+        while (lineEnd < end && !isLineEnd(*lineEnd)) {
+            ++lineEnd;
+        }
+
+        if (lineEnd == end) {
+            // incomplete line: keep it until the rest arrives
+            if (!m_skipPartialLine) {
+                if (m_partialLine.size() + (end - begin) > MaxLineLength) {
+                    m_partialLine.clear();
+                    m_skipPartialLine = true;
+                } else {
+                    m_partialLine.append(begin, int(end - begin));
+                }
+            }
+            break;
+        }
+
+        if (m_skipPartialLine) {
+            m_skipPartialLine = false;
+            ++m_rejectedLines;
+        } else if (!m_partialLine.isEmpty()) {
+            m_partialLine.append(begin, int(lineEnd - begin));
+            parseLine(m_partialLine.constData(), m_partialLine.constData() + m_partialLine.size());
+            m_partialLine.clear();
+        } else {
+            parseLine(begin, lineEnd);
+        }
+
+        begin = lineEnd + 1;
+    }
+}
+
+void LliurexQuotaLineParser::finish()
+{
+    if (m_skipPartialLine) {
+        ++m_rejectedLines;
+    } else if (!m_partialLine.isEmpty()) {
+        parseLine(m_partialLine.constData(), m_partialLine.constData() + m_partialLine.size());
+    }
+    m_partialLine.clear();
+    m_skipPartialLine = false;
+}
+
+const QVector<LliurexQuotaEntry> &LliurexQuotaLineParser::entries() const
+{
+    return m_entries;
+}
+
+int LliurexQuotaLineParser::rejectedLines() const
+{
+    return m_rejectedLines;
+}
+
+quint64 LliurexQuotaLineParser::fingerprint() const
+{
+    return m_fingerprint ^ (quint64(m_size) * 0x9e3779b97f4a7c15ULL);
+}
+
+void LliurexQuotaLineParser::parseLine(const char *begin, const char *end)
+{
+    if (begin == end) {
+        return;
+    }
+
+    LliurexQuotaEntry entry;
+    if (parseLine(begin, end, &entry)) {
+        m_entries.append(entry);
+    } else {
+        ++m_rejectedLines;
+    }
+}
+
+bool LliurexQuotaLineParser::parseLine(const char *begin, const char *end, LliurexQuotaEntry *entry)
+{
+    // True,lliurex,182,0 // tokens: 0,1,2,3 -- empty tokens are skipped
+    const char *tokens[4];
+    const char *tokenEnds[4];
+    int count = 0;
+
+    const char *token = begin;
+    for (;;) {
+        const char *tokenEnd = static_cast<const char *>(memchr(token, ',', end - token));
+        if (!tokenEnd) {
+            tokenEnd = end;
+        }
+        if (tokenEnd > token) {
+            if (count == 4) {
+                return false;
+            }
+            tokens[count] = token;
+            tokenEnds[count] = tokenEnd;
+            ++count;
+        }
+        if (tokenEnd == end) {
+            break;
+        }
+        token = tokenEnd + 1;
+    }
+
+    if (count != 4 || tokenEnds[0] - tokens[0] != 4 || memcmp(tokens[0], "True", 4) != 0) {
+        return false;
+    }
+
+    // 'lliurex-quota' uses kilo bytes -> factor 1024
+    entry->type = LliurexQuotaEntry::GroupQuota;
+    entry->name = QString::fromLocal8Bit(tokens[1], int(tokenEnds[1] - tokens[1]));
+    entry->group = entry->name;
+    entry->used = parseNumber(tokens[2], tokenEnds[2]) * 1024;
+    entry->hardLimit = parseNumber(tokens[3], tokenEnds[3]) * 1024;
+    return true;
+}
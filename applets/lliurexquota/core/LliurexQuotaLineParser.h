@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_LINE_PARSER_H
+#define PLASMA_LLIUREX_QUOTA_LINE_PARSER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * Incremental parser for the output of 'lliurex-quota -mq'.
+ *
+ * The output is fed in chunks as it arrives; only an incomplete trailing
+ * line is buffered. Records of the form 'True,<group>,<used KiB>,<limit KiB>'
+ * are tokenized in place on the raw bytes. While parsing, a fingerprint of
+ * the raw output is computed, so that an output identical to the previous
+ * one can be detected without keeping it around.
+ */
+class LliurexQuotaLineParser
+{
+public:
+    LliurexQuotaLineParser();
+
+    /**
+     * Starts parsing a new output.
+     */
+    void reset();
+
+    /**
+     * Parses all complete lines in @p data and buffers the rest.
+     */
+    void feed(const char *data, int size);
+
+    /**
+     * Parses a pending unterminated last line. Call once the output ended.
+     */
+    void finish();
+
+    /**
+     * Entries parsed so far.
+     */
+    const QVector<LliurexQuotaEntry> &entries() const;
+
+    /**
+     * Number of non-empty lines that were not quota records.
+     */
+    int rejectedLines() const;
+
+    /**
+     * Fingerprint of all raw bytes fed since the last reset().
+     */
+    quint64 fingerprint() const;
+
+    /**
+     * Parses one line [@p begin, @p end) into @p entry.
+     * Returns false if the line is not a quota record.
+     */
+    static bool parseLine(const char *begin, const char *end, LliurexQuotaEntry *entry);
+
+private:
+    void parseLine(const char *begin, const char *end);
+
+    QByteArray m_partialLine;
+    bool m_skipPartialLine = false;
+    QVector<LliurexQuotaEntry> m_entries;
+    int m_rejectedLines = 0;
+    quint64 m_fingerprint = 0;
+    qint64 m_size = 0;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_LINE_PARSER_H
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaMetrics.h"
+#include "lliurexquota_debug.h"
+
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+#include <unistd.h>
+
+namespace {
+    const char *const HistogramNames[LliurexQuotaMetrics::HistogramCount] = {
+        "poll_latency_microseconds",
+        "process_runtime_microseconds",
+        "stdout_bytes",
+        "parse_time_microseconds",
+        "format_time_microseconds",
+        "model_update_time_microseconds"
+    };
+
+    const char *const CounterNames[LliurexQuotaMetrics::CounterCount] = {
+        "polls_total",
+        "failures_total",
+        "timeouts_total",
+        "nonzero_exits_total",
+        "crashes_total",
+        "parse_rejects_total",
+        "breaker_rejects_total",
+        "joined_polls_total"
+    };
+
+    /**
+     * Index of the smallest bucket bound 4^i >= @p value.
+     */
+    int bucketIndex(quint64 value)
+    {
+        if (value <= 1) {
+            return 0;
+        }
+        const int bits = 64 - qCountLeadingZeroBits(value - 1);
+        return qMin((bits + 1) / 2, int(LliurexQuotaMetrics::BucketCount));
+    }
+
+    quint64 bucketBound(int index)
+    {
+        return quint64(1) << (2 * index);
+    }
+}
+
+LliurexQuotaMetrics &LliurexQuotaMetrics::instance()
+{
+    static LliurexQuotaMetrics metrics;
+    return metrics;
+}
+
+LliurexQuotaMetrics::LliurexQuotaMetrics()
+{
+    for (HistogramData &histogram : m_histograms) {
+        for (std::atomic<quint64> &bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.sum.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<quint64> &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LliurexQuotaMetrics::record(Histogram histogram, quint64 value)
+{
+    HistogramData &data = m_histograms[histogram];
+    data.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void LliurexQuotaMetrics::add(Counter counter, quint64 value)
+{
+    m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+QVariantMap LliurexQuotaMetrics::snapshot() const
+{
+    QVariantMap result;
+    for (int i = 0; i < CounterCount; ++i) {
+        result.insert(QLatin1String(CounterNames[i]), m_counters[i].load(std::memory_order_relaxed));
+    }
+
+    for (int i = 0; i < HistogramCount; ++i) {
+        const HistogramData &data = m_histograms[i];
+        QVariantMap buckets;
+        for (int b = 0; b <= BucketCount; ++b) {
+            const QString bound = b < BucketCount ? QString::number(bucketBound(b)) : QStringLiteral("+Inf");
+            buckets.insert(bound, data.buckets[b].load(std::memory_order_relaxed));
+        }
+
+        QVariantMap histogram;
+        histogram.insert(QStringLiteral("count"), data.count.load(std::memory_order_relaxed));
+        histogram.insert(QStringLiteral("sum"), data.sum.load(std::memory_order_relaxed));
+        histogram.insert(QStringLiteral("buckets"), buckets);
+        result.insert(QLatin1String(HistogramNames[i]), histogram);
+    }
+    return result;
+}
+
+QByteArray LliurexQuotaMetrics::prometheusText() const
+{
+    // every applet process writes its own file, the uid tells them apart
+    const QByteArray labels = "uid=\"" + QByteArray::number(getuid()) + '"';
+
+    QByteArray text;
+    for (int i = 0; i < CounterCount; ++i) {
+        const QByteArray name = QByteArray("lliurexquota_") + CounterNames[i];
+        text += "# TYPE " + name + " counter\n";
+        text += name + '{' + labels + "} " + QByteArray::number(m_counters[i].load(std::memory_order_relaxed)) + '\n';
+    }
+
+    for (int i = 0; i < HistogramCount; ++i) {
+        const HistogramData &data = m_histograms[i];
+        const QByteArray name = QByteArray("lliurexquota_") + HistogramNames[i];
+        text += "# TYPE " + name + " histogram\n";
+
+        // buckets and count are read one by one, so make them agree here
+        quint64 cumulative = 0;
+        for (int b = 0; b <= BucketCount; ++b) {
+            cumulative += data.buckets[b].load(std::memory_order_relaxed);
+            const QByteArray bound = b < BucketCount ? QByteArray::number(bucketBound(b)) : QByteArray("+Inf");
+            text += name + "_bucket{" + labels + ",le=\"" + bound + "\"} " + QByteArray::number(cumulative) + '\n';
+        }
+        text += name + "_sum{" + labels + "} " + QByteArray::number(data.sum.load(std::memory_order_relaxed)) + '\n';
+        text += name + "_count{" + labels + "} " + QByteArray::number(cumulative) + '\n';
+    }
+    return text;
+}
+
+void LliurexQuotaMetrics::writeTextfile() const
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("LLIUREX_QUOTA_METRICS_TEXTFILE"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    // the collector must never see a half written file
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(prometheusText()) < 0 || !file.commit()) {
+        qCWarning(LLIUREXQUOTA) << "Cannot write metrics to" << fileName << file.errorString();
+    }
+}
+
+LliurexMetricsSpan::LliurexMetricsSpan(LliurexQuotaMetrics::Histogram histogram)
+    : m_histogram(histogram)
+{
+    m_timer.start();
+}
+
+LliurexMetricsSpan::~LliurexMetricsSpan()
+{
+    stop();
+}
+
+void LliurexMetricsSpan::stop()
+{
+    if (m_timer.isValid()) {
+        LliurexQuotaMetrics::instance().record(m_histogram, quint64(m_timer.nsecsElapsed() / 1000));
+        m_timer.invalidate();
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_METRICS_H
+#define PLASMA_LLIUREX_QUOTA_METRICS_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVariantMap>
+
+#include <atomic>
+
+/**
+ * Process wide metrics of the poll cycle: histograms of the time spent in
+ * each stage, and counters of the things that went wrong.
+ *
+ * Recording is lock-free, every bucket and counter is a relaxed atomic,
+ * so the worker threads of the backends can record as well. Histogram
+ * buckets grow by a factor of 4, from 1 up to 4^15; durations are
+ * recorded in microseconds, sizes in bytes.
+ *
+ * The metrics can be read with snapshot(), over D-Bus (see
+ * LliurexQuotaMetricsAdaptor in the applet), and are written as a
+ * Prometheus textfile to the path in LLIUREX_QUOTA_METRICS_TEXTFILE, if set.
+ */
+class LliurexQuotaMetrics
+{
+public:
+    enum Histogram {
+        PollLatency = 0,    // request to answer, as seen by the applet
+        ProcessRuntime,     // lliurex-quota spawn to exit
+        StdoutBytes,        // output of one lliurex-quota run
+        ParseTime,          // time spent in the line parser for one run
+        FormatTime,         // entries to rows and changes, in the pipeline thread
+        ModelUpdateTime,    // LliurexQuotaListModel::applyChanges()
+        HistogramCount
+    };
+
+    enum Counter {
+        Polls = 0,
+        Failures,
+        Timeouts,
+        NonZeroExits,
+        Crashes,
+        ParseRejects,
+        BreakerRejects,
+        JoinedPolls,        // requests answered by an outstanding poll
+        CounterCount
+    };
+
+    static LliurexQuotaMetrics &instance();
+
+    void record(Histogram histogram, quint64 value);
+    void add(Counter counter, quint64 value = 1);
+
+    /**
+     * All metrics by name: counters as numbers, histograms as maps with
+     * 'count', 'sum' and 'buckets' (the upper bounds mapped to the
+     * non-cumulative counts).
+     */
+    QVariantMap snapshot() const;
+
+    /**
+     * The metrics in the Prometheus text exposition format.
+     */
+    QByteArray prometheusText() const;
+
+    /**
+     * Atomically replaces the textfile named by LLIUREX_QUOTA_METRICS_TEXTFILE.
+     * Does nothing if the variable is not set.
+     */
+    void writeTextfile() const;
+
+    static const int BucketCount = 16;
+
+private:
+    LliurexQuotaMetrics();
+
+    struct HistogramData {
+        std::atomic<quint64> buckets[BucketCount + 1];  // the last one is +Inf
+        std::atomic<quint64> count;
+        std::atomic<quint64> sum;
+    };
+
+    HistogramData m_histograms[HistogramCount];
+    std::atomic<quint64> m_counters[CounterCount];
+};
+
+/**
+ * Records the monotonic time from its construction to its destruction
+ * (or to stop()) in a histogram, in microseconds.
+ */
+class LliurexMetricsSpan
+{
+public:
+    explicit LliurexMetricsSpan(LliurexQuotaMetrics::Histogram histogram);
+    ~LliurexMetricsSpan();
+
+    void stop();
+
+private:
+    QElapsedTimer m_timer;
+    LliurexQuotaMetrics::Histogram m_histogram;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_METRICS_H
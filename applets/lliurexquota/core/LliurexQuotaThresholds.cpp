@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaThresholds.h"
+
+LliurexQuotaThresholds::Level LliurexQuotaThresholds::level(int usage)
+{
+    if (usage < 50) {
+        return NormalLevel;
+    } else if (usage < 90) {
+        return HighLevel;
+    }
+    return CriticalLevel;
+}
+
+int LliurexQuotaThresholds::forecastUsage(qint64 timeToFull)
+{
+    if (timeToFull >= 0 && timeToFull < CriticalForecast) {
+        return 90;
+    } else if (timeToFull >= 0 && timeToFull < HighForecast) {
+        return 75;
+    }
+    return 0;
+}
+
+int LliurexQuotaThresholds::maximumUsage(const QVector<LliurexQuotaEntry> &entries)
+{
+    int maxQuota = 0;
+    for (const LliurexQuotaEntry &entry : entries) {
+        maxQuota = qMax(maxQuota, entry.usage());
+    }
+
+    // make sure max quota is 100. Could be more, due to the
+    // hard limit > soft limit, and we take soft limit as 100%
+    return qMin(100, maxQuota);
+}
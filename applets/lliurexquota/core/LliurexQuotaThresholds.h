@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_THRESHOLDS_H
+#define PLASMA_LLIUREX_QUOTA_THRESHOLDS_H
+
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * The limits at which a quota is worth the user's attention, shared by
+ * the applet and headless tools such as lliurex-quota-probe.
+ *
+ * A quota forecast to be full soon is treated like an almost full one:
+ * forecastUsage() maps the time left to a usage, and the higher of the
+ * two decides the level.
+ */
+class LliurexQuotaThresholds
+{
+public:
+    /**
+     * How urgent a usage is, from calm to full.
+     */
+    enum Level {
+        NormalLevel = 0,    // below 50%
+        HighLevel,          // from 50%
+        CriticalLevel       // from 90%
+    };
+
+    /**
+     * A quota forecast to be full sooner than this, in seconds, is critical.
+     */
+    static const qint64 CriticalForecast = 60 * 60;
+
+    /**
+     * A quota forecast to be full sooner than this, in seconds, is high.
+     */
+    static const qint64 HighForecast = 24 * 60 * 60;
+
+    /**
+     * Level of a usage of @p usage percent.
+     */
+    static Level level(int usage);
+
+    /**
+     * Usage in percent a quota full in @p timeToFull seconds is treated
+     * like, 0 if it is not filling up (@p timeToFull < 0) or slowly.
+     */
+    static int forecastUsage(qint64 timeToFull);
+
+    /**
+     * Highest usage in percent of all @p entries, at most 100.
+     */
+    static int maximumUsage(const QVector<LliurexQuotaEntry> &entries);
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_THRESHOLDS_H
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotactlBackend.h"
+#include "LliurexQuotaMetrics.h"
+#include "lliurexquota_debug.h"
+
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <limits>
+
+#include <sys/types.h>
+#include <sys/quota.h>
+#include <grp.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#ifndef Q_GETNEXTQUOTA
+#define Q_GETNEXTQUOTA 0x800009
+#endif
+
+namespace {
+    /**
+     * Layout of struct if_nextdqblk from <linux/quota.h>, which cannot be
+     * included together with <sys/quota.h>.
+     */
+    struct NextDqBlk {
+        quint64 dqb_bhardlimit;
+        quint64 dqb_bsoftlimit;
+        quint64 dqb_curspace;
+        quint64 dqb_ihardlimit;
+        quint64 dqb_isoftlimit;
+        quint64 dqb_curinodes;
+        quint64 dqb_btime;
+        quint64 dqb_itime;
+        quint32 dqb_valid;
+        quint32 dqb_id;
+    };
+
+    // quota block limits are counted in units of QIF_DQBLKSIZE
+    const qint64 QuotaBlockSize = 1024;
+
+    // a query taking longer than this is reported as failed
+    const int QueryDeadline = 20 * 1000;
+
+    // mountinfo escapes blanks and backslashes as octal sequences, e.g. '\040'
+    QString unescapeMountField(const QByteArray &field)
+    {
+        if (!field.contains('\\')) {
+            return QString::fromLocal8Bit(field);
+        }
+        QByteArray result;
+        result.reserve(field.size());
+        for (int i = 0; i < field.size(); ++i) {
+            if (field[i] == '\\' && i + 3 < field.size()) {
+                bool ok = false;
+                const int c = field.mid(i + 1, 3).toInt(&ok, 8);
+                if (ok) {
+                    result.append(char(c));
+                    i += 3;
+                    continue;
+                }
+            }
+            result.append(field[i]);
+        }
+        return QString::fromLocal8Bit(result);
+    }
+
+    QString userName(uint uid, uint *gid)
+    {
+        char buffer[1024];
+        struct passwd pwd;
+        struct passwd *result = nullptr;
+        if (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &result) == 0 && result) {
+            *gid = result->pw_gid;
+            return QString::fromLocal8Bit(result->pw_name);
+        }
+        return QString();
+    }
+
+    QString groupName(uint gid)
+    {
+        char buffer[4096];
+        struct group grp;
+        struct group *result = nullptr;
+        if (getgrgid_r(gid, &grp, buffer, sizeof(buffer), &result) == 0 && result) {
+            return QString::fromLocal8Bit(result->gr_name);
+        }
+        return QString();
+    }
+
+    /**
+     * Group names by gid, looked up once per query: a sweep meets the
+     * same few primary groups over and over.
+     */
+    typedef QHash<uint, QString> GroupNames;
+
+    QString cachedGroupName(uint gid, GroupNames *groupNames)
+    {
+        auto it = groupNames->constFind(gid);
+        if (it == groupNames->constEnd()) {
+            it = groupNames->insert(gid, groupName(gid));
+        }
+        return it.value();
+    }
+
+    template<typename DqBlk>
+    LliurexQuotaEntry toEntry(const DqBlk &dq, const LliurexQuotactlBackend::Mount &mount,
+                              LliurexQuotaEntry::Type type, uint id, GroupNames *groupNames)
+    {
+        LliurexQuotaEntry entry;
+        entry.type = type;
+        entry.id = id;
+        if (type == LliurexQuotaEntry::GroupQuota) {
+            entry.name = cachedGroupName(id, groupNames);
+            entry.group = entry.name;
+        } else {
+            uint gid = 0;
+            entry.name = userName(id, &gid);
+            if (!entry.name.isEmpty()) {
+                entry.group = cachedGroupName(gid, groupNames);
+            }
+        }
+        entry.mountPoint = mount.mountPoint;
+        entry.used = qint64(dq.dqb_curspace);
+        entry.softLimit = qint64(dq.dqb_bsoftlimit) * QuotaBlockSize;
+        entry.hardLimit = qint64(dq.dqb_bhardlimit) * QuotaBlockSize;
+        entry.inodesUsed = qint64(dq.dqb_curinodes);
+        entry.inodeSoftLimit = qint64(dq.dqb_isoftlimit);
+        entry.inodeHardLimit = qint64(dq.dqb_ihardlimit);
+        entry.graceTime = qint64(dq.dqb_btime);
+        return entry;
+    }
+
+    template<typename DqBlk>
+    bool hasLimits(const DqBlk &dq)
+    {
+        return dq.dqb_bhardlimit || dq.dqb_bsoftlimit || dq.dqb_ihardlimit || dq.dqb_isoftlimit;
+    }
+
+    QVector<uint> currentGroups()
+    {
+        QVector<uint> gids;
+        const int count = getgroups(0, nullptr);
+        if (count > 0) {
+            QVector<gid_t> list(count);
+            const int n = getgroups(count, list.data());
+            for (int i = 0; i < n; ++i) {
+                gids.append(list[i]);
+            }
+        }
+        const uint primary = getgid();
+        if (!gids.contains(primary)) {
+            gids.prepend(primary);
+        }
+        return gids;
+    }
+}
+
+LliurexQuotactlBackend::LliurexQuotactlBackend(QObject *parent)
+    : LliurexQuotaBackend(parent)
+    , m_watcher(new QFutureWatcher<QVector<LliurexQuotaEntry>>(this))
+    , m_deadline(new QTimer(this))
+{
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &LliurexQuotactlBackend::queryFinished);
+
+    m_deadline->setSingleShot(true);
+    connect(m_deadline, &QTimer::timeout, this, &LliurexQuotactlBackend::deadlineExpired);
+}
+
+QString LliurexQuotactlBackend::name() const
+{
+    return QStringLiteral("quotactl");
+}
+
+bool LliurexQuotactlBackend::isAvailable() const
+{
+    return ! quotaMounts().isEmpty();
+}
+
+void LliurexQuotactlBackend::forgetLastResult()
+{
+    m_hasLastEntries = false;
+    m_lastEntries.clear();
+}
+
+void LliurexQuotactlBackend::requestQuota()
+{
+    // a quotactl() call cannot be interrupted: if the previous query still
+    // hangs on a busy device, do not pile up more threads behind it
+    if (m_watcher->isRunning()) {
+        if (m_timedOut) {
+            emit quotaFailed(QStringLiteral("quotactl still blocked"));
+        }
+        return;
+    }
+
+    const QVector<Mount> mounts = quotaMounts();
+    const uint uid = getuid();
+    const QVector<uint> gids = currentGroups();
+    m_timedOut = false;
+    m_watcher->setFuture(QtConcurrent::run(&LliurexQuotactlBackend::queryQuota, mounts, uid, gids));
+    m_deadline->start(QueryDeadline);
+}
+
+void LliurexQuotactlBackend::deadlineExpired()
+{
+    if (m_watcher->isRunning()) {
+        qCWarning(LLIUREXQUOTA) << "quotactl() did not return in time";
+        LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::Timeouts);
+        m_timedOut = true;
+        m_hasLastEntries = false;
+        emit quotaFailed(QStringLiteral("quotactl timed out"));
+    }
+}
+
+void LliurexQuotactlBackend::queryFinished()
+{
+    m_deadline->stop();
+
+    const QVector<LliurexQuotaEntry> entries = m_watcher->result();
+    if (m_hasLastEntries && entries == m_lastEntries) {
+        emit quotaUnchanged();
+        return;
+    }
+    m_lastEntries = entries;
+    m_hasLastEntries = true;
+
+    emit quotaReady(entries);
+}
+
+QVector<LliurexQuotactlBackend::Mount> LliurexQuotactlBackend::quotaMounts(const QString &mountInfoPath)
+{
+    QVector<Mount> mounts;
+
+    QFile file(mountInfoPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return mounts;
+    }
+
+    QSet<QByteArray> devices;
+
+    // format: id parent major:minor root mountpoint options [optional...] - fstype source superoptions
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        const int separator = fields.indexOf("-");
+        if (separator < 6 || separator + 2 >= fields.size()) {
+            continue;
+        }
+
+        const QByteArray source = fields[separator + 2];
+        if (!source.startsWith('/')) {
+            // quotactl() needs a block device, network and virtual file systems are skipped
+            continue;
+        }
+
+        Mount mount;
+        const QByteArray options = fields[5] + ',' + fields.value(separator + 3);
+        for (const QByteArray &option : options.split(',')) {
+            if (option == "usrquota" || option == "quota" || option.startsWith("usrjquota=")
+                || option == "uquota" || option == "uqnoenforce" || option == "qnoenforce") {
+                mount.userQuota = true;
+            } else if (option == "grpquota" || option.startsWith("grpjquota=")
+                || option == "gquota" || option == "gqnoenforce") {
+                mount.groupQuota = true;
+            }
+        }
+
+        if ((!mount.userQuota && !mount.groupQuota) || devices.contains(fields[2])) {
+            continue;
+        }
+        devices.insert(fields[2]);
+
+        mount.device = unescapeMountField(source);
+        mount.mountPoint = unescapeMountField(fields[4]);
+        mount.fsType = QString::fromLatin1(fields[separator + 1]);
+        mounts.append(mount);
+    }
+
+    return mounts;
+}
+
+QVector<LliurexQuotaEntry> LliurexQuotactlBackend::queryQuota(const QVector<Mount> &mounts, uint uid, const QVector<uint> &gids)
+{
+    QVector<LliurexQuotaEntry> entries;
+    GroupNames groupNames;
+
+    for (const Mount &mount : mounts) {
+        const QByteArray device = QFile::encodeName(mount.device);
+        struct dqblk dq;
+
+        if (mount.userQuota) {
+            if (quotactl(QCMD(Q_GETQUOTA, USRQUOTA), device.constData(), int(uid), reinterpret_cast<caddr_t>(&dq)) == 0
+                && hasLimits(dq)) {
+                entries.append(toEntry(dq, mount, LliurexQuotaEntry::UserQuota, uid, &groupNames));
+            }
+        }
+
+        if (mount.groupQuota) {
+            for (uint gid : gids) {
+                if (quotactl(QCMD(Q_GETQUOTA, GRPQUOTA), device.constData(), int(gid), reinterpret_cast<caddr_t>(&dq)) == 0
+                    && hasLimits(dq)) {
+                    entries.append(toEntry(dq, mount, LliurexQuotaEntry::GroupQuota, gid, &groupNames));
+                }
+            }
+        }
+    }
+
+    return entries;
+}
+
+QVector<LliurexQuotaEntry> LliurexQuotactlBackend::sweepQuota(const QVector<Mount> &mounts, LliurexQuotaEntry::Type type)
+{
+    QVector<LliurexQuotaEntry> entries;
+    GroupNames groupNames;
+    const int quotaType = type == LliurexQuotaEntry::GroupQuota ? GRPQUOTA : USRQUOTA;
+
+    for (const Mount &mount : mounts) {
+        if ((type == LliurexQuotaEntry::UserQuota && !mount.userQuota)
+            || (type == LliurexQuotaEntry::GroupQuota && !mount.groupQuota)) {
+            continue;
+        }
+
+        const QByteArray device = QFile::encodeName(mount.device);
+        NextDqBlk dq;
+        quint32 id = 0;
+        // Q_GETNEXTQUOTA returns the first id >= the given id that has a quota
+        // structure, so one call per existing quota walks the whole table
+        while (quotactl(QCMD(Q_GETNEXTQUOTA, quotaType), device.constData(), int(id), reinterpret_cast<caddr_t>(&dq)) == 0) {
+            if (hasLimits(dq)) {
+                entries.append(toEntry(dq, mount, type, dq.dqb_id, &groupNames));
+            }
+            if (dq.dqb_id == std::numeric_limits<quint32>::max()) {
+                break;
+            }
+            id = dq.dqb_id + 1;
+        }
+    }
+
+    return entries;
+}
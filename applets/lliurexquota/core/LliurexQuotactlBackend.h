@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTACTL_BACKEND_H
+#define PLASMA_LLIUREX_QUOTACTL_BACKEND_H
+
+#include "LliurexQuotaBackend.h"
+
+#include <QFutureWatcher>
+
+class QTimer;
+
+/**
+ * Quota backend reading the quotas in-process through quotactl(2).
+ * All local file systems listed in /proc/self/mountinfo that are mounted
+ * with quota options are queried for the user's own quota and for the
+ * quotas of all groups the user is member of. The queries run on a
+ * worker thread, since quotactl() may block on a busy device; a query
+ * not done within a deadline is reported as failed.
+ */
+class LliurexQuotactlBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    /**
+     * A file system mounted with quota support.
+     */
+    struct Mount {
+        QString device;
+        QString mountPoint;
+        QString fsType;
+        bool userQuota = false;
+        bool groupQuota = false;
+    };
+
+    LliurexQuotactlBackend(QObject *parent = nullptr);
+
+    QString name() const override;
+    bool isAvailable() const override;
+    void requestQuota() override;
+    void forgetLastResult() override;
+
+public:
+    /**
+     * Returns all mounts of @p mountInfoPath with user or group quotas
+     * enabled. Bind mounts of the same device are reported once.
+     */
+    static QVector<Mount> quotaMounts(const QString &mountInfoPath = QStringLiteral("/proc/self/mountinfo"));
+
+    /**
+     * Queries the quota of user @p uid and of the groups @p gids on all
+     * @p mounts with Q_GETQUOTA. Ids without any limit are skipped.
+     * This call is synchronous.
+     */
+    static QVector<LliurexQuotaEntry> queryQuota(const QVector<Mount> &mounts, uint uid, const QVector<uint> &gids);
+
+    /**
+     * Reads all quotas of @p type on all @p mounts with one Q_GETNEXTQUOTA
+     * sweep per mount. Requires CAP_SYS_ADMIN. This call is synchronous.
+     */
+    static QVector<LliurexQuotaEntry> sweepQuota(const QVector<Mount> &mounts, LliurexQuotaEntry::Type type);
+
+private Q_SLOTS:
+    void queryFinished();
+    void deadlineExpired();
+
+private:
+    QFutureWatcher<QVector<LliurexQuotaEntry>> *m_watcher = nullptr;
+    QTimer *m_deadline = nullptr;
+    bool m_timedOut = false;
+    QVector<LliurexQuotaEntry> m_lastEntries;
+    bool m_hasLastEntries = false;
+};
+
+#endif // PLASMA_LLIUREX_QUOTACTL_BACKEND_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexToolLocator.h"
+#include "lliurexquota_debug.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+
+namespace {
+    // a package manager touches the directories many times in a row
+    const int RescanDelay = 1000;
+}
+
+LliurexToolLocator::LliurexToolLocator(const QStringList &tools, QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_rescanTimer(new QTimer(this))
+    , m_tools(tools)
+{
+    QStringList directories;
+    const QStringList searchPaths = QString::fromLocal8Bit(qgetenv("PATH")).split(QLatin1Char(':'), QString::SkipEmptyParts);
+    for (const QString &directory : searchPaths) {
+        directories.append(QDir(directory).absolutePath());
+    }
+    for (const QString &tool : tools) {
+        if (QDir::isAbsolutePath(tool)) {
+            directories.append(QFileInfo(tool).absolutePath());
+        }
+    }
+    directories.removeDuplicates();
+
+    // directories missing now are not watched; they rarely appear later
+    for (const QString &directory : qAsConst(directories)) {
+        if (QFileInfo(directory).isDir()) {
+            m_watcher->addPath(directory);
+        }
+    }
+
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RescanDelay);
+    connect(m_rescanTimer, &QTimer::timeout, this, &LliurexToolLocator::rescan);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_rescanTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+    for (const QString &tool : tools) {
+        m_paths.insert(tool, QStandardPaths::findExecutable(tool));
+    }
+}
+
+QString LliurexToolLocator::path(const QString &tool) const
+{
+    QReadLocker locker(&m_lock);
+    return m_paths.value(tool);
+}
+
+bool LliurexToolLocator::isInstalled(const QString &tool) const
+{
+    return !path(tool).isEmpty();
+}
+
+void LliurexToolLocator::rescan()
+{
+    bool changed = false;
+    for (const QString &tool : qAsConst(m_tools)) {
+        const QString path = QStandardPaths::findExecutable(tool);
+        if (this->path(tool) != path) {
+            qCDebug(LLIUREXQUOTA) << "Tool" << tool << "now at" << path;
+            QWriteLocker locker(&m_lock);
+            m_paths.insert(tool, path);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        emit toolsChanged();
+    }
+}
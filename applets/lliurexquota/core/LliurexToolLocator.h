@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_TOOL_LOCATOR_H
+#define PLASMA_LLIUREX_TOOL_LOCATOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QStringList>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * Finds external tools in $PATH once and keeps the result up to date.
+ *
+ * Instead of searching $PATH on every poll, the directories of $PATH are
+ * watched with QFileSystemWatcher (inotify on Linux). When one of them
+ * changes, e.g. because a package was installed or removed, the tools are
+ * resolved again after a short delay that collapses the burst of changes
+ * of a package manager run, and toolsChanged() is emitted if any result
+ * differs.
+ *
+ * path() and isInstalled() may be called from any thread, e.g. by a
+ * backend running in the LliurexQuotaPipeline thread.
+ */
+class LliurexToolLocator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Resolves @p tools, given as names or absolute paths.
+     */
+    LliurexToolLocator(const QStringList &tools, QObject *parent = nullptr);
+
+    /**
+     * Absolute path of @p tool, or an empty string if it is not installed.
+     */
+    QString path(const QString &tool) const;
+
+    bool isInstalled(const QString &tool) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when a tool was installed or removed.
+     */
+    void toolsChanged();
+
+private Q_SLOTS:
+    void rescan();
+
+private:
+    QFileSystemWatcher *m_watcher = nullptr;
+    QTimer *m_rescanTimer = nullptr;
+    QStringList m_tools;
+    mutable QReadWriteLock m_lock;  // guards m_paths
+    QHash<QString, QString> m_paths;
+};
+
+#endif // PLASMA_LLIUREX_TOOL_LOCATOR_H
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexUsageHistory.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include <sys/file.h>
+
+namespace {
+    const quint32 Magic = 0x4c515548; // 'LQUH'
+    const quint32 Version = 1;
+
+    // quotas remembered; a user rarely has more than a handful
+    const int SlotCount = 16;
+
+    // time constant of the smoothed growth rate, in seconds
+    const double RateTimeConstant = 60.0 * 60.0;
+
+    // slower growth (about 84 KiB a day) is treated as standing still
+    const double MinimumGrowthRate = 1.0;
+
+    // quarter-hour samples needed for a trend, i.e. 45 minutes of history
+    const int MinimumTrendSamples = 4;
+
+    // the trend is taken over the last day at most
+    const qint64 TrendWindow = 24 * 60 * 60;
+
+    /**
+     * Position of a tier's ring within the samples of a slot, and the
+     * minimum distance in seconds between two of its samples.
+     */
+    struct TierLayout {
+        int offset;
+        int capacity;
+        qint64 spacing;
+    };
+
+    const TierLayout Tiers[LliurexUsageHistory::TierCount] = {
+        { 0, 64, 0 },               // the last 64 polls
+        { 64, 96, 15 * 60 },        // one day
+        { 160, 124, 6 * 60 * 60 }   // one month
+    };
+    const int SamplesPerSlot = 284;
+
+    struct FileHeader {
+        quint32 magic;
+        quint32 version;
+        quint32 slotCount;
+        quint32 slotSize;
+    };
+
+    quint64 keyHash(const QString &key)
+    {
+        // FNV-1a, 0 marks an unused slot
+        quint64 hash = Q_UINT64_C(14695981039346656037);
+        const QByteArray bytes = key.toUtf8();
+        for (const char c : bytes) {
+            hash ^= static_cast<uchar>(c);
+            hash *= Q_UINT64_C(1099511628211);
+        }
+        return hash ? hash : 1;
+    }
+
+    /**
+     * Holds a flock() on the history file while in scope: the applets of
+     * this user share the file, on an NFS home even from other hosts, where
+     * the kernel turns it into a lock of the NFS server. Does nothing for
+     * the history kept in memory, @p fd -1.
+     */
+    class FileLock
+    {
+    public:
+        FileLock(int fd, int operation)
+            : m_fd(fd)
+        {
+            while (m_fd >= 0 && flock(m_fd, operation) == -1 && errno == EINTR) {
+            }
+        }
+
+        ~FileLock()
+        {
+            if (m_fd >= 0) {
+                flock(m_fd, LOCK_UN);
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(FileLock)
+        int m_fd;
+    };
+
+    /**
+     * Least squares slope of @p samples in bytes per second, false if
+     * they are too few or all of the same second.
+     */
+    bool regression(const QVector<LliurexUsageHistory::Sample> &samples, double *slope)
+    {
+        if (samples.size() < MinimumTrendSamples) {
+            return false;
+        }
+
+        // relative to the first sample, the sums stay exact in a double
+        const qint64 time0 = samples.first().time;
+        const qint64 used0 = samples.first().used;
+        double meanTime = 0;
+        double meanUsed = 0;
+        for (const auto &sample : samples) {
+            meanTime += sample.time - time0;
+            meanUsed += sample.used - used0;
+        }
+        meanTime /= samples.size();
+        meanUsed /= samples.size();
+
+        double covariance = 0;
+        double variance = 0;
+        for (const auto &sample : samples) {
+            const double time = sample.time - time0 - meanTime;
+            covariance += time * (sample.used - used0 - meanUsed);
+            variance += time * time;
+        }
+        if (variance <= 0) {
+            return false;
+        }
+        *slope = covariance / variance;
+        return std::isfinite(*slope);
+    }
+}
+
+/**
+ * The history of one quota, as stored in the file.
+ */
+struct LliurexUsageHistory::Slot {
+    quint64 keyHash;
+    qint64 lastSeen;
+    double rate;        // smoothed bytes per second
+    qint64 rateTime;    // sample the rate was last updated with
+    qint64 rateUsed;
+    quint32 head[TierCount];    // next position to write, per tier
+    quint32 count[TierCount];
+    Sample samples[SamplesPerSlot];
+};
+
+LliurexUsageHistory::LliurexUsageHistory(const QString &fileName)
+{
+    if (!mapFile(fileName)) {
+        m_memory = QByteArray(fileSize(), 0);
+        m_data = reinterpret_cast<uchar *>(m_memory.data());
+    }
+}
+
+LliurexUsageHistory::~LliurexUsageHistory()
+{
+    if (m_file.isOpen()) {
+        m_file.unmap(m_data);
+        m_file.close();
+    }
+}
+
+qint64 LliurexUsageHistory::fileSize()
+{
+    return sizeof(FileHeader) + SlotCount * sizeof(Slot);
+}
+
+QString LliurexUsageHistory::defaultFileName()
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheDir.isEmpty()) {
+        return QString();
+    }
+    return cacheDir + QStringLiteral("/lliurexquota/usage-history");
+}
+
+bool LliurexUsageHistory::isPersistent() const
+{
+    return m_file.isOpen();
+}
+
+int LliurexUsageHistory::handle() const
+{
+    return m_file.isOpen() ? m_file.handle() : -1;
+}
+
+bool LliurexUsageHistory::mapFile(const QString &fileName)
+{
+    if (fileName.isEmpty() || !QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // another applet may be creating the file just now
+    FileLock lock(m_file.handle(), LOCK_EX);
+    const bool sizeMatches = m_file.size() == fileSize();
+    if (!sizeMatches && !m_file.resize(fileSize())) {
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.map(0, fileSize());
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    // a file of another version or layout is started afresh
+    FileHeader *header = reinterpret_cast<FileHeader *>(m_data);
+    if (!sizeMatches || header->magic != Magic || header->version != Version
+        || header->slotCount != SlotCount || header->slotSize != sizeof(Slot)) {
+        std::memset(m_data, 0, fileSize());
+        header->magic = Magic;
+        header->version = Version;
+        header->slotCount = SlotCount;
+        header->slotSize = sizeof(Slot);
+    }
+    return true;
+}
+
+LliurexUsageHistory::Slot *LliurexUsageHistory::slot(int index) const
+{
+    return reinterpret_cast<Slot *>(m_data + sizeof(FileHeader) + index * sizeof(Slot));
+}
+
+LliurexUsageHistory::Slot *LliurexUsageHistory::findSlot(const QString &key) const
+{
+    const quint64 hash = keyHash(key);
+    for (int i = 0; i < SlotCount; ++i) {
+        Slot *s = slot(i);
+        if (s->keyHash == hash) {
+            return s;
+        }
+    }
+    return nullptr;
+}
+
+LliurexUsageHistory::Slot *LliurexUsageHistory::takeSlot(const QString &key)
+{
+    Slot *s = findSlot(key);
+    if (s) {
+        return s;
+    }
+
+    // reuse a free slot, or the one not seen for the longest time
+    s = slot(0);
+    for (int i = 0; i < SlotCount && s->keyHash != 0; ++i) {
+        Slot *candidate = slot(i);
+        if (candidate->keyHash == 0 || candidate->lastSeen < s->lastSeen) {
+            s = candidate;
+        }
+    }
+
+    std::memset(s, 0, sizeof(Slot));
+    s->keyHash = keyHash(key);
+    return s;
+}
+
+void LliurexUsageHistory::addSample(const QString &key, qint64 time, qint64 used)
+{
+    FileLock lock(handle(), LOCK_EX);
+    Slot *s = takeSlot(key);
+    s->lastSeen = time;
+
+    if (!std::isfinite(s->rate)) {
+        s->rate = 0;
+    }
+    if (s->rateTime > 0 && time > s->rateTime) {
+        // the longer the gap, the more the new slope counts
+        const double elapsed = time - s->rateTime;
+        const double current = (used - s->rateUsed) / elapsed;
+        const double alpha = 1.0 - std::exp(-elapsed / RateTimeConstant);
+        s->rate += alpha * (current - s->rate);
+    }
+    s->rateTime = time;
+    s->rateUsed = used;
+
+    const Sample sample = { time, used };
+    for (int t = 0; t < TierCount; ++t) {
+        const TierLayout &layout = Tiers[t];
+        Sample *ring = s->samples + layout.offset;
+        const quint32 capacity = layout.capacity;
+
+        if (s->head[t] >= capacity || s->count[t] > capacity) {
+            s->head[t] = 0;
+            s->count[t] = 0;
+        }
+
+        if (s->count[t] > 0) {
+            Sample &newest = ring[(s->head[t] + capacity - 1) % capacity];
+            const qint64 age = time - newest.time;
+            if (age < 0 || (age == 0 && t == RecentTier)) {
+                // same second, or the clock was set back
+                newest = sample;
+                continue;
+            }
+            if (age < layout.spacing) {
+                continue;
+            }
+        }
+
+        ring[s->head[t]] = sample;
+        s->head[t] = (s->head[t] + 1) % capacity;
+        if (s->count[t] < capacity) {
+            ++s->count[t];
+        }
+    }
+}
+
+double LliurexUsageHistory::growthRate(const QString &key) const
+{
+    double rate = 0;
+    if (trend(key, QuarterHourTier, &rate)) {
+        return rate;
+    }
+
+    // too little history yet: the smoothed rate of the last polls
+    FileLock lock(handle(), LOCK_SH);
+    const Slot *s = findSlot(key);
+    if (!s || !std::isfinite(s->rate)) {
+        return 0;
+    }
+    return s->rate;
+}
+
+bool LliurexUsageHistory::trend(const QString &key, Tier tier, double *rate) const
+{
+    QVector<Sample> window = samples(key, tier);
+    if (window.isEmpty()) {
+        return false;
+    }
+
+    // a ring not fed for a while reaches back further than the window
+    const qint64 start = window.last().time - TrendWindow;
+    int first = 0;
+    while (tier != SixHourTier && window[first].time < start) {
+        ++first;
+    }
+    return regression(window.mid(first), rate);
+}
+
+qint64 LliurexUsageHistory::timeToFull(const QString &key, qint64 used, qint64 limit) const
+{
+    if (limit <= 0) {
+        return -1;
+    }
+    if (used >= limit) {
+        return 0;
+    }
+
+    const double rate = growthRate(key);
+    if (rate < MinimumGrowthRate) {
+        return -1;
+    }
+    return static_cast<qint64>((limit - used) / rate);
+}
+
+QVector<LliurexUsageHistory::Sample> LliurexUsageHistory::samples(const QString &key, Tier tier) const
+{
+    QVector<Sample> result;
+    FileLock lock(handle(), LOCK_SH);
+    const Slot *s = findSlot(key);
+    if (!s || tier < 0 || tier >= TierCount) {
+        return result;
+    }
+
+    const TierLayout &layout = Tiers[tier];
+    const quint32 capacity = layout.capacity;
+    if (s->head[tier] >= capacity || s->count[tier] > capacity) {
+        return result;
+    }
+
+    const Sample *ring = s->samples + layout.offset;
+    const quint32 start = (s->head[tier] + capacity - s->count[tier]) % capacity;
+    result.reserve(s->count[tier]);
+    for (quint32 i = 0; i < s->count[tier]; ++i) {
+        result.append(ring[(start + i) % capacity]);
+    }
+    return result;
+}
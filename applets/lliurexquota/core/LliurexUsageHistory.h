@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_USAGE_HISTORY_H
+#define PLASMA_LLIUREX_USAGE_HISTORY_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * Usage history of the quotas of this user, kept in a memory-mapped file
+ * under $XDG_CACHE_HOME so that it survives restarts of the applet.
+ *
+ * Every quota gets a fixed-size slot with three rings of (time, bytes used)
+ * samples: the most recent polls, one sample per quarter of an hour for the
+ * last day, and one sample per six hours for the last month. Adding a
+ * sample is O(1) and the file never grows. If the file cannot be mapped,
+ * the history is kept in memory for the lifetime of the applet.
+ *
+ * The growth rate, from which the time until the quota is full is
+ * estimated, is the trend of the quarter-hour samples of the last day.
+ * Until there are enough of them, an exponentially smoothed rate of the
+ * polls, kept next to the samples, stands in. The applets of this user
+ * share the file, every access holds a flock() on it.
+ */
+class LliurexUsageHistory
+{
+public:
+    /**
+     * One measurement, @p time in seconds since the epoch.
+     */
+    struct Sample {
+        qint64 time;
+        qint64 used;
+    };
+
+    /**
+     * Sample rings from fine to coarse.
+     */
+    enum Tier {
+        RecentTier = 0,
+        QuarterHourTier,
+        SixHourTier,
+        TierCount
+    };
+
+    explicit LliurexUsageHistory(const QString &fileName = defaultFileName());
+    ~LliurexUsageHistory();
+
+    /**
+     * $XDG_CACHE_HOME/lliurexquota/usage-history
+     */
+    static QString defaultFileName();
+
+    /**
+     * Returns true if the history is backed by the file.
+     */
+    bool isPersistent() const;
+
+    /**
+     * Records that the quota @p key used @p used bytes at @p time.
+     * If all slots are taken, the quota not seen for the longest time
+     * is forgotten.
+     */
+    void addSample(const QString &key, qint64 time, qint64 used);
+
+    /**
+     * Growth of quota @p key in bytes per second, negative if space is
+     * being freed, 0 if unknown: the trend() of the quarter-hour tier, or
+     * the smoothed rate of the polls while that tier has too few samples.
+     */
+    double growthRate(const QString &key) const;
+
+    /**
+     * Sets @p rate to the least squares slope of the samples of quota
+     * @p key in @p tier, in bytes per second, over the last day for the
+     * finer tiers. Returns false if there are too few samples.
+     */
+    bool trend(const QString &key, Tier tier, double *rate) const;
+
+    /**
+     * Estimated seconds until @p used reaches @p limit at the current
+     * growth rate of quota @p key, or -1 if it is not filling up.
+     */
+    qint64 timeToFull(const QString &key, qint64 used, qint64 limit) const;
+
+    /**
+     * The samples of quota @p key in @p tier, oldest first.
+     */
+    QVector<Sample> samples(const QString &key, Tier tier) const;
+
+private:
+    struct Slot;
+    static qint64 fileSize();
+    Slot *findSlot(const QString &key) const;
+    Slot *takeSlot(const QString &key);
+    Slot *slot(int index) const;
+    bool mapFile(const QString &fileName);
+    int handle() const;
+
+    QFile m_file;
+    uchar *m_data = nullptr;
+    QByteArray m_memory;
+};
+
+#endif // PLASMA_LLIUREX_USAGE_HISTORY_H
@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDiskQuota.h"
+#include "LliurexQuotaMetrics.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <sys/resource.h>
+#include <sys/time.h>
+
+/**
+ * lliurex-quota-loadtest runs many headless LliurexDiskQuota instances,
+ * spread over worker processes, against a fake 'lliurex-quota' put first
+ * in $PATH, and reports what they cost the host. Every worker gets a home
+ * folder of its own and no D-Bus, so the test runs offline and does not
+ * touch the data of the user running it.
+ *
+ * The instances of one worker share its LliurexQuotaEngine, as the applets
+ * of one plasmashell do; the quota source is polled once per worker.
+ */
+
+namespace {
+    /**
+     * Resource usage of this process and of its reaped children.
+     */
+    struct Usage {
+        qint64 userTime = 0;            // microseconds
+        qint64 systemTime = 0;
+        qint64 childUserTime = 0;
+        qint64 childSystemTime = 0;
+        qint64 voluntarySwitches = 0;   // a thread went to sleep and was woken up
+        qint64 involuntarySwitches = 0;
+        qint64 maxResident = 0;         // KiB
+    };
+
+    qint64 microseconds(const struct timeval &time)
+    {
+        return qint64(time.tv_sec) * 1000000 + time.tv_usec;
+    }
+
+    Usage currentUsage()
+    {
+        struct rusage self;
+        struct rusage children;
+        getrusage(RUSAGE_SELF, &self);
+        getrusage(RUSAGE_CHILDREN, &children);
+
+        Usage usage;
+        usage.userTime = microseconds(self.ru_utime);
+        usage.systemTime = microseconds(self.ru_stime);
+        usage.childUserTime = microseconds(children.ru_utime);
+        usage.childSystemTime = microseconds(children.ru_stime);
+        usage.voluntarySwitches = self.ru_nvcsw;
+        usage.involuntarySwitches = self.ru_nivcsw;
+        usage.maxResident = self.ru_maxrss;
+        return usage;
+    }
+
+    /**
+     * Current resident set size in KiB, from /proc/self/status.
+     */
+    qint64 residentSize()
+    {
+        QFile file(QStringLiteral("/proc/self/status"));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return 0;
+        }
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine();
+            if (line.startsWith("VmRSS:")) {
+                return line.mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Value at @p percent of the sorted @p values, nearest rank.
+     */
+    qint64 percentile(const QVector<qint64> &values, int percent)
+    {
+        if (values.isEmpty()) {
+            return 0;
+        }
+        const int rank = qMax(1, int((qint64(percent) * values.size() + 99) / 100));
+        return values.at(qMin(rank, values.size()) - 1);
+    }
+
+    /**
+     * Runs @p instances applets for @p duration seconds and prints the
+     * report as one JSON line.
+     */
+    int runWorker(QCoreApplication &app, int instances, int duration)
+    {
+        const Usage before = currentUsage();
+        const qint64 residentBefore = residentSize();
+
+        QVector<qint64> latencies;
+        QVector<LliurexDiskQuota *> quotas;
+        quotas.reserve(instances);
+        for (int i = 0; i < instances; ++i) {
+            auto quota = new LliurexDiskQuota();
+            quotas.append(quota);
+        }
+        // every instance reports the polls of the shared engine
+        QObject::connect(quotas.first(), &LliurexDiskQuota::pollFinished, [&latencies](qint64 latency) {
+            if (latency >= 0) {
+                latencies.append(latency);
+            }
+        });
+        const qint64 residentStarted = residentSize();
+
+        QTimer::singleShot(duration * 1000, &app, &QCoreApplication::quit);
+        app.exec();
+
+        const Usage after = currentUsage();
+        const QVariantMap metrics = LliurexQuotaMetrics::instance().snapshot();
+
+        QJsonArray latencyArray;
+        for (qint64 latency : qAsConst(latencies)) {
+            latencyArray.append(latency);
+        }
+
+        QJsonObject report;
+        report.insert(QStringLiteral("instances"), instances);
+        report.insert(QStringLiteral("userTime"), after.userTime - before.userTime);
+        report.insert(QStringLiteral("systemTime"), after.systemTime - before.systemTime);
+        report.insert(QStringLiteral("toolTime"), after.childUserTime + after.childSystemTime
+                                                  - before.childUserTime - before.childSystemTime);
+        report.insert(QStringLiteral("voluntarySwitches"), after.voluntarySwitches - before.voluntarySwitches);
+        report.insert(QStringLiteral("involuntarySwitches"), after.involuntarySwitches - before.involuntarySwitches);
+        report.insert(QStringLiteral("residentBefore"), residentBefore);
+        report.insert(QStringLiteral("residentStarted"), residentStarted);
+        report.insert(QStringLiteral("residentEnd"), residentSize());
+        report.insert(QStringLiteral("maxResident"), after.maxResident);
+        report.insert(QStringLiteral("polls"), metrics.value(QStringLiteral("polls_total")).toLongLong());
+        report.insert(QStringLiteral("failures"), metrics.value(QStringLiteral("failures_total")).toLongLong());
+        report.insert(QStringLiteral("latencies"), latencyArray);
+
+        const QByteArray line = QJsonDocument(report).toJson(QJsonDocument::Compact) + '\n';
+        fwrite(line.constData(), 1, line.size(), stdout);
+        fflush(stdout);
+
+        qDeleteAll(quotas);
+        return 0;
+    }
+
+    /**
+     * Options of the fake 'lliurex-quota', see fake-lliurex-quota.
+     */
+    struct FakeOptions {
+        QString program;
+        int latency = 0;
+        int failureRate = 0;
+        int lines = 1;
+        int churn = 10;
+    };
+
+    /**
+     * Starts @p processes workers running @p instances applets in total,
+     * and prints their summed report.
+     */
+    int runTest(int instances, int processes, int duration, const FakeOptions &fake, bool json, bool verbose)
+    {
+        if (!QFileInfo(fake.program).isExecutable()) {
+            fprintf(stderr, "The fake lliurex-quota '%s' is not executable\n", qPrintable(fake.program));
+            return 2;
+        }
+
+        QTemporaryDir root;
+        if (!root.isValid()) {
+            fprintf(stderr, "Cannot create a temporary folder\n");
+            return 1;
+        }
+        const QString binDir = root.filePath(QStringLiteral("bin"));
+        const QString runLog = root.filePath(QStringLiteral("runs.log"));
+        QDir().mkpath(binDir);
+        QFile::link(QFileInfo(fake.program).absoluteFilePath(), binDir + QStringLiteral("/lliurex-quota"));
+        QFile log(runLog);
+        log.open(QIODevice::WriteOnly);
+        log.close();
+
+        QVector<QProcess *> workers;
+        for (int i = 0; i < processes; ++i) {
+            const int count = instances / processes + (i < instances % processes ? 1 : 0);
+            if (count == 0) {
+                continue;
+            }
+
+            const QString home = root.filePath(QStringLiteral("home-%1").arg(i));
+            QDir().mkpath(home);
+
+            QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            env.insert(QStringLiteral("PATH"), binDir + QLatin1Char(':') + env.value(QStringLiteral("PATH")));
+            env.insert(QStringLiteral("HOME"), home);
+            env.insert(QStringLiteral("XDG_CACHE_HOME"), home + QStringLiteral("/.cache"));
+            env.insert(QStringLiteral("XDG_CONFIG_HOME"), home + QStringLiteral("/.config"));
+            env.insert(QStringLiteral("XDG_DATA_HOME"), home + QStringLiteral("/.local/share"));
+            env.insert(QStringLiteral("LLIUREX_QUOTA_BACKEND"), QStringLiteral("process"));
+            env.remove(QStringLiteral("LLIUREX_QUOTA_TOOL"));
+            env.remove(QStringLiteral("LLIUREX_QUOTA_METRICS_TEXTFILE"));
+
+            // no quota service, screen saver or admin helper may answer
+            const QString noBus = QStringLiteral("unix:path=") + root.filePath(QStringLiteral("no-bus"));
+            env.insert(QStringLiteral("DBUS_SESSION_BUS_ADDRESS"), noBus);
+            env.insert(QStringLiteral("DBUS_SYSTEM_BUS_ADDRESS"), noBus);
+
+            env.insert(QStringLiteral("LLIUREX_FAKE_QUOTA_LATENCY_MS"), QString::number(fake.latency));
+            env.insert(QStringLiteral("LLIUREX_FAKE_QUOTA_FAILURE_RATE"), QString::number(fake.failureRate));
+            env.insert(QStringLiteral("LLIUREX_FAKE_QUOTA_LINES"), QString::number(fake.lines));
+            env.insert(QStringLiteral("LLIUREX_FAKE_QUOTA_CHURN"), QString::number(fake.churn));
+            env.insert(QStringLiteral("LLIUREX_FAKE_QUOTA_LOG"), runLog);
+
+            auto worker = new QProcess();
+            worker->setProcessEnvironment(env);
+            if (verbose) {
+                worker->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+            } else {
+                worker->setStandardErrorFile(QProcess::nullDevice());
+            }
+            worker->start(QCoreApplication::applicationFilePath(), {
+                QStringLiteral("--worker"),
+                QStringLiteral("--instances"), QString::number(count),
+                QStringLiteral("--duration"), QString::number(duration)
+            });
+            workers.append(worker);
+        }
+
+        qint64 userTime = 0;
+        qint64 systemTime = 0;
+        qint64 toolTime = 0;
+        qint64 voluntarySwitches = 0;
+        qint64 involuntarySwitches = 0;
+        qint64 residentBefore = 0;
+        qint64 residentStarted = 0;
+        qint64 residentEnd = 0;
+        qint64 polls = 0;
+        qint64 failures = 0;
+        QVector<qint64> latencies;
+        int failedWorkers = 0;
+
+        for (QProcess *worker : qAsConst(workers)) {
+            // leave the workers time to start and stop their instances
+            worker->waitForFinished((duration + 300) * 1000);
+            const QJsonObject report = QJsonDocument::fromJson(worker->readAllStandardOutput()).object();
+            if (worker->exitStatus() != QProcess::NormalExit || report.isEmpty()) {
+                ++failedWorkers;
+                worker->kill();
+                worker->waitForFinished();
+                continue;
+            }
+
+            userTime += qint64(report.value(QStringLiteral("userTime")).toDouble());
+            systemTime += qint64(report.value(QStringLiteral("systemTime")).toDouble());
+            toolTime += qint64(report.value(QStringLiteral("toolTime")).toDouble());
+            voluntarySwitches += qint64(report.value(QStringLiteral("voluntarySwitches")).toDouble());
+            involuntarySwitches += qint64(report.value(QStringLiteral("involuntarySwitches")).toDouble());
+            residentBefore += qint64(report.value(QStringLiteral("residentBefore")).toDouble());
+            residentStarted += qint64(report.value(QStringLiteral("residentStarted")).toDouble());
+            residentEnd += qint64(report.value(QStringLiteral("residentEnd")).toDouble());
+            polls += qint64(report.value(QStringLiteral("polls")).toDouble());
+            failures += qint64(report.value(QStringLiteral("failures")).toDouble());
+            const QJsonArray latencyArray = report.value(QStringLiteral("latencies")).toArray();
+            for (const QJsonValue &latency : latencyArray) {
+                latencies.append(qint64(latency.toDouble()));
+            }
+        }
+        qDeleteAll(workers);
+        std::sort(latencies.begin(), latencies.end());
+
+        // every run of the fake is one fork and one exec of the applet
+        const qint64 runs = QFileInfo(runLog).size();
+        const double seconds = duration;
+        const qint64 appletResident = residentEnd - residentBefore;
+
+        if (json) {
+            QJsonObject report;
+            report.insert(QStringLiteral("instances"), instances);
+            report.insert(QStringLiteral("processes"), workers.size());
+            report.insert(QStringLiteral("failedProcesses"), failedWorkers);
+            report.insert(QStringLiteral("duration"), duration);
+            report.insert(QStringLiteral("toolRuns"), runs);
+            report.insert(QStringLiteral("polls"), polls);
+            report.insert(QStringLiteral("failures"), failures);
+            report.insert(QStringLiteral("userTime"), userTime);
+            report.insert(QStringLiteral("systemTime"), systemTime);
+            report.insert(QStringLiteral("toolTime"), toolTime);
+            report.insert(QStringLiteral("residentStarted"), residentStarted);
+            report.insert(QStringLiteral("residentEnd"), residentEnd);
+            report.insert(QStringLiteral("appletResident"), appletResident);
+            report.insert(QStringLiteral("wakeupsPerSecond"), voluntarySwitches / seconds);
+            report.insert(QStringLiteral("involuntarySwitchesPerSecond"), involuntarySwitches / seconds);
+            report.insert(QStringLiteral("latencyP50"), percentile(latencies, 50));
+            report.insert(QStringLiteral("latencyP90"), percentile(latencies, 90));
+            report.insert(QStringLiteral("latencyP99"), percentile(latencies, 99));
+            report.insert(QStringLiteral("latencyMax"), latencies.isEmpty() ? 0 : latencies.last());
+            const QByteArray text = QJsonDocument(report).toJson();
+            fwrite(text.constData(), 1, text.size(), stdout);
+        } else {
+            printf("%d instances in %d processes for %d s", instances, workers.size(), duration);
+            if (failedWorkers > 0) {
+                printf(", %d processes failed", failedWorkers);
+            }
+            printf("\n");
+            printf("lliurex-quota runs (fork + exec): %lld, %.2f/s\n", runs, runs / seconds);
+            printf("polls: %lld, failed: %lld\n", polls, failures);
+            printf("applet CPU: user %.2f s, system %.2f s, %.2f%% of one core\n",
+                   userTime / 1e6, systemTime / 1e6, (userTime + systemTime) / (seconds * 1e4));
+            printf("lliurex-quota CPU: %.2f s\n", toolTime / 1e6);
+            printf("RSS: %lld KiB at the end, %lld KiB for the applets, %lld KiB per instance\n",
+                   residentEnd, appletResident, instances > 0 ? appletResident / instances : 0);
+            printf("wakeups: %.1f/s, preemptions: %.1f/s\n",
+                   voluntarySwitches / seconds, involuntarySwitches / seconds);
+            printf("poll latency: p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms (%d polls)\n",
+                   percentile(latencies, 50) / 1e3, percentile(latencies, 90) / 1e3,
+                   percentile(latencies, 99) / 1e3, (latencies.isEmpty() ? 0 : latencies.last()) / 1e3,
+                   latencies.size());
+        }
+
+        return failedWorkers > 0 ? 1 : 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("lliurex-quota-loadtest"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Runs many quota applets against a fake lliurex-quota and reports their cost."));
+    parser.addHelpOption();
+    QCommandLineOption instancesOption(QStringLiteral("instances"),
+                                       QStringLiteral("Number of applet instances (default: 100)."),
+                                       QStringLiteral("n"), QStringLiteral("100"));
+    QCommandLineOption processesOption(QStringLiteral("processes"),
+                                       QStringLiteral("Number of processes the instances are spread over (default: 1)."),
+                                       QStringLiteral("n"), QStringLiteral("1"));
+    QCommandLineOption durationOption(QStringLiteral("duration"),
+                                      QStringLiteral("Seconds to run (default: 300)."),
+                                      QStringLiteral("seconds"), QStringLiteral("300"));
+    QCommandLineOption fakeOption(QStringLiteral("fake"),
+                                  QStringLiteral("The fake lliurex-quota to run."),
+                                  QStringLiteral("program"), QStringLiteral(LLIUREX_FAKE_QUOTA));
+    QCommandLineOption latencyOption(QStringLiteral("latency"),
+                                     QStringLiteral("Milliseconds the fake takes to answer (default: 0)."),
+                                     QStringLiteral("ms"), QStringLiteral("0"));
+    QCommandLineOption failureRateOption(QStringLiteral("failure-rate"),
+                                         QStringLiteral("Percent of the runs of the fake that fail (default: 0)."),
+                                         QStringLiteral("percent"), QStringLiteral("0"));
+    QCommandLineOption linesOption(QStringLiteral("lines"),
+                                   QStringLiteral("Quota records the fake prints (default: 1)."),
+                                   QStringLiteral("n"), QStringLiteral("1"));
+    QCommandLineOption churnOption(QStringLiteral("churn"),
+                                   QStringLiteral("Percent of the runs of the fake reporting a changed usage (default: 10)."),
+                                   QStringLiteral("percent"), QStringLiteral("10"));
+    QCommandLineOption jsonOption(QStringLiteral("json"),
+                                  QStringLiteral("Print the report as JSON, to compare runs."));
+    QCommandLineOption verboseOption(QStringLiteral("verbose"),
+                                     QStringLiteral("Show the messages of the instances."));
+    QCommandLineOption workerOption(QStringLiteral("worker"),
+                                    QStringLiteral("Internal: run the instances in this process."));
+    parser.addOption(instancesOption);
+    parser.addOption(processesOption);
+    parser.addOption(durationOption);
+    parser.addOption(fakeOption);
+    parser.addOption(latencyOption);
+    parser.addOption(failureRateOption);
+    parser.addOption(linesOption);
+    parser.addOption(churnOption);
+    parser.addOption(jsonOption);
+    parser.addOption(verboseOption);
+    parser.addOption(workerOption);
+    parser.process(app);
+
+    const int instances = qMax(1, parser.value(instancesOption).toInt());
+    const int duration = qMax(1, parser.value(durationOption).toInt());
+
+    if (parser.isSet(workerOption)) {
+        return runWorker(app, instances, duration);
+    }
+
+    FakeOptions fake;
+    fake.program = parser.value(fakeOption);
+    fake.latency = qMax(0, parser.value(latencyOption).toInt());
+    fake.failureRate = qBound(0, parser.value(failureRateOption).toInt(), 100);
+    fake.lines = qMax(0, parser.value(linesOption).toInt());
+    fake.churn = qBound(0, parser.value(churnOption).toInt(), 100);
+
+    const int processes = qBound(1, parser.value(processesOption).toInt(), instances);
+    return runTest(instances, processes, duration, fake, parser.isSet(jsonOption), parser.isSet(verboseOption));
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+import QtQuick 2.1
+import QtQuick.Layouts 1.1
+
+import org.kde.plasma.core 2.0 as PlasmaCore
+import org.kde.plasma.components 2.0 as Components
+import org.kde.plasma.extras 2.0 as PlasmaExtras
+
+import org.kde.plasma.private.lliurexquota 1.0
+
+/**
+ * Largest directories and files below the folder the scanner walks,
+ * updated while the scan runs, or the copies of files found below it.
+ */
+Item {
+    id: diskUsageView
+    property LliurexDiskScanner scanner
+    property LliurexDuplicateFinder duplicateFinder
+    property bool showDuplicates: false
+
+    RowLayout {
+        id: header
+        anchors {
+            top: parent.top
+            left: parent.left
+            right: parent.right
+        }
+
+        Components.ToolButton {
+            iconSource: "go-previous"
+            tooltip: i18n("Back to the quotas")
+            onClicked: {
+                showDuplicates = false
+                duplicateFinder.clear()
+                scanner.clear()
+            }
+        }
+        Components.Label {
+            Layout.fillWidth: true
+            elide: Text.ElideMiddle
+            text: scanner.rootPath
+        }
+        Components.ToolButton {
+            visible: showDuplicates ? duplicateFinder.running : scanner.running
+            iconSource: "process-stop"
+            tooltip: i18n("Stop scanning")
+            onClicked: showDuplicates ? duplicateFinder.cancel() : scanner.cancel()
+        }
+        Components.ToolButton {
+            iconSource: "edit-copy"
+            checkable: true
+            checked: showDuplicates
+            tooltip: i18n("Find copies of the same files")
+            onClicked: {
+                showDuplicates = checked
+                if (checked && duplicateFinder.rootPath != scanner.rootPath) {
+                    duplicateFinder.start(scanner.rootPath)
+                }
+            }
+        }
+        Components.ToolButton {
+            visible: lliurexDiskQuota.cleanUpToolInstalled
+            iconSource: "filelight"
+            tooltip: i18n("Open in Filelight")
+            onClicked: lliurexDiskQuota.openInFilelight(scanner.rootPath)
+        }
+    }
+
+    Components.Label {
+        id: progressLabel
+        anchors {
+            top: header.bottom
+            left: parent.left
+            right: parent.right
+        }
+        opacity: 0.6
+        text: {
+            if (showDuplicates) {
+                switch (duplicateFinder.phase) {
+                    case LliurexDuplicateFinder.ListingPhase:
+                        return i18n("Listing files: %1", duplicateFinder.candidateFiles)
+                    case LliurexDuplicateFinder.SamplingPhase:
+                        return i18n("Comparing %1 files of equal size: %2%", duplicateFinder.candidateFiles, duplicateFinder.progress)
+                    case LliurexDuplicateFinder.HashingPhase:
+                        return i18n("Reading %1 files: %2%", duplicateFinder.candidateFiles, duplicateFinder.progress)
+                }
+                return i18n("%1 can be freed by removing copies", duplicateFinder.reclaimableString)
+            }
+            var files = i18np("%1 file", "%1 files", scanner.scannedFiles)
+            var size = scanner.scannedSizeString
+            return scanner.running ? i18nc("e.g.: Scanning: 1200 files, 3 GiB", "Scanning: %1, %2", files, size)
+                                   : i18nc("e.g.: 1200 files, 3 GiB", "%1, %2", files, size)
+        }
+    }
+
+    PlasmaExtras.ScrollArea {
+        visible: !showDuplicates
+        anchors {
+            top: progressLabel.bottom
+            left: parent.left
+            right: parent.right
+            bottom: parent.bottom
+        }
+        ListView {
+            id: usageListView
+            model: scanner.model
+            boundsBehavior: Flickable.StopAtBounds
+            delegate: Components.ListItem {
+                width: usageListView.width
+                enabled: false
+
+                RowLayout {
+                    width: parent.width
+                    spacing: units.smallSpacing
+
+                    PlasmaCore.IconItem {
+                        source: model.isDirectory ? "folder" : "text-x-generic"
+                        Layout.alignment: Qt.AlignTop
+                        width: units.iconSizes.small
+                        height: width
+                    }
+                    Column {
+                        Layout.fillWidth: true
+                        RowLayout {
+                            width: parent.width
+                            Components.Label {
+                                Layout.fillWidth: true
+                                elide: Text.ElideMiddle
+                                text: model.name
+                            }
+                            Components.Label {
+                                text: model.sizeString
+                                opacity: 0.6
+                            }
+                        }
+                        Components.ProgressBar {
+                            width: parent.width
+                            value: model.share
+                            minimumValue: 0
+                            maximumValue: 100
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    PlasmaExtras.ScrollArea {
+        visible: showDuplicates
+        anchors {
+            top: progressLabel.bottom
+            left: parent.left
+            right: parent.right
+            bottom: parent.bottom
+        }
+        ListView {
+            id: duplicateListView
+            model: duplicateFinder.model
+            boundsBehavior: Flickable.StopAtBounds
+            delegate: Components.ListItem {
+                width: duplicateListView.width
+                enabled: false
+
+                Column {
+                    width: parent.width
+                    RowLayout {
+                        width: parent.width
+                        Components.Label {
+                            Layout.fillWidth: true
+                            elide: Text.ElideMiddle
+                            text: model.name
+                        }
+                        Components.Label {
+                            text: model.sizeString
+                            opacity: 0.6
+                        }
+                    }
+                    Components.Label {
+                        width: parent.width
+                        elide: Text.ElideMiddle
+                        text: model.reclaimableString
+                        opacity: 0.6
+                    }
+                    Repeater {
+                        model: paths
+                        Components.Label {
+                            width: parent.width
+                            elide: Text.ElideMiddle
+                            text: "  " + modelData
+                            opacity: 0.6
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -31,7 +31,10 @@ Components.ListItem {
     property string iconName
     property string usedString
     property string freeString
+    property string forecastString
+    property string reclaimableString
     property int usage
+    property bool confirmingPurge: false
 
     onContainsMouseChanged: {
         if (containsMouse) {
@@ -72,9 +75,73 @@ Components.ListItem {
                     Layout.fillWidth: true
                     height: paintedHeight
                     horizontalAlignment: Text.AlignRight
-                    text: freeString
+                    text: reclaimableString != "" ? i18nc("e.g.: 8 GiB free, 2 GiB reclaimable", "%1, %2", freeString, reclaimableString) : freeString
                     opacity: 0.6
                 }
+                Components.ToolButton {
+                    visible: reclaimableString != ""
+                    enabled: !lliurexDiskQuota.reclaimAnalyzer.purging
+                    iconSource: "edit-clear-history"
+                    tooltip: lliurexDiskQuota.reclaimAnalyzer.purging
+                             ? i18n("Emptying caches: %1%", lliurexDiskQuota.reclaimAnalyzer.purgeProgress)
+                             : i18n("Free space by emptying caches…")
+                    onClicked: confirmingPurge = !confirmingPurge
+                }
+            }
+            // nothing is removed before the user saw what
+            Column {
+                visible: confirmingPurge
+                width: parent.width
+                spacing: units.smallSpacing
+
+                Components.Label {
+                    width: parent.width
+                    wrapMode: Text.WordWrap
+                    text: i18n("These files will be removed for good:")
+                }
+                Repeater {
+                    model: confirmingPurge ? lliurexDiskQuota.reclaimAnalyzer.locations : []
+                    Components.Label {
+                        visible: !modelData.trash
+                        width: parent.width
+                        elide: Text.ElideRight
+                        text: i18nc("e.g.: Thumbnails of pictures and documents: 300 MiB", "%1: %2", modelData.name, modelData.sizeString)
+                        opacity: 0.6
+                    }
+                }
+                Components.CheckBox {
+                    id: purgeTrashBox
+                    property var trash: {
+                        var locations = lliurexDiskQuota.reclaimAnalyzer.locations
+                        for (var i = 0; i < locations.length; ++i) {
+                            if (locations[i].trash) {
+                                return locations[i]
+                            }
+                        }
+                        return null
+                    }
+                    visible: trash !== null
+                    checked: false
+                    text: trash !== null ? i18n("Empty the trash too (%1)", trash.sizeString) : ""
+                }
+                RowLayout {
+                    Components.Button {
+                        text: i18n("Remove")
+                        iconSource: "edit-clear-history"
+                        onClicked: {
+                            lliurexDiskQuota.purgeReclaimable(purgeTrashBox.checked)
+                            purgeTrashBox.checked = false
+                            confirmingPurge = false
+                        }
+                    }
+                    Components.Button {
+                        text: i18n("Cancel")
+                        onClicked: {
+                            purgeTrashBox.checked = false
+                            confirmingPurge = false
+                        }
+                    }
+                }
             }
             Components.ProgressBar {
                 width: parent.width
@@ -89,11 +156,21 @@ Components.ListItem {
                     }
                 }
             }
-            Components.Label {
-                height: paintedHeight
-                anchors.left: parent.left
-                text: usedString
-                opacity: 0.6
+            RowLayout {
+                width: parent.width
+                Components.Label {
+                    Layout.fillWidth: true
+                    height: paintedHeight
+                    text: usedString
+                    opacity: 0.6
+                }
+                Components.Label {
+                    visible: forecastString != ""
+                    height: paintedHeight
+                    horizontalAlignment: Text.AlignRight
+                    text: forecastString
+                    opacity: 0.6
+                }
             }
         }
     }
@@ -52,7 +52,9 @@ Item {
 
     Plasmoid.icon: lliurexDiskQuota.iconName
     Plasmoid.toolTipMainText: lliurexDiskQuota.toolTip
-    Plasmoid.toolTipSubText: lliurexDiskQuota.subToolTip
+    Plasmoid.toolTipSubText: lliurexDiskQuota.adminMode && lliurexDiskQuota.adminStatistics.toolTip
+                             ? lliurexDiskQuota.adminStatistics.toolTip
+                             : lliurexDiskQuota.subToolTip
 
     Component.onCompleted: plasmoid.removeAction("configure")
 
@@ -72,35 +74,125 @@ Item {
                 }
             }
         }
-        Components.Label {
-            visible: !lliurexDiskQuota.quotaInstalled || listView.count == 0
-            anchors.fill: parent
-            text: lliurexDiskQuota.quotaInstalled ? i18n("No quota restrictions found.") : i18n("Quota tool not found.\n\nPlease install 'lliurex-quota'.")
-            horizontalAlignment: Text.AlignHCenter
-            verticalAlignment: Text.AlignVCenter
+        RowLayout {
+            id: adminBar
+            visible: lliurexDiskQuota.adminAvailable
+            anchors {
+                top: parent.top
+                left: parent.left
+                right: parent.right
+            }
+
+            Components.ToolButton {
+                iconSource: "system-users"
+                checkable: true
+                checked: lliurexDiskQuota.adminMode
+                tooltip: i18n("Show the quotas of all users")
+                onClicked: lliurexDiskQuota.adminMode = checked
+            }
+            Components.TextField {
+                visible: lliurexDiskQuota.adminMode
+                Layout.fillWidth: true
+                placeholderText: i18n("Filter by user name or id")
+                clearButtonShown: true
+                onTextChanged: lliurexDiskQuota.adminModel.filterText = text
+            }
+            Components.ToolButton {
+                visible: lliurexDiskQuota.adminMode
+                text: lliurexDiskQuota.adminModel.sortKey == LliurexAdminQuotaModel.SortByName ? i18n("Name") : i18n("Usage")
+                tooltip: i18n("Sort by usage or by name")
+                onClicked: {
+                    var model = lliurexDiskQuota.adminModel
+                    if (model.sortKey == LliurexAdminQuotaModel.SortByName) {
+                        model.sortKey = LliurexAdminQuotaModel.SortByUsage
+                        model.sortOrder = Qt.DescendingOrder
+                    } else {
+                        model.sortKey = LliurexAdminQuotaModel.SortByName
+                        model.sortOrder = Qt.AscendingOrder
+                    }
+                }
+            }
         }
 
-        PlasmaExtras.ScrollArea {
-            anchors.fill: parent
-            ListView {
-                id: listView
-                model: lliurexDiskQuota.model
-                boundsBehavior: Flickable.StopAtBounds
-                highlight: Components.Highlight { }
-                highlightMoveDuration: 0
-                highlightResizeDuration: 0
-                currentIndex: -1
-                delegate: ListDelegateItem {
-                    enabled: lliurexDiskQuota.cleanUpToolInstalled
-                    width: listView.width
-                    mountPoint: model.mountPoint
-                    details: model.details
-                    iconName: model.icon
-                    usedString: model.used
-                    freeString: model.free
-                    usage: model.usage
+        Item {
+            id: contentArea
+            anchors {
+                top: adminBar.visible ? adminBar.bottom : parent.top
+                left: parent.left
+                right: parent.right
+                bottom: parent.bottom
+            }
+
+            Components.Label {
+                visible: !lliurexDiskQuota.adminMode && !diskUsageView.visible && (!lliurexDiskQuota.quotaInstalled || listView.count == 0)
+                anchors.fill: parent
+                text: lliurexDiskQuota.quotaInstalled ? i18n("No quota restrictions found.") : i18n("Quota tool not found.\n\nPlease install 'lliurex-quota'.")
+                horizontalAlignment: Text.AlignHCenter
+                verticalAlignment: Text.AlignVCenter
+            }
+
+            PlasmaExtras.ScrollArea {
+                visible: !lliurexDiskQuota.adminMode && !diskUsageView.visible
+                anchors.fill: parent
+                ListView {
+                    id: listView
+                    model: lliurexDiskQuota.model
+                    // last session's data until the first poll delivered
+                    opacity: lliurexDiskQuota.stale ? 0.6 : 1.0
+                    boundsBehavior: Flickable.StopAtBounds
+                    highlight: Components.Highlight { }
+                    highlightMoveDuration: 0
+                    highlightResizeDuration: 0
+                    currentIndex: -1
+                    delegate: ListDelegateItem {
+                        width: listView.width
+                        mountPoint: model.mountPoint
+                        details: model.details
+                        iconName: model.icon
+                        usedString: model.used
+                        freeString: model.free
+                        forecastString: model.forecast
+                        reclaimableString: model.reclaimable
+                        usage: model.usage
+                    }
                 }
             }
+
+            PlasmaExtras.ScrollArea {
+                visible: lliurexDiskQuota.adminMode
+                anchors.fill: parent
+                ListView {
+                    id: adminListView
+                    // rows are fetched in batches by the model while scrolling
+                    model: lliurexDiskQuota.adminMode ? lliurexDiskQuota.adminModel : null
+                    boundsBehavior: Flickable.StopAtBounds
+                    // thousands of rows: drawn by a few scene graph nodes each
+                    delegate: LliurexQuotaRowItem {
+                        width: adminListView.width
+                        padding: units.smallSpacing
+                        spacing: units.gridUnit
+                        iconSize: units.iconSizes.medium
+                        font: theme.defaultFont
+                        textColor: theme.textColor
+                        barColor: theme.highlightColor
+                        trackColor: Qt.rgba(theme.textColor.r, theme.textColor.g, theme.textColor.b, 0.2)
+                        title: model.name
+                        note: model.overSoftLimit ? i18n("Over the limit") : ""
+                        subtitle: model.used
+                        iconName: model.icon
+                        usage: model.usage
+                    }
+                }
+            }
+
+            // what uses the space of the quota clicked in the list
+            DiskUsageView {
+                id: diskUsageView
+                visible: !lliurexDiskQuota.adminMode && lliurexDiskQuota.scanner.rootPath != ""
+                anchors.fill: parent
+                scanner: lliurexDiskQuota.scanner
+                duplicateFinder: lliurexDiskQuota.duplicateFinder
+            }
         }
     }
 }
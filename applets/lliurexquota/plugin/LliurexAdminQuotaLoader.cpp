@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexAdminQuotaLoader.h"
+#include "LliurexDBusQuotaBackend.h"
+#include "LliurexQuotaDBus.h"
+#include "LliurexQuotactlBackend.h"
+
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QtConcurrent>
+
+#include <unistd.h>
+
+static QVector<LliurexQuotaEntry> sweepAllUsers()
+{
+    const QVector<LliurexQuotactlBackend::Mount> mounts = LliurexQuotactlBackend::quotaMounts();
+    return LliurexQuotactlBackend::sweepQuota(mounts, LliurexQuotaEntry::UserQuota);
+}
+
+LliurexAdminQuotaLoader::LliurexAdminQuotaLoader(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFutureWatcher<QVector<LliurexQuotaEntry>>(this))
+{
+    LliurexQuotaDBus::registerTypes();
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &LliurexAdminQuotaLoader::sweepFinished);
+}
+
+bool LliurexAdminQuotaLoader::isAvailable() const
+{
+    return m_available;
+}
+
+void LliurexAdminQuotaLoader::setAvailable(bool available)
+{
+    if (m_available != available) {
+        m_available = available;
+        emit availableChanged();
+    }
+}
+
+bool LliurexAdminQuotaLoader::sweepLocally() const
+{
+    // only root may sweep, and only without the service doing it already
+    return geteuid() == 0 && !LliurexDBusQuotaBackend::serviceAvailable();
+}
+
+void LliurexAdminQuotaLoader::checkAvailable()
+{
+    if (m_checkCall) {
+        return;
+    }
+
+    if (sweepLocally()) {
+        setAvailable(!LliurexQuotactlBackend::quotaMounts().isEmpty());
+        return;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::objectPath,
+                                                          LliurexQuotaDBus::interfaceName, QStringLiteral("CanListAllQuotas"));
+    m_checkCall = new QDBusPendingCallWatcher(LliurexQuotaDBus::bus().asyncCall(message), this);
+    connect(m_checkCall, &QDBusPendingCallWatcher::finished, this, &LliurexAdminQuotaLoader::checkFinished);
+}
+
+void LliurexAdminQuotaLoader::checkFinished(QDBusPendingCallWatcher *call)
+{
+    m_checkCall = nullptr;
+    call->deleteLater();
+
+    const QDBusPendingReply<bool> reply = *call;
+    setAvailable(!reply.isError() && reply.value());
+}
+
+void LliurexAdminQuotaLoader::requestQuota()
+{
+    if (m_pendingCall || m_watcher->isRunning()) {
+        return;
+    }
+
+    if (sweepLocally()) {
+        m_watcher->setFuture(QtConcurrent::run(&sweepAllUsers));
+        return;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::objectPath,
+                                                          LliurexQuotaDBus::interfaceName, QStringLiteral("GetAllQuotas"));
+    m_pendingCall = new QDBusPendingCallWatcher(LliurexQuotaDBus::bus().asyncCall(message), this);
+    connect(m_pendingCall, &QDBusPendingCallWatcher::finished, this, &LliurexAdminQuotaLoader::callFinished);
+}
+
+void LliurexAdminQuotaLoader::callFinished(QDBusPendingCallWatcher *call)
+{
+    m_pendingCall = nullptr;
+    call->deleteLater();
+
+    const QDBusPendingReply<QVector<LliurexQuotaEntry>> reply = *call;
+    if (reply.isError()) {
+        // e.g. removed from the admin group, or the service is gone
+        setAvailable(false);
+        emit quotaFailed(reply.error().message());
+        return;
+    }
+
+    emit quotaReady(reply.value());
+}
+
+void LliurexAdminQuotaLoader::sweepFinished()
+{
+    emit quotaReady(m_watcher->result());
+}
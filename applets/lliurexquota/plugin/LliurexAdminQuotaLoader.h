@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_ADMIN_QUOTA_LOADER_H
+#define PLASMA_LLIUREX_ADMIN_QUOTA_LOADER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+class QDBusPendingCallWatcher;
+
+/**
+ * Fetches the user quotas of all users for the administrator view.
+ *
+ * The data comes from GetAllQuotas() of the quota service, which only
+ * answers root and members of its admin groups. If the service is not
+ * present and the applet runs as root, the quotas are swept locally with
+ * Q_GETNEXTQUOTA on a worker thread instead.
+ */
+class LliurexAdminQuotaLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    LliurexAdminQuotaLoader(QObject *parent = nullptr);
+
+    /**
+     * Returns true if the caller may list all quotas, as found out by
+     * the last checkAvailable().
+     */
+    bool isAvailable() const;
+
+    /**
+     * Asks the service whether the caller may list all quotas.
+     * Emits availableChanged() if the answer changed.
+     */
+    void checkAvailable();
+
+    /**
+     * Starts fetching all quotas, and finally emits quotaReady() or
+     * quotaFailed(). Does nothing while a request is running.
+     */
+    void requestQuota();
+
+Q_SIGNALS:
+    void availableChanged();
+    void quotaReady(const QVector<LliurexQuotaEntry> &entries);
+    void quotaFailed(const QString &reason);
+
+private Q_SLOTS:
+    void checkFinished(QDBusPendingCallWatcher *call);
+    void callFinished(QDBusPendingCallWatcher *call);
+    void sweepFinished();
+
+private:
+    void setAvailable(bool available);
+    bool sweepLocally() const;
+
+    QDBusPendingCallWatcher *m_checkCall = nullptr;
+    QDBusPendingCallWatcher *m_pendingCall = nullptr;
+    QFutureWatcher<QVector<LliurexQuotaEntry>> *m_watcher = nullptr;
+    bool m_available = false;
+};
+
+#endif // PLASMA_LLIUREX_ADMIN_QUOTA_LOADER_H
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexAdminQuotaModel.h"
+
+#include <KLocalizedString>
+
+#include <algorithm>
+
+namespace {
+    // rows handed out to the view per fetchMore()
+    const int FetchBatchSize = 200;
+
+    /**
+     * QML data roles.
+     */
+    enum {
+        NameRole = Qt::UserRole,
+        IdRole,
+        MountPointRole,
+        UsageRole,
+        UsedRole,
+        LimitRole,
+        UsedStringRole,
+        IconRole,
+        OverSoftLimitRole,
+        GraceTimeRole
+    };
+}
+
+LliurexAdminQuotaModel::LliurexAdminQuotaModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QHash<int, QByteArray> LliurexAdminQuotaModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[IdRole] = "uid";
+    roles[MountPointRole] = "mountPoint";
+    roles[UsageRole] = "usage";
+    roles[UsedRole] = "usedBytes";
+    roles[LimitRole] = "limitBytes";
+    roles[UsedStringRole] = "used";
+    roles[IconRole] = "icon";
+    roles[OverSoftLimitRole] = "overSoftLimit";
+    roles[GraceTimeRole] = "graceTime";
+
+    return roles;
+}
+
+QVariant LliurexAdminQuotaModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid() || index.row() >= m_fetched) {
+        return QVariant();
+    }
+
+    const LliurexQuotaEntry &entry = m_entries.at(m_rows.at(index.row()));
+
+    switch (role) {
+        case NameRole: return entry.name.isEmpty() ? QString::number(entry.id) : entry.name;
+        case IdRole: return entry.id;
+        case MountPointRole: return entry.mountPoint;
+        case UsageRole: return entry.usage();
+        case UsedRole: return entry.used;
+        case LimitRole: return entry.limit();
+        case UsedStringRole:
+            return i18nc("e.g.: 12 GiB of 20 GiB", "%1 of %2",
+                         m_formatter.formatByteSize(entry.used), m_formatter.formatByteSize(entry.limit()));
+        case IconRole: return LliurexQuotaFormatter::iconNameForQuota(entry.usage());
+        case OverSoftLimitRole: return entry.softLimit > 0 && entry.used > entry.softLimit;
+        case GraceTimeRole: return entry.graceTime;
+    }
+
+    return QVariant();
+}
+
+int LliurexAdminQuotaModel::rowCount(const QModelIndex &index) const
+{
+    if (! index.isValid()) {
+        return m_fetched;
+    }
+
+    return 0;
+}
+
+bool LliurexAdminQuotaModel::canFetchMore(const QModelIndex &parent) const
+{
+    return ! parent.isValid() && m_fetched < m_rows.size();
+}
+
+void LliurexAdminQuotaModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const int count = qMin(FetchBatchSize, m_rows.size() - m_fetched);
+    if (count <= 0) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_fetched, m_fetched + count - 1);
+    m_fetched += count;
+    endInsertRows();
+}
+
+LliurexAdminQuotaModel::SortKey LliurexAdminQuotaModel::sortKey() const
+{
+    return m_sortKey;
+}
+
+void LliurexAdminQuotaModel::setSortKey(SortKey key)
+{
+    if (m_sortKey != key) {
+        m_sortKey = key;
+        rebuild();
+        emit sortKeyChanged();
+    }
+}
+
+Qt::SortOrder LliurexAdminQuotaModel::sortOrder() const
+{
+    return m_sortOrder;
+}
+
+void LliurexAdminQuotaModel::setSortOrder(Qt::SortOrder order)
+{
+    if (m_sortOrder != order) {
+        m_sortOrder = order;
+        rebuild();
+        emit sortOrderChanged();
+    }
+}
+
+QString LliurexAdminQuotaModel::filterText() const
+{
+    return m_filterText;
+}
+
+void LliurexAdminQuotaModel::setFilterText(const QString &text)
+{
+    if (m_filterText != text) {
+        m_filterText = text;
+        rebuild();
+        emit filterTextChanged();
+    }
+}
+
+int LliurexAdminQuotaModel::totalCount() const
+{
+    return m_rows.size();
+}
+
+bool LliurexAdminQuotaModel::lessThan(int a, int b) const
+{
+    const LliurexQuotaEntry &left = m_entries.at(a);
+    const LliurexQuotaEntry &right = m_entries.at(b);
+
+    qint64 leftValue = 0;
+    qint64 rightValue = 0;
+    switch (m_sortKey) {
+        case SortByUsage:
+            leftValue = left.usage();
+            rightValue = right.usage();
+            break;
+        case SortByUsed:
+            leftValue = left.used;
+            rightValue = right.used;
+            break;
+        case SortByName:
+            break;
+    }
+
+    if (leftValue != rightValue) {
+        return m_sortOrder == Qt::AscendingOrder ? leftValue < rightValue : leftValue > rightValue;
+    }
+
+    // ties and name sorting: by name, then by id for a stable order
+    const int result = QString::compare(left.name, right.name, Qt::CaseInsensitive);
+    if (result != 0) {
+        return (m_sortKey != SortByName || m_sortOrder == Qt::AscendingOrder) ? result < 0 : result > 0;
+    }
+    return left.id != right.id ? left.id < right.id : a < b;
+}
+
+QVector<int> LliurexAdminQuotaModel::sortedRows() const
+{
+    QVector<int> rows;
+    rows.reserve(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const LliurexQuotaEntry &entry = m_entries.at(i);
+        if (m_filterText.isEmpty()
+            || entry.name.contains(m_filterText, Qt::CaseInsensitive)
+            || QString::number(entry.id).startsWith(m_filterText)) {
+            rows.append(i);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [this](int a, int b) {
+        return lessThan(a, b);
+    });
+    return rows;
+}
+
+void LliurexAdminQuotaModel::rebuild()
+{
+    beginResetModel();
+    m_rows = sortedRows();
+    m_fetched = qMin(FetchBatchSize, m_rows.size());
+    endResetModel();
+    emit totalCountChanged();
+}
+
+void LliurexAdminQuotaModel::clear()
+{
+    beginResetModel();
+    m_entries.clear();
+    m_entryIndex.clear();
+    m_rows.clear();
+    m_fetched = 0;
+    endResetModel();
+    emit totalCountChanged();
+}
+
+void LliurexAdminQuotaModel::setEntries(const QVector<LliurexQuotaEntry> &entries)
+{
+    // the common case: the same users as before, some with new numbers
+    bool sameUsers = entries.size() == m_entries.size();
+    for (int i = 0; sameUsers && i < entries.size(); ++i) {
+        sameUsers = m_entryIndex.contains(entries[i].key());
+    }
+
+    if (!sameUsers) {
+        m_entries = entries;
+        m_entryIndex.clear();
+        m_entryIndex.reserve(m_entries.size());
+        for (int i = 0; i < m_entries.size(); ++i) {
+            m_entryIndex.insert(m_entries[i].key(), i);
+        }
+        rebuild();
+        return;
+    }
+
+    // update in place, so that the indices in m_rows stay valid
+    QVector<int> changed;
+    for (const LliurexQuotaEntry &entry : entries) {
+        const int i = m_entryIndex.value(entry.key());
+        if (m_entries[i] != entry) {
+            m_entries[i] = entry;
+            changed.append(i);
+        }
+    }
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    const QVector<int> rows = sortedRows();
+    if (rows.size() != m_rows.size()) {
+        rebuild();
+        return;
+    }
+
+    if (rows == m_rows) {
+        // same order: only signal the fetched rows that changed
+        QVector<int> rowOfEntry(m_entries.size(), -1);
+        for (int row = 0; row < m_fetched; ++row) {
+            rowOfEntry[m_rows[row]] = row;
+        }
+        for (int i : qAsConst(changed)) {
+            const int row = rowOfEntry[i];
+            if (row >= 0) {
+                const QModelIndex index = createIndex(row, 0);
+                emit dataChanged(index, index);
+            }
+        }
+        return;
+    }
+
+    // new order: move the persistent indices along with their users
+    emit layoutAboutToBeChanged();
+    QVector<int> newRowOfEntry(m_entries.size(), -1);
+    for (int row = 0; row < rows.size(); ++row) {
+        newRowOfEntry[rows[row]] = row;
+    }
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex &index : oldIndexes) {
+        const int newRow = newRowOfEntry[m_rows[index.row()]];
+        newIndexes.append(newRow >= 0 && newRow < m_fetched ? createIndex(newRow, 0) : QModelIndex());
+    }
+    m_rows = rows;
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged();
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_ADMIN_QUOTA_MODEL_H
+#define PLASMA_LLIUREX_ADMIN_QUOTA_MODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaFormatter.h"
+
+/**
+ * Data model with the quotas of all users, for the administrator view.
+ *
+ * The full data set, often tens of thousands of users, is kept in C++ and
+ * sorted and filtered there. Rows are handed out to the view in batches
+ * through canFetchMore()/fetchMore(), so a ListView only ever creates the
+ * delegates it scrolls to. On refresh, rows keep their place if the order
+ * did not change, and only rows whose data changed are signalled.
+ */
+class LliurexAdminQuotaModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(SortKey sortKey READ sortKey WRITE setSortKey NOTIFY sortKeyChanged)
+    Q_PROPERTY(Qt::SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortOrderChanged)
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
+
+    Q_ENUMS(SortKey)
+
+public:
+    /**
+     * Columns the rows can be sorted by.
+     */
+    enum SortKey {
+        SortByUsage = 0,
+        SortByUsed,
+        SortByName
+    };
+
+    LliurexAdminQuotaModel(QObject *parent = nullptr);
+
+public: // QAbstractListModel overrides
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+public:
+    SortKey sortKey() const;
+    void setSortKey(SortKey key);
+
+    Qt::SortOrder sortOrder() const;
+    void setSortOrder(Qt::SortOrder order);
+
+    /**
+     * Only users whose name or id contains @p text are shown.
+     */
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+    /**
+     * Number of rows matching the filter, including rows not fetched yet.
+     */
+    int totalCount() const;
+
+    /**
+     * Replaces the data set with @p entries, keeping unchanged rows.
+     */
+    void setEntries(const QVector<LliurexQuotaEntry> &entries);
+
+    /**
+     * Removes all rows.
+     */
+    void clear();
+
+Q_SIGNALS:
+    void sortKeyChanged();
+    void sortOrderChanged();
+    void filterTextChanged();
+    void totalCountChanged();
+
+private:
+    /**
+     * Returns the entry indices matching the filter, in sort order.
+     */
+    QVector<int> sortedRows() const;
+    bool lessThan(int a, int b) const;
+    void rebuild();
+
+    QVector<LliurexQuotaEntry> m_entries;
+    QHash<QString, int> m_entryIndex;   // key() -> index in m_entries
+    QVector<int> m_rows;                // visible rows, indices into m_entries
+    int m_fetched = 0;                  // number of rows handed out to the view
+    SortKey m_sortKey = SortByUsage;
+    Qt::SortOrder m_sortOrder = Qt::DescendingOrder;
+    QString m_filterText;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_ADMIN_QUOTA_MODEL_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexAdminStatistics.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace {
+    // groups named in the tooltip
+    const int ToolTipGroups = 3;
+}
+
+LliurexAdminStatistics::LliurexAdminStatistics(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int LliurexAdminStatistics::userCount() const
+{
+    return m_aggregates.count();
+}
+
+int LliurexAdminStatistics::overSoftLimit() const
+{
+    return m_aggregates.overSoftLimit();
+}
+
+int LliurexAdminStatistics::overHardLimit() const
+{
+    return m_aggregates.overHardLimit();
+}
+
+int LliurexAdminStatistics::inGrace() const
+{
+    return m_inGrace;
+}
+
+int LliurexAdminStatistics::usageMedian() const
+{
+    return m_aggregates.usagePercentile(50);
+}
+
+int LliurexAdminStatistics::usageP90() const
+{
+    return m_aggregates.usagePercentile(90);
+}
+
+int LliurexAdminStatistics::usageP99() const
+{
+    return m_aggregates.usagePercentile(99);
+}
+
+QVariantList LliurexAdminStatistics::groupTotals() const
+{
+    return m_groupTotals;
+}
+
+QString LliurexAdminStatistics::toolTip() const
+{
+    return m_toolTip;
+}
+
+void LliurexAdminStatistics::setEntries(const QVector<LliurexQuotaEntry> &entries)
+{
+    m_aggregates.apply(entries);
+    update();
+}
+
+void LliurexAdminStatistics::clear()
+{
+    if (m_aggregates.count() == 0) {
+        return;
+    }
+    m_aggregates.clear();
+    update();
+}
+
+void LliurexAdminStatistics::update()
+{
+    m_inGrace = m_aggregates.inGrace(QDateTime::currentMSecsSinceEpoch() / 1000);
+
+    const QVector<LliurexQuotaAggregates::GroupTotals> totals = m_aggregates.groupTotals();
+    m_groupTotals.clear();
+    QStringList topGroups;
+    for (const LliurexQuotaAggregates::GroupTotals &group : totals) {
+        const QString usedString = m_formatter.formatByteSize(group.used);
+        QVariantMap map;
+        map.insert(QStringLiteral("group"), group.group);
+        map.insert(QStringLiteral("quotas"), group.quotas);
+        map.insert(QStringLiteral("used"), group.used);
+        map.insert(QStringLiteral("usedString"), usedString);
+        map.insert(QStringLiteral("limit"), group.limit);
+        map.insert(QStringLiteral("overSoftLimit"), group.overSoftLimit);
+        m_groupTotals.append(map);
+
+        if (topGroups.size() < ToolTipGroups && !group.group.isEmpty()) {
+            topGroups.append(i18nc("e.g.: students: 1.2 TiB", "%1: %2", group.group, usedString));
+        }
+    }
+
+    const int count = m_aggregates.count();
+    if (count == 0) {
+        m_toolTip.clear();
+    } else {
+        m_toolTip = i18ncp("e.g.: 250 users, median 41% used, 12 over the soft limit (3 in grace), 2 at the hard limit",
+                           "%1 user, median %2% used, %3 over the soft limit (%4 in grace), %5 at the hard limit",
+                           "%1 users, median %2% used, %3 over the soft limit (%4 in grace), %5 at the hard limit",
+                           count, usageMedian(), overSoftLimit(), m_inGrace, overHardLimit());
+        if (!topGroups.isEmpty()) {
+            m_toolTip += QLatin1Char('\n') + topGroups.join(QStringLiteral(", "));
+        }
+    }
+
+    emit changed();
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_ADMIN_STATISTICS_H
+#define PLASMA_LLIUREX_ADMIN_STATISTICS_H
+
+#include <QObject>
+#include <QVariantList>
+#include <QVector>
+
+#include "LliurexQuotaAggregates.h"
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaFormatter.h"
+
+/**
+ * Statistics over the quotas of all users for the administrator mode,
+ * kept up to date from every list of all users in a
+ * LliurexQuotaAggregates store.
+ */
+class LliurexAdminStatistics : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int userCount READ userCount NOTIFY changed)
+    Q_PROPERTY(int overSoftLimit READ overSoftLimit NOTIFY changed)
+    Q_PROPERTY(int overHardLimit READ overHardLimit NOTIFY changed)
+    Q_PROPERTY(int inGrace READ inGrace NOTIFY changed)
+    Q_PROPERTY(int usageMedian READ usageMedian NOTIFY changed)
+    Q_PROPERTY(int usageP90 READ usageP90 NOTIFY changed)
+    Q_PROPERTY(int usageP99 READ usageP99 NOTIFY changed)
+    Q_PROPERTY(QVariantList groupTotals READ groupTotals NOTIFY changed)
+    Q_PROPERTY(QString toolTip READ toolTip NOTIFY changed)
+
+public:
+    explicit LliurexAdminStatistics(QObject *parent = nullptr);
+
+    /**
+     * Number of quotas of all users.
+     */
+    int userCount() const;
+
+    int overSoftLimit() const;
+    int overHardLimit() const;
+
+    /**
+     * Quotas over their soft limit whose grace period did not run out,
+     * as of the last list.
+     */
+    int inGrace() const;
+
+    /**
+     * Usage in percent that half, 90% and 99% of the quotas do not exceed.
+     */
+    int usageMedian() const;
+    int usageP90() const;
+    int usageP99() const;
+
+    /**
+     * One map per group, largest usage first, with the keys 'group',
+     * 'quotas', 'used', 'usedString', 'limit' and 'overSoftLimit'.
+     */
+    QVariantList groupTotals() const;
+
+    /**
+     * Summary for the tooltip of the applet, e.g.
+     * '250 users, median 41% used, 12 over the soft limit (3 in grace)'.
+     */
+    QString toolTip() const;
+
+public Q_SLOTS:
+    /**
+     * Updates the statistics from the quotas of all users.
+     */
+    void setEntries(const QVector<LliurexQuotaEntry> &entries);
+
+    void clear();
+
+Q_SIGNALS:
+    void changed();
+
+private:
+    void update();
+
+    LliurexQuotaAggregates m_aggregates;
+    LliurexQuotaFormatter m_formatter;
+    int m_inGrace = 0;
+    QVariantList m_groupTotals;
+    QString m_toolTip;
+};
+
+#endif // PLASMA_LLIUREX_ADMIN_STATISTICS_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexCircuitBreaker.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTimer>
+
+namespace {
+    // time a half-open probe may take before it counts as failed
+    const int ProbeTimeout = 60 * 1000;
+}
+
+LliurexCircuitBreaker::LliurexCircuitBreaker(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_random(quint32(QDateTime::currentMSecsSinceEpoch()) ^ quint32(QCoreApplication::applicationPid()))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::CoarseTimer);
+    connect(m_timer, &QTimer::timeout, this, &LliurexCircuitBreaker::timeout);
+}
+
+LliurexCircuitBreaker::State LliurexCircuitBreaker::state() const
+{
+    return m_state;
+}
+
+void LliurexCircuitBreaker::setState(State state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged();
+    }
+}
+
+void LliurexCircuitBreaker::setFailureThreshold(int failures)
+{
+    m_failureThreshold = qMax(1, failures);
+}
+
+void LliurexCircuitBreaker::setBackoff(int initial, int maximum)
+{
+    m_initialBackoff = qMax(1, initial);
+    m_maximumBackoff = qMax(m_initialBackoff, maximum);
+}
+
+bool LliurexCircuitBreaker::allowRequest()
+{
+    switch (m_state) {
+        case Closed:
+            return true;
+        case Open:
+            return false;
+        case HalfOpen:
+            if (m_probing) {
+                return false;
+            }
+            m_probing = true;
+            m_timer->start(ProbeTimeout);
+            return true;
+    }
+    return false;
+}
+
+void LliurexCircuitBreaker::recordSuccess()
+{
+    m_failures = 0;
+    m_backoff = 0;
+    m_probing = false;
+    m_timer->stop();
+    setState(Closed);
+}
+
+void LliurexCircuitBreaker::recordFailure()
+{
+    ++m_failures;
+
+    if (m_state == HalfOpen) {
+        // the probe failed: back off longer
+        m_backoff = m_backoff > m_maximumBackoff / 2 ? m_maximumBackoff : 2 * m_backoff;
+        open();
+    } else if (m_state == Closed && m_failures >= m_failureThreshold) {
+        m_backoff = m_initialBackoff;
+        open();
+    }
+}
+
+void LliurexCircuitBreaker::open()
+{
+    m_probing = false;
+
+    // "equal jitter": at least half the backoff, at most all of it
+    const int half = m_backoff / 2;
+    const int delay = half + std::uniform_int_distribution<int>(0, m_backoff - half)(m_random);
+    m_timer->start(delay);
+
+    setState(Open);
+}
+
+void LliurexCircuitBreaker::timeout()
+{
+    if (m_state == Open) {
+        m_probing = false;
+        setState(HalfOpen);
+        emit probeDue();
+    } else if (m_state == HalfOpen && m_probing) {
+        // the probe never answered
+        recordFailure();
+    }
+}
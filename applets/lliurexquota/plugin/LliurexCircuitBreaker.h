@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_CIRCUIT_BREAKER_H
+#define PLASMA_LLIUREX_CIRCUIT_BREAKER_H
+
+#include <QObject>
+
+#include <random>
+
+class QTimer;
+
+/**
+ * Stops polling a quota source that keeps failing.
+ *
+ * While closed, every request is let through. After a few consecutive
+ * failures the breaker opens and rejects all requests for a backoff time,
+ * which doubles on every further failure up to a maximum and is jittered,
+ * so that the clients of a sick server do not come back all at once. When
+ * the backoff elapsed, the breaker is half-open: probeDue() is emitted and
+ * exactly one probe request is let through. Its success closes the breaker,
+ * its failure (or no answer at all) opens it again.
+ */
+class LliurexCircuitBreaker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Closed = 0,
+        Open,
+        HalfOpen
+    };
+
+    LliurexCircuitBreaker(QObject *parent = nullptr);
+
+    State state() const;
+
+    /**
+     * Number of consecutive failures before the breaker opens.
+     */
+    void setFailureThreshold(int failures);
+
+    /**
+     * Backoff in milliseconds after the breaker opened for the first
+     * time, and the maximum it grows to.
+     */
+    void setBackoff(int initial, int maximum);
+
+    /**
+     * Returns true if a request may be sent now. In the half-open state
+     * this returns true once, for the probe.
+     */
+    bool allowRequest();
+
+    /**
+     * Report the outcome of a request.
+     */
+    void recordSuccess();
+    void recordFailure();
+
+Q_SIGNALS:
+    void stateChanged();
+
+    /**
+     * Emitted when the backoff elapsed and a probe request is welcome.
+     */
+    void probeDue();
+
+private Q_SLOTS:
+    void timeout();
+
+private:
+    void open();
+    void setState(State state);
+
+    QTimer *m_timer = nullptr;
+    std::mt19937 m_random;
+    State m_state = Closed;
+    int m_failures = 0;
+    int m_failureThreshold = 3;
+    int m_initialBackoff = 60 * 1000;
+    int m_maximumBackoff = 30 * 60 * 1000;
+    int m_backoff = 0;
+    bool m_probing = false;
+};
+
+#endif // PLASMA_LLIUREX_CIRCUIT_BREAKER_H
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDBusQuotaBackend.h"
+#include "LliurexQuotaDBus.h"
+
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusReply>
+#include <QDBusServiceWatcher>
+#include <QStringList>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * Ids the service announces changes for, 'u<uid>' and 'g<gid>' for
+     * the user and all groups of this process.
+     */
+    QStringList ownQuotaIds()
+    {
+        QStringList ids{QLatin1Char('u') + QString::number(getuid())};
+
+        const int count = getgroups(0, nullptr);
+        QVector<gid_t> gids(qMax(count, 0));
+        const int n = count > 0 ? getgroups(count, gids.data()) : 0;
+        gids.resize(qMax(n, 0));
+        if (!gids.contains(getgid())) {
+            gids.append(getgid());
+        }
+        for (gid_t gid : gids) {
+            ids.append(QLatin1Char('g') + QString::number(gid));
+        }
+        return ids;
+    }
+}
+
+LliurexDBusQuotaBackend::LliurexDBusQuotaBackend(LliurexQuotaBackend *fallback, QObject *parent)
+    : LliurexQuotaBackend(parent)
+    , m_fallback(fallback)
+{
+    LliurexQuotaDBus::registerTypes();
+
+    m_fallback->setParent(this);
+    connect(m_fallback, &LliurexQuotaBackend::quotaReady, this, [this](const QVector<LliurexQuotaEntry> &entries) {
+        if (usesFallback()) {
+            emit quotaReady(entries);
+        }
+    });
+    connect(m_fallback, &LliurexQuotaBackend::quotaUnchanged, this, [this]() {
+        if (usesFallback()) {
+            emit quotaUnchanged();
+        }
+    });
+    connect(m_fallback, &LliurexQuotaBackend::quotaFailed, this, [this](const QString &reason) {
+        if (usesFallback()) {
+            emit quotaFailed(reason);
+        }
+    });
+
+    m_serviceWatcher = new QDBusServiceWatcher(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::bus(),
+                                               QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &LliurexDBusQuotaBackend::serviceRegistered);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &LliurexDBusQuotaBackend::serviceUnregistered);
+
+    // the fallback answers until the bus daemon told whether the service is there
+    checkService();
+}
+
+QString LliurexDBusQuotaBackend::name() const
+{
+    return usesFallback() ? m_fallback->name() : QStringLiteral("dbus");
+}
+
+bool LliurexDBusQuotaBackend::isAvailable() const
+{
+    return !usesFallback() || m_fallback->isAvailable();
+}
+
+bool LliurexDBusQuotaBackend::pushesUpdates() const
+{
+    return !usesFallback();
+}
+
+bool LliurexDBusQuotaBackend::usesFallback() const
+{
+    return !m_servicePresent || m_serviceEmpty;
+}
+
+bool LliurexDBusQuotaBackend::serviceAvailable()
+{
+    QDBusConnectionInterface *interface = LliurexQuotaDBus::bus().interface();
+    if (!interface) {
+        return false;
+    }
+    if (interface->isServiceRegistered(LliurexQuotaDBus::serviceName)) {
+        return true;
+    }
+    const QDBusReply<QStringList> activatable = interface->activatableServiceNames();
+    return activatable.isValid() && activatable.value().contains(LliurexQuotaDBus::serviceName);
+}
+
+void LliurexDBusQuotaBackend::checkService()
+{
+    // a check still running asked before the last change of the owner
+    delete m_checkCall;
+    m_checkCall = callBus(QStringLiteral("NameHasOwner"), {QString(LliurexQuotaDBus::serviceName)});
+    connect(m_checkCall, &QDBusPendingCallWatcher::finished, this, &LliurexDBusQuotaBackend::ownerChecked);
+}
+
+QDBusPendingCallWatcher *LliurexDBusQuotaBackend::callBus(const QString &method, const QVariantList &arguments)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.DBus"),
+                                                          QStringLiteral("/org/freedesktop/DBus"),
+                                                          QStringLiteral("org.freedesktop.DBus"), method);
+    message.setArguments(arguments);
+    return new QDBusPendingCallWatcher(LliurexQuotaDBus::bus().asyncCall(message), this);
+}
+
+void LliurexDBusQuotaBackend::ownerChecked(QDBusPendingCallWatcher *call)
+{
+    m_checkCall = nullptr;
+    call->deleteLater();
+
+    const QDBusPendingReply<bool> reply = *call;
+    if (!reply.isError() && reply.value()) {
+        setServicePresent(true);
+        return;
+    }
+
+    // not running now, but the bus daemon starts it on the first call
+    m_checkCall = callBus(QStringLiteral("ListActivatableNames"), {});
+    connect(m_checkCall, &QDBusPendingCallWatcher::finished, this, &LliurexDBusQuotaBackend::activatableChecked);
+}
+
+void LliurexDBusQuotaBackend::activatableChecked(QDBusPendingCallWatcher *call)
+{
+    m_checkCall = nullptr;
+    call->deleteLater();
+
+    const QDBusPendingReply<QStringList> reply = *call;
+    setServicePresent(!reply.isError() && reply.value().contains(LliurexQuotaDBus::serviceName));
+}
+
+void LliurexDBusQuotaBackend::requestQuota()
+{
+    if (usesFallback()) {
+        m_fallback->requestQuota();
+        return;
+    }
+
+    // one outstanding call is enough, its answer is the most recent data anyway
+    if (m_pendingCall) {
+        return;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::objectPath,
+                                                          LliurexQuotaDBus::interfaceName, QStringLiteral("GetQuota"));
+    m_pendingCall = new QDBusPendingCallWatcher(LliurexQuotaDBus::bus().asyncCall(message), this);
+    connect(m_pendingCall, &QDBusPendingCallWatcher::finished, this, &LliurexDBusQuotaBackend::callFinished);
+}
+
+void LliurexDBusQuotaBackend::callFinished(QDBusPendingCallWatcher *call)
+{
+    m_pendingCall = nullptr;
+    call->deleteLater();
+
+    const QDBusPendingReply<QVector<LliurexQuotaEntry>> reply = *call;
+    if (reply.isError()) {
+        // the service went away or is broken: poll locally until it is back
+        setServicePresent(false);
+        m_fallback->requestQuota();
+        return;
+    }
+
+    if (reply.value().isEmpty()) {
+        // the service only reads local file systems, the quota of this user
+        // comes from lliurex-quota or NFS; ask the service again once it
+        // announces a change of one of our ids
+        setServiceEmpty(true);
+        m_fallback->requestQuota();
+        return;
+    }
+
+    emit quotaReady(reply.value());
+}
+
+void LliurexDBusQuotaBackend::quotaChanged(const QString &id)
+{
+    Q_UNUSED(id)
+    setServiceEmpty(false);
+    requestQuota();
+}
+
+void LliurexDBusQuotaBackend::serviceRegistered()
+{
+    delete m_checkCall;
+    m_checkCall = nullptr;
+
+    setServicePresent(true);
+    requestQuota();
+}
+
+void LliurexDBusQuotaBackend::serviceUnregistered()
+{
+    // an activatable service exits when idle and is started again on demand
+    checkService();
+}
+
+void LliurexDBusQuotaBackend::setServicePresent(bool present)
+{
+    if (m_servicePresent == present) {
+        return;
+    }
+
+    const bool fallback = usesFallback();
+    m_servicePresent = present;
+    // a service coming back is asked again, it may know our quota by now
+    m_serviceEmpty = false;
+    subscribe(present);
+
+    if (usesFallback() != fallback) {
+        // the data shown came from the other source, the next result must be published
+        m_fallback->forgetLastResult();
+        emit pushesUpdatesChanged();
+    }
+}
+
+void LliurexDBusQuotaBackend::setServiceEmpty(bool empty)
+{
+    if (m_serviceEmpty == empty || !m_servicePresent) {
+        return;
+    }
+
+    m_serviceEmpty = empty;
+    m_fallback->forgetLastResult();
+    emit pushesUpdatesChanged();
+}
+
+void LliurexDBusQuotaBackend::subscribe(bool enable)
+{
+    QDBusConnection bus = LliurexQuotaDBus::bus();
+
+    // one match rule per id, so that the bus daemon only wakes us up for our own quotas
+    for (const QString &id : ownQuotaIds()) {
+        if (enable) {
+            bus.connect(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::objectPath, LliurexQuotaDBus::interfaceName,
+                        QStringLiteral("QuotaChanged"), QStringList{id}, QStringLiteral("s"),
+                        this, SLOT(quotaChanged(QString)));
+        } else {
+            bus.disconnect(LliurexQuotaDBus::serviceName, LliurexQuotaDBus::objectPath, LliurexQuotaDBus::interfaceName,
+                           QStringLiteral("QuotaChanged"), QStringList{id}, QStringLiteral("s"),
+                           this, SLOT(quotaChanged(QString)));
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DBUS_QUOTA_BACKEND_H
+#define PLASMA_LLIUREX_DBUS_QUOTA_BACKEND_H
+
+#include "LliurexQuotaBackend.h"
+
+#include <QVariantList>
+
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+/**
+ * Quota backend talking to the per-host quota service 'net.lliurex.Quota'.
+ * The service polls all users in one pass and announces changes with the
+ * QuotaChanged signal; this backend only subscribes to the ids of the
+ * current user and fetches its quota when one of them changed.
+ * While the service is not present, or while it has no quota of this
+ * user because the quota comes from lliurex-quota or NFS instead of a
+ * local file system, all requests are delegated to the @p fallback backend.
+ */
+class LliurexDBusQuotaBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    LliurexDBusQuotaBackend(LliurexQuotaBackend *fallback, QObject *parent = nullptr);
+
+    QString name() const override;
+    bool isAvailable() const override;
+    void requestQuota() override;
+    bool pushesUpdates() const override;
+
+    /**
+     * Returns true if the quota service is running or can be activated.
+     * Blocks on two bus round-trips, the backend itself asks asynchronously.
+     */
+    static bool serviceAvailable();
+
+private Q_SLOTS:
+    void serviceRegistered();
+    void serviceUnregistered();
+    void quotaChanged(const QString &id);
+    void callFinished(QDBusPendingCallWatcher *call);
+    void ownerChecked(QDBusPendingCallWatcher *call);
+    void activatableChecked(QDBusPendingCallWatcher *call);
+
+private:
+    /**
+     * Asks the bus daemon whether the service runs or can be activated,
+     * answered by ownerChecked() and activatableChecked().
+     */
+    void checkService();
+    QDBusPendingCallWatcher *callBus(const QString &method, const QVariantList &arguments);
+    bool usesFallback() const;
+    void setServicePresent(bool present);
+    void setServiceEmpty(bool empty);
+    void subscribe(bool enable);
+
+    LliurexQuotaBackend *m_fallback = nullptr;
+    QDBusServiceWatcher *m_serviceWatcher = nullptr;
+    QDBusPendingCallWatcher *m_pendingCall = nullptr;
+    QDBusPendingCallWatcher *m_checkCall = nullptr;
+    bool m_servicePresent = false;
+    // the service answered without any quota of this user
+    bool m_serviceEmpty = false;
+};
+
+#endif // PLASMA_LLIUREX_DBUS_QUOTA_BACKEND_H
@@ -0,0 +1,1135 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDirectoryIndex.h"
+#include "LliurexHash64.h"
+#include "lliurexquota_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QQueue>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const quint32 Magic = 0x4c514449; // 'LQDI'
+    const quint32 Version = 2;
+
+    // 20 MiB of records, 2 MiB of hash slots and 8 MiB of names at most;
+    // untouched pages of the sparse file take neither disk nor memory
+    const qint32 MaxDirectories = 256 * 1024;
+    const quint32 NameCapacity = 8 * 1024 * 1024;
+
+    // a power of two, at most half full
+    const quint32 HashSlots = 2 * MaxDirectories;
+
+    const qint32 NoRecord = -1;
+    const qint32 FreeRecord = -2;
+
+    // slots hold the record index + 1, so a sparse file starts empty
+    const qint32 EmptySlot = 0;
+    const qint32 DeletedSlot = -1;
+
+    // names of removed directories are compacted away once they are half
+    // of the names stored, and at least this much
+    const quint32 MinNameGarbage = 64 * 1024;
+
+    // a file being written sends events all the time: re-read its
+    // directory at most this often
+    const int SettleInterval = 2000;
+
+    const int VerifyInterval = 6 * 60 * 60 * 1000;
+    const int UnwatchedInterval = 15 * 60 * 1000;
+
+    // the walk is left to the desktop's start
+    const int StartDelay = 2 * 60 * 1000;
+
+    // directories read before events are looked at again
+    const int BatchSize = 64;
+
+    const quint32 WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO
+                            | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    enum HeaderFlag {
+        CompleteFlag = 0x1,     // every directory was read once
+        TruncatedFlag = 0x2     // the tree did not fit
+    };
+
+    enum RecordFlag {
+        UnwatchedFlag = 0x1,    // no inotify watch could be added
+        DirtyFlag = 0x2         // changed and not read since, kept over a restart
+    };
+
+    struct FileHeader {
+        quint32 magic;
+        quint32 version;
+        quint64 device;
+        quint64 rootInode;
+        qint32 recordCount;     // records ever used, free ones included
+        qint32 freeHead;
+        quint32 namesUsed;
+        quint32 flags;
+        quint32 recordSize;
+        quint32 namesFree;      // bytes of names of removed directories
+        quint32 deletedSlots;
+        quint32 reserved[3];
+    };
+
+    struct Record {
+        qint32 parent;          // FreeRecord for records on the free list
+        qint32 firstChild;
+        qint32 nextSibling;     // the next free record on the free list
+        quint32 nameOffset;
+        quint32 nameLength;
+        quint32 flags;
+        quint32 nameHash;
+        quint32 reserved;
+        quint64 inode;
+        qint64 changeTime;      // ctime in ns when it was read
+        qint64 ownBytes;        // the directory and its files
+        qint64 totalBytes;      // ... and all its subdirectories
+        qint64 ownFiles;
+        qint64 totalFiles;
+    };
+
+    const qint64 SlotsOffset = sizeof(FileHeader) + qint64(MaxDirectories) * sizeof(Record);
+    const qint64 NamesOffset = SlotsOffset + qint64(HashSlots) * sizeof(qint32);
+    const qint64 FileSize = NamesOffset + NameCapacity;
+
+    quint32 hashName(qint32 parent, const char *name, int length)
+    {
+        return quint32(LliurexHash64::hash(name, length, quint64(parent)));
+    }
+
+    qint64 changeTime(const struct stat &st)
+    {
+        return qint64(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+    }
+}
+
+/**
+ * The mapped index, shared by the GUI thread, which only reads it, and
+ * the worker thread, which alone writes it. The worker takes the write
+ * lock for every change; reading needs the read lock in the GUI thread
+ * only.
+ */
+class LliurexDirectoryIndexFile
+{
+public:
+    ~LliurexDirectoryIndexFile();
+
+    /**
+     * Maps @p fileName, or anonymous memory if that fails. Returns true
+     * if the file held an index of @p root that can be used. Nothing is
+     * mapped if another process holds the file.
+     */
+    bool open(const QString &fileName, const QByteArray &root, dev_t device, ino_t inode);
+    bool isOpen() const;
+    void reset();
+
+    FileHeader *header() const;
+    Record &record(qint32 index) const;
+    bool inUse(qint32 index) const;
+    QByteArray name(qint32 index) const;
+    QByteArray path(qint32 index) const;
+    qint32 find(const QByteArray &path) const;
+
+    /**
+     * The subdirectory @p name of @p parent, by the hash slots: no walk
+     * along the siblings, no copy of a name.
+     */
+    qint32 findChild(qint32 parent, const char *name, int length) const;
+
+    qint32 addChild(qint32 parent, const QByteArray &name, quint64 inode);
+    void removeSubtree(qint32 index, QVector<qint32> *removed);
+    void addToAncestors(qint32 index, qint64 bytes, qint64 files);
+
+    QByteArray root;
+    dev_t device = 0;
+    mutable QReadWriteLock lock;
+    std::atomic<bool> cancelled{false};
+
+private:
+    qint32 *slots() const;
+    char *names() const;
+    void insertSlot(qint32 index);
+    void removeSlot(qint32 index);
+    void rebuildSlots();
+    void compactNames();
+    void release(qint64 offset, qint64 length);
+
+    QFile m_file;
+    uchar *m_data = nullptr;
+    bool m_anonymous = false;
+};
+
+LliurexDirectoryIndexFile::~LliurexDirectoryIndexFile()
+{
+    if (m_anonymous) {
+        munmap(m_data, FileSize);
+    } else if (m_data) {
+        m_file.unmap(m_data);
+    }
+}
+
+bool LliurexDirectoryIndexFile::open(const QString &fileName, const QByteArray &rootPath, dev_t rootDevice, ino_t rootInode)
+{
+    root = rootPath;
+    device = rootDevice;
+
+    bool sizeMatches = false;
+    if (!fileName.isEmpty() && QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        m_file.setFileName(fileName);
+        if (m_file.open(QIODevice::ReadWrite)) {
+            // another applet instance keeps the index of this user
+            if (flock(m_file.handle(), LOCK_EX | LOCK_NB) != 0) {
+                m_file.close();
+                return false;
+            }
+            sizeMatches = m_file.size() == FileSize;
+            if (sizeMatches || m_file.resize(FileSize)) {
+                m_data = m_file.map(0, FileSize);
+            }
+        }
+    }
+
+    if (!m_data) {
+        void *memory = mmap(nullptr, FileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        m_data = static_cast<uchar *>(memory);
+        m_anonymous = true;
+        sizeMatches = false;
+    }
+
+    FileHeader *h = header();
+    const bool usable = sizeMatches && h->magic == Magic && h->version == Version && h->recordSize == sizeof(Record)
+        && h->device == quint64(rootDevice) && h->rootInode == quint64(rootInode)
+        && h->recordCount > 0 && name(0) == root;
+
+    h->device = rootDevice;
+    h->rootInode = rootInode;
+    if (!usable) {
+        reset();
+    }
+    return usable;
+}
+
+bool LliurexDirectoryIndexFile::isOpen() const
+{
+    return m_data;
+}
+
+void LliurexDirectoryIndexFile::reset()
+{
+    // the records beyond recordCount are never read, clearing them would
+    // only make the sparse file dense
+    FileHeader *h = header();
+    h->magic = Magic;
+    h->version = Version;
+    h->recordSize = sizeof(Record);
+    h->recordCount = 1;
+    h->freeHead = NoRecord;
+    h->flags = 0;
+    h->namesFree = 0;
+    h->deletedSlots = 0;
+
+    Record &r = record(0);
+    std::memset(&r, 0, sizeof(Record));
+    r.parent = NoRecord;
+    r.firstChild = NoRecord;
+    r.nextSibling = NoRecord;
+    r.nameOffset = 0;
+    r.nameLength = root.size();
+    r.inode = h->rootInode;
+    std::memcpy(names(), root.constData(), root.size());
+    h->namesUsed = root.size();
+
+    // the root is found by its path, not by a slot
+    std::memset(slots(), 0, qint64(HashSlots) * sizeof(qint32));
+    release(NamesOffset + h->namesUsed, NameCapacity - h->namesUsed);
+}
+
+FileHeader *LliurexDirectoryIndexFile::header() const
+{
+    return reinterpret_cast<FileHeader *>(m_data);
+}
+
+Record &LliurexDirectoryIndexFile::record(qint32 index) const
+{
+    return reinterpret_cast<Record *>(m_data + sizeof(FileHeader))[index];
+}
+
+qint32 *LliurexDirectoryIndexFile::slots() const
+{
+    return reinterpret_cast<qint32 *>(m_data + SlotsOffset);
+}
+
+char *LliurexDirectoryIndexFile::names() const
+{
+    return reinterpret_cast<char *>(m_data + NamesOffset);
+}
+
+bool LliurexDirectoryIndexFile::inUse(qint32 index) const
+{
+    return index >= 0 && index < header()->recordCount && record(index).parent != FreeRecord;
+}
+
+QByteArray LliurexDirectoryIndexFile::name(qint32 index) const
+{
+    const Record &r = record(index);
+    if (quint64(r.nameOffset) + r.nameLength > NameCapacity) {
+        return QByteArray();
+    }
+    return QByteArray(names() + r.nameOffset, r.nameLength);
+}
+
+QByteArray LliurexDirectoryIndexFile::path(qint32 index) const
+{
+    QVector<qint32> chain;
+    for (qint32 i = index; i != NoRecord; i = record(i).parent) {
+        chain.append(i);
+    }
+
+    QByteArray result;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        if (!result.isEmpty() && !result.endsWith('/')) {
+            result += '/';
+        }
+        result += name(chain[i]);
+    }
+    return result;
+}
+
+qint32 LliurexDirectoryIndexFile::find(const QByteArray &path) const
+{
+    if (path == root) {
+        return 0;
+    }
+    int offset = root.size();
+    if (!path.startsWith(root) || (!root.endsWith('/') && path.at(offset) != '/')) {
+        return NoRecord;
+    }
+
+    // the components are looked up in place
+    const char *data = path.constData();
+    const int size = path.size();
+    qint32 current = 0;
+    while (offset < size) {
+        if (data[offset] == '/') {
+            ++offset;
+            continue;
+        }
+        const char *end = static_cast<const char *>(std::memchr(data + offset, '/', size - offset));
+        const int length = end ? int(end - data) - offset : size - offset;
+        current = findChild(current, data + offset, length);
+        if (current == NoRecord) {
+            return NoRecord;
+        }
+        offset += length;
+    }
+    return current;
+}
+
+qint32 LliurexDirectoryIndexFile::findChild(qint32 parent, const char *childName, int length) const
+{
+    const quint32 hash = hashName(parent, childName, length);
+    const qint32 *table = slots();
+    for (quint32 slot = hash & (HashSlots - 1); table[slot] != EmptySlot; slot = (slot + 1) & (HashSlots - 1)) {
+        if (table[slot] == DeletedSlot) {
+            continue;
+        }
+        const qint32 index = table[slot] - 1;
+        const Record &r = record(index);
+        if (r.nameHash == hash && r.parent == parent && r.nameLength == quint32(length)
+            && quint64(r.nameOffset) + r.nameLength <= NameCapacity
+            && std::memcmp(names() + r.nameOffset, childName, length) == 0) {
+            return index;
+        }
+    }
+    return NoRecord;
+}
+
+void LliurexDirectoryIndexFile::insertSlot(qint32 index)
+{
+    qint32 *table = slots();
+    quint32 slot = record(index).nameHash & (HashSlots - 1);
+    while (table[slot] != EmptySlot && table[slot] != DeletedSlot) {
+        slot = (slot + 1) & (HashSlots - 1);
+    }
+    if (table[slot] == DeletedSlot) {
+        --header()->deletedSlots;
+    }
+    table[slot] = index + 1;
+}
+
+void LliurexDirectoryIndexFile::removeSlot(qint32 index)
+{
+    qint32 *table = slots();
+    for (quint32 slot = record(index).nameHash & (HashSlots - 1); table[slot] != EmptySlot; slot = (slot + 1) & (HashSlots - 1)) {
+        if (table[slot] == index + 1) {
+            table[slot] = DeletedSlot;
+            ++header()->deletedSlots;
+            break;
+        }
+    }
+}
+
+void LliurexDirectoryIndexFile::rebuildSlots()
+{
+    std::memset(slots(), 0, qint64(HashSlots) * sizeof(qint32));
+    header()->deletedSlots = 0;
+    for (qint32 index = 1; index < header()->recordCount; ++index) {
+        if (inUse(index)) {
+            insertSlot(index);
+        }
+    }
+}
+
+void LliurexDirectoryIndexFile::compactNames()
+{
+    FileHeader *h = header();
+    QByteArray compacted;
+    compacted.reserve(int(h->namesUsed - h->namesFree));
+    for (qint32 index = 0; index < h->recordCount; ++index) {
+        if (!inUse(index)) {
+            continue;
+        }
+        Record &r = record(index);
+        const quint32 offset = compacted.size();
+        compacted.append(names() + r.nameOffset, int(r.nameLength));
+        r.nameOffset = offset;
+    }
+
+    const quint32 oldUsed = h->namesUsed;
+    std::memcpy(names(), compacted.constData(), compacted.size());
+    h->namesUsed = compacted.size();
+    h->namesFree = 0;
+    release(NamesOffset + h->namesUsed, oldUsed - h->namesUsed);
+}
+
+void LliurexDirectoryIndexFile::release(qint64 offset, qint64 length)
+{
+    // whole pages only; they read back as zeros
+    const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 begin = (offset + pageSize - 1) / pageSize * pageSize;
+    const qint64 end = (offset + length) / pageSize * pageSize;
+    if (end > begin) {
+        // MADV_REMOVE punches a hole into the file behind a shared mapping
+        madvise(m_data + begin, end - begin, m_anonymous ? MADV_DONTNEED : MADV_REMOVE);
+    }
+}
+
+qint32 LliurexDirectoryIndexFile::addChild(qint32 parent, const QByteArray &childName, quint64 inode)
+{
+    FileHeader *h = header();
+    if (h->namesUsed + quint64(childName.size()) > NameCapacity && h->namesFree > 0) {
+        compactNames();
+    }
+    if (h->namesUsed + quint64(childName.size()) > NameCapacity
+        || (h->freeHead == NoRecord && h->recordCount >= MaxDirectories)) {
+        h->flags |= TruncatedFlag;
+        return NoRecord;
+    }
+
+    qint32 index = h->freeHead;
+    if (index != NoRecord) {
+        h->freeHead = record(index).nextSibling;
+    } else {
+        index = h->recordCount++;
+    }
+
+    Record &r = record(index);
+    std::memset(&r, 0, sizeof(Record));
+    r.parent = parent;
+    r.firstChild = NoRecord;
+    r.nextSibling = record(parent).firstChild;
+    r.nameOffset = h->namesUsed;
+    r.nameLength = childName.size();
+    r.nameHash = hashName(parent, childName.constData(), childName.size());
+    r.inode = inode;
+    record(parent).firstChild = index;
+    insertSlot(index);
+
+    std::memcpy(names() + h->namesUsed, childName.constData(), childName.size());
+    h->namesUsed += childName.size();
+    return index;
+}
+
+void LliurexDirectoryIndexFile::removeSubtree(qint32 index, QVector<qint32> *removed)
+{
+    Record &r = record(index);
+    addToAncestors(r.parent, -r.totalBytes, -r.totalFiles);
+
+    // unlink from the parent
+    qint32 *link = &record(r.parent).firstChild;
+    while (*link != index) {
+        link = &record(*link).nextSibling;
+    }
+    *link = r.nextSibling;
+
+    FileHeader *h = header();
+    QVector<qint32> stack{index};
+    while (!stack.isEmpty()) {
+        const qint32 i = stack.takeLast();
+        for (qint32 child = record(i).firstChild; child != NoRecord; child = record(child).nextSibling) {
+            stack.append(child);
+        }
+        removeSlot(i);
+        h->namesFree += record(i).nameLength;
+        record(i).parent = FreeRecord;
+        record(i).nextSibling = h->freeHead;
+        h->freeHead = i;
+        removed->append(i);
+    }
+
+    // deleted slots lengthen every probe that passes them
+    if (h->deletedSlots > HashSlots / 4) {
+        rebuildSlots();
+    }
+    if (h->namesFree >= MinNameGarbage && h->namesFree * 2 >= h->namesUsed) {
+        compactNames();
+    }
+}
+
+void LliurexDirectoryIndexFile::addToAncestors(qint32 index, qint64 bytes, qint64 files)
+{
+    for (qint32 i = index; i != NoRecord; i = record(i).parent) {
+        record(i).totalBytes += bytes;
+        record(i).totalFiles += files;
+    }
+}
+
+/**
+ * Keeps the index fresh, in its own thread.
+ */
+class LliurexDirectoryIndexWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LliurexDirectoryIndexWorker(const QSharedPointer<LliurexDirectoryIndexFile> &file);
+    ~LliurexDirectoryIndexWorker() override;
+
+    void start(bool kept);
+
+Q_SIGNALS:
+    void readyChanged(bool ready);
+
+private Q_SLOTS:
+    void readEvents();
+    void settle();
+    void processBatch();
+    void verify();
+    void verifyUnwatched();
+
+private:
+    void check();
+    void scheduleBatch();
+    void markDirty(qint32 index);
+    void enqueue(qint32 index);
+    void watch(qint32 index);
+    void unwatch(qint32 index);
+    void checkDirectory(qint32 index);
+    void readDirectory(qint32 index);
+    void updateReady();
+
+    QSharedPointer<LliurexDirectoryIndexFile> m_file;
+    int m_inotify = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QHash<int, qint32> m_records;   // watch descriptor -> record
+    QHash<qint32, int> m_watches;   // record -> watch descriptor
+    QSet<qint32> m_dirty;
+    QQueue<qint32> m_queue;
+    QSet<qint32> m_queued;
+    QQueue<qint32> m_checks;
+    QTimer *m_settleTimer = nullptr;
+    QTimer *m_unwatchedTimer = nullptr;
+    bool m_batchPending = false;
+    bool m_ready = false;
+};
+
+LliurexDirectoryIndexWorker::LliurexDirectoryIndexWorker(const QSharedPointer<LliurexDirectoryIndexFile> &file)
+    : m_file(file)
+{
+}
+
+LliurexDirectoryIndexWorker::~LliurexDirectoryIndexWorker()
+{
+    delete m_notifier;
+    if (m_inotify >= 0) {
+        close(m_inotify);
+    }
+}
+
+void LliurexDirectoryIndexWorker::start(bool kept)
+{
+    // the timers must live in this thread
+    m_settleTimer = new QTimer(this);
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SettleInterval);
+    connect(m_settleTimer, &QTimer::timeout, this, &LliurexDirectoryIndexWorker::settle);
+
+    m_unwatchedTimer = new QTimer(this);
+    m_unwatchedTimer->setInterval(UnwatchedInterval);
+    connect(m_unwatchedTimer, &QTimer::timeout, this, &LliurexDirectoryIndexWorker::verifyUnwatched);
+
+    QTimer *verifyTimer = new QTimer(this);
+    verifyTimer->setInterval(VerifyInterval);
+    connect(verifyTimer, &QTimer::timeout, this, &LliurexDirectoryIndexWorker::verify);
+    verifyTimer->start();
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify >= 0) {
+        m_notifier = new QSocketNotifier(m_inotify, QSocketNotifier::Read);
+        connect(m_notifier, &QSocketNotifier::activated, this, &LliurexDirectoryIndexWorker::readEvents);
+    } else {
+        qCWarning(LLIUREXQUOTA) << "inotify not available, the directory index is only verified periodically";
+    }
+
+    m_ready = (m_file->header()->flags & (CompleteFlag | TruncatedFlag)) == CompleteFlag;
+    if (kept) {
+        // nobody watched while the applet was not running
+        check();
+    } else {
+        enqueue(0);
+    }
+}
+
+void LliurexDirectoryIndexWorker::check()
+{
+    // only directories marked dirty, or whose entries changed since they
+    // were read, are read again: one stat() each instead of a stat() of
+    // every file
+    m_checks.clear();
+    for (qint32 index = 0; index < m_file->header()->recordCount; ++index) {
+        if (!m_file->inUse(index)) {
+            continue;
+        }
+        if (m_file->record(index).flags & DirtyFlag) {
+            if (!m_watches.contains(index)) {
+                watch(index);
+            }
+            enqueue(index);
+        } else {
+            m_checks.enqueue(index);
+        }
+    }
+    scheduleBatch();
+}
+
+void LliurexDirectoryIndexWorker::scheduleBatch()
+{
+    if (!m_batchPending) {
+        m_batchPending = true;
+        QTimer::singleShot(0, this, &LliurexDirectoryIndexWorker::processBatch);
+    }
+}
+
+void LliurexDirectoryIndexWorker::markDirty(qint32 index)
+{
+    // kept in the file: a restart reads it even if this session does not
+    Record &r = m_file->record(index);
+    if (!(r.flags & DirtyFlag)) {
+        QWriteLocker locker(&m_file->lock);
+        r.flags |= DirtyFlag;
+    }
+}
+
+void LliurexDirectoryIndexWorker::enqueue(qint32 index)
+{
+    if (m_queued.contains(index)) {
+        return;
+    }
+    markDirty(index);
+    m_queued.insert(index);
+    m_queue.enqueue(index);
+    scheduleBatch();
+}
+
+void LliurexDirectoryIndexWorker::processBatch()
+{
+    m_batchPending = false;
+    for (int i = 0; i < BatchSize && (!m_queue.isEmpty() || !m_checks.isEmpty()); ++i) {
+        if (m_file->cancelled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (!m_queue.isEmpty()) {
+            const qint32 index = m_queue.dequeue();
+            m_queued.remove(index);
+            readDirectory(index);
+        } else {
+            checkDirectory(m_checks.dequeue());
+        }
+    }
+
+    if (!m_queue.isEmpty() || !m_checks.isEmpty()) {
+        scheduleBatch();
+        return;
+    }
+
+    FileHeader *h = m_file->header();
+    if (!(h->flags & CompleteFlag)) {
+        QWriteLocker locker(&m_file->lock);
+        h->flags |= CompleteFlag;
+    }
+    updateReady();
+}
+
+void LliurexDirectoryIndexWorker::updateReady()
+{
+    const bool ready = (m_file->header()->flags & (CompleteFlag | TruncatedFlag)) == CompleteFlag;
+    if (ready != m_ready) {
+        m_ready = ready;
+        if (m_file->header()->flags & TruncatedFlag) {
+            qCWarning(LLIUREXQUOTA) << "The directory tree of" << m_file->root << "does not fit into the index";
+        }
+        emit readyChanged(ready);
+    }
+}
+
+void LliurexDirectoryIndexWorker::checkDirectory(qint32 index)
+{
+    if (!m_file->inUse(index)) {
+        return;
+    }
+
+    // watched first: a change after the stat() sends an event
+    if (!m_watches.contains(index)) {
+        watch(index);
+    }
+
+    const Record &record = m_file->record(index);
+    struct stat st;
+    if (stat(m_file->path(index).constData(), &st) != 0 || st.st_ino != record.inode
+        || changeTime(st) != record.changeTime) {
+        enqueue(index);
+    }
+}
+
+void LliurexDirectoryIndexWorker::readDirectory(qint32 index)
+{
+    if (!m_file->inUse(index)) {
+        return;
+    }
+
+    const Record &record = m_file->record(index);
+    const QByteArray path = m_file->path(index);
+    const int fd = open(path.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_ino != record.inode) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        // gone or replaced: the parent drops or re-adds it
+        if (record.parent >= 0) {
+            enqueue(record.parent);
+        }
+        return;
+    }
+
+    DIR *dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return;
+    }
+
+    qint64 bytes = qint64(st.st_blocks) * 512;
+    qint64 files = 0;
+    QHash<QByteArray, quint64> subdirectories;
+    while (struct dirent *entry = readdir(dir)) {
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+            continue;
+        }
+        struct stat entryStat;
+        if (fstatat(dirfd(dir), name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;
+        }
+        if (S_ISDIR(entryStat.st_mode)) {
+            // mount points below the root belong to other quotas
+            if (entryStat.st_dev == m_file->device) {
+                subdirectories.insert(QByteArray(name), entryStat.st_ino);
+            }
+            continue;
+        }
+        // every link of a file carries its share, the shares add up to
+        // the file when all its links are in the tree
+        bytes += qint64(entryStat.st_blocks) * 512 / qMax<nlink_t>(1, entryStat.st_nlink);
+        ++files;
+    }
+    closedir(dir);
+
+    QVector<qint32> removed;
+    QVector<qint32> added;
+    {
+        QWriteLocker locker(&m_file->lock);
+        Record &r = m_file->record(index);
+        m_file->addToAncestors(index, bytes - r.ownBytes, files - r.ownFiles);
+        r.ownBytes = bytes;
+        r.ownFiles = files;
+        r.changeTime = changeTime(st);
+        r.flags &= ~DirtyFlag;
+
+        // the subdirectories still there keep their records
+        QSet<qint32> kept;
+        for (auto it = subdirectories.begin(); it != subdirectories.end(); ) {
+            const qint32 child = m_file->findChild(index, it.key().constData(), it.key().size());
+            if (child != NoRecord && m_file->record(child).inode == it.value()) {
+                kept.insert(child);
+                it = subdirectories.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (qint32 child = r.firstChild; child != NoRecord; ) {
+            const qint32 next = m_file->record(child).nextSibling;
+            if (!kept.contains(child)) {
+                m_file->removeSubtree(child, &removed);
+            }
+            child = next;
+        }
+
+        for (auto it = subdirectories.constBegin(); it != subdirectories.constEnd(); ++it) {
+            const qint32 child = m_file->addChild(index, it.key(), it.value());
+            if (child == NoRecord) {
+                break;
+            }
+            added.append(child);
+        }
+    }
+
+    for (qint32 child : qAsConst(removed)) {
+        unwatch(child);
+        m_queued.remove(child);
+    }
+    for (qint32 child : qAsConst(added)) {
+        watch(child);
+        enqueue(child);
+    }
+    if (index == 0 && !m_watches.contains(0)) {
+        watch(0);
+    }
+}
+
+void LliurexDirectoryIndexWorker::watch(qint32 index)
+{
+    if (m_inotify < 0) {
+        return;
+    }
+
+    const int wd = inotify_add_watch(m_inotify, m_file->path(index).constData(), WatchMask);
+    QWriteLocker locker(&m_file->lock);
+    Record &r = m_file->record(index);
+    if (wd < 0) {
+        // usually ENOSPC: fs.inotify.max_user_watches is used up
+        r.flags |= UnwatchedFlag;
+        m_unwatchedTimer->start();
+        return;
+    }
+    r.flags &= ~UnwatchedFlag;
+    m_records.insert(wd, index);
+    m_watches.insert(index, wd);
+}
+
+void LliurexDirectoryIndexWorker::unwatch(qint32 index)
+{
+    const auto it = m_watches.find(index);
+    if (it == m_watches.end()) {
+        return;
+    }
+    // the directory may be gone already, then the kernel dropped the watch
+    inotify_rm_watch(m_inotify, it.value());
+    m_records.remove(it.value());
+    m_watches.erase(it);
+}
+
+void LliurexDirectoryIndexWorker::readEvents()
+{
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        const ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // which directories lost events is unknown: those whose
+                // entries changed tell by their ctime
+                qCDebug(LLIUREXQUOTA) << "inotify queue overflow, checking the directory index";
+                check();
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                const qint32 index = m_records.value(event->wd, NoRecord);
+                m_records.remove(event->wd);
+                if (index != NoRecord && m_watches.value(index, -1) == event->wd) {
+                    m_watches.remove(index);
+                }
+                continue;
+            }
+
+            const qint32 index = m_records.value(event->wd, NoRecord);
+            if (index != NoRecord && !m_dirty.contains(index)) {
+                m_dirty.insert(index);
+                markDirty(index);
+            }
+        }
+    }
+
+    // not restarted by later events: a directory written to all the time
+    // is still re-read every SettleInterval
+    if (!m_dirty.isEmpty() && !m_settleTimer->isActive()) {
+        m_settleTimer->start();
+    }
+}
+
+void LliurexDirectoryIndexWorker::settle()
+{
+    for (qint32 index : qAsConst(m_dirty)) {
+        enqueue(index);
+    }
+    m_dirty.clear();
+}
+
+void LliurexDirectoryIndexWorker::verify()
+{
+    FileHeader *h = m_file->header();
+    if (h->flags & TruncatedFlag) {
+        // directories removed since may make room for the ones left out
+        for (auto it = m_watches.constBegin(); it != m_watches.constEnd(); ++it) {
+            inotify_rm_watch(m_inotify, it.value());
+        }
+        m_records.clear();
+        m_watches.clear();
+        m_queue.clear();
+        m_queued.clear();
+        m_checks.clear();
+        {
+            QWriteLocker locker(&m_file->lock);
+            m_file->reset();
+        }
+        updateReady();
+        enqueue(0);
+        return;
+    }
+
+    // parents before children: records are mostly allocated in that order
+    for (qint32 index = 0; index < h->recordCount; ++index) {
+        if (!m_file->inUse(index)) {
+            continue;
+        }
+        if (!m_watches.contains(index)) {
+            watch(index);
+        }
+        enqueue(index);
+    }
+}
+
+void LliurexDirectoryIndexWorker::verifyUnwatched()
+{
+    bool unwatched = false;
+    for (qint32 index = 0; index < m_file->header()->recordCount; ++index) {
+        if (m_file->inUse(index) && (m_file->record(index).flags & UnwatchedFlag)) {
+            watch(index);
+            enqueue(index);
+            unwatched = true;
+        }
+    }
+    if (!unwatched) {
+        m_unwatchedTimer->stop();
+    }
+}
+
+LliurexDirectoryIndex::LliurexDirectoryIndex(const QString &rootPath, QObject *parent)
+    : QObject(parent)
+    , m_rootPath(QDir(rootPath).canonicalPath())
+    , m_file(new LliurexDirectoryIndexFile())
+{
+    struct stat st;
+    if (m_rootPath.isEmpty() || stat(QFile::encodeName(m_rootPath).constData(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        qCWarning(LLIUREXQUOTA) << "Cannot index" << rootPath;
+        return;
+    }
+
+    const bool kept = m_file->open(defaultFileName(), QFile::encodeName(m_rootPath), st.st_dev, st.st_ino);
+    if (!m_file->isOpen()) {
+        return;
+    }
+    // last session's index answers until it is verified
+    m_ready = kept && (m_file->header()->flags & (CompleteFlag | TruncatedFlag)) == CompleteFlag;
+
+    m_thread = new QThread();
+    LliurexDirectoryIndexWorker *worker = new LliurexDirectoryIndexWorker(m_file);
+    worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::started, worker, [worker, kept]() {
+        QTimer::singleShot(StartDelay, worker, [worker, kept]() {
+            worker->start(kept);
+        });
+    });
+    connect(m_thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(m_thread, &QThread::finished, m_thread, &QObject::deleteLater);
+    connect(worker, &LliurexDirectoryIndexWorker::readyChanged, this, [this](bool ready) {
+        if (m_ready != ready) {
+            m_ready = ready;
+            emit readyChanged();
+        }
+    });
+    m_thread->start(QThread::LowestPriority);
+}
+
+LliurexDirectoryIndex::~LliurexDirectoryIndex()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    // not waited for: a directory read may hang on NFS; the thread and
+    // the worker delete themselves once the batch at hand is done
+    m_file->cancelled.store(true);
+    m_thread->quit();
+}
+
+QString LliurexDirectoryIndex::defaultFileName()
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheDir.isEmpty()) {
+        return QString();
+    }
+    return cacheDir + QStringLiteral("/lliurexquota/directory-index");
+}
+
+QString LliurexDirectoryIndex::rootPath() const
+{
+    return m_rootPath;
+}
+
+bool LliurexDirectoryIndex::ready() const
+{
+    return m_ready;
+}
+
+bool LliurexDirectoryIndex::covers(const QString &path) const
+{
+    if (m_rootPath.isEmpty()) {
+        return false;
+    }
+    return path == m_rootPath || path.startsWith(m_rootPath.endsWith(QLatin1Char('/')) ? m_rootPath : m_rootPath + QLatin1Char('/'));
+}
+
+LliurexDirectoryIndex::Entry LliurexDirectoryIndex::entry(const QString &path) const
+{
+    Entry result{path, -1, 0};
+    if (!m_file->isOpen()) {
+        return result;
+    }
+
+    QReadLocker locker(&m_file->lock);
+    const qint32 index = m_file->find(QFile::encodeName(path));
+    if (index != NoRecord) {
+        result.size = m_file->record(index).totalBytes;
+        result.files = m_file->record(index).totalFiles;
+    }
+    return result;
+}
+
+namespace {
+    bool largerEntry(const LliurexDirectoryIndex::Entry &a, const LliurexDirectoryIndex::Entry &b)
+    {
+        return a.size > b.size;
+    }
+}
+
+QVector<LliurexDirectoryIndex::Entry> LliurexDirectoryIndex::children(const QString &path) const
+{
+    QVector<Entry> result;
+    if (!m_file->isOpen()) {
+        return result;
+    }
+
+    QReadLocker locker(&m_file->lock);
+    const qint32 index = m_file->find(QFile::encodeName(path));
+    if (index == NoRecord) {
+        return result;
+    }
+    for (qint32 child = m_file->record(index).firstChild; child != NoRecord; child = m_file->record(child).nextSibling) {
+        const Record &r = m_file->record(child);
+        result.append(Entry{QFile::decodeName(m_file->path(child)), r.totalBytes, r.totalFiles});
+    }
+    locker.unlock();
+
+    std::sort(result.begin(), result.end(), largerEntry);
+    return result;
+}
+
+QVector<LliurexDirectoryIndex::Entry> LliurexDirectoryIndex::largest(const QString &path, int count) const
+{
+    QVector<Entry> result;
+    if (!m_file->isOpen() || count <= 0) {
+        return result;
+    }
+
+    QReadLocker locker(&m_file->lock);
+    const qint32 index = m_file->find(QFile::encodeName(path));
+    if (index == NoRecord) {
+        return result;
+    }
+
+    // only the sizes are collected while walking, paths for the winners
+    std::vector<std::pair<qint64, qint32>> directories;
+    QVector<qint32> stack{m_file->record(index).firstChild};
+    while (!stack.isEmpty()) {
+        for (qint32 i = stack.takeLast(); i != NoRecord; i = m_file->record(i).nextSibling) {
+            directories.emplace_back(m_file->record(i).totalBytes, i);
+            stack.append(m_file->record(i).firstChild);
+        }
+    }
+
+    const auto middle = directories.begin() + qMin<size_t>(count, directories.size());
+    std::partial_sort(directories.begin(), middle, directories.end(), std::greater<std::pair<qint64, qint32>>());
+    for (auto it = directories.begin(); it != middle; ++it) {
+        result.append(Entry{QFile::decodeName(m_file->path(it->second)), it->first, m_file->record(it->second).totalFiles});
+    }
+    return result;
+}
+
+#include "LliurexDirectoryIndex.moc"
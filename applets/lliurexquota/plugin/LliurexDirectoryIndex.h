@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DIRECTORY_INDEX_H
+#define PLASMA_LLIUREX_DIRECTORY_INDEX_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class QThread;
+class LliurexDirectoryIndexFile;
+
+/**
+ * Cumulative sizes of all directories below a root folder, usually the
+ * home folder, kept up to date in the background so that the question
+ * "what uses my quota" is answered without walking the tree again.
+ *
+ * The index is a flat array of fixed-size directory records in a
+ * memory-mapped file under $XDG_CACHE_HOME: every record links to its
+ * parent, its first child and its next sibling, and holds the bytes and
+ * files of the directory itself and of its whole subtree. Looking up a
+ * folder hashes each path component with its parent's record into an
+ * open-addressing table in the same file, listing the subdirectories of
+ * a folder reads only their records. The names of removed directories
+ * are compacted away, their records reused. The number of records and
+ * the room for names are fixed, so the file, and the memory it can take,
+ * are bounded; a tree that does not fit is not reported as ready().
+ *
+ * A worker thread keeps the records fresh: inotify(7) watches every
+ * indexed directory, and a directory with events is marked dirty in the
+ * file and re-read (only its own entries, not its subtree) after the
+ * events settled; the difference of its bytes is added to all its
+ * ancestors. New subdirectories are read in the same way, removed ones
+ * are dropped with their subtree. After a restart, or when the kernel
+ * reports lost events, only the directories still marked dirty and
+ * those whose ctime changed since they were read are re-read. A full
+ * verification pass runs every few hours, for files rewritten in place
+ * while nobody watched, and directories without a watch are re-read
+ * periodically.
+ *
+ * fanotify(7) would watch a whole file system with a single mark, but it
+ * needs CAP_SYS_ADMIN, which the applet does not have.
+ */
+class LliurexDirectoryIndex : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
+
+public:
+    /**
+     * A directory and its cumulative size.
+     */
+    struct Entry {
+        QString path;
+        qint64 size;
+        qint64 files;
+    };
+
+    explicit LliurexDirectoryIndex(const QString &rootPath, QObject *parent = nullptr);
+    ~LliurexDirectoryIndex() override;
+
+    /**
+     * $XDG_CACHE_HOME/lliurexquota/directory-index
+     */
+    static QString defaultFileName();
+
+    QString rootPath() const;
+
+    /**
+     * Returns true once every directory below rootPath() was read, and
+     * the whole tree fits into the index.
+     */
+    bool ready() const;
+
+    /**
+     * Returns true if @p path is rootPath() or lies below it.
+     */
+    bool covers(const QString &path) const;
+
+    /**
+     * The directory @p path with its cumulative size, or an entry with
+     * size -1 if it is not indexed.
+     */
+    Entry entry(const QString &path) const;
+
+    /**
+     * The subdirectories of @p path, largest first.
+     */
+    QVector<Entry> children(const QString &path) const;
+
+    /**
+     * The @p count largest directories anywhere below @p path, largest
+     * first.
+     */
+    QVector<Entry> largest(const QString &path, int count) const;
+
+Q_SIGNALS:
+    void readyChanged();
+
+private:
+    QString m_rootPath;
+    QSharedPointer<LliurexDirectoryIndexFile> m_file;
+    QThread *m_thread = nullptr;
+    bool m_ready = false;
+};
+
+#endif // PLASMA_LLIUREX_DIRECTORY_INDEX_H
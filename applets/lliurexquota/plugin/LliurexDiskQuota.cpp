@@ -16,279 +16,172 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "LliurexDiskQuota.h"
-#include "LliurexQuotaItem.h"
-#include "LliurexQuotaListModel.h"
+#include "LliurexDiskScanner.h"
+#include "LliurexDuplicateFinder.h"
+#include "LliurexQuotaEngine.h"
+#include "LliurexReclaimAnalyzer.h"
 
-#include <KLocalizedString>
-#include <KFormat>
-
-#include <QTimer>
-#include <QRegularExpression>
-#include <QStandardPaths>
-#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
 
 LliurexDiskQuota::LliurexDiskQuota(QObject *parent)
     : QObject(parent)
-    , m_timer(new QTimer(this))
-    , m_quotaProcess(new QProcess(this))
-    , m_model(new LliurexQuotaListModel(this))
-{
-    connect(m_timer, &QTimer::timeout, this, &LliurexDiskQuota::updateQuota);
-    m_timer->start(1 * 60 * 1000); // check every 2 minutes
-
-    connect(m_quotaProcess, (void (QProcess::*)(int, QProcess::ExitStatus))&QProcess::finished,
-            this, &LliurexDiskQuota::quotaProcessFinished);
-    updateQuota();
-}
-
-bool LliurexDiskQuota::quotaInstalled() const
-{
-    return m_quotaInstalled;
+    , m_engine(LliurexQuotaEngine::acquire())
+    , m_scanner(new LliurexDiskScanner(this))
+    , m_duplicateFinder(new LliurexDuplicateFinder(this))
+{
+    LliurexQuotaEngine *engine = m_engine.data();
+    connect(engine, &LliurexQuotaEngine::quotaInstalledChanged, this, &LliurexDiskQuota::quotaInstalledChanged);
+    connect(engine, &LliurexQuotaEngine::cleanUpToolInstalledChanged, this, &LliurexDiskQuota::cleanUpToolInstalledChanged);
+    connect(engine, &LliurexQuotaEngine::statusChanged, this, &LliurexDiskQuota::statusChanged);
+    connect(engine, &LliurexQuotaEngine::toolTipChanged, this, &LliurexDiskQuota::toolTipChanged);
+    connect(engine, &LliurexQuotaEngine::subToolTipChanged, this, &LliurexDiskQuota::subToolTipChanged);
+    connect(engine, &LliurexQuotaEngine::iconNameChanged, this, &LliurexDiskQuota::iconNameChanged);
+    connect(engine, &LliurexQuotaEngine::staleChanged, this, &LliurexDiskQuota::staleChanged);
+    connect(engine, &LliurexQuotaEngine::pollFinished, this, &LliurexDiskQuota::pollFinished);
+
+    connect(engine, &LliurexQuotaEngine::adminAvailableChanged, this, &LliurexDiskQuota::adminAvailableChanged);
+    connect(engine, &LliurexQuotaEngine::adminAvailableChanged, this, [this]() {
+        if (!m_engine->adminAvailable()) {
+            setAdminMode(false);
+        }
+    });
 }
 
-void LliurexDiskQuota::setQuotaInstalled(bool installed)
+LliurexDiskQuota::~LliurexDiskQuota()
 {
-    if (m_quotaInstalled != installed) {
-        m_quotaInstalled = installed;
-
-        if (!installed) {
-            m_model->clear();
-            setStatus(PassiveStatus);
-            setToolTip(i18n("Lliurex Disk Quota"));
-            setSubToolTip(i18n("Please install 'lliurex-quota'"));
-        }
-
-        emit quotaInstalledChanged();
+    // the engine outlives this view if another applet holds it
+    if (m_adminMode) {
+        m_engine->removeAdminView();
     }
 }
 
-bool LliurexDiskQuota::cleanUpToolInstalled() const
+bool LliurexDiskQuota::quotaInstalled() const
 {
-    return m_cleanUpToolInstalled;
+    return m_engine->quotaInstalled();
 }
 
-void LliurexDiskQuota::setCleanUpToolInstalled(bool installed)
+bool LliurexDiskQuota::cleanUpToolInstalled() const
 {
-    if (m_cleanUpToolInstalled != installed) {
-        m_cleanUpToolInstalled = installed;
-        emit cleanUpToolInstalledChanged();
-    }
+    return m_engine->cleanUpToolInstalled();
 }
 
 LliurexDiskQuota::TrayStatus LliurexDiskQuota::status() const
 {
-    return m_status;
-}
-
-void LliurexDiskQuota::setStatus(LliurexDiskQuota::TrayStatus status)
-{
-    if (m_status != status) {
-        m_status = status;
-        emit statusChanged();
-    }
+    return m_engine->status();
 }
 
 QString LliurexDiskQuota::iconName() const
 {
-    return m_iconName;
-}
-
-void LliurexDiskQuota::setIconName(const QString &name)
-{
-    if (m_iconName != name) {
-        m_iconName = name;
-        emit iconNameChanged();
-    }
+    return m_engine->iconName();
 }
 
 QString LliurexDiskQuota::toolTip() const
 {
-    return m_toolTip;
+    return m_engine->toolTip();
 }
 
-void LliurexDiskQuota::setToolTip(const QString &toolTip)
+QString LliurexDiskQuota::subToolTip() const
 {
-    if (m_toolTip != toolTip) {
-        m_toolTip = toolTip;
-        emit toolTipChanged();
-    }
+    return m_engine->subToolTip();
 }
 
-QString LliurexDiskQuota::subToolTip() const
+bool LliurexDiskQuota::stale() const
 {
-    return m_subToolTip;
+    return m_engine->stale();
 }
 
-void LliurexDiskQuota::setSubToolTip(const QString &subToolTip)
+void LliurexDiskQuota::updateQuota()
 {
-    if (m_subToolTip != subToolTip) {
-        m_subToolTip = subToolTip;
-        emit subToolTipChanged();
-    }
+    m_engine->updateQuota();
 }
 
-static QString iconNameForQuota(int quota)
+LliurexQuotaListModel *LliurexDiskQuota::model() const
 {
-    if (quota < 50) {
-        return QStringLiteral("lliurexquota");
-    } else if (quota < 75) {
-        return QStringLiteral("lliurexquota-low");
-    } else if (quota < 90) {
-        return QStringLiteral("lliurexquota-high");
-    }
-
-    // quota >= 90%
-    return QStringLiteral("lliurexquota-critical");
+    return m_engine->model();
 }
 
-static bool isQuotaLine(const QString &line)
+bool LliurexDiskQuota::adminAvailable() const
 {
-    QStringList parts = line.split(QLatin1Char(','), QString::SkipEmptyParts);
-    if (parts.size() == 4){
-        if (parts[0] == "True"){
-            return true;
-        }
-        return false;
-    }
-    return false;
+    return m_engine->adminAvailable();
 }
 
-void LliurexDiskQuota::updateQuota()
+bool LliurexDiskQuota::adminMode() const
 {
-    const bool quotaFound = ! QStandardPaths::findExecutable(QStringLiteral("lliurex-quota")).isEmpty();
-    setQuotaInstalled(quotaFound);
-    if (!quotaFound) {
-        return;
-    }
-
-    // for now, only filelight is supported
-    //setCleanUpToolInstalled(! QStandardPaths::findExecutable(QStringLiteral("filelight")).isEmpty());
-    setCleanUpToolInstalled(false);
-
-    // kill running process in case it hanged for whatever reason
-    if (m_quotaProcess->state() != QProcess::NotRunning) {
-        m_quotaProcess->kill();
-    }
-
-    // Try to run 'quota'
-    const QStringList args{
-        QStringLiteral("-mq"),
-    };
-    //qDebug() << "Initiating lliurex-quota";
-    m_quotaProcess->start(QStringLiteral("lliurex-quota"), args, QIODevice::ReadOnly);
+    return m_adminMode;
 }
 
-void LliurexDiskQuota::quotaProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void LliurexDiskQuota::setAdminMode(bool enabled)
 {
-    Q_UNUSED(exitCode)
-    //qDebug() << "Ending process lliurex-quota";
-    if (exitStatus != QProcess::NormalExit) {
-        //qDebug() << "Wrong EXITCODE" ;
-        m_model->clear();
-        setToolTip(i18n("Lliurex Disk Quota"));
-        setSubToolTip(i18n("Running lliurex-quota failed"));
-        return;
-    }
-
-    // get quota output
-    const QString rawData = QString::fromLocal8Bit(m_quotaProcess->readAllStandardOutput());
-    //qDebug() << "Result from lliurex-quota cmd:" << rawData;
-
-    const QStringList lines = rawData.split(QRegularExpression(QStringLiteral("[\r\n]")), QString::SkipEmptyParts);
-    // Testing
-//     QStringList lines = QStringList()
-//         << QStringLiteral("/home/peterpan 3975379*  5000000 7000000           57602 0       0")
-//         << QStringLiteral("/home/archive 2263536  6000000 5100000            3932 0       0")
-//         << QStringLiteral("/home/shared 4271196*  10000000 7000000           57602 0       0");
-//         << QStringLiteral("/home/peterpan %1*  5000000 7000000           57602 0       0").arg(qrand() % 5000000)
-//         << QStringLiteral("/home/archive %1  5000000 5100000            3932 0       0").arg(qrand() % 5000000)
-//         << QStringLiteral("/home/shared %1*  5000000 7000000           57602 0       0").arg(qrand() % 5000000);
-//     lines.removeAt(qrand() % lines.size());
-
-    // format class needed for GiB/MiB/KiB formatting
-    KFormat fmt;
-    int maxQuota = 0;
-    QVector<LliurexQuotaItem> items;
+    if (m_adminMode != enabled) {
+        m_adminMode = enabled;
 
-    // assumption: Filesystem starts with slash
-    for (const QString &line : lines) {
-        //qDebug() << "Procesing line + isQuotaLine" << line << " + " << isQuotaLine(line);
-        if (!isQuotaLine(line)) {
-            continue;
+        if (enabled) {
+            m_engine->addAdminView();
+        } else {
+            m_engine->removeAdminView();
         }
 
-        QStringList parts = line.split(QLatin1Char(','), QString::SkipEmptyParts);
-        // True,lliurex,182,0 // parts: 0,1,2,3
-
-        // 'quota' uses kilo bytes -> factor 1024
-        // NOTE: int is not large enough, hence qint64
-
-        const qint64 hardLimit = parts[3].toLongLong() * 1024;
-        const qint64 used = parts[2].toLongLong() * 1024;
-        const qint64 freeSize = hardLimit - used;
-        const int percent = qMin(100, qMax(0, qRound(used * 100.0 / hardLimit)));
-
-        LliurexQuotaItem item;
-        item.setIconName(iconNameForQuota(percent));
-        item.setMountPoint(i18n("Assigned space"));
-        item.setUsage(percent);
-        item.setMountString(i18nc("usage of quota, e.g.: '/home/bla: 38\% used'", "%1: %2% used", i18n("Assigned space"), percent));
-        item.setUsedString(i18nc("e.g.: 12 GiB of 20 GiB", "%1 of %2", fmt.formatByteSize(used), fmt.formatByteSize(hardLimit)));
-        item.setFreeString(i18nc("e.g.: 8 GiB free", "%1 free", fmt.formatByteSize(qMax(qint64(0), freeSize))));
-
-        items.append(item);
-
-        maxQuota = qMax(maxQuota, percent);
+        emit adminModeChanged();
     }
+}
 
-//     qDebug() << "QUOTAS:" << quotas;
-
-    // make sure max quota is 100. Could be more, due to the
-    // hard limit > soft limit, and we take soft limit as 100%
-    maxQuota = qMin(100, maxQuota);
-
-    // update icon in panel
-    setIconName(iconNameForQuota(maxQuota));
+LliurexAdminQuotaModel *LliurexDiskQuota::adminModel() const
+{
+    return m_engine->adminModel();
+}
 
-    if (maxQuota < 50){
-        //qDebug() << "Setting status passive";
-        setStatus(PassiveStatus);
-    }else if (maxQuota < 90){
-        //qDebug() << "Setting status active";
-        setStatus(ActiveStatus);
-    }else{
-        //qDebug() << "Setting status need attention";
-        setStatus(NeedsAttentionStatus);
-    }
-    // update status
-    //setStatus(maxQuota < 50 ? PassiveStatus
-    //        : maxQuota < 98 ? ActiveStatus
-    //        : NeedsAttentionStatus);
+LliurexAdminStatistics *LliurexDiskQuota::adminStatistics() const
+{
+    return m_engine->adminStatistics();
+}
 
-    if (!items.isEmpty()) {
-        setToolTip(i18nc("example: Quota: 83% used",
-                         "Quota: %1% used", maxQuota));
-        setSubToolTip(QString());
-    } else {
-        setToolTip(i18n("Disk Quota"));
-        setSubToolTip(i18n("No quota restrictions found."));
-    }
+LliurexDiskScanner *LliurexDiskQuota::scanner() const
+{
+    return m_scanner;
+}
 
-    // merge new items, add new ones, remove old ones
-    m_model->updateItems(items);
+LliurexDuplicateFinder *LliurexDiskQuota::duplicateFinder() const
+{
+    return m_duplicateFinder;
 }
 
-LliurexQuotaListModel *LliurexDiskQuota::model() const
+LliurexReclaimAnalyzer *LliurexDiskQuota::reclaimAnalyzer() const
 {
-    return m_model;
+    return m_engine->reclaimAnalyzer();
 }
 
 void LliurexDiskQuota::openCleanUpTool(const QString &mountPoint)
 {
-    Q_UNUSED(mountPoint);
+    // rows are named after their mount point, except e.g. the assigned
+    // space reported by 'lliurex-quota', which lives in the home folder;
+    // a user quota on /home only counts what the user owns, which is the
+    // home folder, not the homes of the others
+    const QString home = QDir::homePath();
+    QString folder = home;
+    if (QFileInfo(mountPoint).isDir()) {
+        const QString prefix = mountPoint.endsWith(QLatin1Char('/')) ? mountPoint : mountPoint + QLatin1Char('/');
+        if (!home.startsWith(prefix) && home != mountPoint) {
+            folder = mountPoint;
+        }
+    }
+    m_duplicateFinder->clear();
+    // the index of the home folder is only built once a folder is scanned
+    m_scanner->setIndex(m_engine->directoryIndex());
+    m_scanner->start(folder);
+}
+
+void LliurexDiskQuota::openInFilelight(const QString &path)
+{
     if (!cleanUpToolInstalled()) {
         return;
     }
 
-    //QProcess::startDetached(QStringLiteral("filelight"), {mountPoint});
+    QProcess::startDetached(m_engine->cleanUpToolPath(), {path});
+}
+
+void LliurexDiskQuota::purgeReclaimable(bool purgeTrash)
+{
+    m_engine->reclaimAnalyzer()->purge(purgeTrash);
 }
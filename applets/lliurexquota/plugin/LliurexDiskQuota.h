@@ -19,15 +19,22 @@
 #define PLASMA_LLIUREX_DISK_QUOTA_H
 
 #include <QObject>
-#include <QProcess>
+#include <QSharedPointer>
 
-class QTimer;
+class LliurexAdminQuotaModel;
+class LliurexAdminStatistics;
+class LliurexDiskScanner;
+class LliurexDuplicateFinder;
+class LliurexQuotaEngine;
 class LliurexQuotaListModel;
+class LliurexReclaimAnalyzer;
 
 /**
- * Class monitoring the file system quota.
- * The monitoring is performed through a timer, running the 'quota'
- * command line tool.
+ * The file system quota as one applet shows it.
+ * The quota is monitored by the LliurexQuotaEngine of the process, shared
+ * by all applets; this class only forwards its state and models, and keeps
+ * what belongs to one applet: whether it shows the quotas of all users,
+ * and the scan of the folder clicked in it.
  */
 class LliurexDiskQuota : public QObject
 {
@@ -40,13 +47,24 @@ class LliurexDiskQuota : public QObject
     Q_PROPERTY(QString toolTip READ toolTip NOTIFY toolTipChanged)
     Q_PROPERTY(QString subToolTip READ subToolTip NOTIFY subToolTipChanged)
     Q_PROPERTY(QString iconName READ iconName NOTIFY iconNameChanged)
+    Q_PROPERTY(bool stale READ stale NOTIFY staleChanged)
 
     Q_PROPERTY(LliurexQuotaListModel* model READ model CONSTANT)
 
+    Q_PROPERTY(bool adminAvailable READ adminAvailable NOTIFY adminAvailableChanged)
+    Q_PROPERTY(bool adminMode READ adminMode WRITE setAdminMode NOTIFY adminModeChanged)
+    Q_PROPERTY(LliurexAdminQuotaModel* adminModel READ adminModel CONSTANT)
+    Q_PROPERTY(LliurexAdminStatistics* adminStatistics READ adminStatistics CONSTANT)
+
+    Q_PROPERTY(LliurexDiskScanner* scanner READ scanner CONSTANT)
+    Q_PROPERTY(LliurexDuplicateFinder* duplicateFinder READ duplicateFinder CONSTANT)
+    Q_PROPERTY(LliurexReclaimAnalyzer* reclaimAnalyzer READ reclaimAnalyzer CONSTANT)
+
     Q_ENUMS(TrayStatus)
 
 public:
     LliurexDiskQuota(QObject *parent = nullptr);
+    ~LliurexDiskQuota() override;
 
 public:
     /**
@@ -60,45 +78,92 @@ public:
 
 public:
     bool quotaInstalled() const;
-    void setQuotaInstalled(bool installed);
 
     bool cleanUpToolInstalled() const;
-    void setCleanUpToolInstalled(bool installed);
 
     TrayStatus status() const;
-    void setStatus(TrayStatus status);
 
     QString toolTip() const;
-    void setToolTip(const QString &toolTip);
 
     QString subToolTip() const;
-    void setSubToolTip(const QString &subToolTip);
 
     QString iconName() const;
-    void setIconName(const QString &name);
 
     /**
-     * Getter function for the model that is used in QML.
+     * Returns true while the data shown is the snapshot saved by the last
+     * session, before the first poll of this one delivered, or the last
+     * good data of a failing quota source.
+     */
+    bool stale() const;
+
+    /**
+     * Getter function for the model that is used in QML, shared by all
+     * applets of the process.
      */
     LliurexQuotaListModel *model() const;
 
+    /**
+     * Returns true if the user may see the quotas of all users.
+     */
+    bool adminAvailable() const;
+
+    /**
+     * While the administrator mode is on, the quotas of all users are
+     * fetched into adminModel() on every update.
+     */
+    bool adminMode() const;
+    void setAdminMode(bool enabled);
+
+    /**
+     * Getter function for the model of all users that is used in QML.
+     */
+    LliurexAdminQuotaModel *adminModel() const;
+
+    /**
+     * Getter function for the statistics over all users, for the tooltip
+     * in the administrator mode.
+     */
+    LliurexAdminStatistics *adminStatistics() const;
+
+    /**
+     * Getter function for the disk usage scanner that is used in QML.
+     */
+    LliurexDiskScanner *scanner() const;
+
+    /**
+     * Getter function for the duplicate file finder that is used in QML.
+     */
+    LliurexDuplicateFinder *duplicateFinder() const;
+
+    /**
+     * Getter function for the analyzer of caches and trash that is used in QML.
+     */
+    LliurexReclaimAnalyzer *reclaimAnalyzer() const;
+
 public Q_SLOTS:
     /**
-     * Called every timer timeout to update the data model.
-     * Launches an asynchronous 'quota' process to obtain data,
-     * and finally calls quotaProcessFinished().
+     * Asks the engine for fresh data.
      */
     void updateQuota();
 
     /**
-     * Processes the quota data from the 'quota' process.
+     * Starts the built-in scanner to find what uses the space of the quota
+     * on @p mountPoint: the home folder if it lies on it, otherwise the
+     * folder @p mountPoint itself.
      */
-    void quotaProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void openCleanUpTool(const QString &mountPoint);
 
     /**
-     * Opens the cleanup tool (filelight) at the folder @p mountPoint.
+     * Opens the cleanup tool (filelight) at the folder @p path.
      */
-    void openCleanUpTool(const QString &mountPoint);
+    void openInFilelight(const QString &path);
+
+    /**
+     * Empties the caches, and the trash if @p purgeTrash, in the
+     * background; the quota is updated as soon as that is done. The view
+     * asks first, listing reclaimAnalyzer.locations.
+     */
+    void purgeReclaimable(bool purgeTrash = false);
 
 Q_SIGNALS:
     void quotaInstalledChanged();
@@ -107,17 +172,21 @@ Q_SIGNALS:
     void toolTipChanged();
     void subToolTipChanged();
     void iconNameChanged();
+    void staleChanged();
+    void adminAvailableChanged();
+    void adminModeChanged();
+
+    /**
+     * Emitted when a poll was answered or failed, with the microseconds
+     * since the oldest unanswered request, or -1 for pushed answers.
+     */
+    void pollFinished(qint64 latency);
 
 private:
-    QTimer *m_timer = nullptr;
-    QProcess *m_quotaProcess = nullptr;
-    bool m_quotaInstalled = true;
-    bool m_cleanUpToolInstalled = true;
-    TrayStatus m_status = PassiveStatus;
-    QString m_iconName = QStringLiteral("lliurexquota");
-    QString m_toolTip;
-    QString m_subToolTip;
-    LliurexQuotaListModel *m_model = nullptr;
+    QSharedPointer<LliurexQuotaEngine> m_engine;
+    bool m_adminMode = false;
+    LliurexDiskScanner *m_scanner = nullptr;
+    LliurexDuplicateFinder *m_duplicateFinder = nullptr;
 };
 
 #endif // PLASMA_LLIUREX_DISK_QUOTA_H
@@ -0,0 +1,818 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDiskScanner.h"
+#include "LliurexDirectoryIndex.h"
+#include "LliurexDiskUsageModel.h"
+#include "lliurexquota_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QPair>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    // rows of directories and of files shown
+    const int TopDirectories = 25;
+    const int TopFiles = 25;
+
+    // how often the GUI picks up the progress of a running scan
+    const int UpdateInterval = 250;
+
+    const int MaxWorkers = 16;
+
+    // getdents64() buffer of each worker
+    const int DirentBufferSize = 32 * 1024;
+
+    // directories are allocated in chunks that never move
+    const int NodeChunkSize = 1024;
+
+    // hard link bookkeeping is split to keep the workers apart
+    const int LinkShards = 16;
+
+    /**
+     * A directory found by the walk.
+     */
+    struct ScanNode {
+        ScanNode *parent = nullptr;
+        QByteArray name;                // the full path for the root
+        std::atomic<qint64> total{0};   // bytes in and below this directory
+    };
+
+    struct RankedFile {
+        qint64 size;
+        QByteArray path;
+
+        bool operator<(const RankedFile &other) const
+        {
+            // std::push_heap() builds a max-heap: make the smallest the top
+            return size > other.size;
+        }
+    };
+
+    /**
+     * The thread pool of all scans. It is never waited for: a worker hung
+     * in an NFS call must not block plasmashell on exit.
+     */
+    QThreadPool *scanPool()
+    {
+        static QThreadPool *pool = new QThreadPool();
+        return pool;
+    }
+}
+
+/**
+ * State shared by the workers of one scan and the scanner.
+ * It lives as long as the last worker or the scanner refers to it.
+ */
+class LliurexDiskScanState
+{
+public:
+    enum RootState {
+        Resolving,
+        Resolved,
+        Failed
+    };
+
+    /**
+     * The update() slot of @p receiver is invoked when the last worker
+     * finished, until detach().
+     */
+    LliurexDiskScanState(const QString &path, int workerCount, QObject *receiver);
+
+    void run(int worker);
+    bool isFinished() const;
+
+    /**
+     * Makes the workers stop after their current system call.
+     */
+    void cancel();
+
+    /**
+     * Cancels and stops invoking the receiver.
+     */
+    void detach();
+
+    RootState rootState() const;
+
+    /**
+     * The canonical path of the root, once it is Resolved.
+     */
+    QString rootPath() const;
+
+    QVector<LliurexDiskUsageModel::Item> ranking();
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<qint64> files{0};
+    std::atomic<qint64> bytes{0};
+    std::atomic<qint64> errors{0};
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<ScanNode *> directories;
+    };
+
+    /**
+     * The largest directories one worker added bytes to, with their
+     * totals at that time. A directory in the overall top list is in
+     * the list of the worker that added to it last.
+     */
+    struct DirectoryRanking {
+        std::mutex mutex;
+        std::vector<std::pair<qint64, const ScanNode *>> directories;
+        qint64 threshold = 0;           // written by its worker only
+    };
+
+    struct LinkShard {
+        std::mutex mutex;
+        QSet<QPair<quint64, quint64>> inodes;
+    };
+
+    void resolveRoot();
+    ScanNode *newNode(ScanNode *parent, const QByteArray &name);
+    QByteArray path(const ScanNode *node) const;
+    void push(int worker, ScanNode *node);
+    ScanNode *take(int worker);
+    bool hasWork();
+    bool waitForWork();
+    void finishDirectory();
+    void wakeAll();
+    void scanDirectory(int worker, ScanNode *node, char *buffer);
+    bool countOnce(dev_t device, ino_t inode);
+    void offerDirectory(DirectoryRanking &ranking, const ScanNode *node, qint64 total);
+    void offerFile(qint64 size, const ScanNode *directory, const char *name);
+
+    const QString m_requestedPath;
+    QString m_rootPath;                 // set before m_rootState turns Resolved
+    std::atomic<int> m_rootState{Resolving};
+    dev_t m_device = 0;
+    const int m_workerCount;
+    std::atomic<int> m_pending{0};      // directories queued or being read
+    std::atomic<int> m_finishedWorkers{0};
+
+    std::mutex m_receiverMutex;
+    QObject *m_receiver;
+
+    // idle workers sleep until a directory is queued or the walk ends
+    QMutex m_idleMutex;
+    QWaitCondition m_workQueued;
+    std::atomic<int> m_idleWorkers{0};
+
+    std::mutex m_nodeMutex;
+    std::vector<std::unique_ptr<ScanNode[]>> m_nodeChunks;
+    int m_nodeCount = 0;
+
+    std::unique_ptr<WorkQueue[]> m_queues;
+    std::unique_ptr<DirectoryRanking[]> m_rankings;
+    LinkShard m_links[LinkShards];
+
+    std::mutex m_filesMutex;
+    std::vector<RankedFile> m_topFiles;             // min-heap on size
+    std::atomic<qint64> m_fileThreshold{0};         // smallest size that can enter
+};
+
+LliurexDiskScanState::LliurexDiskScanState(const QString &path, int workerCount, QObject *receiver)
+    : m_requestedPath(path)
+    , m_workerCount(workerCount)
+    , m_receiver(receiver)
+    , m_queues(new WorkQueue[workerCount])
+    , m_rankings(new DirectoryRanking[workerCount])
+{
+    // the root is pending until the first worker resolved it
+    m_pending.store(1);
+}
+
+void LliurexDiskScanState::resolveRoot()
+{
+    // canonicalPath() and stat() can block on NFS: never on the GUI thread
+    const QString rootPath = QDir(m_requestedPath).canonicalPath();
+    struct stat st;
+    if (rootPath.isEmpty() || stat(QFile::encodeName(rootPath).constData(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+        m_rootState.store(Failed, std::memory_order_release);
+    } else {
+        m_rootPath = rootPath;
+        m_device = st.st_dev;
+        m_rootState.store(Resolved, std::memory_order_release);
+        push(0, newNode(nullptr, QFile::encodeName(rootPath)));
+    }
+    finishDirectory();
+}
+
+LliurexDiskScanState::RootState LliurexDiskScanState::rootState() const
+{
+    return RootState(m_rootState.load(std::memory_order_acquire));
+}
+
+QString LliurexDiskScanState::rootPath() const
+{
+    return rootState() == Resolved ? m_rootPath : QString();
+}
+
+ScanNode *LliurexDiskScanState::newNode(ScanNode *parent, const QByteArray &name)
+{
+    std::lock_guard<std::mutex> lock(m_nodeMutex);
+    if (m_nodeCount % NodeChunkSize == 0) {
+        m_nodeChunks.emplace_back(new ScanNode[NodeChunkSize]);
+    }
+    ScanNode *node = &m_nodeChunks.back()[m_nodeCount % NodeChunkSize];
+    node->parent = parent;
+    node->name = name;
+    ++m_nodeCount;
+    return node;
+}
+
+QByteArray LliurexDiskScanState::path(const ScanNode *node) const
+{
+    QVector<const ScanNode *> chain;
+    for (; node; node = node->parent) {
+        chain.append(node);
+    }
+
+    QByteArray result;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        if (!result.isEmpty() && !result.endsWith('/')) {
+            result += '/';
+        }
+        result += chain[i]->name;
+    }
+    return result;
+}
+
+void LliurexDiskScanState::push(int worker, ScanNode *node)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        WorkQueue &queue = m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.directories.push_back(node);
+    }
+
+    // a worker that found all queues empty counted itself idle first
+    if (m_idleWorkers.load() > 0) {
+        QMutexLocker locker(&m_idleMutex);
+        m_workQueued.wakeOne();
+    }
+}
+
+ScanNode *LliurexDiskScanState::take(int worker)
+{
+    {
+        // own work: the newest directory, depth first
+        WorkQueue &queue = m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.directories.empty()) {
+            ScanNode *node = queue.directories.back();
+            queue.directories.pop_back();
+            return node;
+        }
+    }
+
+    // steal the oldest directory of another worker: the biggest subtree
+    for (int i = 1; i < m_workerCount; ++i) {
+        WorkQueue &queue = m_queues[(worker + i) % m_workerCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.directories.empty()) {
+            ScanNode *node = queue.directories.front();
+            queue.directories.pop_front();
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+bool LliurexDiskScanState::hasWork()
+{
+    for (int i = 0; i < m_workerCount; ++i) {
+        WorkQueue &queue = m_queues[i];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.directories.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LliurexDiskScanState::waitForWork()
+{
+    QMutexLocker locker(&m_idleMutex);
+    m_idleWorkers.fetch_add(1);
+
+    bool work = false;
+    while (!cancelled.load() && m_pending.load() > 0) {
+        // checked after counting as idle: push() wakes us for anything newer
+        if (hasWork()) {
+            work = true;
+            break;
+        }
+        // another worker is still reading a directory that may add work
+        m_workQueued.wait(&m_idleMutex);
+    }
+
+    m_idleWorkers.fetch_sub(1);
+    return work;
+}
+
+void LliurexDiskScanState::finishDirectory()
+{
+    if (m_pending.fetch_sub(1) == 1) {
+        wakeAll();
+    }
+}
+
+void LliurexDiskScanState::wakeAll()
+{
+    QMutexLocker locker(&m_idleMutex);
+    m_workQueued.wakeAll();
+}
+
+void LliurexDiskScanState::cancel()
+{
+    cancelled.store(true);
+    wakeAll();
+}
+
+void LliurexDiskScanState::detach()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_receiverMutex);
+        m_receiver = nullptr;
+    }
+    cancel();
+}
+
+void LliurexDiskScanState::run(int worker)
+{
+    if (worker == 0) {
+        resolveRoot();
+    }
+
+    std::vector<char> buffer(DirentBufferSize);
+
+    while (!cancelled.load(std::memory_order_relaxed)) {
+        ScanNode *node = take(worker);
+        if (!node) {
+            if (!waitForWork()) {
+                break;
+            }
+            continue;
+        }
+
+        scanDirectory(worker, node, buffer.data());
+        finishDirectory();
+    }
+
+    if (m_finishedWorkers.fetch_add(1, std::memory_order_acq_rel) + 1 == m_workerCount) {
+        // show the result now rather than at the next update
+        std::lock_guard<std::mutex> lock(m_receiverMutex);
+        if (m_receiver) {
+            QMetaObject::invokeMethod(m_receiver, "update", Qt::QueuedConnection);
+        }
+    }
+}
+
+bool LliurexDiskScanState::isFinished() const
+{
+    return m_finishedWorkers.load(std::memory_order_acquire) == m_workerCount;
+}
+
+void LliurexDiskScanState::scanDirectory(int worker, ScanNode *node, char *buffer)
+{
+    const QByteArray directoryPath = path(node);
+    const int fd = openat(AT_FDCWD, directoryPath.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    qint64 ownBytes = 0;
+    qint64 ownFiles = 0;
+    while (!cancelled.load(std::memory_order_relaxed)) {
+        const long count = syscall(SYS_getdents64, fd, buffer, DirentBufferSize);
+        if (count <= 0) {
+            if (count < 0) {
+                errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+
+        // struct linux_dirent64: ino (8), off (8), reclen (2), type (1), name
+        for (long offset = 0; offset < count; ) {
+            unsigned short recordLength;
+            std::memcpy(&recordLength, buffer + offset + 16, sizeof(recordLength));
+            const char *name = buffer + offset + 19;
+            offset += recordLength;
+
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            struct stat st;
+            if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                errors.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            const qint64 size = qint64(st.st_blocks) * 512;
+            if (S_ISDIR(st.st_mode)) {
+                // mount points below the root belong to other quotas
+                if (st.st_dev == m_device) {
+                    ownBytes += size;
+                    push(worker, newNode(node, QByteArray(name)));
+                }
+                continue;
+            }
+
+            if (st.st_nlink > 1 && !countOnce(st.st_dev, st.st_ino)) {
+                continue;
+            }
+
+            ownBytes += size;
+            ++ownFiles;
+            offerFile(size, node, name);
+        }
+    }
+    close(fd);
+
+    if (ownBytes > 0) {
+        DirectoryRanking &ranking = m_rankings[worker];
+        for (ScanNode *n = node; n; n = n->parent) {
+            const qint64 total = n->total.fetch_add(ownBytes, std::memory_order_relaxed) + ownBytes;
+            // the root is the scan itself, not a row
+            if (n->parent) {
+                offerDirectory(ranking, n, total);
+            }
+        }
+    }
+    bytes.fetch_add(ownBytes, std::memory_order_relaxed);
+    files.fetch_add(ownFiles, std::memory_order_relaxed);
+}
+
+bool LliurexDiskScanState::countOnce(dev_t device, ino_t inode)
+{
+    LinkShard &shard = m_links[inode % LinkShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const QPair<quint64, quint64> key(quint64(device), quint64(inode));
+    if (shard.inodes.contains(key)) {
+        return false;
+    }
+    shard.inodes.insert(key);
+    return true;
+}
+
+void LliurexDiskScanState::offerDirectory(DirectoryRanking &ranking, const ScanNode *node, qint64 total)
+{
+    // totals only grow: most directories never reach the ranking
+    if (total <= ranking.threshold) {
+        return;
+    }
+
+    typedef std::pair<qint64, const ScanNode *> Ranked;
+    std::lock_guard<std::mutex> lock(ranking.mutex);
+    std::vector<Ranked> &directories = ranking.directories;
+    auto it = std::find_if(directories.begin(), directories.end(), [node](const Ranked &ranked) {
+        return ranked.second == node;
+    });
+    if (it != directories.end()) {
+        it->first = total;
+    } else if (int(directories.size()) < TopDirectories) {
+        directories.emplace_back(total, node);
+    } else {
+        *std::min_element(directories.begin(), directories.end()) = Ranked(total, node);
+    }
+
+    if (int(directories.size()) == TopDirectories) {
+        ranking.threshold = std::min_element(directories.begin(), directories.end())->first;
+    }
+}
+
+void LliurexDiskScanState::offerFile(qint64 size, const ScanNode *directory, const char *name)
+{
+    // most files are too small to enter the ranking: decide without a lock
+    if (size <= m_fileThreshold.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    QByteArray filePath = path(directory);
+    filePath += '/';
+    filePath += name;
+
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+    m_topFiles.push_back(RankedFile{size, filePath});
+    std::push_heap(m_topFiles.begin(), m_topFiles.end());
+    if (int(m_topFiles.size()) > TopFiles) {
+        std::pop_heap(m_topFiles.begin(), m_topFiles.end());
+        m_topFiles.pop_back();
+    }
+    if (int(m_topFiles.size()) == TopFiles) {
+        m_fileThreshold.store(m_topFiles.front().size, std::memory_order_relaxed);
+    }
+}
+
+QVector<LliurexDiskUsageModel::Item> LliurexDiskScanState::ranking()
+{
+    QVector<LliurexDiskUsageModel::Item> items;
+
+    // directories: the union of the workers' rankings, by their total so far
+    std::vector<std::pair<qint64, const ScanNode *>> directories;
+    QSet<const ScanNode *> seen;
+    for (int i = 0; i < m_workerCount; ++i) {
+        DirectoryRanking &ranking = m_rankings[i];
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        for (const auto &ranked : ranking.directories) {
+            if (!seen.contains(ranked.second)) {
+                seen.insert(ranked.second);
+                directories.emplace_back(ranked.second->total.load(std::memory_order_relaxed), ranked.second);
+            }
+        }
+    }
+    const auto middle = directories.begin() + qMin<size_t>(TopDirectories, directories.size());
+    std::partial_sort(directories.begin(), middle, directories.end(),
+                      [](const std::pair<qint64, const ScanNode *> &a, const std::pair<qint64, const ScanNode *> &b) {
+                          return a.first > b.first;
+                      });
+    for (auto it = directories.begin(); it != middle; ++it) {
+        LliurexDiskUsageModel::Item item;
+        item.path = QFile::decodeName(path(it->second));
+        item.size = it->first;
+        item.directory = true;
+        items.append(item);
+    }
+
+    std::vector<RankedFile> topFiles;
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        topFiles = m_topFiles;
+    }
+    for (const RankedFile &file : topFiles) {
+        LliurexDiskUsageModel::Item item;
+        item.path = QFile::decodeName(file.path);
+        item.size = file.size;
+        items.append(item);
+    }
+
+    std::stable_sort(items.begin(), items.end(), [](const LliurexDiskUsageModel::Item &a, const LliurexDiskUsageModel::Item &b) {
+        return a.size > b.size;
+    });
+    return items;
+}
+
+namespace {
+    class ScanWorker : public QRunnable
+    {
+    public:
+        ScanWorker(const QSharedPointer<LliurexDiskScanState> &state, int index)
+            : m_state(state)
+            , m_index(index)
+        {
+        }
+
+        void run() override
+        {
+            m_state->run(m_index);
+        }
+
+    private:
+        QSharedPointer<LliurexDiskScanState> m_state;
+        int m_index;
+    };
+}
+
+LliurexDiskScanner::LliurexDiskScanner(QObject *parent)
+    : QObject(parent)
+    , m_model(new LliurexDiskUsageModel(this))
+    , m_updateTimer(new QTimer(this))
+    , m_workerCount(qBound(2, 2 * QThread::idealThreadCount(), MaxWorkers))
+{
+    m_updateTimer->setInterval(UpdateInterval);
+    connect(m_updateTimer, &QTimer::timeout, this, &LliurexDiskScanner::update);
+}
+
+LliurexDiskScanner::~LliurexDiskScanner()
+{
+    // the workers drop their references once they noticed
+    if (m_state) {
+        m_state->detach();
+    }
+}
+
+bool LliurexDiskScanner::running() const
+{
+    return m_running;
+}
+
+QString LliurexDiskScanner::rootPath() const
+{
+    return m_rootPath;
+}
+
+qint64 LliurexDiskScanner::scannedFiles() const
+{
+    return m_state ? m_state->files.load(std::memory_order_relaxed) : m_indexedFiles;
+}
+
+qint64 LliurexDiskScanner::scannedSize() const
+{
+    return m_state ? m_state->bytes.load(std::memory_order_relaxed) : m_indexedSize;
+}
+
+QString LliurexDiskScanner::scannedSizeString() const
+{
+    return m_formatter.formatByteSize(scannedSize());
+}
+
+qint64 LliurexDiskScanner::errorCount() const
+{
+    return m_state ? m_state->errors.load(std::memory_order_relaxed) : 0;
+}
+
+LliurexDiskUsageModel *LliurexDiskScanner::model() const
+{
+    return m_model;
+}
+
+void LliurexDiskScanner::setWorkerCount(int count)
+{
+    m_workerCount = qBound(1, count, MaxWorkers);
+}
+
+void LliurexDiskScanner::setIndex(LliurexDirectoryIndex *index)
+{
+    m_index = index;
+}
+
+bool LliurexDiskScanner::showIndexed(const QString &rootPath)
+{
+    if (!m_index || !m_index->ready() || !m_index->covers(rootPath)) {
+        return false;
+    }
+
+    const LliurexDirectoryIndex::Entry root = m_index->entry(rootPath);
+    if (root.size < 0) {
+        return false;
+    }
+
+    // the index knows directories only
+    QVector<LliurexDiskUsageModel::Item> items;
+    const auto directories = m_index->largest(rootPath, TopDirectories + TopFiles);
+    for (const LliurexDirectoryIndex::Entry &entry : directories) {
+        LliurexDiskUsageModel::Item item;
+        item.path = entry.path;
+        item.size = entry.size;
+        item.directory = true;
+        items.append(item);
+    }
+
+    m_indexedFiles = root.files;
+    m_indexedSize = root.size;
+    m_model->setItems(items, rootPath, root.size);
+    return true;
+}
+
+void LliurexDiskScanner::start(const QString &path)
+{
+    if (m_state) {
+        m_state->detach();
+        m_state.clear();
+    }
+
+    // the first worker resolves the canonical path, update() picks it up
+    const QString rootPath = QDir::cleanPath(path);
+    if (!QDir::isAbsolutePath(rootPath)) {
+        qCWarning(LLIUREXQUOTA) << "Cannot scan" << path;
+        clear();
+        return;
+    }
+
+    m_model->clear();
+    if (m_rootPath != rootPath) {
+        m_rootPath = rootPath;
+        emit rootPathChanged();
+    }
+
+    if (showIndexed(rootPath)) {
+        m_updateTimer->stop();
+        if (m_running) {
+            m_running = false;
+            emit runningChanged();
+        }
+        emit progressChanged();
+        emit finished();
+        return;
+    }
+
+    m_state.reset(new LliurexDiskScanState(rootPath, m_workerCount, this));
+
+    QThreadPool *pool = scanPool();
+    pool->setMaxThreadCount(qMax(pool->maxThreadCount(), m_workerCount));
+    for (int i = 0; i < m_workerCount; ++i) {
+        pool->start(new ScanWorker(m_state, i));
+    }
+
+    m_updateTimer->start();
+    if (!m_running) {
+        m_running = true;
+        emit runningChanged();
+    }
+    emit progressChanged();
+}
+
+void LliurexDiskScanner::cancel()
+{
+    if (m_state && m_running) {
+        m_state->cancel();
+        // the results so far stay, the workers wind down on their own
+        update();
+    }
+}
+
+void LliurexDiskScanner::clear()
+{
+    if (m_state) {
+        m_state->detach();
+        m_state.clear();
+    }
+    m_updateTimer->stop();
+    m_model->clear();
+    m_indexedFiles = 0;
+    m_indexedSize = 0;
+
+    if (!m_rootPath.isEmpty()) {
+        m_rootPath.clear();
+        emit rootPathChanged();
+    }
+    if (m_running) {
+        m_running = false;
+        emit runningChanged();
+        emit finished();
+    }
+    emit progressChanged();
+}
+
+void LliurexDiskScanner::update()
+{
+    // the last worker invokes this once more when the timer was faster
+    if (!m_state || !m_running) {
+        return;
+    }
+
+    switch (m_state->rootState()) {
+        case LliurexDiskScanState::Resolving:
+            break;
+        case LliurexDiskScanState::Resolved:
+            if (m_rootPath != m_state->rootPath()) {
+                m_rootPath = m_state->rootPath();
+                emit rootPathChanged();
+            }
+            break;
+        case LliurexDiskScanState::Failed:
+            qCWarning(LLIUREXQUOTA) << "Cannot scan" << m_rootPath;
+            clear();
+            return;
+    }
+
+    const bool done = m_state->isFinished() || m_state->cancelled.load();
+    m_model->setItems(m_state->ranking(), m_rootPath, scannedSize());
+    emit progressChanged();
+
+    if (done) {
+        m_updateTimer->stop();
+        m_running = false;
+        emit runningChanged();
+        emit finished();
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DISK_SCANNER_H
+#define PLASMA_LLIUREX_DISK_SCANNER_H
+
+#include <QObject>
+#include <QSharedPointer>
+
+#include "LliurexQuotaFormatter.h"
+
+class QTimer;
+class LliurexDirectoryIndex;
+class LliurexDiskScanState;
+class LliurexDiskUsageModel;
+
+/**
+ * Finds what uses the space of a quota: walks a directory tree and streams
+ * the largest directories and files into model() while it runs.
+ *
+ * The walk runs on a pool of worker threads with one deque of directories
+ * each; a worker takes its newest directory (depth first, warm caches)
+ * and steals the oldest one of another worker when it runs dry, so large
+ * subtrees are spread over all threads. Directories are read with
+ * getdents64() and every entry is stat'ed relative to its directory with
+ * fstatat(), which keeps the path lookups in the kernel short on NFS.
+ * Files with several hard links are counted once, and the walk never
+ * crosses into another file system. Sizes are allocated blocks, as the
+ * quota counts them.
+ *
+ * The GUI thread never waits for a worker and never touches the file
+ * system: the first worker resolves the folder, and every worker keeps
+ * its own list of the largest directories it added to, which the GUI
+ * merges with the atomic counters every quarter of a second. Idle workers
+ * sleep until a directory is queued. cancel() makes the workers stop
+ * after their current system call.
+ *
+ * If a ready LliurexDirectoryIndex covers the folder, the largest
+ * directories are taken from it at once and no walk is started.
+ */
+class LliurexDiskScanner : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(QString rootPath READ rootPath NOTIFY rootPathChanged)
+    Q_PROPERTY(qint64 scannedFiles READ scannedFiles NOTIFY progressChanged)
+    Q_PROPERTY(qint64 scannedSize READ scannedSize NOTIFY progressChanged)
+    Q_PROPERTY(QString scannedSizeString READ scannedSizeString NOTIFY progressChanged)
+    Q_PROPERTY(qint64 errorCount READ errorCount NOTIFY progressChanged)
+    Q_PROPERTY(LliurexDiskUsageModel* model READ model CONSTANT)
+
+public:
+    LliurexDiskScanner(QObject *parent = nullptr);
+    ~LliurexDiskScanner() override;
+
+    bool running() const;
+    QString rootPath() const;
+    qint64 scannedFiles() const;
+    qint64 scannedSize() const;
+    QString scannedSizeString() const;
+
+    /**
+     * Number of directories and files that could not be read.
+     */
+    qint64 errorCount() const;
+
+    LliurexDiskUsageModel *model() const;
+
+    /**
+     * Number of worker threads, by default twice the number of cores,
+     * at most 16: on NFS the workers mostly wait for the server.
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * Answers from @p index instead of walking, where it is ready.
+     */
+    void setIndex(LliurexDirectoryIndex *index);
+
+public Q_SLOTS:
+    /**
+     * Starts scanning @p path, cancelling a running scan. rootPath()
+     * turns canonical once a worker resolved it.
+     */
+    void start(const QString &path);
+
+    /**
+     * Stops a running scan; its results so far are kept.
+     */
+    void cancel();
+
+    /**
+     * Cancels and forgets the scan.
+     */
+    void clear();
+
+Q_SIGNALS:
+    void runningChanged();
+    void rootPathChanged();
+    void progressChanged();
+
+    /**
+     * Emitted when the scan completed or was cancelled.
+     */
+    void finished();
+
+private Q_SLOTS:
+    void update();
+
+private:
+    bool showIndexed(const QString &rootPath);
+
+    QSharedPointer<LliurexDiskScanState> m_state;
+    LliurexDiskUsageModel *m_model = nullptr;
+    QTimer *m_updateTimer = nullptr;
+    QString m_rootPath;
+    int m_workerCount = 0;
+    LliurexDirectoryIndex *m_index = nullptr;
+    qint64 m_indexedFiles = 0;
+    qint64 m_indexedSize = 0;
+    bool m_running = false;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_DISK_SCANNER_H
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDiskUsageModel.h"
+
+namespace {
+    /**
+     * QML data roles.
+     */
+    enum {
+        PathRole = Qt::UserRole,
+        NameRole,
+        SizeRole,
+        SizeStringRole,
+        DirectoryRole,
+        ShareRole
+    };
+}
+
+bool LliurexDiskUsageModel::Item::operator==(const Item &other) const
+{
+    return size == other.size && directory == other.directory && path == other.path;
+}
+
+LliurexDiskUsageModel::LliurexDiskUsageModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QHash<int, QByteArray> LliurexDiskUsageModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PathRole] = "path";
+    roles[NameRole] = "name";
+    roles[SizeRole] = "size";
+    roles[SizeStringRole] = "sizeString";
+    roles[DirectoryRole] = "isDirectory";
+    roles[ShareRole] = "share";
+
+    return roles;
+}
+
+QVariant LliurexDiskUsageModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid() || index.row() >= m_items.size()) {
+        return QVariant();
+    }
+
+    const Item &item = m_items.at(index.row());
+
+    switch (role) {
+        case PathRole: return item.path;
+        case NameRole:
+            // e.g. '.cache/thumbnails' below the scanned home folder
+            if (item.path.startsWith(m_rootPath + QLatin1Char('/'))) {
+                return item.path.mid(m_rootPath.size() + 1);
+            }
+            return item.path;
+        case SizeRole: return item.size;
+        case SizeStringRole: return m_formatter.formatByteSize(item.size);
+        case DirectoryRole: return item.directory;
+        case ShareRole: return m_total > 0 ? int(qMin(qint64(100), item.size * 100 / m_total)) : 0;
+    }
+
+    return QVariant();
+}
+
+int LliurexDiskUsageModel::rowCount(const QModelIndex &index) const
+{
+    if (! index.isValid()) {
+        return m_items.size();
+    }
+
+    return 0;
+}
+
+void LliurexDiskUsageModel::setItems(const QVector<Item> &items, const QString &rootPath, qint64 total)
+{
+    const bool totalChanged = m_total != total;
+    m_total = total;
+
+    if (rootPath != m_rootPath || items.size() != m_items.size()) {
+        beginResetModel();
+        m_items = items;
+        m_rootPath = rootPath;
+        endResetModel();
+        return;
+    }
+
+    // the ranking changes little between two updates of a running scan
+    for (int row = 0; row < items.size(); ++row) {
+        if (!(m_items[row] == items[row])) {
+            m_items[row] = items[row];
+            const QModelIndex index = createIndex(row, 0);
+            emit dataChanged(index, index);
+        } else if (totalChanged) {
+            const QModelIndex index = createIndex(row, 0);
+            emit dataChanged(index, index, {ShareRole});
+        }
+    }
+}
+
+void LliurexDiskUsageModel::clear()
+{
+    beginResetModel();
+    m_items.clear();
+    m_rootPath.clear();
+    m_total = 0;
+    endResetModel();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DISK_USAGE_MODEL_H
+#define PLASMA_LLIUREX_DISK_USAGE_MODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include "LliurexQuotaFormatter.h"
+
+/**
+ * The largest directories and files found by a LliurexDiskScanner,
+ * largest first. Rows are updated in place while the scan runs.
+ */
+class LliurexDiskUsageModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * One directory (with everything below it) or file.
+     */
+    struct Item {
+        QString path;
+        qint64 size = 0;
+        bool directory = false;
+
+        bool operator==(const Item &other) const;
+    };
+
+    LliurexDiskUsageModel(QObject *parent = nullptr);
+
+public: // QAbstractListModel overrides
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &index) const override;
+
+public:
+    /**
+     * Replaces all rows with @p items; paths are shown relative to
+     * @p rootPath, sizes as share of @p total.
+     */
+    void setItems(const QVector<Item> &items, const QString &rootPath, qint64 total);
+
+    void clear();
+
+private:
+    QVector<Item> m_items;
+    QString m_rootPath;
+    qint64 m_total = 0;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_DISK_USAGE_MODEL_H
@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDuplicateFinder.h"
+#include "LliurexDuplicateModel.h"
+#include "LliurexHash64.h"
+#include "lliurexquota_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QPair>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // copies of smaller files free too little to be worth the reading
+    const qint64 MinFileSize = 64 * 1024;
+
+    // sampled at the start and at the end of a file
+    const qint64 SampleSize = 16 * 1024;
+
+    const qint64 ReadSize = 1024 * 1024;
+
+    const int UpdateInterval = 250;
+
+    const int MaxWorkers = 16;
+
+    /**
+     * The thread pool of all searches, never waited for, like the one
+     * of LliurexDiskScanner.
+     */
+    QThreadPool *searchPool()
+    {
+        static QThreadPool *pool = new QThreadPool();
+        return pool;
+    }
+
+    class FunctionRunnable : public QRunnable
+    {
+    public:
+        explicit FunctionRunnable(const std::function<void()> &function)
+            : m_function(function)
+        {
+        }
+
+        void run() override
+        {
+            m_function();
+        }
+
+    private:
+        std::function<void()> m_function;
+    };
+}
+
+/**
+ * One search, shared by its threads and the finder.
+ */
+class LliurexDuplicateSearch
+{
+public:
+    LliurexDuplicateSearch(const QString &path, int workerCount)
+        : m_requestedPath(path)
+        , m_workerCount(workerCount)
+    {
+    }
+
+    void run();
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> done{false};
+    std::atomic<bool> resolved{false};
+    std::atomic<bool> failed{false};    // the folder cannot be read, done is set
+
+    // the canonical folder, written before resolved is set
+    QString rootPath;
+    std::atomic<int> phase{LliurexDuplicateFinder::ListingPhase};
+    std::atomic<qint64> candidates{0};
+    std::atomic<qint64> total{0};
+    std::atomic<qint64> processed{0};
+
+    // written before done is set
+    QVector<LliurexDuplicateModel::Group> groups;
+
+private:
+    struct Candidate {
+        QByteArray path;
+        qint64 size;
+        qint64 allocated;
+        qint64 modified;
+        quint64 sample = 0;
+        quint64 hash = 0;
+        bool complete = false;  // the sample covered the whole file
+        bool failed = false;
+    };
+
+    void list(std::vector<Candidate> *files);
+    void forEach(std::vector<Candidate> &files, const std::function<void(Candidate &, std::vector<char> &)> &function);
+    int openUnchanged(const Candidate &file) const;
+    void sample(Candidate &file, std::vector<char> &buffer);
+    void hash(Candidate &file, std::vector<char> &buffer);
+
+    template<typename Key>
+    static std::vector<Candidate> keepGroups(std::vector<Candidate> &files, Key key);
+
+    bool resolveRoot();
+
+    const QString m_requestedPath;
+    QByteArray m_root;
+    dev_t m_device = 0;
+    const int m_workerCount;
+};
+
+bool LliurexDuplicateSearch::resolveRoot()
+{
+    // canonicalPath() and stat() can block on NFS: never on the GUI thread
+    const QString path = QDir(m_requestedPath).canonicalPath();
+    struct stat st;
+    if (path.isEmpty() || stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+    m_root = QFile::encodeName(path);
+    m_device = st.st_dev;
+    rootPath = path;
+    resolved.store(true, std::memory_order_release);
+    return true;
+}
+
+void LliurexDuplicateSearch::list(std::vector<Candidate> *files)
+{
+    QSet<QPair<quint64, quint64>> linked;
+    QVector<QByteArray> directories{m_root};
+
+    while (!directories.isEmpty() && !cancelled.load(std::memory_order_relaxed)) {
+        const QByteArray directory = directories.takeLast();
+        const int fd = open(directory.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        DIR *dir = fd >= 0 ? fdopendir(fd) : nullptr;
+        if (!dir) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            continue;
+        }
+
+        while (struct dirent *entry = readdir(dir)) {
+            const char *name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            struct stat st;
+            if (fstatat(dirfd(dir), name, &st, AT_SYMLINK_NOFOLLOW) != 0 || st.st_dev != m_device) {
+                continue;
+            }
+
+            QByteArray path = directory;
+            if (!path.endsWith('/')) {
+                path += '/';
+            }
+            path += name;
+
+            if (S_ISDIR(st.st_mode)) {
+                directories.append(path);
+            } else if (S_ISREG(st.st_mode) && st.st_size >= MinFileSize) {
+                // further links of a file share its blocks
+                if (st.st_nlink > 1) {
+                    const QPair<quint64, quint64> inode(quint64(st.st_dev), quint64(st.st_ino));
+                    if (linked.contains(inode)) {
+                        continue;
+                    }
+                    linked.insert(inode);
+                }
+                Candidate file;
+                file.path = path;
+                file.size = st.st_size;
+                file.allocated = qint64(st.st_blocks) * 512;
+                file.modified = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+                files->push_back(file);
+                candidates.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        closedir(dir);
+    }
+}
+
+template<typename Key>
+std::vector<LliurexDuplicateSearch::Candidate> LliurexDuplicateSearch::keepGroups(std::vector<Candidate> &files, Key key)
+{
+    std::sort(files.begin(), files.end(), [&key](const Candidate &a, const Candidate &b) {
+        return key(a) < key(b);
+    });
+
+    std::vector<Candidate> kept;
+    for (size_t first = 0; first < files.size(); ) {
+        size_t last = first + 1;
+        while (last < files.size() && key(files[last]) == key(files[first])) {
+            ++last;
+        }
+        if (last - first > 1) {
+            for (size_t i = first; i < last; ++i) {
+                if (!files[i].failed) {
+                    kept.push_back(std::move(files[i]));
+                }
+            }
+        }
+        first = last;
+    }
+    return kept;
+}
+
+void LliurexDuplicateSearch::forEach(std::vector<Candidate> &files, const std::function<void(Candidate &, std::vector<char> &)> &function)
+{
+    std::atomic<size_t> next{0};
+    QSemaphore finishedWorkers;
+
+    const int workers = qMax(1, qMin<int>(m_workerCount, files.size()));
+    QThreadPool *pool = searchPool();
+    pool->setMaxThreadCount(qMax(pool->maxThreadCount(), workers + 1));
+    for (int i = 0; i < workers; ++i) {
+        pool->start(new FunctionRunnable([&]() {
+            std::vector<char> buffer(ReadSize);
+            for (size_t index = next++; index < files.size(); index = next++) {
+                if (cancelled.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                function(files[index], buffer);
+            }
+            finishedWorkers.release();
+        }));
+    }
+
+    // the references of the workers point into this frame
+    finishedWorkers.acquire(workers);
+}
+
+int LliurexDuplicateSearch::openUnchanged(const Candidate &file) const
+{
+    const int fd = open(file.path.constData(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // a file written since it was listed is left out
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size != file.size
+        || qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec != file.modified) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void LliurexDuplicateSearch::sample(Candidate &file, std::vector<char> &buffer)
+{
+    const int fd = openUnchanged(file);
+    if (fd < 0) {
+        file.failed = true;
+        processed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    file.complete = file.size <= 2 * SampleSize;
+    const qint64 head = file.complete ? file.size : SampleSize;
+    ssize_t length = pread(fd, buffer.data(), head, 0);
+    if (length == head && !file.complete) {
+        length = pread(fd, buffer.data() + head, SampleSize, file.size - SampleSize);
+        length = length == SampleSize ? head + SampleSize : -1;
+    }
+    close(fd);
+
+    if (length < 0 || (file.complete && length != file.size)) {
+        file.failed = true;
+    } else {
+        file.sample = LliurexHash64::hash(buffer.data(), length);
+        file.hash = file.sample;
+    }
+    processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LliurexDuplicateSearch::hash(Candidate &file, std::vector<char> &buffer)
+{
+    if (file.complete) {
+        return;
+    }
+
+    const int fd = openUnchanged(file);
+    if (fd < 0) {
+        file.failed = true;
+        processed.fetch_add(file.size, std::memory_order_relaxed);
+        return;
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    LliurexHash64 hasher;
+    qint64 remaining = file.size;
+    while (remaining > 0 && !cancelled.load(std::memory_order_relaxed)) {
+        const ssize_t length = read(fd, buffer.data(), buffer.size());
+        if (length <= 0) {
+            break;
+        }
+        hasher.addData(buffer.data(), length);
+        remaining -= length;
+        processed.fetch_add(length, std::memory_order_relaxed);
+    }
+    // the files were read once, keep the page cache for others
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+
+    file.failed = remaining != 0;
+    processed.fetch_add(qMax<qint64>(0, remaining), std::memory_order_relaxed);
+    file.hash = hasher.result();
+}
+
+void LliurexDuplicateSearch::run()
+{
+    if (!resolveRoot()) {
+        failed.store(true);
+        done.store(true, std::memory_order_release);
+        return;
+    }
+
+    std::vector<Candidate> files;
+    list(&files);
+
+    // round 1: sizes
+    files = keepGroups(files, [](const Candidate &file) {
+        return file.size;
+    });
+
+    // round 2: first and last blocks
+    phase.store(LliurexDuplicateFinder::SamplingPhase);
+    candidates.store(files.size());
+    processed.store(0);
+    total.store(files.size());
+    forEach(files, [this](Candidate &file, std::vector<char> &buffer) {
+        sample(file, buffer);
+    });
+    files = keepGroups(files, [](const Candidate &file) {
+        return qMakePair(file.size, file.sample);
+    });
+
+    // round 3: whole contents
+    qint64 bytes = 0;
+    for (const Candidate &file : files) {
+        bytes += file.complete ? 0 : file.size;
+    }
+    phase.store(LliurexDuplicateFinder::HashingPhase);
+    candidates.store(files.size());
+    processed.store(0);
+    total.store(bytes);
+    forEach(files, [this](Candidate &file, std::vector<char> &buffer) {
+        hash(file, buffer);
+    });
+
+    if (!cancelled.load()) {
+        std::sort(files.begin(), files.end(), [](const Candidate &a, const Candidate &b) {
+            return qMakePair(a.size, a.hash) < qMakePair(b.size, b.hash);
+        });
+        for (size_t first = 0; first < files.size(); ) {
+            size_t last = first;
+            LliurexDuplicateModel::Group group;
+            group.size = files[first].allocated;
+            for (; last < files.size() && files[last].size == files[first].size && files[last].hash == files[first].hash; ++last) {
+                if (!files[last].failed) {
+                    group.paths.append(QFile::decodeName(files[last].path));
+                }
+            }
+            if (group.paths.size() > 1) {
+                group.paths.sort();
+                groups.append(group);
+            }
+            first = last;
+        }
+        std::sort(groups.begin(), groups.end(), [](const LliurexDuplicateModel::Group &a, const LliurexDuplicateModel::Group &b) {
+            return a.reclaimable() > b.reclaimable();
+        });
+    }
+
+    done.store(true, std::memory_order_release);
+}
+
+LliurexDuplicateFinder::LliurexDuplicateFinder(QObject *parent)
+    : QObject(parent)
+    , m_model(new LliurexDuplicateModel(this))
+    , m_updateTimer(new QTimer(this))
+    , m_workerCount(qBound(2, 2 * QThread::idealThreadCount(), MaxWorkers))
+{
+    m_updateTimer->setInterval(UpdateInterval);
+    connect(m_updateTimer, &QTimer::timeout, this, &LliurexDuplicateFinder::update);
+}
+
+LliurexDuplicateFinder::~LliurexDuplicateFinder()
+{
+    if (m_search) {
+        m_search->cancelled.store(true);
+    }
+}
+
+bool LliurexDuplicateFinder::running() const
+{
+    return m_running;
+}
+
+QString LliurexDuplicateFinder::rootPath() const
+{
+    return m_rootPath;
+}
+
+LliurexDuplicateFinder::Phase LliurexDuplicateFinder::phase() const
+{
+    return m_running ? Phase(m_search->phase.load()) : IdlePhase;
+}
+
+qint64 LliurexDuplicateFinder::candidateFiles() const
+{
+    return m_search ? m_search->candidates.load(std::memory_order_relaxed) : 0;
+}
+
+int LliurexDuplicateFinder::progress() const
+{
+    if (!m_search) {
+        return 0;
+    }
+    const qint64 total = m_search->total.load(std::memory_order_relaxed);
+    if (total <= 0) {
+        return 0;
+    }
+    return int(qMin<qint64>(100, m_search->processed.load(std::memory_order_relaxed) * 100 / total));
+}
+
+qint64 LliurexDuplicateFinder::reclaimable() const
+{
+    return m_reclaimable;
+}
+
+QString LliurexDuplicateFinder::reclaimableString() const
+{
+    return m_formatter.formatByteSize(m_reclaimable);
+}
+
+LliurexDuplicateModel *LliurexDuplicateFinder::model() const
+{
+    return m_model;
+}
+
+void LliurexDuplicateFinder::setWorkerCount(int count)
+{
+    m_workerCount = qBound(1, count, MaxWorkers);
+}
+
+void LliurexDuplicateFinder::setRunning(bool running)
+{
+    if (m_running != running) {
+        m_running = running;
+        emit runningChanged();
+    }
+}
+
+void LliurexDuplicateFinder::start(const QString &path)
+{
+    if (m_search) {
+        m_search->cancelled.store(true);
+        m_search.clear();
+    }
+
+    // the search resolves the canonical path, update() picks it up
+    const QString rootPath = QDir::cleanPath(path);
+    if (!QDir::isAbsolutePath(rootPath)) {
+        qCWarning(LLIUREXQUOTA) << "Cannot search" << path;
+        clear();
+        return;
+    }
+
+    m_model->clear();
+    m_reclaimable = 0;
+    if (m_rootPath != rootPath) {
+        m_rootPath = rootPath;
+        emit rootPathChanged();
+    }
+
+    m_search.reset(new LliurexDuplicateSearch(rootPath, m_workerCount));
+    QSharedPointer<LliurexDuplicateSearch> search = m_search;
+    QThreadPool *pool = searchPool();
+    pool->setMaxThreadCount(qMax(pool->maxThreadCount(), m_workerCount + 1));
+    pool->start(new FunctionRunnable([search]() {
+        search->run();
+    }));
+
+    m_updateTimer->start();
+    setRunning(true);
+    emit progressChanged();
+    emit resultsChanged();
+}
+
+void LliurexDuplicateFinder::cancel()
+{
+    if (!m_search || !m_running) {
+        return;
+    }
+
+    // the threads wind down on their own, groups of a cut search are
+    // not trustworthy
+    m_search->cancelled.store(true);
+    m_updateTimer->stop();
+    setRunning(false);
+    emit progressChanged();
+    emit finished();
+}
+
+void LliurexDuplicateFinder::clear()
+{
+    cancel();
+    m_search.clear();
+    m_model->clear();
+    m_reclaimable = 0;
+
+    if (!m_rootPath.isEmpty()) {
+        m_rootPath.clear();
+        emit rootPathChanged();
+    }
+    emit progressChanged();
+    emit resultsChanged();
+}
+
+void LliurexDuplicateFinder::update()
+{
+    if (!m_search) {
+        return;
+    }
+
+    if (m_search->failed.load()) {
+        qCWarning(LLIUREXQUOTA) << "Cannot search" << m_rootPath;
+        clear();
+        return;
+    }
+    if (m_search->resolved.load(std::memory_order_acquire) && m_rootPath != m_search->rootPath) {
+        m_rootPath = m_search->rootPath;
+        emit rootPathChanged();
+    }
+
+    if (m_search->done.load(std::memory_order_acquire)) {
+        m_updateTimer->stop();
+        m_reclaimable = 0;
+        for (const LliurexDuplicateModel::Group &group : qAsConst(m_search->groups)) {
+            m_reclaimable += group.reclaimable();
+        }
+        m_model->setGroups(m_search->groups, m_rootPath);
+        setRunning(false);
+        emit resultsChanged();
+        emit finished();
+    }
+    emit progressChanged();
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DUPLICATE_FINDER_H
+#define PLASMA_LLIUREX_DUPLICATE_FINDER_H
+
+#include <QObject>
+#include <QSharedPointer>
+
+#include "LliurexQuotaFormatter.h"
+
+class QTimer;
+class LliurexDuplicateModel;
+class LliurexDuplicateSearch;
+
+/**
+ * Finds files with equal contents below a folder, to tell how much space
+ * keeping a single copy of each would free.
+ *
+ * Files are compared in rounds that each read more of fewer files:
+ * first all files are grouped by size, which needs no reading at all;
+ * files of a size no other file has cannot have a copy. The remaining
+ * candidates are grouped by a hash of their first and last block, which
+ * separates nearly all different files of equal size (e.g. videos) with
+ * two small reads. Only files still in a group are read completely and
+ * compared by the hash of their whole contents (LliurexHash64).
+ *
+ * Hashing runs on a pool of threads, reading several files at once: on
+ * NFS that keeps the server busy, on a local disk it lets the kernel
+ * order the reads. Hard links of one file are no copies and are counted
+ * once; small files are skipped, their copies free little. The GUI
+ * thread only polls the progress and picks up the groups at the end.
+ */
+class LliurexDuplicateFinder : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(QString rootPath READ rootPath NOTIFY rootPathChanged)
+    Q_PROPERTY(Phase phase READ phase NOTIFY progressChanged)
+    Q_PROPERTY(qint64 candidateFiles READ candidateFiles NOTIFY progressChanged)
+    Q_PROPERTY(int progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(qint64 reclaimable READ reclaimable NOTIFY resultsChanged)
+    Q_PROPERTY(QString reclaimableString READ reclaimableString NOTIFY resultsChanged)
+    Q_PROPERTY(LliurexDuplicateModel* model READ model CONSTANT)
+
+    Q_ENUMS(Phase)
+
+public:
+    /**
+     * The rounds of a search.
+     */
+    enum Phase {
+        IdlePhase = 0,
+        ListingPhase,       // walking the tree, grouping by size
+        SamplingPhase,      // hashing the first and last block
+        HashingPhase        // hashing whole files
+    };
+
+    LliurexDuplicateFinder(QObject *parent = nullptr);
+    ~LliurexDuplicateFinder() override;
+
+    bool running() const;
+    QString rootPath() const;
+    Phase phase() const;
+
+    /**
+     * Files that still may have a copy, in the current round.
+     */
+    qint64 candidateFiles() const;
+
+    /**
+     * Percentage of the current round done.
+     */
+    int progress() const;
+
+    /**
+     * Space freed by removing all copies found.
+     */
+    qint64 reclaimable() const;
+    QString reclaimableString() const;
+
+    LliurexDuplicateModel *model() const;
+
+    /**
+     * Number of files read at once, by default twice the number of
+     * cores, at most 16.
+     */
+    void setWorkerCount(int count);
+
+public Q_SLOTS:
+    /**
+     * Starts searching @p path, cancelling a running search. rootPath()
+     * turns canonical once the search resolved it.
+     */
+    void start(const QString &path);
+
+    void cancel();
+
+    /**
+     * Cancels and forgets the search.
+     */
+    void clear();
+
+Q_SIGNALS:
+    void runningChanged();
+    void rootPathChanged();
+    void progressChanged();
+    void resultsChanged();
+
+    /**
+     * Emitted when the search completed or was cancelled.
+     */
+    void finished();
+
+private Q_SLOTS:
+    void update();
+
+private:
+    void setRunning(bool running);
+
+    QSharedPointer<LliurexDuplicateSearch> m_search;
+    LliurexDuplicateModel *m_model = nullptr;
+    QTimer *m_updateTimer = nullptr;
+    QString m_rootPath;
+    qint64 m_reclaimable = 0;
+    int m_workerCount = 0;
+    bool m_running = false;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_DUPLICATE_FINDER_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexDuplicateModel.h"
+
+#include <KLocalizedString>
+
+namespace {
+    /**
+     * QML data roles.
+     */
+    enum {
+        NameRole = Qt::UserRole,
+        PathsRole,
+        CountRole,
+        SizeRole,
+        SizeStringRole,
+        ReclaimableRole,
+        ReclaimableStringRole
+    };
+}
+
+qint64 LliurexDuplicateModel::Group::reclaimable() const
+{
+    return size * qMax(0, paths.size() - 1);
+}
+
+LliurexDuplicateModel::LliurexDuplicateModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QHash<int, QByteArray> LliurexDuplicateModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[PathsRole] = "paths";
+    roles[CountRole] = "count";
+    roles[SizeRole] = "size";
+    roles[SizeStringRole] = "sizeString";
+    roles[ReclaimableRole] = "reclaimable";
+    roles[ReclaimableStringRole] = "reclaimableString";
+
+    return roles;
+}
+
+QString LliurexDuplicateModel::displayPath(const QString &path) const
+{
+    if (path.startsWith(m_rootPath + QLatin1Char('/'))) {
+        return path.mid(m_rootPath.size() + 1);
+    }
+    return path;
+}
+
+QVariant LliurexDuplicateModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid() || index.row() >= m_groups.size()) {
+        return QVariant();
+    }
+
+    const Group &group = m_groups.at(index.row());
+
+    switch (role) {
+        case NameRole: return displayPath(group.paths.value(0));
+        case PathsRole: {
+            QStringList paths;
+            for (const QString &path : group.paths) {
+                paths.append(displayPath(path));
+            }
+            return paths;
+        }
+        case CountRole: return group.paths.size();
+        case SizeRole: return group.size;
+        case SizeStringRole: return m_formatter.formatByteSize(group.size);
+        case ReclaimableRole: return group.reclaimable();
+        case ReclaimableStringRole:
+            return i18nc("e.g.: 3 copies, 1.4 GiB can be freed", "%1 copies, %2 can be freed",
+                         group.paths.size(), m_formatter.formatByteSize(group.reclaimable()));
+    }
+
+    return QVariant();
+}
+
+int LliurexDuplicateModel::rowCount(const QModelIndex &index) const
+{
+    if (! index.isValid()) {
+        return m_groups.size();
+    }
+
+    return 0;
+}
+
+void LliurexDuplicateModel::setGroups(const QVector<Group> &groups, const QString &rootPath)
+{
+    beginResetModel();
+    m_groups = groups;
+    m_rootPath = rootPath;
+    endResetModel();
+}
+
+void LliurexDuplicateModel::clear()
+{
+    beginResetModel();
+    m_groups.clear();
+    m_rootPath.clear();
+    endResetModel();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_DUPLICATE_MODEL_H
+#define PLASMA_LLIUREX_DUPLICATE_MODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVector>
+
+#include "LliurexQuotaFormatter.h"
+
+/**
+ * Groups of identical files found by a LliurexDuplicateFinder, the group
+ * that frees most space first.
+ */
+class LliurexDuplicateModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Files with equal contents.
+     */
+    struct Group {
+        QStringList paths;
+        qint64 size = 0;        // of one file, allocated blocks
+
+        /**
+         * Space freed by keeping a single copy.
+         */
+        qint64 reclaimable() const;
+    };
+
+    LliurexDuplicateModel(QObject *parent = nullptr);
+
+public: // QAbstractListModel overrides
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &index) const override;
+
+public:
+    /**
+     * Replaces all rows with @p groups; paths are shown relative to
+     * @p rootPath.
+     */
+    void setGroups(const QVector<Group> &groups, const QString &rootPath);
+
+    void clear();
+
+private:
+    QString displayPath(const QString &path) const;
+
+    QVector<Group> m_groups;
+    QString m_rootPath;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_DUPLICATE_MODEL_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexHash64.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+    const quint64 Prime1 = 11400714785074694791ULL;
+    const quint64 Prime2 = 14029467366897019727ULL;
+    const quint64 Prime3 = 1609587929392839161ULL;
+    const quint64 Prime4 = 9650029242287828579ULL;
+    const quint64 Prime5 = 2870177450012600261ULL;
+
+    inline quint64 rotateLeft(quint64 value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline quint64 read64(const char *data)
+    {
+        quint64 value;
+        std::memcpy(&value, data, sizeof(value));
+        return qFromLittleEndian(value);
+    }
+
+    inline quint32 read32(const char *data)
+    {
+        quint32 value;
+        std::memcpy(&value, data, sizeof(value));
+        return qFromLittleEndian(value);
+    }
+
+    inline quint64 round(quint64 lane, quint64 input)
+    {
+        lane += input * Prime2;
+        lane = rotateLeft(lane, 31);
+        return lane * Prime1;
+    }
+
+    inline quint64 mergeRound(quint64 hash, quint64 lane)
+    {
+        hash ^= round(0, lane);
+        return hash * Prime1 + Prime4;
+    }
+
+    inline void consumeStripe(quint64 *lanes, const char *stripe)
+    {
+        lanes[0] = round(lanes[0], read64(stripe));
+        lanes[1] = round(lanes[1], read64(stripe + 8));
+        lanes[2] = round(lanes[2], read64(stripe + 16));
+        lanes[3] = round(lanes[3], read64(stripe + 24));
+    }
+}
+
+LliurexHash64::LliurexHash64(quint64 seed)
+    : m_seed(seed)
+{
+    m_lanes[0] = seed + Prime1 + Prime2;
+    m_lanes[1] = seed + Prime2;
+    m_lanes[2] = seed;
+    m_lanes[3] = seed - Prime1;
+}
+
+void LliurexHash64::addData(const char *data, qint64 length)
+{
+    m_length += length;
+
+    if (m_buffered + length < 32) {
+        std::memcpy(m_buffer + m_buffered, data, length);
+        m_buffered += length;
+        return;
+    }
+
+    if (m_buffered > 0) {
+        const int fill = 32 - m_buffered;
+        std::memcpy(m_buffer + m_buffered, data, fill);
+        consumeStripe(m_lanes, m_buffer);
+        data += fill;
+        length -= fill;
+        m_buffered = 0;
+    }
+
+    // local copies let the compiler keep the lanes out of memory
+    quint64 lanes[4] = {m_lanes[0], m_lanes[1], m_lanes[2], m_lanes[3]};
+    const char *end = data + length;
+    for (; data + 32 <= end; data += 32) {
+        consumeStripe(lanes, data);
+    }
+    std::memcpy(m_lanes, lanes, sizeof(lanes));
+
+    m_buffered = end - data;
+    std::memcpy(m_buffer, data, m_buffered);
+}
+
+quint64 LliurexHash64::result() const
+{
+    quint64 hash;
+    if (m_length >= 32) {
+        hash = rotateLeft(m_lanes[0], 1) + rotateLeft(m_lanes[1], 7) + rotateLeft(m_lanes[2], 12) + rotateLeft(m_lanes[3], 18);
+        for (int i = 0; i < 4; ++i) {
+            hash = mergeRound(hash, m_lanes[i]);
+        }
+    } else {
+        hash = m_seed + Prime5;
+    }
+    hash += m_length;
+
+    const char *data = m_buffer;
+    const char *end = m_buffer + m_buffered;
+    for (; data + 8 <= end; data += 8) {
+        hash ^= round(0, read64(data));
+        hash = rotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+    if (data + 4 <= end) {
+        hash ^= quint64(read32(data)) * Prime1;
+        hash = rotateLeft(hash, 23) * Prime2 + Prime3;
+        data += 4;
+    }
+    for (; data < end; ++data) {
+        hash ^= quint64(quint8(*data)) * Prime5;
+        hash = rotateLeft(hash, 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+quint64 LliurexHash64::hash(const char *data, qint64 length, quint64 seed)
+{
+    LliurexHash64 hasher(seed);
+    hasher.addData(data, length);
+    return hasher.result();
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_HASH64_H
+#define PLASMA_LLIUREX_HASH64_H
+
+#include <QtGlobal>
+
+/**
+ * Streaming XXH64, the 64-bit xxHash of Yann Collet.
+ *
+ * The input is consumed in stripes of 32 bytes by four independent
+ * accumulators, which the compiler keeps in registers or vector lanes:
+ * hashing runs at memory speed, far faster than a disk delivers. It is
+ * no cryptographic hash; it tells equal files from different ones, it
+ * does not resist crafted collisions.
+ */
+class LliurexHash64
+{
+public:
+    explicit LliurexHash64(quint64 seed = 0);
+
+    void addData(const char *data, qint64 length);
+
+    /**
+     * The hash of all data added so far; more data may be added after.
+     */
+    quint64 result() const;
+
+    static quint64 hash(const char *data, qint64 length, quint64 seed = 0);
+
+private:
+    quint64 m_lanes[4];
+    quint64 m_seed;
+    quint64 m_length = 0;
+    char m_buffer[32];
+    int m_buffered = 0;
+};
+
+#endif // PLASMA_LLIUREX_HASH64_H
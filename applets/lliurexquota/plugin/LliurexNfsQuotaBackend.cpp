@@ -0,0 +1,696 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexNfsQuotaBackend.h"
+#include "LliurexQuotaMetrics.h"
+#include "lliurexquota_debug.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHostInfo>
+#include <QSet>
+#include <QSysInfo>
+#include <QTimer>
+#include <QUdpSocket>
+
+#include <algorithm>
+
+#include <grp.h>
+#include <pwd.h>
+#include <unistd.h>
+
+namespace {
+    // ONC RPC (RFC 5531) and the programs asked here
+    const quint32 RpcCall = 0;
+    const quint32 RpcReply = 1;
+    const quint32 RpcVersion = 2;
+    const quint32 MsgAccepted = 0;
+    const quint32 AcceptSuccess = 0;
+    const quint32 AuthNull = 0;
+    const quint32 AuthUnix = 1;
+
+    const quint32 PortmapProgram = 100000;
+    const quint32 PortmapVersion = 2;
+    const quint32 PortmapGetPort = 3;
+    const quint16 PortmapPort = 111;
+    const quint32 IpProtoUdp = 17;
+
+    const quint32 RquotaProgram = 100011;
+    const quint32 RquotaVersion = 1;
+    const quint32 RquotaGetQuota = 1;
+
+    // getquota_rslt status
+    const quint32 QuotaOk = 1;
+    const quint32 QuotaNoQuota = 2;
+    const quint32 QuotaPermissionDenied = 3;
+
+    // a call is sent again after this long without a reply ...
+    const int RetransmitInterval = 1000;
+    // ... and given up after this many sends
+    const int MaxAttempts = 3;
+
+    // after rquotad could not answer, the fallback answers this long
+    const qint64 FallbackInterval = 10 * 60 * 1000;
+
+    /**
+     * Appends XDR encoded values, all big-endian and padded to 4 bytes.
+     */
+    class XdrWriter
+    {
+    public:
+        void putUInt(quint32 value)
+        {
+            const char bytes[4] = {
+                char(value >> 24), char(value >> 16), char(value >> 8), char(value)
+            };
+            m_data.append(bytes, 4);
+        }
+
+        void putOpaque(const QByteArray &value)
+        {
+            putUInt(quint32(value.size()));
+            m_data.append(value);
+            m_data.append(QByteArray((4 - value.size() % 4) % 4, '\0'));
+        }
+
+        QByteArray data() const { return m_data; }
+
+    private:
+        QByteArray m_data;
+    };
+
+    /**
+     * Reads XDR encoded values; reading past the end sets failed().
+     */
+    class XdrReader
+    {
+    public:
+        explicit XdrReader(const QByteArray &data) : m_data(data) {}
+
+        quint32 getUInt()
+        {
+            if (m_pos + 4 > m_data.size()) {
+                m_failed = true;
+                return 0;
+            }
+            const uchar *p = reinterpret_cast<const uchar *>(m_data.constData()) + m_pos;
+            m_pos += 4;
+            return quint32(p[0]) << 24 | quint32(p[1]) << 16 | quint32(p[2]) << 8 | quint32(p[3]);
+        }
+
+        void skipOpaque()
+        {
+            const quint32 size = getUInt();
+            const qint64 padded = (qint64(size) + 3) & ~qint64(3);
+            if (m_pos + padded > m_data.size()) {
+                m_failed = true;
+                return;
+            }
+            m_pos += int(padded);
+        }
+
+        bool failed() const { return m_failed; }
+
+    private:
+        QByteArray m_data;
+        int m_pos = 0;
+        bool m_failed = false;
+    };
+
+    QByteArray callHeader(quint32 xid, quint32 program, quint32 version, quint32 procedure, uint uid)
+    {
+        XdrWriter xdr;
+        xdr.putUInt(xid);
+        xdr.putUInt(RpcCall);
+        xdr.putUInt(RpcVersion);
+        xdr.putUInt(program);
+        xdr.putUInt(version);
+        xdr.putUInt(procedure);
+
+        // rquotad only answers about other users to root, so say who asks
+        XdrWriter cred;
+        cred.putUInt(quint32(QDateTime::currentMSecsSinceEpoch() / 1000));
+        cred.putOpaque(QSysInfo::machineHostName().toLatin1().left(255));
+        cred.putUInt(uid);
+        cred.putUInt(getgid());
+        cred.putUInt(0);            // no supplementary groups
+        xdr.putUInt(AuthUnix);
+        xdr.putOpaque(cred.data());
+
+        xdr.putUInt(AuthNull);
+        xdr.putUInt(0);
+        return xdr.data();
+    }
+
+    // mountinfo escapes blanks and backslashes as octal sequences, e.g. '\040'
+    QByteArray unescapeMountField(const QByteArray &field)
+    {
+        if (!field.contains('\\')) {
+            return field;
+        }
+        QByteArray result;
+        result.reserve(field.size());
+        for (int i = 0; i < field.size(); ++i) {
+            if (field[i] == '\\' && i + 3 < field.size()) {
+                bool ok = false;
+                const int c = field.mid(i + 1, 3).toInt(&ok, 8);
+                if (ok) {
+                    result.append(char(c));
+                    i += 3;
+                    continue;
+                }
+            }
+            result.append(field[i]);
+        }
+        return result;
+    }
+
+    QString userName(uint uid)
+    {
+        char buffer[1024];
+        struct passwd pwd;
+        struct passwd *result = nullptr;
+        if (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &result) == 0 && result) {
+            return QString::fromLocal8Bit(result->pw_name);
+        }
+        return QString();
+    }
+
+    QString groupName(uint gid)
+    {
+        char buffer[4096];
+        struct group grp;
+        struct group *result = nullptr;
+        if (getgrgid_r(gid, &grp, buffer, sizeof(buffer), &result) == 0 && result) {
+            return QString::fromLocal8Bit(result->gr_name);
+        }
+        return QString();
+    }
+}
+
+LliurexNfsQuotaBackend::LliurexNfsQuotaBackend(LliurexQuotaBackend *fallback, QObject *parent)
+    : LliurexQuotaBackend(parent)
+    , m_fallback(fallback)
+    , m_retransmitTimer(new QTimer(this))
+{
+    if (m_fallback) {
+        m_fallback->setParent(this);
+        connect(m_fallback, &LliurexQuotaBackend::quotaReady, this, [this](const QVector<LliurexQuotaEntry> &entries) {
+            if (m_usingFallback) {
+                emit quotaReady(entries);
+            }
+        });
+        connect(m_fallback, &LliurexQuotaBackend::quotaUnchanged, this, [this]() {
+            if (m_usingFallback) {
+                emit quotaUnchanged();
+            }
+        });
+        connect(m_fallback, &LliurexQuotaBackend::quotaFailed, this, [this](const QString &reason) {
+            if (m_usingFallback) {
+                emit quotaFailed(reason);
+            }
+        });
+    }
+
+    m_nfs4Root = qgetenv("LLIUREX_NFS4_ROOT");
+    while (m_nfs4Root.endsWith('/')) {
+        m_nfs4Root.chop(1);
+    }
+
+    m_uid = getuid();
+    m_userName = userName(m_uid);
+    m_groupName = groupName(getgid());
+    m_nextXid = quint32(QDateTime::currentMSecsSinceEpoch()) ^ quint32(getpid()) << 16;
+    m_clock.start();
+
+    bool ok = false;
+    const uint port = qgetenv("LLIUREX_RQUOTA_PORT").toUInt(&ok);
+    if (ok && port > 0 && port <= 0xffff) {
+        m_portOverride = quint16(port);
+    }
+
+    m_retransmitTimer->setInterval(RetransmitInterval / 4);
+    connect(m_retransmitTimer, &QTimer::timeout, this, &LliurexNfsQuotaBackend::retransmit);
+}
+
+LliurexNfsQuotaBackend::~LliurexNfsQuotaBackend()
+{
+}
+
+QString LliurexNfsQuotaBackend::name() const
+{
+    return m_usingFallback ? m_fallback->name() : QStringLiteral("nfs");
+}
+
+bool LliurexNfsQuotaBackend::isAvailable() const
+{
+    return ! nfsMounts().isEmpty() || (m_fallback && m_fallback->isAvailable());
+}
+
+void LliurexNfsQuotaBackend::forgetLastResult()
+{
+    m_hasLastEntries = false;
+    m_lastEntries.clear();
+    if (m_fallback) {
+        m_fallback->forgetLastResult();
+    }
+}
+
+void LliurexNfsQuotaBackend::requestQuota()
+{
+    // replies to the calls of an aborted query no longer match any xid
+    m_calls.clear();
+    abortLookups();
+
+    if (m_fallback && m_fallbackSince.isValid() && !m_fallbackSince.hasExpired(FallbackInterval)) {
+        askFallback();
+        return;
+    }
+    m_fallbackSince.invalidate();
+    if (m_usingFallback) {
+        // the data shown came from the fallback, the next result must be published
+        m_usingFallback = false;
+        m_hasLastEntries = false;
+    }
+
+    m_entries.clear();
+    m_failure.clear();
+    m_mounts = nfsMounts();
+    m_remaining = m_mounts.size();
+    if (m_mounts.isEmpty()) {
+        m_failure = QStringLiteral("no NFS mounts");
+        finish();
+        return;
+    }
+
+    for (int i = 0; i < m_mounts.size(); ++i) {
+        startMount(i);
+    }
+    m_retransmitTimer->start();
+}
+
+void LliurexNfsQuotaBackend::startMount(int mount)
+{
+    Mount &target = m_mounts[mount];
+    if (target.address.isNull()) {
+        const auto it = m_hostAddresses.constFind(target.host);
+        if (it == m_hostAddresses.constEnd()) {
+            // one lookup per host, its mounts start when it is done
+            const QList<QString> pending = m_lookups.values();
+            if (!pending.contains(target.host)) {
+                m_lookups.insert(QHostInfo::lookupHost(target.host, this, SLOT(hostFound(QHostInfo))), target.host);
+            }
+            return;
+        }
+        target.address = it.value();
+    }
+
+    const Server &srv = server(target.address);
+    startCall(m_portOverride || srv.rquotaPort ? Call::GetQuota : Call::GetPort, mount);
+}
+
+void LliurexNfsQuotaBackend::hostFound(const QHostInfo &info)
+{
+    // lookups of aborted queries are not in m_lookups any more
+    const QString host = m_lookups.take(info.lookupId());
+    if (host.isEmpty()) {
+        return;
+    }
+
+    // rquotad is often reachable over IPv4 only, even on dual-stack servers
+    const QList<QHostAddress> addresses = info.addresses();
+    if (!addresses.isEmpty()) {
+        QHostAddress address = addresses.first();
+        for (const QHostAddress &candidate : addresses) {
+            if (candidate.protocol() == QAbstractSocket::IPv4Protocol) {
+                address = candidate;
+                break;
+            }
+        }
+        m_hostAddresses.insert(host, address);
+    }
+
+    for (int i = 0; i < m_mounts.size(); ++i) {
+        if (!m_mounts[i].address.isNull() || m_mounts[i].host != host) {
+            continue;
+        }
+        if (addresses.isEmpty()) {
+            mountFailed(i, QStringLiteral("cannot find %1: %2").arg(host, info.errorString()));
+        } else {
+            startMount(i);
+        }
+    }
+}
+
+void LliurexNfsQuotaBackend::abortLookups()
+{
+    for (auto it = m_lookups.constBegin(); it != m_lookups.constEnd(); ++it) {
+        QHostInfo::abortHostLookup(it.key());
+    }
+    m_lookups.clear();
+}
+
+void LliurexNfsQuotaBackend::askFallback()
+{
+    if (!m_usingFallback) {
+        // the data shown came from rquotad, the next result must be published
+        m_usingFallback = true;
+        m_fallback->forgetLastResult();
+    }
+    m_fallback->requestQuota();
+}
+
+LliurexNfsQuotaBackend::Server &LliurexNfsQuotaBackend::server(const QHostAddress &address)
+{
+    Server &srv = m_servers[address.toString()];
+    if (!srv.socket) {
+        srv.socket = new QUdpSocket(this);
+        srv.socket->bind(address.protocol() == QAbstractSocket::IPv6Protocol ? QHostAddress::AnyIPv6 : QHostAddress::AnyIPv4, 0);
+        connect(srv.socket, &QUdpSocket::readyRead, this, &LliurexNfsQuotaBackend::readDatagrams);
+    }
+    return srv;
+}
+
+void LliurexNfsQuotaBackend::startCall(Call::Kind kind, int mount)
+{
+    const Mount &target = m_mounts[mount];
+    const quint32 xid = ++m_nextXid;
+
+    Call call;
+    call.kind = kind;
+    call.mount = mount;
+
+    if (kind == Call::GetPort) {
+        XdrWriter args;
+        args.putUInt(RquotaProgram);
+        args.putUInt(RquotaVersion);
+        args.putUInt(IpProtoUdp);
+        args.putUInt(0);
+        call.datagram = callHeader(xid, PortmapProgram, PortmapVersion, PortmapGetPort, m_uid) + args.data();
+        call.port = PortmapPort;
+    } else {
+        // rquotad knows the paths of the server, not those below an NFSv4 pseudo-root
+        QByteArray path = target.exportPath;
+        if (target.nfs4 && !m_nfs4Root.isEmpty()) {
+            path = path == "/" ? m_nfs4Root : m_nfs4Root + path;
+        }
+        XdrWriter args;
+        args.putOpaque(path);
+        args.putUInt(m_uid);
+        call.datagram = callHeader(xid, RquotaProgram, RquotaVersion, RquotaGetQuota, m_uid) + args.data();
+        call.port = m_portOverride ? m_portOverride : server(target.address).rquotaPort;
+    }
+
+    send(call);
+    m_calls.insert(xid, call);
+}
+
+void LliurexNfsQuotaBackend::send(Call &call)
+{
+    const Mount &target = m_mounts[call.mount];
+    ++call.attempts;
+    call.sentAt = m_clock.elapsed();
+    // a full send buffer drops the datagram like the network would, the
+    // retransmission covers both
+    server(target.address).socket->writeDatagram(call.datagram, target.address, call.port);
+}
+
+void LliurexNfsQuotaBackend::retransmit()
+{
+    const qint64 now = m_clock.elapsed();
+    QVector<quint32> expired;
+
+    for (auto it = m_calls.begin(); it != m_calls.end(); ++it) {
+        if (now - it->sentAt < RetransmitInterval) {
+            continue;
+        }
+        if (it->attempts < MaxAttempts) {
+            send(it.value());
+        } else {
+            expired.append(it.key());
+        }
+    }
+
+    for (quint32 xid : expired) {
+        // a failure may have started the next query already
+        if (!m_calls.contains(xid)) {
+            continue;
+        }
+        const Call call = m_calls.take(xid);
+        const Mount &target = m_mounts[call.mount];
+        qCWarning(LLIUREXQUOTA) << "rquota server" << target.address << "did not answer for" << target.mountPoint;
+        LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::Timeouts);
+        if (call.kind == Call::GetQuota) {
+            // rquotad may have been restarted on another port
+            server(target.address).rquotaPort = 0;
+        }
+        // or the host may have moved
+        m_hostAddresses.remove(target.host);
+        mountFailed(call.mount, QStringLiteral("%1 timed out").arg(target.address.toString()));
+    }
+}
+
+void LliurexNfsQuotaBackend::readDatagrams()
+{
+    QUdpSocket *socket = qobject_cast<QUdpSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    while (socket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(int(qMax<qint64>(socket->pendingDatagramSize(), 0)));
+        QHostAddress from;
+        if (socket->readDatagram(datagram.data(), datagram.size(), &from) < 4) {
+            continue;
+        }
+
+        XdrReader xdr(datagram);
+        const quint32 xid = xdr.getUInt();
+        auto it = m_calls.find(xid);
+        // late duplicates of answered or aborted calls
+        if (it == m_calls.end() || !m_mounts[it->mount].address.isEqual(from)) {
+            continue;
+        }
+        const Call call = it.value();
+        m_calls.erase(it);
+        handleReply(call, datagram);
+    }
+}
+
+void LliurexNfsQuotaBackend::handleReply(const Call &call, const QByteArray &datagram)
+{
+    const Mount &target = m_mounts[call.mount];
+
+    XdrReader xdr(datagram);
+    xdr.getUInt();                                  // xid
+    const quint32 type = xdr.getUInt();
+    const quint32 replyStatus = xdr.getUInt();
+    if (type != RpcReply || replyStatus != MsgAccepted) {
+        mountFailed(call.mount, QStringLiteral("%1 rejected the call").arg(target.address.toString()));
+        return;
+    }
+    xdr.getUInt();                                  // verifier flavor
+    xdr.skipOpaque();
+    const quint32 acceptStatus = xdr.getUInt();
+    if (xdr.failed() || acceptStatus != AcceptSuccess) {
+        const QString program = call.kind == Call::GetPort ? QStringLiteral("portmapper") : QStringLiteral("rquotad");
+        mountFailed(call.mount, QStringLiteral("%1 %2 error %3").arg(target.address.toString(), program).arg(acceptStatus));
+        return;
+    }
+
+    if (call.kind == Call::GetPort) {
+        const quint32 port = xdr.getUInt();
+        if (xdr.failed() || port == 0 || port > 0xffff) {
+            mountFailed(call.mount, QStringLiteral("%1 does not run rquotad").arg(target.address.toString()));
+            return;
+        }
+        server(target.address).rquotaPort = quint16(port);
+        startCall(Call::GetQuota, call.mount);
+        return;
+    }
+
+    const quint32 status = xdr.getUInt();
+    if (status == QuotaNoQuota) {
+        // rquotad knows user quotas only, and only on paths it exports:
+        // a group quota or a path it does not know look the same
+        mountFailed(call.mount, QStringLiteral("%1 has no user quota on %2")
+                                    .arg(target.address.toString(), QString::fromLocal8Bit(target.exportPath)));
+        return;
+    }
+    if (status == QuotaPermissionDenied) {
+        mountFailed(call.mount, QStringLiteral("%1 denied the quota of %2").arg(target.address.toString()).arg(m_uid));
+        return;
+    }
+
+    // struct rquota: bsize, active, bhardlimit, bsoftlimit, curblocks,
+    // fhardlimit, fsoftlimit, curfiles, btimeleft, ftimeleft
+    quint32 rquota[10];
+    for (quint32 &field : rquota) {
+        field = xdr.getUInt();
+    }
+    if (xdr.failed() || status != QuotaOk) {
+        mountFailed(call.mount, QStringLiteral("%1 sent a malformed quota").arg(target.address.toString()));
+        return;
+    }
+
+    const qint64 blockSize = rquota[0];
+    LliurexQuotaEntry entry;
+    entry.type = LliurexQuotaEntry::UserQuota;
+    entry.id = m_uid;
+    entry.name = m_userName;
+    entry.group = m_groupName;
+    entry.mountPoint = target.mountPoint;
+    entry.hardLimit = qint64(rquota[2]) * blockSize;
+    entry.softLimit = qint64(rquota[3]) * blockSize;
+    entry.used = qint64(rquota[4]) * blockSize;
+    entry.inodeHardLimit = rquota[5];
+    entry.inodeSoftLimit = rquota[6];
+    entry.inodesUsed = rquota[7];
+    // the grace period is sent as seconds left, not as a point in time
+    const qint32 blocksTimeLeft = qint32(rquota[8]);
+    if (blocksTimeLeft > 0 && entry.softLimit && entry.used > entry.softLimit) {
+        entry.graceTime = QDateTime::currentMSecsSinceEpoch() / 1000 + blocksTimeLeft;
+    }
+
+    if (entry.hardLimit || entry.softLimit || entry.inodeHardLimit || entry.inodeSoftLimit) {
+        m_entries.append(entry);
+    }
+    mountDone();
+}
+
+void LliurexNfsQuotaBackend::mountFailed(int mount, const QString &reason)
+{
+    qCDebug(LLIUREXQUOTA) << "no NFS quota for" << m_mounts[mount].mountPoint << reason;
+    if (m_failure.isEmpty()) {
+        m_failure = reason;
+    }
+    mountDone();
+}
+
+void LliurexNfsQuotaBackend::mountDone()
+{
+    if (--m_remaining == 0) {
+        finish();
+    }
+}
+
+void LliurexNfsQuotaBackend::finish()
+{
+    m_retransmitTimer->stop();
+    abortLookups();
+
+    // a partial answer would make the quotas of the missing mounts vanish
+    // from the list: the fallback answers instead, or failing keeps the
+    // last complete one on screen
+    if (!m_failure.isEmpty()) {
+        m_hasLastEntries = false;
+        if (m_fallback) {
+            qCDebug(LLIUREXQUOTA) << "rquotad cannot answer," << m_failure << "- asking" << m_fallback->name();
+            m_fallbackSince.start();
+            askFallback();
+            return;
+        }
+        emit quotaFailed(m_failure);
+        return;
+    }
+
+    // the order of replies is arbitrary, the order of the mounts is not
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const LliurexQuotaEntry &a, const LliurexQuotaEntry &b) {
+        return a.mountPoint < b.mountPoint;
+    });
+
+    if (m_hasLastEntries && m_entries == m_lastEntries) {
+        emit quotaUnchanged();
+        return;
+    }
+    m_lastEntries = m_entries;
+    m_hasLastEntries = true;
+
+    emit quotaReady(m_entries);
+}
+
+QVector<LliurexNfsQuotaBackend::Mount> LliurexNfsQuotaBackend::nfsMounts(const QString &mountInfoPath)
+{
+    QVector<Mount> mounts;
+
+    QString path = mountInfoPath;
+    if (path.isEmpty()) {
+        path = QString::fromLocal8Bit(qgetenv("LLIUREX_NFS_MOUNTINFO"));
+    }
+    if (path.isEmpty()) {
+        path = QStringLiteral("/proc/self/mountinfo");
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return mounts;
+    }
+
+    QSet<QString> exports;
+
+    // format: id parent major:minor root mountpoint options [optional...] - fstype source superoptions
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        const int separator = fields.indexOf("-");
+        if (separator < 6 || separator + 2 >= fields.size()) {
+            continue;
+        }
+
+        const QByteArray fsType = fields[separator + 1];
+        if (fsType != "nfs" && fsType != "nfs4") {
+            continue;
+        }
+
+        // server:/export, with IPv6 literals in brackets
+        const QByteArray source = unescapeMountField(fields[separator + 2]);
+        const int colon = source.indexOf(":/");
+        if (colon <= 0) {
+            continue;
+        }
+
+        Mount mount;
+        mount.exportPath = source.mid(colon + 1);
+        mount.nfs4 = fsType == "nfs4";
+        QByteArray host = source.left(colon);
+        if (host.startsWith('[') && host.endsWith(']')) {
+            host = host.mid(1, host.size() - 2);
+        }
+        mount.host = QString::fromLatin1(host);
+        for (const QByteArray &option : fields.value(separator + 3).split(',')) {
+            if (option.startsWith("addr=")) {
+                mount.address.setAddress(QString::fromLatin1(option.mid(5)));
+            }
+        }
+        // else a literal address, or a host name looked up when asked
+        if (mount.address.isNull()) {
+            mount.address.setAddress(mount.host);
+        }
+
+        const QString server = mount.address.isNull() ? mount.host : mount.address.toString();
+        const QString key = server + QLatin1Char(':') + QString::fromLocal8Bit(mount.exportPath);
+        if (exports.contains(key)) {
+            continue;
+        }
+        exports.insert(key);
+
+        mount.mountPoint = QString::fromLocal8Bit(unescapeMountField(fields[4]));
+        mounts.append(mount);
+    }
+
+    return mounts;
+}
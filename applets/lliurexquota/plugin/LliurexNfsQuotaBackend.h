@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_NFS_QUOTA_BACKEND_H
+#define PLASMA_LLIUREX_NFS_QUOTA_BACKEND_H
+
+#include "LliurexQuotaBackend.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+
+class QHostInfo;
+class QTimer;
+class QUdpSocket;
+
+/**
+ * Quota backend asking the rpc.rquotad of the servers of the NFS mounts
+ * listed in /proc/self/mountinfo directly, instead of the kernel.
+ *
+ * quotactl(2) and the quota tools sleep uninterruptibly while an NFS
+ * server stalls. This backend speaks ONC RPC over UDP itself, on
+ * non-blocking sockets driven by the event loop: the rquotad port is
+ * looked up with the portmapper once and kept, like the socket of each
+ * server, across polls; calls are retransmitted, and a server that does
+ * not answer in time fails the query without blocking anything.
+ *
+ * The user quota is read with RQUOTAVERS 1 GETQUOTA on the exported path.
+ * Servers are addressed by the addr= mount option; a mount without it is
+ * addressed by its host name, looked up without blocking. NFSv4 mounts
+ * name a path below the server's pseudo-root, which rquotad does not
+ * know: LLIUREX_NFS4_ROOT gives the server path of that root.
+ *
+ * rquotad answers for user quotas only and may not run at all, so every
+ * query it cannot answer completely (a server that does not answer, a
+ * mount without a quota, an address that cannot be found) is handed to
+ * the @p fallback backend, which then answers all queries for a while
+ * before rquotad is tried again. The backend is only used when asked for
+ * with LLIUREX_QUOTA_BACKEND=nfs.
+ *
+ * LLIUREX_NFS_MOUNTINFO names another mountinfo file and
+ * LLIUREX_RQUOTA_PORT skips the portmapper, to test against a stand-in
+ * rquotad on this host.
+ */
+class LliurexNfsQuotaBackend : public LliurexQuotaBackend
+{
+    Q_OBJECT
+
+public:
+    /**
+     * An NFS mount and where its quota is asked for.
+     */
+    struct Mount {
+        QString mountPoint;
+        QByteArray exportPath;      // path on the server
+        QHostAddress address;       // null until the host was looked up
+        QString host;
+        bool nfs4 = false;
+    };
+
+    /**
+     * Takes ownership of @p fallback, which may be null.
+     */
+    LliurexNfsQuotaBackend(LliurexQuotaBackend *fallback, QObject *parent = nullptr);
+    ~LliurexNfsQuotaBackend() override;
+
+    QString name() const override;
+    bool isAvailable() const override;
+    void requestQuota() override;
+    void forgetLastResult() override;
+
+public:
+    /**
+     * Returns the NFS mounts of @p mountInfoPath, one per exported path.
+     * By default, LLIUREX_NFS_MOUNTINFO or /proc/self/mountinfo is read.
+     */
+    static QVector<Mount> nfsMounts(const QString &mountInfoPath = QString());
+
+private Q_SLOTS:
+    void readDatagrams();
+    void retransmit();
+    void hostFound(const QHostInfo &info);
+
+private:
+    struct Server {
+        QUdpSocket *socket = nullptr;
+        quint16 rquotaPort = 0;     // 0 until the portmapper answered
+    };
+
+    struct Call {
+        enum Kind {
+            GetPort,
+            GetQuota
+        };
+
+        Kind kind = GetPort;
+        int mount = 0;              // index into m_mounts
+        QByteArray datagram;
+        quint16 port = 0;
+        int attempts = 0;
+        qint64 sentAt = 0;          // m_clock milliseconds
+    };
+
+    Server &server(const QHostAddress &address);
+    void startMount(int mount);
+    void abortLookups();
+    void askFallback();
+    void startCall(Call::Kind kind, int mount);
+    void send(Call &call);
+    void handleReply(const Call &call, const QByteArray &datagram);
+    void mountFailed(int mount, const QString &reason);
+    void mountDone();
+    void finish();
+
+    LliurexQuotaBackend *m_fallback = nullptr;
+    bool m_usingFallback = false;       // the fallback answers the current query
+    QElapsedTimer m_fallbackSince;      // valid while rquotad is not asked
+
+    QHash<QString, Server> m_servers;   // by address, kept across polls
+    QHash<QString, QHostAddress> m_hostAddresses;   // kept across polls
+    QHash<int, QString> m_lookups;      // host lookups of this query
+    QHash<quint32, Call> m_calls;       // by transaction id
+    QVector<Mount> m_mounts;
+    QByteArray m_nfs4Root;
+    QVector<LliurexQuotaEntry> m_entries;
+    QString m_failure;
+    int m_remaining = 0;
+    quint32 m_nextXid = 0;
+    quint16 m_portOverride = 0;
+    uint m_uid = 0;
+    QString m_userName;
+    QString m_groupName;
+    QTimer *m_retransmitTimer = nullptr;
+    QElapsedTimer m_clock;
+    QVector<LliurexQuotaEntry> m_lastEntries;
+    bool m_hasLastEntries = false;
+};
+
+#endif // PLASMA_LLIUREX_NFS_QUOTA_BACKEND_H
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexPollScheduler.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QSysInfo>
+#include <QTimer>
+
+namespace {
+    // every interval is stretched by up to +-10% depending on the host ...
+    const double HostJitter = 0.10;
+    // ... and by up to +-5% at random on every poll
+    const double RandomJitter = 0.05;
+
+    // usage samples closer than this are too noisy for a growth rate
+    const qint64 MinGrowthSampleDistance = 10 * 1000;
+
+    // maximum delay of the catch-up poll after the screen was unlocked
+    const int ResumeDelay = 5 * 1000;
+
+    class MonotonicClock : public LliurexPollScheduler::Clock
+    {
+    public:
+        MonotonicClock()
+        {
+            m_timer.start();
+        }
+
+        qint64 now() const override
+        {
+            return m_timer.elapsed();
+        }
+
+    private:
+        QElapsedTimer m_timer;
+    };
+
+    quint32 machineSeed()
+    {
+        for (const QString &fileName : {QStringLiteral("/etc/machine-id"), QStringLiteral("/var/lib/dbus/machine-id")}) {
+            QFile file(fileName);
+            if (file.open(QIODevice::ReadOnly)) {
+                const QByteArray id = file.readAll().trimmed();
+                if (!id.isEmpty()) {
+                    return qHash(id);
+                }
+            }
+        }
+        return qHash(QSysInfo::machineHostName());
+    }
+}
+
+LliurexPollScheduler::Clock::~Clock()
+{
+}
+
+LliurexPollScheduler::LliurexPollScheduler(QObject *parent)
+    : QObject(parent)
+    , m_clock(new MonotonicClock())
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &LliurexPollScheduler::timeout);
+    setHostSeed(machineSeed());
+}
+
+LliurexPollScheduler::~LliurexPollScheduler()
+{
+}
+
+void LliurexPollScheduler::setClock(Clock *clock)
+{
+    m_clock.reset(clock);
+    m_lastUsage = -1;
+    m_lastPoll = -1;
+}
+
+void LliurexPollScheduler::setHostSeed(quint32 seed)
+{
+    // the host phase is fixed per host, the random part differs per process
+    m_hostPhase = (seed % 10007) / 10007.0;
+    m_random.seed(seed ^ quint32(QCoreApplication::applicationPid()));
+}
+
+void LliurexPollScheduler::start(int initialDelay)
+{
+    m_running = true;
+    if (m_paused) {
+        return;
+    }
+    schedule(initialDelay >= 0 ? initialDelay : int(m_hostPhase * nextInterval()));
+}
+
+int LliurexPollScheduler::startupDelay(int window)
+{
+    const double random = std::uniform_real_distribution<double>(0.0, 1.0)(m_random);
+    return int(window * 0.5 * (m_hostPhase + random));
+}
+
+void LliurexPollScheduler::stop()
+{
+    m_running = false;
+    m_timer->stop();
+}
+
+bool LliurexPollScheduler::isPaused() const
+{
+    return m_paused;
+}
+
+void LliurexPollScheduler::setPaused(bool paused)
+{
+    if (m_paused == paused) {
+        return;
+    }
+    m_paused = paused;
+
+    if (!m_running) {
+        return;
+    }
+
+    if (paused) {
+        m_timer->stop();
+        return;
+    }
+
+    const int interval = nextInterval();
+    const qint64 sinceLastPoll = m_lastPoll < 0 ? interval : m_clock->now() - m_lastPoll;
+    if (sinceLastPoll >= interval) {
+        // overdue: catch up soon, but not all clients of a classroom at once
+        schedule(std::uniform_int_distribution<int>(0, ResumeDelay)(m_random));
+    } else {
+        schedule(int(interval - sinceLastPoll));
+    }
+}
+
+void LliurexPollScheduler::setSafetyInterval(int interval)
+{
+    if (m_safetyInterval == interval) {
+        return;
+    }
+    m_safetyInterval = interval;
+
+    if (m_running && !m_paused) {
+        const int next = nextInterval();
+        const qint64 sinceLastPoll = m_lastPoll < 0 ? 0 : m_clock->now() - m_lastPoll;
+        schedule(int(qMax(qint64(0), next - sinceLastPoll)));
+    }
+}
+
+void LliurexPollScheduler::reportUsage(int usage)
+{
+    const qint64 now = m_clock->now();
+
+    if (m_lastUsage < 0) {
+        m_lastUsage = usage;
+        m_lastUsageTime = now;
+    } else if (now - m_lastUsageTime >= MinGrowthSampleDistance) {
+        const double rate = (usage - m_lastUsage) * 3600.0 * 1000.0 / (now - m_lastUsageTime);
+        m_growthRate = 0.5 * m_growthRate + 0.5 * rate;
+        m_lastUsage = usage;
+        m_lastUsageTime = now;
+    }
+
+    m_usage = usage;
+    m_lastPoll = now;
+
+    if (m_running && !m_paused) {
+        schedule(nextInterval());
+    }
+}
+
+double LliurexPollScheduler::growthRate() const
+{
+    return m_growthRate;
+}
+
+int LliurexPollScheduler::policyInterval(int usage, double growthRate)
+{
+    if (usage >= 90 || growthRate >= 10.0) {
+        return 30 * 1000;
+    } else if (usage >= 75 || growthRate >= 2.0) {
+        return 60 * 1000;
+    } else if (usage >= 50 || growthRate >= 0.5) {
+        return 2 * 60 * 1000;
+    }
+
+    // below 50% and stable
+    return 5 * 60 * 1000;
+}
+
+int LliurexPollScheduler::nextInterval()
+{
+    const int base = m_safetyInterval > 0 ? m_safetyInterval : policyInterval(m_usage, m_growthRate);
+    const double random = std::uniform_real_distribution<double>(-RandomJitter, RandomJitter)(m_random);
+    const double factor = 1.0 + HostJitter * (2.0 * m_hostPhase - 1.0) + random;
+    return qMax(1000, int(base * factor));
+}
+
+void LliurexPollScheduler::schedule(int interval)
+{
+    // coarse timers let the kernel batch our wakeups with others
+    m_timer->setTimerType(interval >= 60 * 1000 ? Qt::VeryCoarseTimer : Qt::CoarseTimer);
+    m_timer->start(interval);
+}
+
+void LliurexPollScheduler::timeout()
+{
+    m_lastPoll = m_clock->now();
+    emit pollRequested();
+
+    // rescheduled again by reportUsage() once the poll delivered data
+    if (m_running && !m_paused) {
+        schedule(nextInterval());
+    }
+}
+
+void LliurexPollScheduler::watchScreenSaver()
+{
+    QDBusConnection::sessionBus().connect(QStringLiteral("org.freedesktop.ScreenSaver"),
+                                          QStringLiteral("/ScreenSaver"),
+                                          QStringLiteral("org.freedesktop.ScreenSaver"),
+                                          QStringLiteral("ActiveChanged"),
+                                          this, SLOT(screenSaverActiveChanged(bool)));
+}
+
+void LliurexPollScheduler::screenSaverActiveChanged(bool active)
+{
+    setPaused(active);
+}
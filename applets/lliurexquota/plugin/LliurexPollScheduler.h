@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_POLL_SCHEDULER_H
+#define PLASMA_LLIUREX_POLL_SCHEDULER_H
+
+#include <QObject>
+#include <QScopedPointer>
+
+#include <random>
+
+class QTimer;
+
+/**
+ * Decides when the quota is polled next.
+ *
+ * The interval adapts to the last reported usage: a stable quota under 50%
+ * is polled every few minutes, a quota close to the 90% attention threshold
+ * or growing fast every 30 seconds. Every interval is stretched or shrunk by
+ * a per-host jitter, so that clients logging in at the same moment do not
+ * poll the quota server in lockstep. Polling pauses while the screen saver
+ * or screen locker is active.
+ *
+ * All time keeping goes through a Clock, so the policy can be tested with a
+ * mocked clock.
+ */
+class LliurexPollScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Monotonic time source in milliseconds.
+     */
+    class Clock
+    {
+    public:
+        virtual ~Clock();
+        virtual qint64 now() const = 0;
+    };
+
+    LliurexPollScheduler(QObject *parent = nullptr);
+    ~LliurexPollScheduler() override;
+
+    /**
+     * Replaces the monotonic clock, takes ownership of @p clock.
+     */
+    void setClock(Clock *clock);
+
+    /**
+     * Seeds the jitter. By default the seed is derived from /etc/machine-id,
+     * so every host gets its own stable phase.
+     */
+    void setHostSeed(quint32 seed);
+
+    /**
+     * Starts scheduling. The first poll is delayed by @p initialDelay
+     * milliseconds, or by a per-host fraction of the interval if negative.
+     */
+    void start(int initialDelay = -1);
+    void stop();
+
+    /**
+     * A delay for the first poll after login, up to @p window milliseconds:
+     * half of it is the per-host phase, half is random, so that neither
+     * clients booted together nor restarts of the same host line up.
+     */
+    int startupDelay(int window);
+
+    /**
+     * Pauses polling, e.g. while the screen is locked. When resumed, an
+     * overdue poll is requested right away.
+     */
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    /**
+     * If @p interval is > 0, changes are reported by other means (kernel
+     * warnings, the quota service), and polling is only a safety net with
+     * the fixed @p interval. 0 enables the adaptive policy.
+     */
+    void setSafetyInterval(int interval);
+
+    /**
+     * Feeds the usage in percent of the latest poll into the policy and
+     * schedules the next poll accordingly.
+     */
+    void reportUsage(int usage);
+
+    /**
+     * Smoothed usage growth in percent per hour.
+     */
+    double growthRate() const;
+
+    /**
+     * Interval in milliseconds until the next poll, including jitter.
+     */
+    int nextInterval();
+
+    /**
+     * The adaptive policy without jitter: interval in milliseconds for a
+     * quota at @p usage percent growing by @p growthRate percent per hour.
+     */
+    static int policyInterval(int usage, double growthRate);
+
+    /**
+     * Follows org.freedesktop.ScreenSaver on the session bus and pauses
+     * polling while the screen saver is active.
+     */
+    void watchScreenSaver();
+
+Q_SIGNALS:
+    /**
+     * Emitted whenever a poll is due.
+     */
+    void pollRequested();
+
+private Q_SLOTS:
+    void timeout();
+    void screenSaverActiveChanged(bool active);
+
+private:
+    void schedule(int interval);
+
+    QScopedPointer<Clock> m_clock;
+    QTimer *m_timer = nullptr;
+    std::mt19937 m_random;
+    double m_hostPhase = 0.0;
+    bool m_running = false;
+    bool m_paused = false;
+    int m_safetyInterval = 0;
+    int m_usage = 0;
+    int m_lastUsage = -1;
+    qint64 m_lastUsageTime = 0;
+    qint64 m_lastPoll = -1;
+    double m_growthRate = 0.0;
+};
+
+#endif // PLASMA_LLIUREX_POLL_SCHEDULER_H
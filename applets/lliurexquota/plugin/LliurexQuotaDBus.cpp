@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaDBus.h"
+
+#include <QDBusMetaType>
+
+void LliurexQuotaDBus::registerTypes()
+{
+    qRegisterMetaType<LliurexQuotaEntry>();
+    qRegisterMetaType<QVector<LliurexQuotaEntry>>();
+    qDBusRegisterMetaType<LliurexQuotaEntry>();
+    qDBusRegisterMetaType<QVector<LliurexQuotaEntry>>();
+}
+
+QDBusConnection LliurexQuotaDBus::bus()
+{
+    if (qgetenv("LLIUREX_QUOTA_SERVICE_BUS") == "session") {
+        return QDBusConnection::sessionBus();
+    }
+    return QDBusConnection::systemBus();
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LliurexQuotaEntry &entry)
+{
+    argument.beginStructure();
+    argument << uint(entry.type) << entry.id << entry.name << entry.mountPoint
+             << entry.used << entry.softLimit << entry.hardLimit
+             << entry.inodesUsed << entry.inodeSoftLimit << entry.inodeHardLimit
+             << entry.graceTime << entry.group;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, LliurexQuotaEntry &entry)
+{
+    uint type = 0;
+    argument.beginStructure();
+    argument >> type >> entry.id >> entry.name >> entry.mountPoint
+             >> entry.used >> entry.softLimit >> entry.hardLimit
+             >> entry.inodesUsed >> entry.inodeSoftLimit >> entry.inodeHardLimit
+             >> entry.graceTime >> entry.group;
+    argument.endStructure();
+    entry.type = type == LliurexQuotaEntry::GroupQuota ? LliurexQuotaEntry::GroupQuota : LliurexQuotaEntry::UserQuota;
+    return argument;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_DBUS_H
+#define PLASMA_LLIUREX_QUOTA_DBUS_H
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * Names of the per-host quota service, see service/LliurexQuotaService.h.
+ */
+namespace LliurexQuotaDBus {
+    static const QLatin1String serviceName("net.lliurex.Quota");
+    static const QLatin1String objectPath("/net/lliurex/Quota");
+    static const QLatin1String interfaceName("net.lliurex.Quota");
+
+    /**
+     * Registers the D-Bus marshalling of LliurexQuotaEntry, signature
+     * '(uussxxxxxxxs)'. Must be called before any quota is sent or received.
+     */
+    void registerTypes();
+
+    /**
+     * The bus the service lives on: the system bus, or the session bus
+     * if LLIUREX_QUOTA_SERVICE_BUS=session is set (used for testing).
+     */
+    QDBusConnection bus();
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LliurexQuotaEntry &entry);
+const QDBusArgument &operator>>(const QDBusArgument &argument, LliurexQuotaEntry &entry);
+
+#endif // PLASMA_LLIUREX_QUOTA_DBUS_H
@@ -0,0 +1,506 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaEngine.h"
+#include "LliurexAdminQuotaLoader.h"
+#include "LliurexAdminQuotaModel.h"
+#include "LliurexAdminStatistics.h"
+#include "LliurexCircuitBreaker.h"
+#include "LliurexDirectoryIndex.h"
+#include "LliurexPollScheduler.h"
+#include "LliurexQuotaFormatter.h"
+#include "LliurexProcessQuotaBackend.h"
+#include "LliurexQuotaListModel.h"
+#include "LliurexQuotaMetrics.h"
+#include "LliurexQuotaMetricsAdaptor.h"
+#include "LliurexQuotaNetlinkListener.h"
+#include "LliurexQuotaSnapshot.h"
+#include "LliurexQuotaThresholds.h"
+#include "LliurexReclaimAnalyzer.h"
+#include "LliurexToolLocator.h"
+#include "lliurexquota_debug.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QDir>
+#include <QLocale>
+
+namespace {
+    // the only cleanup tool supported
+    const QLatin1String CleanUpTool("filelight");
+
+    // safety poll interval while the kernel reports quota warnings for us
+    const int NetlinkPollInterval = 10 * 60 * 1000;
+    // safety poll interval while the quota service pushes changes
+    const int PushedPollInterval = 15 * 60 * 1000;
+
+    // the first poll after login is spread over this window, in milliseconds;
+    // a wider one if the last known quota can be shown meanwhile
+    const int StartupWindow = 10 * 1000;
+    const int SnapshotStartupWindow = 60 * 1000;
+
+    // a request joins the outstanding poll if it was sent less than this ago
+    const int JoinWindow = 2 * 1000;
+}
+
+QSharedPointer<LliurexQuotaEngine> LliurexQuotaEngine::acquire()
+{
+    // the applets of a process all run as the same user, one engine serves them all
+    static QWeakPointer<LliurexQuotaEngine> shared;
+
+    QSharedPointer<LliurexQuotaEngine> engine = shared.toStrongRef();
+    if (!engine) {
+        engine = QSharedPointer<LliurexQuotaEngine>(new LliurexQuotaEngine());
+        shared = engine;
+    }
+    return engine;
+}
+
+LliurexQuotaEngine::LliurexQuotaEngine()
+    : QObject(nullptr)
+    , m_scheduler(new LliurexPollScheduler(this))
+    , m_toolLocator(new LliurexToolLocator({LliurexProcessQuotaBackend::program(), CleanUpTool}, this))
+    , m_pipeline(new LliurexQuotaPipeline(m_toolLocator, this))
+    , m_model(new LliurexQuotaListModel(this))
+    , m_adminLoader(new LliurexAdminQuotaLoader(this))
+    , m_adminModel(new LliurexAdminQuotaModel(this))
+    , m_adminStatistics(new LliurexAdminStatistics(this))
+    , m_breaker(new LliurexCircuitBreaker(this))
+{
+    connect(m_breaker, &LliurexCircuitBreaker::probeDue, this, &LliurexQuotaEngine::updateQuota);
+    connect(m_breaker, &LliurexCircuitBreaker::stateChanged, this, [this]() {
+        qCDebug(LLIUREXQUOTA) << "Circuit breaker state" << m_breaker->state();
+    });
+    LliurexQuotaMetricsAdaptor::exportOnSessionBus();
+
+    // tools are only looked up again when a $PATH directory changed
+    connect(m_toolLocator, &LliurexToolLocator::toolsChanged, this, &LliurexQuotaEngine::toolsChanged);
+    setCleanUpToolInstalled(m_toolLocator->isInstalled(CleanUpTool));
+
+    m_netlinkListener = new LliurexQuotaNetlinkListener(this);
+    connect(m_netlinkListener, &LliurexQuotaNetlinkListener::quotaWarning, this, &LliurexQuotaEngine::quotaWarning);
+
+    connect(m_scheduler, &LliurexPollScheduler::pollRequested, this, &LliurexQuotaEngine::updateQuota);
+    m_scheduler->watchScreenSaver();
+    updatePollInterval();
+
+    connect(m_pipeline, &LliurexQuotaPipeline::presented, this, &LliurexQuotaEngine::quotaPresented);
+    connect(m_pipeline, &LliurexQuotaPipeline::quotaFailed, this, &LliurexQuotaEngine::quotaFailed);
+    connect(m_pipeline, &LliurexQuotaPipeline::backendChanged, this, &LliurexQuotaEngine::updatePollInterval);
+    connect(m_pipeline, &LliurexQuotaPipeline::availableChanged, this, &LliurexQuotaEngine::availableChanged);
+
+    // the views leave the administrator mode when it becomes unavailable
+    connect(m_adminLoader, &LliurexAdminQuotaLoader::availableChanged, this, &LliurexQuotaEngine::adminAvailableChanged);
+    connect(m_adminLoader, &LliurexAdminQuotaLoader::quotaReady, this, [this](const QVector<LliurexQuotaEntry> &entries) {
+        // an answer arriving after the last view left the administrator mode
+        if (m_adminViews > 0) {
+            m_adminModel->setEntries(entries);
+            m_adminStatistics->setEntries(entries);
+        }
+    });
+    connect(m_adminLoader, &LliurexAdminQuotaLoader::quotaFailed, m_adminModel, &LliurexAdminQuotaModel::clear);
+    connect(m_adminLoader, &LliurexAdminQuotaLoader::quotaFailed, m_adminStatistics, &LliurexAdminStatistics::clear);
+    m_adminLoader->checkAvailable();
+
+    // show the last known quota right away, and do not query the quota
+    // source while the whole desktop (or the whole classroom) starts up
+    LliurexQuotaSnapshot snapshot;
+    if (snapshot.load()) {
+        m_entries = snapshot.entries;
+        m_lastUpdate = snapshot.time;
+        m_pipeline->present(m_entries);
+        m_scheduler->start(m_scheduler->startupDelay(SnapshotStartupWindow));
+    } else {
+        m_scheduler->start(m_scheduler->startupDelay(StartupWindow));
+    }
+}
+
+LliurexQuotaEngine::~LliurexQuotaEngine()
+{
+}
+
+bool LliurexQuotaEngine::quotaInstalled() const
+{
+    return m_quotaInstalled;
+}
+
+void LliurexQuotaEngine::setQuotaInstalled(bool installed)
+{
+    if (m_quotaInstalled != installed) {
+        m_quotaInstalled = installed;
+
+        if (!installed) {
+            resetQuota();
+            setStatus(LliurexDiskQuota::PassiveStatus);
+            setToolTip(i18n("Lliurex Disk Quota"));
+            setSubToolTip(i18n("Please install 'lliurex-quota'"));
+        }
+
+        emit quotaInstalledChanged();
+    }
+}
+
+bool LliurexQuotaEngine::cleanUpToolInstalled() const
+{
+    return m_cleanUpToolInstalled;
+}
+
+void LliurexQuotaEngine::setCleanUpToolInstalled(bool installed)
+{
+    if (m_cleanUpToolInstalled != installed) {
+        m_cleanUpToolInstalled = installed;
+        emit cleanUpToolInstalledChanged();
+    }
+}
+
+LliurexQuotaEngine::TrayStatus LliurexQuotaEngine::status() const
+{
+    return m_status;
+}
+
+void LliurexQuotaEngine::setStatus(TrayStatus status)
+{
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged();
+    }
+}
+
+QString LliurexQuotaEngine::iconName() const
+{
+    return m_iconName;
+}
+
+void LliurexQuotaEngine::setIconName(const QString &name)
+{
+    if (m_iconName != name) {
+        m_iconName = name;
+        emit iconNameChanged();
+    }
+}
+
+QString LliurexQuotaEngine::toolTip() const
+{
+    return m_toolTip;
+}
+
+void LliurexQuotaEngine::setToolTip(const QString &toolTip)
+{
+    if (m_toolTip != toolTip) {
+        m_toolTip = toolTip;
+        emit toolTipChanged();
+    }
+}
+
+QString LliurexQuotaEngine::subToolTip() const
+{
+    return m_subToolTip;
+}
+
+void LliurexQuotaEngine::setSubToolTip(const QString &subToolTip)
+{
+    if (m_subToolTip != subToolTip) {
+        m_subToolTip = subToolTip;
+        emit subToolTipChanged();
+    }
+}
+
+bool LliurexQuotaEngine::stale() const
+{
+    return m_stale;
+}
+
+void LliurexQuotaEngine::setStale(bool stale)
+{
+    if (m_stale != stale) {
+        m_stale = stale;
+        emit staleChanged();
+    }
+}
+
+void LliurexQuotaEngine::updateQuota()
+{
+    const bool quotaFound = m_pipeline->isAvailable();
+    setQuotaInstalled(quotaFound);
+    if (!quotaFound) {
+        // e.g. the quota service appeared, reported by availableChanged()
+        m_pipeline->checkAvailable();
+        return;
+    }
+
+    // a quota source that keeps failing is left alone for a while
+    if (!m_breaker->allowRequest()) {
+        LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::BreakerRejects);
+        return;
+    }
+
+    // several views or a view and the scheduler asking at once: a recent
+    // poll still outstanding answers them all
+    if (m_pollTimer.isValid() && m_pollTimer.elapsed() < JoinWindow) {
+        LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::JoinedPolls);
+        return;
+    }
+
+    LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::Polls);
+    if (!m_pollTimer.isValid()) {
+        m_pollTimer.start();
+    }
+    m_pipeline->requestQuota();
+
+    if (m_adminViews > 0) {
+        m_adminLoader->requestQuota();
+    }
+}
+
+void LliurexQuotaEngine::toolsChanged()
+{
+    setCleanUpToolInstalled(m_toolLocator->isInstalled(CleanUpTool));
+
+    // 'lliurex-quota' being installed or removed is reported by availableChanged()
+}
+
+void LliurexQuotaEngine::availableChanged()
+{
+    // react to the quota source appearing or vanishing right away
+    setQuotaInstalled(m_pipeline->isAvailable());
+    updateQuota();
+}
+
+void LliurexQuotaEngine::updatePollInterval()
+{
+    if (m_pipeline->pushesUpdates()) {
+        m_scheduler->setSafetyInterval(PushedPollInterval);
+    } else if (m_netlinkListener->isActive() && m_pipeline->backendName() == QLatin1String("quotactl")) {
+        // the kernel only warns about local quotas, so this only helps the quotactl backend
+        m_scheduler->setSafetyInterval(NetlinkPollInterval);
+    } else {
+        m_scheduler->setSafetyInterval(0);
+    }
+}
+
+void LliurexQuotaEngine::quotaWarning(int type, quint64 id, int warning)
+{
+    Q_UNUSED(type)
+    Q_UNUSED(id)
+
+    // do not wait for the data to show that a limit was hit
+    if (LliurexQuotaNetlinkListener::isExceeded(warning)) {
+        setStatus(LliurexDiskQuota::NeedsAttentionStatus);
+    }
+
+    // a poll sent just before the change may have read the old usage:
+    // rather than joining it, poll again once it is answered
+    if (m_pollTimer.isValid() && m_pollTimer.elapsed() < JoinWindow) {
+        m_repollPending = true;
+        return;
+    }
+    updateQuota();
+}
+
+void LliurexQuotaEngine::pollAnswered()
+{
+    // answers pushed by the backend without a request have no latency
+    LliurexQuotaMetrics &metrics = LliurexQuotaMetrics::instance();
+    qint64 latency = -1;
+    if (m_pollTimer.isValid()) {
+        latency = m_pollTimer.nsecsElapsed() / 1000;
+        metrics.record(LliurexQuotaMetrics::PollLatency, quint64(latency));
+        m_pollTimer.invalidate();
+    }
+    metrics.writeTextfile();
+
+    emit pollFinished(latency);
+
+    if (m_repollPending) {
+        m_repollPending = false;
+        QMetaObject::invokeMethod(this, "updateQuota", Qt::QueuedConnection);
+    }
+}
+
+void LliurexQuotaEngine::quotaFailed(const QString &reason)
+{
+    qCWarning(LLIUREXQUOTA) << "Quota query failed:" << reason;
+    LliurexQuotaMetrics::instance().add(LliurexQuotaMetrics::Failures);
+    m_breaker->recordFailure();
+    pollAnswered();
+
+    // keep showing the last good data rather than nothing
+    if (!m_entries.isEmpty()) {
+        setStale(true);
+        setSubToolTip(i18nc("e.g.: Quota source not responding, last updated: 08:01",
+                            "Quota source not responding, last updated: %1",
+                            QLocale().toString(m_lastUpdate, QLocale::ShortFormat)));
+        return;
+    }
+
+    resetQuota();
+    setToolTip(i18n("Lliurex Disk Quota"));
+    setSubToolTip(i18n("Running lliurex-quota failed"));
+}
+
+void LliurexQuotaEngine::resetQuota()
+{
+    setStale(false);
+    m_entries.clear();
+    m_model->clear();
+    m_pipeline->reset();
+}
+
+void LliurexQuotaEngine::saveSnapshot()
+{
+    m_lastUpdate = QDateTime::currentDateTime();
+
+    LliurexQuotaSnapshot snapshot;
+    snapshot.entries = m_entries;
+    snapshot.time = m_lastUpdate;
+    snapshot.save();
+}
+
+void LliurexQuotaEngine::quotaPresented(const LliurexQuotaPipeline::Presentation &presentation)
+{
+    typedef LliurexQuotaPipeline::Presentation Presentation;
+
+    // merge new items, add new ones, remove old ones
+    {
+        LliurexMetricsSpan updateSpan(LliurexQuotaMetrics::ModelUpdateTime);
+        m_model->applyChanges(presentation.changes);
+    }
+
+    // only the reclaimable space of some rows changed
+    if (presentation.kind == Presentation::Refresh) {
+        return;
+    }
+
+    const bool fresh = presentation.isFresh();
+    if (fresh) {
+        m_breaker->recordSuccess();
+        pollAnswered();
+    }
+    if (presentation.kind == Presentation::Answer) {
+        m_entries = presentation.entries;
+        saveSnapshot();
+    } else if (presentation.kind == Presentation::Stale) {
+        m_entries = presentation.entries;
+    }
+
+    const int maxQuota = presentation.maxQuota;
+    const int alertQuota = presentation.alertQuota;
+
+    // update icon in panel
+    setIconName(LliurexQuotaFormatter::iconNameForQuota(alertQuota));
+
+    // update status
+    switch (LliurexQuotaThresholds::level(alertQuota)) {
+        case LliurexQuotaThresholds::NormalLevel: setStatus(LliurexDiskQuota::PassiveStatus); break;
+        case LliurexQuotaThresholds::HighLevel: setStatus(LliurexDiskQuota::ActiveStatus); break;
+        case LliurexQuotaThresholds::CriticalLevel: setStatus(LliurexDiskQuota::NeedsAttentionStatus); break;
+    }
+    qCDebug(LLIUREXQUOTA) << "Usage" << maxQuota << "% treated as" << alertQuota << "%, status" << m_status;
+
+    if (!presentation.entries.isEmpty()) {
+        setToolTip(i18nc("example: Quota: 83% used",
+                         "Quota: %1% used", maxQuota));
+        if (!fresh) {
+            setSubToolTip(i18nc("e.g.: Last updated: 08:01", "Last updated: %1",
+                                QLocale().toString(m_lastUpdate, QLocale::ShortFormat)));
+        } else {
+            setSubToolTip(presentation.forecast);
+        }
+    } else {
+        setToolTip(i18n("Disk Quota"));
+        setSubToolTip(i18n("No quota restrictions found."));
+    }
+
+    setStale(!fresh);
+
+    // adapt the poll interval to the new usage; stale data must not
+    // postpone the first real poll
+    if (fresh) {
+        m_scheduler->reportUsage(alertQuota);
+        if (m_reclaimAnalyzer) {
+            m_reclaimAnalyzer->refresh();
+        }
+    }
+}
+
+void LliurexQuotaEngine::reclaimableChanged()
+{
+    m_pipeline->setReclaimable(m_reclaimAnalyzer->reclaimable());
+}
+
+LliurexQuotaListModel *LliurexQuotaEngine::model() const
+{
+    return m_model;
+}
+
+bool LliurexQuotaEngine::adminAvailable() const
+{
+    return m_adminLoader->isAvailable();
+}
+
+LliurexAdminQuotaModel *LliurexQuotaEngine::adminModel() const
+{
+    return m_adminModel;
+}
+
+LliurexAdminStatistics *LliurexQuotaEngine::adminStatistics() const
+{
+    return m_adminStatistics;
+}
+
+void LliurexQuotaEngine::addAdminView()
+{
+    if (++m_adminViews == 1) {
+        m_adminLoader->requestQuota();
+    }
+}
+
+void LliurexQuotaEngine::removeAdminView()
+{
+    Q_ASSERT(m_adminViews > 0);
+    if (--m_adminViews == 0) {
+        // the list of all users can be large, do not keep it around
+        m_adminModel->clear();
+        m_adminStatistics->clear();
+    }
+}
+
+LliurexDirectoryIndex *LliurexQuotaEngine::directoryIndex()
+{
+    if (!m_directoryIndex) {
+        m_directoryIndex = new LliurexDirectoryIndex(QDir::homePath(), this);
+    }
+    return m_directoryIndex;
+}
+
+LliurexReclaimAnalyzer *LliurexQuotaEngine::reclaimAnalyzer()
+{
+    if (!m_reclaimAnalyzer) {
+        m_reclaimAnalyzer = new LliurexReclaimAnalyzer(QDir::homePath(), this);
+        connect(m_reclaimAnalyzer, &LliurexReclaimAnalyzer::reclaimableChanged, this, &LliurexQuotaEngine::reclaimableChanged);
+        connect(m_reclaimAnalyzer, &LliurexReclaimAnalyzer::purged, this, &LliurexQuotaEngine::updateQuota);
+        // from then on sized again after every fresh poll
+        m_reclaimAnalyzer->refresh();
+    }
+    return m_reclaimAnalyzer;
+}
+
+QString LliurexQuotaEngine::cleanUpToolPath() const
+{
+    return m_toolLocator->path(CleanUpTool);
+}
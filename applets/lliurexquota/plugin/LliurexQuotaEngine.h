@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_ENGINE_H
+#define PLASMA_LLIUREX_QUOTA_ENGINE_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "LliurexDiskQuota.h"
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaPipeline.h"
+
+class LliurexAdminQuotaLoader;
+class LliurexAdminQuotaModel;
+class LliurexAdminStatistics;
+class LliurexCircuitBreaker;
+class LliurexDirectoryIndex;
+class LliurexPollScheduler;
+class LliurexQuotaListModel;
+class LliurexQuotaNetlinkListener;
+class LliurexReclaimAnalyzer;
+class LliurexToolLocator;
+
+/**
+ * Monitors the file system quota of the user for all the applets of the
+ * process, which are views on it (LliurexDiskQuota).
+ * The monitoring is performed through an adaptive LliurexPollScheduler,
+ * querying a LliurexQuotaBackend in the LliurexQuotaPipeline thread:
+ * quotactl(2) if local file systems with quotas are mounted, otherwise the
+ * 'lliurex-quota' command line tool.
+ * The usage of every quota is recorded in a LliurexUsageHistory, and a
+ * quota that fills up quickly raises the tray status before it is full.
+ * A LliurexCircuitBreaker stops polling a quota source that keeps failing,
+ * while the last good data is shown, marked stale.
+ *
+ * There is one engine per process, created by the first view and
+ * destroyed with the last one: an applet on two panels polls, parses and
+ * keeps its rows once. Requests of the views while a poll is outstanding
+ * are answered by that poll.
+ */
+class LliurexQuotaEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef LliurexDiskQuota::TrayStatus TrayStatus;
+
+    /**
+     * Returns the engine of this process, created if no view holds it.
+     */
+    static QSharedPointer<LliurexQuotaEngine> acquire();
+
+    ~LliurexQuotaEngine() override;
+
+public:
+    bool quotaInstalled() const;
+    bool cleanUpToolInstalled() const;
+    TrayStatus status() const;
+    QString toolTip() const;
+    QString subToolTip() const;
+    QString iconName() const;
+
+    /**
+     * Returns true while the data shown is the snapshot saved by the last
+     * session, before the first poll of this one delivered, or the last
+     * good data of a failing quota source.
+     */
+    bool stale() const;
+
+    /**
+     * The rows shared by all views.
+     */
+    LliurexQuotaListModel *model() const;
+
+    /**
+     * Returns true if the user may see the quotas of all users.
+     */
+    bool adminAvailable() const;
+
+    /**
+     * The quotas of all users, filled while a view shows them, see
+     * addAdminView().
+     */
+    LliurexAdminQuotaModel *adminModel() const;
+
+    /**
+     * Statistics over the quotas of all users, kept with adminModel().
+     */
+    LliurexAdminStatistics *adminStatistics() const;
+
+    /**
+     * Counts a view showing the quotas of all users, which are fetched
+     * on every update while there is one.
+     */
+    void addAdminView();
+    void removeAdminView();
+
+    /**
+     * The index of the home folder, created when a view first scans a
+     * folder: it walks and watches the whole home folder.
+     */
+    LliurexDirectoryIndex *directoryIndex();
+
+    /**
+     * Sizes the caches below the home folder, created when a view first
+     * shows the rows or purges.
+     */
+    LliurexReclaimAnalyzer *reclaimAnalyzer();
+
+    /**
+     * Path of the cleanup tool (filelight), empty if not installed.
+     */
+    QString cleanUpToolPath() const;
+
+public Q_SLOTS:
+    /**
+     * Called whenever the scheduler or a view requests a poll to update
+     * the data model. Starts an asynchronous backend query to obtain data,
+     * and finally calls quotaPresented() or quotaFailed().
+     */
+    void updateQuota();
+
+    /**
+     * Shows the quota data prepared by the pipeline.
+     */
+    void quotaPresented(const LliurexQuotaPipeline::Presentation &presentation);
+
+    /**
+     * Called when the backend failed to deliver quota data.
+     */
+    void quotaFailed(const QString &reason);
+
+    /**
+     * Called when the kernel reports that a quota limit was crossed.
+     * Refreshes the data immediately, or once a poll sent just before
+     * is answered.
+     */
+    void quotaWarning(int type, quint64 id, int warning);
+
+Q_SIGNALS:
+    void quotaInstalledChanged();
+    void cleanUpToolInstalledChanged();
+    void statusChanged();
+    void toolTipChanged();
+    void subToolTipChanged();
+    void iconNameChanged();
+    void staleChanged();
+    void adminAvailableChanged();
+
+    /**
+     * Emitted when a poll was answered or failed, with the microseconds
+     * since the oldest unanswered request, or -1 for pushed answers.
+     */
+    void pollFinished(qint64 latency);
+
+private Q_SLOTS:
+    void toolsChanged();
+    void availableChanged();
+    void reclaimableChanged();
+
+private:
+    LliurexQuotaEngine();
+
+    void setQuotaInstalled(bool installed);
+    void setCleanUpToolInstalled(bool installed);
+    void setStatus(TrayStatus status);
+    void setToolTip(const QString &toolTip);
+    void setSubToolTip(const QString &subToolTip);
+    void setIconName(const QString &name);
+    void setStale(bool stale);
+
+    void updatePollInterval();
+    void saveSnapshot();
+    void pollAnswered();
+    void resetQuota();
+
+    LliurexPollScheduler *m_scheduler = nullptr;
+    LliurexToolLocator *m_toolLocator = nullptr;
+    LliurexQuotaPipeline *m_pipeline = nullptr;
+    LliurexQuotaNetlinkListener *m_netlinkListener = nullptr;
+    bool m_quotaInstalled = true;
+    bool m_cleanUpToolInstalled = true;
+    TrayStatus m_status = LliurexDiskQuota::PassiveStatus;
+    QString m_iconName = QStringLiteral("lliurexquota");
+    QString m_toolTip;
+    QString m_subToolTip;
+    LliurexQuotaListModel *m_model = nullptr;
+    QVector<LliurexQuotaEntry> m_entries;
+    QDateTime m_lastUpdate;
+    bool m_stale = false;
+    LliurexAdminQuotaLoader *m_adminLoader = nullptr;
+    LliurexAdminQuotaModel *m_adminModel = nullptr;
+    LliurexAdminStatistics *m_adminStatistics = nullptr;
+    int m_adminViews = 0;
+    LliurexCircuitBreaker *m_breaker = nullptr;
+    QElapsedTimer m_pollTimer;  // since the oldest unanswered request
+    bool m_repollPending = false;   // a quota warning arrived while a poll was outstanding
+    LliurexDirectoryIndex *m_directoryIndex = nullptr;
+    LliurexReclaimAnalyzer *m_reclaimAnalyzer = nullptr;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_ENGINE_H
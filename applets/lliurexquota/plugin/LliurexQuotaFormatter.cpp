@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaFormatter.h"
+
+#include <KLocalizedString>
+
+namespace {
+    // the cache holds the few sizes of the visible rows, keep it small
+    const int MaxCachedByteSizes = 512;
+
+    // forecasts further ahead are too vague to be shown
+    const qint64 MaxForecast = 30 * 24 * 60 * 60;
+}
+
+QString LliurexQuotaFormatter::iconNameForQuota(int quota)
+{
+    if (quota < 50) {
+        return QStringLiteral("lliurexquota");
+    } else if (quota < 75) {
+        return QStringLiteral("lliurexquota-low");
+    } else if (quota < 90) {
+        return QStringLiteral("lliurexquota-high");
+    }
+
+    // quota >= 90%
+    return QStringLiteral("lliurexquota-critical");
+}
+
+QString LliurexQuotaFormatter::displayName(const LliurexQuotaEntry &entry)
+{
+    // 'lliurex-quota' does not report mount points, all its quotas are the assigned space
+    if (entry.mountPoint.isEmpty()) {
+        return i18n("Assigned space");
+    }
+
+    if (entry.type == LliurexQuotaEntry::GroupQuota) {
+        return i18nc("group quota on a mount point, e.g.: '/home (group teachers)'",
+                     "%1 (group %2)", entry.mountPoint, entry.name.isEmpty() ? QString::number(entry.id) : entry.name);
+    }
+
+    return entry.mountPoint;
+}
+
+LliurexQuotaItem LliurexQuotaFormatter::toItem(const LliurexQuotaEntry &entry)
+{
+    LliurexQuotaItem item;
+    item.setMountPoint(displayName(entry));
+    item.setUsage(entry.usage());
+    item.setUsed(entry.used);
+    item.setSoftLimit(entry.softLimit);
+    item.setHardLimit(entry.hardLimit);
+    item.setInodesUsed(entry.inodesUsed);
+    item.setInodeSoftLimit(entry.inodeSoftLimit);
+    item.setInodeHardLimit(entry.inodeHardLimit);
+    return item;
+}
+
+QVector<LliurexQuotaItem> LliurexQuotaFormatter::toItems(const QVector<LliurexQuotaEntry> &entries)
+{
+    QVector<LliurexQuotaItem> items;
+    items.reserve(entries.size());
+    for (const LliurexQuotaEntry &entry : entries) {
+        items.append(toItem(entry));
+    }
+    return items;
+}
+
+QString LliurexQuotaFormatter::formatByteSize(qint64 size)
+{
+    const QLocale locale;
+    if (locale != m_locale) {
+        m_locale = locale;
+        m_byteSizes.clear();
+    }
+
+    const auto it = m_byteSizes.constFind(size);
+    if (it != m_byteSizes.constEnd()) {
+        return it.value();
+    }
+
+    if (m_byteSizes.size() >= MaxCachedByteSizes) {
+        m_byteSizes.clear();
+    }
+    const QString text = m_format.formatByteSize(size);
+    m_byteSizes.insert(size, text);
+    return text;
+}
+
+QString LliurexQuotaFormatter::mountString(const LliurexQuotaItem &item)
+{
+    return i18nc("usage of quota, e.g.: '/home/bla: 38\% used'", "%1: %2% used", item.mountPoint(), item.usage());
+}
+
+QString LliurexQuotaFormatter::usedString(const LliurexQuotaItem &item)
+{
+    return i18nc("e.g.: 12 GiB of 20 GiB", "%1 of %2", formatByteSize(item.used()), formatByteSize(item.limit()));
+}
+
+QString LliurexQuotaFormatter::freeString(const LliurexQuotaItem &item)
+{
+    return i18nc("e.g.: 8 GiB free", "%1 free", formatByteSize(item.freeSize()));
+}
+
+QString LliurexQuotaFormatter::forecastString(const LliurexQuotaItem &item)
+{
+    if (item.timeToFull() <= 0 || item.timeToFull() > MaxForecast) {
+        return QString();
+    }
+
+    // minutes are enough, a forecast is no stopwatch
+    const quint64 msecs = (item.timeToFull() + 59) / 60 * 60 * 1000;
+    return i18nc("e.g.: Full in 3 hours", "Full in %1", m_format.formatSpelloutDuration(msecs));
+}
+
+QString LliurexQuotaFormatter::reclaimableString(const LliurexQuotaItem &item)
+{
+    if (item.reclaimable() <= 0) {
+        return QString();
+    }
+    return i18nc("e.g.: 2 GiB reclaimable", "%1 reclaimable", formatByteSize(item.reclaimable()));
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_FORMATTER_H
+#define PLASMA_LLIUREX_QUOTA_FORMATTER_H
+
+#include <QHash>
+#include <QLocale>
+#include <QString>
+#include <QVector>
+
+#include <KFormat>
+
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaItem.h"
+
+/**
+ * Turns the raw quota numbers of a backend into LliurexQuotaItems, and
+ * builds the display strings of an item.
+ *
+ * Byte sizes are formatted through a small memo cache keyed by the byte
+ * value, which is flushed when the locale changes. The strings are built
+ * in the LliurexQuotaPipeline thread, each formatter is used by one thread.
+ */
+class LliurexQuotaFormatter
+{
+public:
+    /**
+     * Icon name for a usage of @p quota percent.
+     */
+    static QString iconNameForQuota(int quota);
+
+    /**
+     * Name of the quota shown to the user, e.g. the mount point.
+     */
+    static QString displayName(const LliurexQuotaEntry &entry);
+
+    /**
+     * Converts one @p entry into an item, without formatting any size.
+     */
+    static LliurexQuotaItem toItem(const LliurexQuotaEntry &entry);
+
+    /**
+     * Converts all @p entries.
+     */
+    static QVector<LliurexQuotaItem> toItems(const QVector<LliurexQuotaEntry> &entries);
+
+public:
+    /**
+     * Byte size formatted for the current locale, e.g. '12 GiB'.
+     */
+    QString formatByteSize(qint64 size);
+
+    /**
+     * e.g. '/home: 38% used'
+     */
+    QString mountString(const LliurexQuotaItem &item);
+
+    /**
+     * e.g. '12 GiB of 20 GiB'
+     */
+    QString usedString(const LliurexQuotaItem &item);
+
+    /**
+     * e.g. '8 GiB free'
+     */
+    QString freeString(const LliurexQuotaItem &item);
+
+    /**
+     * e.g. 'Full in 3 hours', empty if the quota is not filling up.
+     */
+    QString forecastString(const LliurexQuotaItem &item);
+
+    /**
+     * e.g. '2 GiB reclaimable', empty if nothing can be removed.
+     */
+    QString reclaimableString(const LliurexQuotaItem &item);
+
+private:
+    KFormat m_format;
+    QLocale m_locale;
+    QHash<qint64, QString> m_byteSizes;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_FORMATTER_H
@@ -20,24 +20,20 @@
 #include <QDebug>
 
 LliurexQuotaItem::LliurexQuotaItem()
-    : m_iconName(QStringLiteral("lliurexquota"))
-    , m_mountPoint()
+    : m_mountPoint()
+    , m_used(0)
+    , m_softLimit(0)
+    , m_hardLimit(0)
+    , m_inodesUsed(0)
+    , m_inodeSoftLimit(0)
+    , m_inodeHardLimit(0)
+    , m_timeToFull(-1)
+    , m_reclaimable(0)
+    , m_growthRate(0)
     , m_usage(0)
-    , m_mountString()
-    , m_usedString()
 {
 }
 
-QString LliurexQuotaItem::iconName() const
-{
-    return m_iconName;
-}
-
-void LliurexQuotaItem::setIconName(const QString &name)
-{
-    m_iconName = name;
-}
-
 QString LliurexQuotaItem::mountPoint() const
 {
     return m_mountPoint;
@@ -58,44 +54,119 @@ void LliurexQuotaItem::setUsage(int usage)
     m_usage = usage;
 }
 
-QString LliurexQuotaItem::mountString() const
+qint64 LliurexQuotaItem::used() const
+{
+    return m_used;
+}
+
+void LliurexQuotaItem::setUsed(qint64 used)
+{
+    m_used = used;
+}
+
+qint64 LliurexQuotaItem::softLimit() const
+{
+    return m_softLimit;
+}
+
+void LliurexQuotaItem::setSoftLimit(qint64 softLimit)
+{
+    m_softLimit = softLimit;
+}
+
+qint64 LliurexQuotaItem::hardLimit() const
+{
+    return m_hardLimit;
+}
+
+void LliurexQuotaItem::setHardLimit(qint64 hardLimit)
+{
+    m_hardLimit = hardLimit;
+}
+
+qint64 LliurexQuotaItem::inodesUsed() const
+{
+    return m_inodesUsed;
+}
+
+void LliurexQuotaItem::setInodesUsed(qint64 inodesUsed)
+{
+    m_inodesUsed = inodesUsed;
+}
+
+qint64 LliurexQuotaItem::inodeSoftLimit() const
+{
+    return m_inodeSoftLimit;
+}
+
+void LliurexQuotaItem::setInodeSoftLimit(qint64 inodeSoftLimit)
+{
+    m_inodeSoftLimit = inodeSoftLimit;
+}
+
+qint64 LliurexQuotaItem::inodeHardLimit() const
+{
+    return m_inodeHardLimit;
+}
+
+void LliurexQuotaItem::setInodeHardLimit(qint64 inodeHardLimit)
+{
+    m_inodeHardLimit = inodeHardLimit;
+}
+
+double LliurexQuotaItem::growthRate() const
+{
+    return m_growthRate;
+}
+
+void LliurexQuotaItem::setGrowthRate(double growthRate)
+{
+    m_growthRate = growthRate;
+}
+
+qint64 LliurexQuotaItem::timeToFull() const
 {
-    return m_mountString;
+    return m_timeToFull;
 }
 
-void LliurexQuotaItem::setMountString(const QString &mountString)
+void LliurexQuotaItem::setTimeToFull(qint64 timeToFull)
 {
-    m_mountString = mountString;
+    m_timeToFull = timeToFull;
 }
 
-QString LliurexQuotaItem::usedString() const
+qint64 LliurexQuotaItem::reclaimable() const
 {
-    return m_usedString;
+    return m_reclaimable;
 }
 
-void LliurexQuotaItem::setUsedString(const QString &usedString)
+void LliurexQuotaItem::setReclaimable(qint64 reclaimable)
 {
-    m_usedString = usedString;
+    m_reclaimable = reclaimable;
 }
 
-QString LliurexQuotaItem::freeString() const
+qint64 LliurexQuotaItem::limit() const
 {
-    return m_freeString;
+    return m_hardLimit > 0 ? m_hardLimit : m_softLimit;
 }
 
-void LliurexQuotaItem::setFreeString(const QString &freeString)
+qint64 LliurexQuotaItem::freeSize() const
 {
-    m_freeString = freeString;
+    return qMax(qint64(0), limit() - m_used);
 }
 
 bool LliurexQuotaItem::operator==(const LliurexQuotaItem &other) const
 {
     return m_mountPoint == other.m_mountPoint
-        && m_iconName == other.m_iconName
         && m_usage == other.m_usage
-        && m_mountString == other.m_mountString
-        && m_usedString == other.m_usedString
-        && m_freeString == other.m_freeString;
+        && m_used == other.m_used
+        && m_softLimit == other.m_softLimit
+        && m_hardLimit == other.m_hardLimit
+        && m_inodesUsed == other.m_inodesUsed
+        && m_inodeSoftLimit == other.m_inodeSoftLimit
+        && m_inodeHardLimit == other.m_inodeHardLimit
+        && m_growthRate == other.m_growthRate
+        && m_timeToFull == other.m_timeToFull
+        && m_reclaimable == other.m_reclaimable;
 }
 
 bool LliurexQuotaItem::operator!=(const LliurexQuotaItem &other) const
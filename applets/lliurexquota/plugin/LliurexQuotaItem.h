@@ -23,6 +23,9 @@
 
 /**
  * Class that holds all quota info for one mount point.
+ * Only raw numbers are stored; the display strings are built by
+ * LliurexQuotaListModel::makeRow() in the LliurexQuotaPipeline thread,
+ * for items whose numbers changed. All sizes are in bytes.
  */
 class LliurexQuotaItem
 {
@@ -35,28 +38,69 @@ public:
     int usage() const;
     void setUsage(int usage);
 
-    QString iconName() const;
-    void setIconName(const QString &name);
+    qint64 used() const;
+    void setUsed(qint64 used);
 
-    QString mountString() const;
-    void setMountString(const QString &mountString);
+    qint64 softLimit() const;
+    void setSoftLimit(qint64 softLimit);
 
-    QString usedString() const;
-    void setUsedString(const QString &usedString);
+    qint64 hardLimit() const;
+    void setHardLimit(qint64 hardLimit);
 
-    QString freeString() const;
-    void setFreeString(const QString &freeString);
+    qint64 inodesUsed() const;
+    void setInodesUsed(qint64 inodesUsed);
+
+    qint64 inodeSoftLimit() const;
+    void setInodeSoftLimit(qint64 inodeSoftLimit);
+
+    qint64 inodeHardLimit() const;
+    void setInodeHardLimit(qint64 inodeHardLimit);
+
+    /**
+     * Smoothed growth in bytes per second to two significant digits,
+     * see LliurexUsageHistory.
+     */
+    double growthRate() const;
+    void setGrowthRate(double growthRate);
+
+    /**
+     * Estimated seconds until limit() is reached, -1 if not filling up.
+     */
+    qint64 timeToFull() const;
+    void setTimeToFull(qint64 timeToFull);
+
+    /**
+     * Bytes of caches and trash on this quota that can be removed,
+     * see LliurexReclaimAnalyzer.
+     */
+    qint64 reclaimable() const;
+    void setReclaimable(qint64 reclaimable);
+
+    /**
+     * The hard limit if set, otherwise the soft limit.
+     */
+    qint64 limit() const;
+
+    /**
+     * Free bytes until limit() is reached, never negative.
+     */
+    qint64 freeSize() const;
 
     bool operator==(const LliurexQuotaItem &other) const;
     bool operator!=(const LliurexQuotaItem &other) const;
 
 private:
-    QString m_iconName;
     QString m_mountPoint;
+    qint64 m_used;
+    qint64 m_softLimit;
+    qint64 m_hardLimit;
+    qint64 m_inodesUsed;
+    qint64 m_inodeSoftLimit;
+    qint64 m_inodeHardLimit;
+    qint64 m_timeToFull;
+    qint64 m_reclaimable;
+    double m_growthRate;
     int m_usage;
-    QString m_mountString;
-    QString m_usedString;
-    QString m_freeString;
 };
 
 Q_DECLARE_METATYPE(LliurexQuotaItem)
@@ -18,6 +18,9 @@
 #include "LliurexQuotaListModel.h"
 
 #include <QDebug>
+#include <QSet>
+
+#include <algorithm>
 
 LliurexQuotaListModel::LliurexQuotaListModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -34,7 +37,11 @@ namespace {
         FreeStringRole,
         UsedStringRole,
         MountPointRole,
-        UsageRole
+        UsageRole,
+        GrowthRateRole,
+        TimeToFullRole,
+        ForecastStringRole,
+        ReclaimableStringRole
     };
 }
 
@@ -47,25 +54,33 @@ QHash<int, QByteArray> LliurexQuotaListModel::roleNames() const
     roles[UsedStringRole] = "used";
     roles[MountPointRole] = "mountPoint";
     roles[UsageRole] = "usage";
+    roles[GrowthRateRole] = "growthRate";
+    roles[TimeToFullRole] = "timeToFull";
+    roles[ForecastStringRole] = "forecast";
+    roles[ReclaimableStringRole] = "reclaimable";
 
     return roles;
 }
 
 QVariant LliurexQuotaListModel::data(const QModelIndex &index, int role) const
 {
-    if (! index.isValid() || index.row() >= m_items.size()) {
+    if (! index.isValid() || index.row() >= m_rows.size()) {
         return QVariant();
     }
 
-    const auto item = m_items[index.row()];
+    const auto &row = m_rows.at(index.row());
 
     switch (role) {
-        case DetailsRole: return item.mountString();
-        case IconRole: return item.iconName();
-        case FreeStringRole: return item.freeString();
-        case UsedStringRole: return item.usedString();
-        case MountPointRole: return item.mountPoint();
-        case UsageRole: return item.usage();
+        case DetailsRole: return row.details;
+        case IconRole: return row.icon;
+        case FreeStringRole: return row.free;
+        case UsedStringRole: return row.used;
+        case MountPointRole: return row.item.mountPoint();
+        case UsageRole: return row.item.usage();
+        case GrowthRateRole: return row.item.growthRate();
+        case TimeToFullRole: return row.item.timeToFull();
+        case ForecastStringRole: return row.forecast;
+        case ReclaimableStringRole: return row.reclaimable;
     }
 
     return QVariant();
@@ -74,7 +89,7 @@ QVariant LliurexQuotaListModel::data(const QModelIndex &index, int role) const
 int LliurexQuotaListModel::rowCount(const QModelIndex &index) const
 {
     if (! index.isValid()) {
-        return m_items.size();
+        return m_rows.size();
     }
 
     return 0;
@@ -85,17 +100,17 @@ bool LliurexQuotaListModel::setData(const QModelIndex &index, const QVariant &va
     Q_UNUSED(role)
 
     const int row = index.row();
-    if (index.isValid() && row < m_items.size()) {
+    if (index.isValid() && row < m_rows.size()) {
         const LliurexQuotaItem item = variant.value<LliurexQuotaItem>();
 
         // This assert makes sure that changing items modify the correct item:
         // therefore, the unique identifier 'mountPoint()' is used. If that
         // is not the case, the newly inserted row must have an empty mountPoint().
-        Q_ASSERT(item.mountPoint() == m_items[row].mountPoint()
-            || m_items[row].mountPoint().isEmpty());
+        Q_ASSERT(item.mountPoint() == m_rows[row].item.mountPoint()
+            || m_rows[row].item.mountPoint().isEmpty());
 
-        if (m_items[row] != item) {
-            m_items[row] = item;
+        if (m_rows[row].item != item) {
+            m_rows[row] = makeRow(item, m_formatter);
             emit dataChanged(index, index);
             return true;
         }
@@ -107,12 +122,12 @@ bool LliurexQuotaListModel::setData(const QModelIndex &index, const QVariant &va
 bool LliurexQuotaListModel::insertRows(int row, int count, const QModelIndex &parent)
 {
     // only top-level items are supported
-    if (parent.isValid()) {
+    if (parent.isValid() || row < 0 || count <= 0 || row > m_rows.size()) {
         return false;
     }
 
     beginInsertRows(QModelIndex(), row, row + count - 1);
-    m_items.insert(row, count, LliurexQuotaItem());
+    m_rows.insert(row, count, Row());
     endInsertRows();
 
     return true;
@@ -121,12 +136,12 @@ bool LliurexQuotaListModel::insertRows(int row, int count, const QModelIndex &pa
 bool LliurexQuotaListModel::removeRows(int row, int count, const QModelIndex &parent)
 {
     // only top-level items are valid
-    if (parent.isValid() || (row + count) >= m_items.size()) {
+    if (parent.isValid() || row < 0 || count <= 0 || (row + count) > m_rows.size()) {
         return false;
     }
 
     beginRemoveRows(QModelIndex(), row, row + count - 1);
-    m_items.remove(row, count);
+    m_rows.remove(row, count);
     endRemoveRows();
 
     return true;
@@ -135,54 +150,281 @@ bool LliurexQuotaListModel::removeRows(int row, int count, const QModelIndex &pa
 void LliurexQuotaListModel::clear()
 {
     beginResetModel();
-    m_items.clear();
+    m_rows.clear();
     endResetModel();
 }
 
+LliurexQuotaListModel::Row LliurexQuotaListModel::makeRow(const LliurexQuotaItem &item, LliurexQuotaFormatter &formatter)
+{
+    Row row;
+    row.item = item;
+    row.details = formatter.mountString(item);
+    row.icon = LliurexQuotaFormatter::iconNameForQuota(item.usage());
+    row.free = formatter.freeString(item);
+    row.used = formatter.usedString(item);
+    row.forecast = formatter.forecastString(item);
+    row.reclaimable = formatter.reclaimableString(item);
+    return row;
+}
+
 namespace {
-    QStringList mountPoints(const QVector<LliurexQuotaItem> &items)
+    /**
+     * Returns the roles whose data differ between @p a and @p b.
+     */
+    QVector<int> changedRoles(const LliurexQuotaListModel::Row &a, const LliurexQuotaListModel::Row &b)
     {
-        QStringList list;
-        for (auto & item : items) {
-            list.append(item.mountPoint());
+        QVector<int> roles;
+        if (a.details != b.details) {
+            roles.append(DetailsRole);
+        }
+        if (a.icon != b.icon) {
+            roles.append(IconRole);
+        }
+        if (a.free != b.free) {
+            roles.append(FreeStringRole);
+        }
+        if (a.used != b.used) {
+            roles.append(UsedStringRole);
+        }
+        if (a.item.mountPoint() != b.item.mountPoint()) {
+            roles.append(MountPointRole);
+        }
+        if (a.item.usage() != b.item.usage()) {
+            roles.append(UsageRole);
+        }
+        if (a.item.growthRate() != b.item.growthRate()) {
+            roles.append(GrowthRateRole);
+        }
+        if (a.item.timeToFull() != b.item.timeToFull()) {
+            roles.append(TimeToFullRole);
+        }
+        if (a.forecast != b.forecast) {
+            roles.append(ForecastStringRole);
+        }
+        if (a.reclaimable != b.reclaimable) {
+            roles.append(ReclaimableStringRole);
         }
-        return list;
+        return roles;
     }
+}
 
-    int indexOfMountPoint(const QString &mountPoint, const QVector<LliurexQuotaItem> &items)
-    {
-        for (int i = 0; i < items.size(); ++i) {
-            if (mountPoint == items[i].mountPoint()) {
-                return i;
-            }
+QVector<LliurexQuotaListModel::Row> LliurexQuotaListModel::uniqueRows(const QVector<Row> &rows)
+{
+    QVector<Row> unique;
+    QHash<QString, int> keys;
+    unique.reserve(rows.size());
+    keys.reserve(rows.size());
+    for (const auto &row : rows) {
+        const auto it = keys.constFind(row.item.mountPoint());
+        if (it != keys.constEnd()) {
+            unique[it.value()] = row;
+        } else {
+            keys.insert(row.item.mountPoint(), unique.size());
+            unique.append(row);
         }
-        return -1;
     }
+    return unique;
 }
 
-void LliurexQuotaListModel::updateItems(const QVector<LliurexQuotaItem> &items)
+LliurexQuotaListModel::ChangeSet LliurexQuotaListModel::diff(const QVector<Row> &current, const QVector<Row> &rows)
 {
-    QStringList unusedMountPoints = mountPoints(m_items);
+    ChangeSet changes;
+    QVector<Row> model = current;
+
+    const QVector<Row> newRows = uniqueRows(rows);
+    QSet<QString> newKeys;
+    newKeys.reserve(newRows.size());
+    for (const auto &row : newRows) {
+        newKeys.insert(row.item.mountPoint());
+    }
+
+    QSet<QString> oldKeys;
+    oldKeys.reserve(model.size());
+    for (const auto &row : qAsConst(model)) {
+        oldKeys.insert(row.item.mountPoint());
+    }
+
+    // 1. remove vanished items, one step per contiguous range, back to front
+    for (int row = model.size() - 1; row >= 0; --row) {
+        if (newKeys.contains(model[row].item.mountPoint())) {
+            continue;
+        }
+        const int last = row;
+        while (row > 0 && !newKeys.contains(model[row - 1].item.mountPoint())) {
+            --row;
+        }
+        Change change;
+        change.type = Change::Remove;
+        change.first = row;
+        change.last = last;
+        changes.append(change);
+        model.remove(row, last - row + 1);
+    }
+
+    // 2. bring the remaining items into the new order. The rows on a
+    // longest increasing subsequence of their new positions keep their
+    // relative order and stay; only the others are moved, each right behind
+    // its new predecessor, which is the least number of moves possible.
+    // In the common case the order did not change and no row is moved.
+    QVector<QString> order;
+    QHash<QString, int> positions;
+    order.reserve(model.size());
+    positions.reserve(model.size());
+    for (const auto &row : newRows) {
+        if (oldKeys.contains(row.item.mountPoint())) {
+            positions.insert(row.item.mountPoint(), order.size());
+            order.append(row.item.mountPoint());
+        }
+    }
+
+    // patience sorting: tails[k] is the row ending the best subsequence of
+    // length k + 1 found so far, previous[] links each row to its predecessor
+    QVector<int> tails;
+    QVector<int> previous(model.size(), -1);
+    for (int row = 0; row < model.size(); ++row) {
+        const int position = positions.value(model[row].item.mountPoint());
+        const auto it = std::lower_bound(tails.begin(), tails.end(), position, [&](int tail, int value) {
+            return positions.value(model[tail].item.mountPoint()) < value;
+        });
+        if (it != tails.begin()) {
+            previous[row] = *(it - 1);
+        }
+        if (it == tails.end()) {
+            tails.append(row);
+        } else {
+            *it = row;
+        }
+    }
+    QVector<bool> staying(order.size(), false);
+    for (int row = tails.isEmpty() ? -1 : tails.last(); row >= 0; row = previous[row]) {
+        staying[positions.value(model[row].item.mountPoint())] = true;
+    }
+
+    auto rowOf = [&model](const QString &key) {
+        int row = 0;
+        while (model[row].item.mountPoint() != key) {
+            ++row;
+        }
+        return row;
+    };
+
+    for (int position = 0; position < order.size(); ++position) {
+        if (staying[position]) {
+            continue;
+        }
+        // the search is linear, like the move of the vector itself
+        const int from = rowOf(order[position]);
+        int to = position == 0 ? 0 : rowOf(order[position - 1]) + 1;
+        if (from < to) {
+            --to;
+        }
+        if (from == to) {
+            continue;
+        }
+        Change change;
+        change.type = Change::Move;
+        change.first = from;
+        change.last = to;
+        changes.append(change);
+        model.move(from, to);
+    }
+
+    // 3. insert new items as contiguous ranges and update the others with
+    // the changed roles only, merging neighbouring rows with equal roles
+    Change pending;
+    bool hasPending = false;
+    auto flushPending = [&]() {
+        if (hasPending) {
+            changes.append(pending);
+            hasPending = false;
+        }
+    };
 
-    // merge existing and new mount points
-    for (auto & item : items) {
-        // remove still used item from unused list
-        unusedMountPoints.removeOne(item.mountPoint());
+    for (int row = 0; row < newRows.size(); ) {
+        if (!oldKeys.contains(newRows[row].item.mountPoint())) {
+            int last = row;
+            while (last + 1 < newRows.size() && !oldKeys.contains(newRows[last + 1].item.mountPoint())) {
+                ++last;
+            }
+            flushPending();
+            Change change;
+            change.type = Change::Insert;
+            change.first = row;
+            change.last = last;
+            change.rows = newRows.mid(row, last - row + 1);
+            changes.append(change);
+            model.insert(row, last - row + 1, Row());
+            row = last + 1;
+            continue;
+        }
 
-        // insert or modify m_items
-        int row = indexOfMountPoint(item.mountPoint(), m_items);
-        if (row < 0) {
-            // new item: append on end
-            row = m_items.size();
-            insertRow(row);
+        Q_ASSERT(model[row].item.mountPoint() == newRows[row].item.mountPoint());
+        if (model[row].item != newRows[row].item) {
+            // numbers without a role of their own (e.g. inodes) are stored
+            // silently, with an empty list of roles
+            const QVector<int> roles = changedRoles(model[row], newRows[row]);
+            if (hasPending && (pending.last + 1 != row || pending.roles != roles)) {
+                flushPending();
+            }
+            if (!hasPending) {
+                pending = Change();
+                pending.type = Change::Update;
+                pending.first = row;
+                pending.roles = roles;
+                hasPending = true;
+            }
+            pending.last = row;
+            pending.rows.append(newRows[row]);
         }
-        setData(createIndex(row, 0), QVariant::fromValue(item));
+        ++row;
     }
+    flushPending();
+
+    return changes;
+}
 
-    // remove mount points, that do not exist anymore
-    for (const auto & mountPoint : unusedMountPoints) {
-        const int row = indexOfMountPoint(mountPoint, m_items);
-        Q_ASSERT(row >= 0);
-        removeRow(row);
+void LliurexQuotaListModel::applyChanges(const ChangeSet &changes)
+{
+    for (const Change &change : changes) {
+        switch (change.type) {
+            case Change::Remove:
+                beginRemoveRows(QModelIndex(), change.first, change.last);
+                m_rows.remove(change.first, change.last - change.first + 1);
+                endRemoveRows();
+                break;
+            case Change::Move:
+                // Qt counts the destination of a move down before the moved row is taken out
+                beginMoveRows(QModelIndex(), change.first, change.first, QModelIndex(),
+                              change.last > change.first ? change.last + 1 : change.last);
+                m_rows.move(change.first, change.last);
+                endMoveRows();
+                break;
+            case Change::Insert:
+                beginInsertRows(QModelIndex(), change.first, change.last);
+                m_rows.insert(change.first, change.rows.size(), Row());
+                for (int i = 0; i < change.rows.size(); ++i) {
+                    m_rows[change.first + i] = change.rows[i];
+                }
+                endInsertRows();
+                break;
+            case Change::Update:
+                for (int i = 0; i < change.rows.size(); ++i) {
+                    m_rows[change.first + i] = change.rows[i];
+                }
+                if (!change.roles.isEmpty()) {
+                    emit dataChanged(createIndex(change.first, 0), createIndex(change.last, 0), change.roles);
+                }
+                break;
+        }
+    }
+}
+
+void LliurexQuotaListModel::updateItems(const QVector<LliurexQuotaItem> &items)
+{
+    QVector<Row> rows;
+    rows.reserve(items.size());
+    for (const auto &item : items) {
+        rows.append(makeRow(item, m_formatter));
     }
+    applyChanges(diff(m_rows, rows));
 }
@@ -21,16 +21,58 @@
 #include <QAbstractListModel>
 #include <QVector>
 
+#include "LliurexQuotaFormatter.h"
 #include "LliurexQuotaItem.h"
 
 /**
  * Data model holding disk quota items.
+ *
+ * The display strings of every row are built when the row is set, not
+ * when QML asks for them, and a list of new items is turned into a
+ * ChangeSet by the pure function diff(): both can run on a worker thread,
+ * see LliurexQuotaPipeline, so that the GUI thread only applies the
+ * changes with applyChanges(). The pipeline keeps the row of an item
+ * whose numbers did not change, so only changed rows are formatted.
  */
 class LliurexQuotaListModel : public QAbstractListModel
 {
     Q_OBJECT
 
 public:
+    /**
+     * An item with its display strings.
+     */
+    struct Row {
+        LliurexQuotaItem item;
+        QString details;
+        QString icon;
+        QString free;
+        QString used;
+        QString forecast;
+        QString reclaimable;
+    };
+
+    /**
+     * One step of a ChangeSet, in terms of the rows at the time it is
+     * applied.
+     */
+    struct Change {
+        enum Type {
+            Remove,     // rows first to last
+            Move,       // row first to position last
+            Insert,     // rows at first to last
+            Update      // rows first to last, roles changed
+        };
+
+        Type type = Update;
+        int first = 0;
+        int last = 0;
+        QVector<int> roles;     // Update: empty if no shown data changed
+        QVector<Row> rows;      // Insert, Update
+    };
+
+    typedef QVector<Change> ChangeSet;
+
     LliurexQuotaListModel(QObject *parent = nullptr);
 
 public: // QAbstractListModel overrides
@@ -65,6 +107,33 @@ public: // QAbstractListModel overrides
     bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 
 public: // additional helper functions
+    /**
+     * Builds the row showing @p item. Safe to call from any thread, with
+     * a @p formatter of that thread.
+     */
+    static Row makeRow(const LliurexQuotaItem &item, LliurexQuotaFormatter &formatter);
+
+    /**
+     * Returns @p rows with one row per key: the mount point is the key of
+     * a row, and for duplicate keys the last row wins, at the position of
+     * the first one. These are the rows of the model after applying
+     * diff() to @p rows.
+     */
+    static QVector<Row> uniqueRows(const QVector<Row> &rows);
+
+    /**
+     * Returns the steps turning @p current into uniqueRows() of @p rows:
+     * vanished rows are removed, the others brought into the new order
+     * with as few moves as possible, new ones inserted, and changed ones
+     * updated with the roles that differ. Safe to call from any thread.
+     */
+    static ChangeSet diff(const QVector<Row> &current, const QVector<Row> &rows);
+
+    /**
+     * Applies @p changes, computed by diff() against the rows of this model.
+     */
+    void applyChanges(const ChangeSet &changes);
+
     /**
      * Merges @p items into the existing quota item list. Old items that are
      * not available in @p items anymore are deleted.
@@ -77,7 +146,10 @@ public: // additional helper functions
     void clear();
 
 private:
-    QVector<LliurexQuotaItem> m_items;
+    QVector<Row> m_rows;
+
+    // builds the rows of updateItems() and setData()
+    LliurexQuotaFormatter m_formatter;
 };
 
 #endif // PLASMA_LLIUREX_QUOTA_LIST_MODEL_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaMetricsAdaptor.h"
+#include "LliurexQuotaMetrics.h"
+#include "lliurexquota_debug.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+
+LliurexQuotaMetricsAdaptor::LliurexQuotaMetricsAdaptor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void LliurexQuotaMetricsAdaptor::exportOnSessionBus()
+{
+    static bool exported = false;
+    if (exported || !QCoreApplication::instance()) {
+        return;
+    }
+    exported = true;
+
+    auto adaptor = new LliurexQuotaMetricsAdaptor(QCoreApplication::instance());
+    if (!QDBusConnection::sessionBus().registerObject(QStringLiteral("/net/lliurex/Quota/Metrics"), adaptor,
+                                                      QDBusConnection::ExportScriptableSlots)) {
+        qCDebug(LLIUREXQUOTA) << "Cannot export the metrics on the session bus";
+    }
+}
+
+QVariantMap LliurexQuotaMetricsAdaptor::Snapshot() const
+{
+    return LliurexQuotaMetrics::instance().snapshot();
+}
+
+QString LliurexQuotaMetricsAdaptor::PrometheusText() const
+{
+    return QString::fromUtf8(LliurexQuotaMetrics::instance().prometheusText());
+}
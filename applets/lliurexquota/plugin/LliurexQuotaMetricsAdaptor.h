@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_METRICS_ADAPTOR_H
+#define PLASMA_LLIUREX_QUOTA_METRICS_ADAPTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * D-Bus face of LliurexQuotaMetrics.
+ */
+class LliurexQuotaMetricsAdaptor : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.lliurex.Quota.Metrics")
+
+public:
+    LliurexQuotaMetricsAdaptor(QObject *parent = nullptr);
+
+    /**
+     * Publishes the metrics as net.lliurex.Quota.Metrics on the object path
+     * /net/lliurex/Quota/Metrics of the session bus. Only the first call
+     * has an effect.
+     */
+    static void exportOnSessionBus();
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QVariantMap Snapshot() const;
+    Q_SCRIPTABLE QString PrometheusText() const;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_METRICS_ADAPTOR_H
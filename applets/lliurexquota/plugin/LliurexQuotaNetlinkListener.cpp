@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaNetlinkListener.h"
+
+#include <QSocketNotifier>
+
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/quota.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+    const char QuotaFamilyName[] = "VFS_DQUOT";
+    const char QuotaGroupName[] = "events";
+
+    /**
+     * Iterates over the netlink attributes in [data, data + size).
+     */
+    template<typename Function>
+    void forEachAttribute(const char *data, int size, Function function)
+    {
+        while (size >= int(NLA_HDRLEN)) {
+            const struct nlattr *attribute = reinterpret_cast<const struct nlattr *>(data);
+            if (attribute->nla_len < NLA_HDRLEN || attribute->nla_len > size) {
+                return;
+            }
+            function(attribute->nla_type & NLA_TYPE_MASK, data + NLA_HDRLEN, int(attribute->nla_len - NLA_HDRLEN));
+            const int length = NLA_ALIGN(attribute->nla_len);
+            data += length;
+            size -= length;
+        }
+    }
+
+    template<typename T>
+    T attributeValue(const char *payload, int size)
+    {
+        T value = 0;
+        memcpy(&value, payload, qMin(int(sizeof(T)), size));
+        return value;
+    }
+
+    void appendAttribute(QByteArray &buffer, quint16 type, const void *payload, int size)
+    {
+        struct nlattr attribute;
+        attribute.nla_len = quint16(NLA_HDRLEN + size);
+        attribute.nla_type = type;
+        buffer.append(reinterpret_cast<const char *>(&attribute), sizeof(attribute));
+        buffer.append(static_cast<const char *>(payload), size);
+        buffer.append(NLA_ALIGN(size) - size, '\0');
+    }
+
+    /**
+     * Builds a complete netlink message of @p type carrying a generic
+     * netlink header with command @p command and the attributes @p attributes.
+     */
+    QByteArray genericMessage(quint16 type, quint16 flags, quint8 command, const QByteArray &attributes)
+    {
+        struct nlmsghdr header;
+        memset(&header, 0, sizeof(header));
+        header.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN + attributes.size());
+        header.nlmsg_type = type;
+        header.nlmsg_flags = flags;
+
+        struct genlmsghdr genericHeader;
+        memset(&genericHeader, 0, sizeof(genericHeader));
+        genericHeader.cmd = command;
+        genericHeader.version = 1;
+
+        QByteArray message;
+        message.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        message.append(NLMSG_HDRLEN - int(sizeof(header)), '\0');
+        message.append(reinterpret_cast<const char *>(&genericHeader), sizeof(genericHeader));
+        message.append(GENL_HDRLEN - int(sizeof(genericHeader)), '\0');
+        message.append(attributes);
+        return message;
+    }
+}
+
+LliurexQuotaNetlinkListener::LliurexQuotaNetlinkListener(QObject *parent)
+    : QObject(parent)
+    , m_uid(getuid())
+{
+    const int count = getgroups(0, nullptr);
+    QVector<gid_t> gids(qMax(count, 0));
+    const int n = count > 0 ? getgroups(count, gids.data()) : 0;
+    for (int i = 0; i < n; ++i) {
+        m_gids.append(gids[i]);
+    }
+    if (!m_gids.contains(getgid())) {
+        m_gids.append(getgid());
+    }
+
+    if (!subscribe()) {
+        if (m_socket >= 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+        return;
+    }
+
+    m_notifier = new QSocketNotifier(m_socket, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &LliurexQuotaNetlinkListener::readSocket);
+}
+
+LliurexQuotaNetlinkListener::~LliurexQuotaNetlinkListener()
+{
+    if (m_socket >= 0) {
+        ::close(m_socket);
+    }
+}
+
+bool LliurexQuotaNetlinkListener::isActive() const
+{
+    return m_notifier != nullptr;
+}
+
+void LliurexQuotaNetlinkListener::setIds(uint uid, const QVector<uint> &gids)
+{
+    m_uid = uid;
+    m_gids = gids;
+}
+
+bool LliurexQuotaNetlinkListener::isExceeded(int warning)
+{
+    switch (warning) {
+        case InodeHardLimitReached:
+        case InodeGraceExpired:
+        case InodeSoftLimitReached:
+        case BlockHardLimitReached:
+        case BlockGraceExpired:
+        case BlockSoftLimitReached:
+            return true;
+    }
+    return false;
+}
+
+bool LliurexQuotaNetlinkListener::subscribe()
+{
+    m_socket = ::socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (m_socket < 0) {
+        return false;
+    }
+
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    if (::bind(m_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0) {
+        return false;
+    }
+
+    // resolve the dynamic family id and the multicast group of VFS_DQUOT
+    QByteArray attributes;
+    appendAttribute(attributes, CTRL_ATTR_FAMILY_NAME, QuotaFamilyName, sizeof(QuotaFamilyName));
+    const QByteArray request = genericMessage(GENL_ID_CTRL, NLM_F_REQUEST, CTRL_CMD_GETFAMILY, attributes);
+
+    struct sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    if (::sendto(m_socket, request.constData(), request.size(), 0,
+                 reinterpret_cast<struct sockaddr *>(&kernel), sizeof(kernel)) < 0) {
+        return false;
+    }
+
+    // the kernel answers synchronously, the reply is queued once sendto() returns
+    alignas(struct nlmsghdr) char buffer[4096];
+    const ssize_t size = ::recv(m_socket, buffer, sizeof(buffer), 0);
+    if (size < ssize_t(NLMSG_HDRLEN + GENL_HDRLEN)) {
+        return false;
+    }
+
+    const struct nlmsghdr *header = reinterpret_cast<const struct nlmsghdr *>(buffer);
+    if (header->nlmsg_type == NLMSG_ERROR || !NLMSG_OK(header, size)) {
+        // family unknown: kernel built without CONFIG_QUOTA_NETLINK_INTERFACE
+        return false;
+    }
+
+    int groupId = -1;
+    const char *payload = static_cast<const char *>(NLMSG_DATA(header)) + GENL_HDRLEN;
+    const int payloadSize = int(header->nlmsg_len) - NLMSG_HDRLEN - GENL_HDRLEN;
+    forEachAttribute(payload, payloadSize, [&](int type, const char *data, int length) {
+        if (type == CTRL_ATTR_FAMILY_ID) {
+            m_familyId = attributeValue<quint16>(data, length);
+        } else if (type == CTRL_ATTR_MCAST_GROUPS) {
+            forEachAttribute(data, length, [&](int, const char *group, int groupLength) {
+                QByteArray name;
+                quint32 id = 0;
+                forEachAttribute(group, groupLength, [&](int groupType, const char *value, int valueLength) {
+                    if (groupType == CTRL_ATTR_MCAST_GRP_NAME) {
+                        name = QByteArray(value, qstrnlen(value, valueLength));
+                    } else if (groupType == CTRL_ATTR_MCAST_GRP_ID) {
+                        id = attributeValue<quint32>(value, valueLength);
+                    }
+                });
+                if (name == QuotaGroupName) {
+                    groupId = int(id);
+                }
+            });
+        }
+    });
+
+    if (m_familyId < 0 || groupId < 0) {
+        return false;
+    }
+
+    return ::setsockopt(m_socket, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &groupId, sizeof(groupId)) == 0;
+}
+
+void LliurexQuotaNetlinkListener::readSocket()
+{
+    alignas(struct nlmsghdr) char buffer[8192];
+    for (;;) {
+        const ssize_t size = ::recv(m_socket, buffer, sizeof(buffer), 0);
+        if (size > 0) {
+            processDatagram(QByteArray::fromRawData(buffer, int(size)));
+        } else if (size < 0 && errno == ENOBUFS) {
+            // we missed warnings, which is harmless: the next poll catches up
+            continue;
+        } else {
+            break;
+        }
+    }
+}
+
+void LliurexQuotaNetlinkListener::processDatagram(const QByteArray &datagram)
+{
+    int size = datagram.size();
+    const struct nlmsghdr *header = reinterpret_cast<const struct nlmsghdr *>(datagram.constData());
+
+    for (; NLMSG_OK(header, size); header = NLMSG_NEXT(header, size)) {
+        if (header->nlmsg_type < NLMSG_MIN_TYPE
+            || (m_familyId >= 0 && header->nlmsg_type != m_familyId)
+            || header->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+            continue;
+        }
+
+        const struct genlmsghdr *genericHeader = static_cast<const struct genlmsghdr *>(NLMSG_DATA(header));
+        if (genericHeader->cmd != QUOTA_NL_C_WARNING) {
+            continue;
+        }
+
+        int type = -1;
+        quint64 id = 0;
+        int warning = NoWarning;
+        uint devMajor = 0;
+        uint devMinor = 0;
+
+        const char *payload = reinterpret_cast<const char *>(genericHeader) + GENL_HDRLEN;
+        const int payloadSize = int(header->nlmsg_len) - NLMSG_HDRLEN - GENL_HDRLEN;
+        forEachAttribute(payload, payloadSize, [&](int attribute, const char *data, int length) {
+            switch (attribute) {
+                case QUOTA_NL_A_QTYPE: type = int(attributeValue<quint32>(data, length)); break;
+                case QUOTA_NL_A_EXCESS_ID: id = attributeValue<quint64>(data, length); break;
+                case QUOTA_NL_A_WARNING: warning = int(attributeValue<quint32>(data, length)); break;
+                case QUOTA_NL_A_DEV_MAJOR: devMajor = attributeValue<quint32>(data, length); break;
+                case QUOTA_NL_A_DEV_MINOR: devMinor = attributeValue<quint32>(data, length); break;
+            }
+        });
+
+        // 0 = USRQUOTA, 1 = GRPQUOTA; project quotas are not shown
+        const bool relevant = (type == 0 && id == m_uid)
+                           || (type == 1 && id <= 0xffffffffu && m_gids.contains(uint(id)));
+        if (relevant && warning != NoWarning) {
+            emit quotaWarning(type, id, warning, devMajor, devMinor);
+        }
+    }
+}
+
+QByteArray LliurexQuotaNetlinkListener::createWarningDatagram(int type, quint64 id, int warning,
+                                                              uint devMajor, uint devMinor) const
+{
+    const quint32 qtype = quint32(type);
+    const quint32 warningValue = quint32(warning);
+    const quint64 causedId = id;
+
+    QByteArray attributes;
+    appendAttribute(attributes, QUOTA_NL_A_QTYPE, &qtype, sizeof(qtype));
+    appendAttribute(attributes, QUOTA_NL_A_EXCESS_ID, &id, sizeof(id));
+    appendAttribute(attributes, QUOTA_NL_A_WARNING, &warningValue, sizeof(warningValue));
+    appendAttribute(attributes, QUOTA_NL_A_DEV_MAJOR, &devMajor, sizeof(devMajor));
+    appendAttribute(attributes, QUOTA_NL_A_DEV_MINOR, &devMinor, sizeof(devMinor));
+    appendAttribute(attributes, QUOTA_NL_A_CAUSED_ID, &causedId, sizeof(causedId));
+
+    const quint16 familyId = m_familyId >= 0 ? quint16(m_familyId) : quint16(GENL_MIN_ID);
+    return genericMessage(familyId, 0, QUOTA_NL_C_WARNING, attributes);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_NETLINK_LISTENER_H
+#define PLASMA_LLIUREX_QUOTA_NETLINK_LISTENER_H
+
+#include <QObject>
+#include <QVector>
+
+class QSocketNotifier;
+
+/**
+ * Listens to the quota warnings the kernel sends through the generic
+ * netlink family VFS_DQUOT whenever a user or group crosses a soft or hard
+ * limit, its grace time expires, or its usage drops below a limit again.
+ *
+ * Only warnings about the user and groups set with setIds() are reported,
+ * by default those of the current process.
+ */
+class LliurexQuotaNetlinkListener : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Kind of a quota warning, values of QUOTA_NL_* in <linux/quota.h>.
+     */
+    enum Warning {
+        NoWarning = 0,
+        InodeHardLimitReached,
+        InodeGraceExpired,
+        InodeSoftLimitReached,
+        BlockHardLimitReached,
+        BlockGraceExpired,
+        BlockSoftLimitReached,
+        InodeBelowHardLimit,
+        InodeBelowSoftLimit,
+        BlockBelowHardLimit,
+        BlockBelowSoftLimit
+    };
+
+    LliurexQuotaNetlinkListener(QObject *parent = nullptr);
+    ~LliurexQuotaNetlinkListener() override;
+
+    /**
+     * Returns true if the listener is subscribed to the kernel's quota
+     * warnings. False if the kernel lacks CONFIG_QUOTA_NETLINK_INTERFACE.
+     */
+    bool isActive() const;
+
+    /**
+     * Restricts the reported warnings to user @p uid and groups @p gids.
+     */
+    void setIds(uint uid, const QVector<uint> &gids);
+
+    /**
+     * Returns true if @p warning means that a limit is exceeded.
+     */
+    static bool isExceeded(int warning);
+
+    /**
+     * Parses one netlink datagram, which may hold several messages, and
+     * emits quotaWarning() for each relevant warning. Used for the data read
+     * from the socket, and to inject synthetic messages for testing.
+     */
+    void processDatagram(const QByteArray &datagram);
+
+    /**
+     * Builds a datagram with one QUOTA_NL_C_WARNING message as the kernel
+     * would send it, e.g. to feed processDatagram() in tests.
+     * @p type is 0 for user and 1 for group quotas.
+     */
+    QByteArray createWarningDatagram(int type, quint64 id, int warning,
+                                     uint devMajor = 0, uint devMinor = 0) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted for each warning concerning the user or its groups.
+     * @p type is 0 for user and 1 for group quotas, @p warning a Warning.
+     */
+    void quotaWarning(int type, quint64 id, int warning, uint devMajor, uint devMinor);
+
+private Q_SLOTS:
+    void readSocket();
+
+private:
+    bool subscribe();
+
+    int m_socket = -1;
+    int m_familyId = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    uint m_uid = 0;
+    QVector<uint> m_gids;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_NETLINK_LISTENER_H
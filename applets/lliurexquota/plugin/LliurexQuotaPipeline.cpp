@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaPipeline.h"
+#include "LliurexDBusQuotaBackend.h"
+#include "LliurexNfsQuotaBackend.h"
+#include "LliurexProcessQuotaBackend.h"
+#include "LliurexQuotactlBackend.h"
+#include "LliurexQuotaFormatter.h"
+#include "LliurexQuotaMetrics.h"
+#include "LliurexQuotaThresholds.h"
+#include "LliurexToolLocator.h"
+#include "LliurexUsageHistory.h"
+#include "lliurexquota_debug.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QScopedPointer>
+#include <QStorageInfo>
+#include <QThread>
+
+#include <atomic>
+#include <cmath>
+
+namespace {
+    /**
+     * @p rate in bytes per second to two significant digits, and slower
+     * than a byte per second as 0, so that the smoothed rate, which moves
+     * a little on every poll, only changes the growthRate role now and then.
+     */
+    double quantizedGrowthRate(double rate)
+    {
+        if (std::abs(rate) < 1.0) {
+            return 0.0;
+        }
+        const double scale = std::pow(10.0, std::floor(std::log10(std::abs(rate))) - 1.0);
+        return std::round(rate / scale) * scale;
+    }
+}
+
+/**
+ * Picks the in-process quotactl backend if quota enabled file systems are
+ * mounted locally, otherwise falls back to running 'lliurex-quota'.
+ */
+static LliurexQuotaBackend *createLocalBackend(const QByteArray &forced, LliurexToolLocator *locator, QObject *parent)
+{
+    if (forced != "nfs" && forced != "process") {
+        auto backend = new LliurexQuotactlBackend(parent);
+        if (forced == "quotactl" || backend->isAvailable()) {
+            return backend;
+        }
+        delete backend;
+    }
+    // homes mounted over NFS have no local device for quotactl(); asking
+    // rquotad directly is opt-in, lliurex-quota answers whenever it cannot
+    if (forced == "nfs") {
+        return new LliurexNfsQuotaBackend(new LliurexProcessQuotaBackend(locator, parent), parent);
+    }
+    return new LliurexProcessQuotaBackend(locator, parent);
+}
+
+/**
+ * Uses the per-host quota service whenever it is present and polls locally
+ * otherwise. The choice can be forced with LLIUREX_QUOTA_BACKEND=quotactl|nfs|process.
+ */
+static LliurexQuotaBackend *createBackend(LliurexToolLocator *locator, QObject *parent)
+{
+    const QByteArray forced = qgetenv("LLIUREX_QUOTA_BACKEND");
+    LliurexQuotaBackend *local = createLocalBackend(forced, locator, parent);
+    if (forced == "quotactl" || forced == "nfs" || forced == "process") {
+        return local;
+    }
+    return new LliurexDBusQuotaBackend(local, parent);
+}
+
+/**
+ * The part of LliurexQuotaPipeline living in its thread, together with
+ * the backend, which is its child.
+ */
+class LliurexQuotaPipelineWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef LliurexQuotaPipeline::Presentation Presentation;
+
+    explicit LliurexQuotaPipelineWorker(LliurexToolLocator *locator);
+
+    QString backendName() const { return m_backendName; }
+    bool isAvailable() const { return m_available; }
+    bool pushesUpdates() const { return m_pushesUpdates; }
+
+    // generation of the latest call of the GUI thread, which may not
+    // have been processed yet
+    std::atomic<quint64> latestGeneration;
+
+public Q_SLOTS:
+    void request(quint64 generation);
+    void present(quint64 generation, const QVector<LliurexQuotaEntry> &entries);
+    void setReclaimable(quint64 generation, qint64 bytes);
+    void reset(quint64 generation);
+    void publishState();
+
+Q_SIGNALS:
+    void presented(const LliurexQuotaPipeline::Presentation &presentation);
+    void quotaFailed(const QString &reason);
+    void stateChanged(const QString &name, bool available, bool pushesUpdates);
+
+private Q_SLOTS:
+    void quotaReady(const QVector<LliurexQuotaEntry> &entries);
+    void quotaUnchanged();
+    void backendFailed(const QString &reason);
+
+private:
+    bool takeAnswer();
+    void recordUsage(const QVector<LliurexQuotaEntry> &entries);
+    void forecast(const LliurexQuotaEntry &entry, qint64 *timeToFull, double *growthRate) const;
+    bool forecastChanged() const;
+    void emitPresentation(Presentation::Kind kind, const QVector<LliurexQuotaEntry> &entries);
+    void applyReclaimable(QVector<LliurexQuotaItem> &items, const QVector<LliurexQuotaEntry> &entries) const;
+
+    LliurexQuotaBackend *m_backend = nullptr;
+    QScopedPointer<LliurexUsageHistory> m_history;
+    LliurexQuotaFormatter m_formatter;
+
+    // the rows and entries as last presented, with the forecast of
+    // every entry and the tray numbers
+    QVector<LliurexQuotaListModel::Row> m_rows;
+    QVector<LliurexQuotaEntry> m_entries;
+    QVector<qint64> m_timesToFull;
+    QVector<double> m_growthRates;
+    int m_maxQuota = 0;
+    int m_alertQuota = 0;
+    QString m_forecast;
+    qint64 m_reclaimable = 0;
+
+    quint64 m_processed = 0;        // generation of the last call processed
+    bool m_pending = false;         // a backend query is running
+    bool m_discardAnswer = false;   // its answer predates a reset()
+
+    QString m_backendName;
+    bool m_available = false;
+    bool m_pushesUpdates = false;
+};
+
+LliurexQuotaPipelineWorker::LliurexQuotaPipelineWorker(LliurexToolLocator *locator)
+    : QObject()
+    , latestGeneration(0)
+    , m_backend(createBackend(locator, this))
+    , m_history(new LliurexUsageHistory())
+{
+    m_backendName = m_backend->name();
+    m_available = m_backend->isAvailable();
+    m_pushesUpdates = m_backend->pushesUpdates();
+
+    connect(m_backend, &LliurexQuotaBackend::quotaReady, this, &LliurexQuotaPipelineWorker::quotaReady);
+    connect(m_backend, &LliurexQuotaBackend::quotaUnchanged, this, &LliurexQuotaPipelineWorker::quotaUnchanged);
+    connect(m_backend, &LliurexQuotaBackend::quotaFailed, this, &LliurexQuotaPipelineWorker::backendFailed);
+    connect(m_backend, &LliurexQuotaBackend::pushesUpdatesChanged, this, &LliurexQuotaPipelineWorker::publishState);
+
+    // the locator lives in the GUI thread, this is a queued connection
+    connect(locator, &LliurexToolLocator::toolsChanged, this, &LliurexQuotaPipelineWorker::publishState);
+}
+
+void LliurexQuotaPipelineWorker::request(quint64 generation)
+{
+    m_processed = generation;
+    m_pending = true;
+    m_discardAnswer = false;
+    m_backend->requestQuota();
+
+    // e.g. the tool was removed since the last query
+    publishState();
+}
+
+void LliurexQuotaPipelineWorker::present(quint64 generation, const QVector<LliurexQuotaEntry> &entries)
+{
+    m_processed = generation;
+    emitPresentation(Presentation::Stale, entries);
+}
+
+void LliurexQuotaPipelineWorker::setReclaimable(quint64 generation, qint64 bytes)
+{
+    m_processed = generation;
+    if (m_reclaimable == bytes) {
+        return;
+    }
+    m_reclaimable = bytes;
+
+    // the presentation of a later call shows it anyway
+    if (latestGeneration.load() == generation) {
+        emitPresentation(Presentation::Refresh, m_entries);
+    }
+}
+
+void LliurexQuotaPipelineWorker::reset(quint64 generation)
+{
+    m_processed = generation;
+    m_discardAnswer = m_pending;
+    m_rows.clear();
+    m_entries.clear();
+    m_timesToFull.clear();
+    m_growthRates.clear();
+    m_backend->forgetLastResult();
+}
+
+void LliurexQuotaPipelineWorker::publishState()
+{
+    const QString name = m_backend->name();
+    const bool available = m_backend->isAvailable();
+    const bool pushesUpdates = m_backend->pushesUpdates();
+    if (name != m_backendName || available != m_available || pushesUpdates != m_pushesUpdates) {
+        m_backendName = name;
+        m_available = available;
+        m_pushesUpdates = pushesUpdates;
+        emit stateChanged(name, available, pushesUpdates);
+    }
+}
+
+bool LliurexQuotaPipelineWorker::takeAnswer()
+{
+    // answers pushed by the backend without a request are always taken
+    const bool discard = m_pending && m_discardAnswer;
+    m_pending = false;
+    m_discardAnswer = false;
+    if (discard) {
+        qCDebug(LLIUREXQUOTA) << "Dropping the answer to a poll started before a reset";
+    }
+    return !discard;
+}
+
+void LliurexQuotaPipelineWorker::quotaReady(const QVector<LliurexQuotaEntry> &entries)
+{
+    if (takeAnswer()) {
+        recordUsage(entries);
+        emitPresentation(Presentation::Answer, entries);
+    }
+}
+
+void LliurexQuotaPipelineWorker::quotaUnchanged()
+{
+    if (!takeAnswer()) {
+        return;
+    }
+
+    // the numbers are the same, but the growth rate still decays with time
+    recordUsage(m_entries);
+    if (forecastChanged()) {
+        emitPresentation(Presentation::Unchanged, m_entries);
+        return;
+    }
+
+    // nothing shown changed: tell that the poll was answered, without
+    // formatting or diffing any row
+    Presentation presentation;
+    presentation.generation = m_processed;
+    presentation.kind = Presentation::Unchanged;
+    presentation.entries = m_entries;
+    presentation.maxQuota = m_maxQuota;
+    presentation.alertQuota = m_alertQuota;
+    presentation.forecast = m_forecast;
+    emit presented(presentation);
+}
+
+void LliurexQuotaPipelineWorker::backendFailed(const QString &reason)
+{
+    if (takeAnswer()) {
+        emit quotaFailed(reason);
+    }
+}
+
+void LliurexQuotaPipelineWorker::recordUsage(const QVector<LliurexQuotaEntry> &entries)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    for (const LliurexQuotaEntry &entry : entries) {
+        m_history->addSample(entry.key(), now, entry.used);
+    }
+}
+
+void LliurexQuotaPipelineWorker::forecast(const LliurexQuotaEntry &entry, qint64 *timeToFull, double *growthRate) const
+{
+    const QString key = entry.key();
+    const qint64 seconds = m_history->timeToFull(key, entry.used, entry.limit());
+
+    // whole minutes, so that the forecast roles do not change on every poll
+    *timeToFull = seconds > 0 ? seconds / 60 * 60 : seconds;
+    *growthRate = quantizedGrowthRate(m_history->growthRate(key));
+}
+
+bool LliurexQuotaPipelineWorker::forecastChanged() const
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        qint64 timeToFull;
+        double growthRate;
+        forecast(m_entries[i], &timeToFull, &growthRate);
+        if (timeToFull != m_timesToFull.value(i, -1) || growthRate != m_growthRates.value(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LliurexQuotaPipelineWorker::emitPresentation(Presentation::Kind kind, const QVector<LliurexQuotaEntry> &entries)
+{
+    LliurexMetricsSpan formatSpan(LliurexQuotaMetrics::FormatTime);
+
+    Presentation presentation;
+    presentation.generation = m_processed;
+    presentation.kind = kind;
+    presentation.entries = entries;
+    presentation.maxQuota = LliurexQuotaThresholds::maximumUsage(entries);
+
+    QVector<LliurexQuotaItem> items = LliurexQuotaFormatter::toItems(entries);
+
+    // attach the forecast of each quota, the usage of fresh entries was
+    // recorded by the caller
+    QVector<qint64> timesToFull(entries.size());
+    QVector<double> growthRates(entries.size());
+    int soonestFull = -1;
+    for (int i = 0; i < entries.size(); ++i) {
+        forecast(entries[i], &timesToFull[i], &growthRates[i]);
+        items[i].setGrowthRate(growthRates[i]);
+        items[i].setTimeToFull(timesToFull[i]);
+
+        if (timesToFull[i] >= 0 && (soonestFull < 0 || timesToFull[i] < timesToFull[soonestFull])) {
+            soonestFull = i;
+        }
+    }
+
+    // a quota filling up quickly is shown like an almost full one
+    presentation.alertQuota = soonestFull >= 0
+        ? qMax(presentation.maxQuota, LliurexQuotaThresholds::forecastUsage(items[soonestFull].timeToFull()))
+        : presentation.maxQuota;
+    if (presentation.alertQuota > presentation.maxQuota) {
+        presentation.forecast = m_formatter.forecastString(items[soonestFull]);
+    }
+
+    applyReclaimable(items, entries);
+
+    // only rows whose numbers changed are formatted again
+    QHash<QString, int> previousRows;
+    previousRows.reserve(m_rows.size());
+    for (int i = 0; i < m_rows.size(); ++i) {
+        previousRows.insert(m_rows[i].item.mountPoint(), i);
+    }
+
+    QVector<LliurexQuotaListModel::Row> rows;
+    rows.reserve(items.size());
+    for (const LliurexQuotaItem &item : qAsConst(items)) {
+        const auto it = previousRows.constFind(item.mountPoint());
+        if (it != previousRows.constEnd() && m_rows[it.value()].item == item) {
+            rows.append(m_rows[it.value()]);
+        } else {
+            rows.append(LliurexQuotaListModel::makeRow(item, m_formatter));
+        }
+    }
+    rows = LliurexQuotaListModel::uniqueRows(rows);
+    presentation.changes = LliurexQuotaListModel::diff(m_rows, rows);
+    m_rows = rows;
+    m_entries = entries;
+    m_timesToFull = timesToFull;
+    m_growthRates = growthRates;
+    m_maxQuota = presentation.maxQuota;
+    m_alertQuota = presentation.alertQuota;
+    m_forecast = presentation.forecast;
+    formatSpan.stop();
+
+    if (kind == Presentation::Refresh && presentation.changes.isEmpty()) {
+        return;
+    }
+    emit presented(presentation);
+}
+
+void LliurexQuotaPipelineWorker::applyReclaimable(QVector<LliurexQuotaItem> &items, const QVector<LliurexQuotaEntry> &entries) const
+{
+    // caches and trash are in the home folder: they count against the
+    // quotas of its file system, and against the assigned space of
+    // lliurex-quota, whose records name no mount point. The type says
+    // nothing here, lliurex-quota reports group quotas only.
+    const QString homeMountPoint = QStorageInfo(QDir::homePath()).rootPath();
+    for (int i = 0; i < items.size(); ++i) {
+        const LliurexQuotaEntry &entry = entries[i];
+        const bool onHome = entry.mountPoint.isEmpty() || entry.mountPoint == homeMountPoint;
+        items[i].setReclaimable(onHome ? m_reclaimable : 0);
+    }
+}
+
+LliurexQuotaPipeline::LliurexQuotaPipeline(LliurexToolLocator *locator, QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_worker(new LliurexQuotaPipelineWorker(locator))
+{
+    // both cross to the worker thread and back
+    qRegisterMetaType<LliurexQuotaPipeline::Presentation>();
+    qRegisterMetaType<QVector<LliurexQuotaEntry>>();
+
+    m_backendName = m_worker->backendName();
+    m_available = m_worker->isAvailable();
+    m_pushesUpdates = m_worker->pushesUpdates();
+
+    connect(m_worker, &LliurexQuotaPipelineWorker::presented, this, &LliurexQuotaPipeline::workerPresented);
+    connect(m_worker, &LliurexQuotaPipelineWorker::quotaFailed, this, &LliurexQuotaPipeline::quotaFailed);
+    connect(m_worker, &LliurexQuotaPipelineWorker::stateChanged, this, &LliurexQuotaPipeline::stateChanged);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    m_thread->setObjectName(QStringLiteral("LliurexQuotaPipeline"));
+    m_worker->moveToThread(m_thread);
+    m_thread->start();
+}
+
+LliurexQuotaPipeline::~LliurexQuotaPipeline()
+{
+    // the worker is deleted in its thread when the thread finishes
+    m_thread->quit();
+    m_thread->wait();
+}
+
+QString LliurexQuotaPipeline::backendName() const
+{
+    return m_backendName;
+}
+
+bool LliurexQuotaPipeline::isAvailable() const
+{
+    return m_available;
+}
+
+bool LliurexQuotaPipeline::pushesUpdates() const
+{
+    return m_pushesUpdates;
+}
+
+quint64 LliurexQuotaPipeline::nextGeneration()
+{
+    m_worker->latestGeneration.store(++m_generation);
+    return m_generation;
+}
+
+void LliurexQuotaPipeline::requestQuota()
+{
+    QMetaObject::invokeMethod(m_worker, "request", Qt::QueuedConnection,
+                              Q_ARG(quint64, nextGeneration()));
+}
+
+void LliurexQuotaPipeline::checkAvailable()
+{
+    QMetaObject::invokeMethod(m_worker, "publishState", Qt::QueuedConnection);
+}
+
+void LliurexQuotaPipeline::present(const QVector<LliurexQuotaEntry> &entries)
+{
+    QMetaObject::invokeMethod(m_worker, "present", Qt::QueuedConnection,
+                              Q_ARG(quint64, nextGeneration()),
+                              Q_ARG(QVector<LliurexQuotaEntry>, entries));
+}
+
+void LliurexQuotaPipeline::setReclaimable(qint64 bytes)
+{
+    QMetaObject::invokeMethod(m_worker, "setReclaimable", Qt::QueuedConnection,
+                              Q_ARG(quint64, nextGeneration()),
+                              Q_ARG(qint64, bytes));
+}
+
+void LliurexQuotaPipeline::reset()
+{
+    m_resetGeneration = nextGeneration();
+    QMetaObject::invokeMethod(m_worker, "reset", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_resetGeneration));
+}
+
+void LliurexQuotaPipeline::workerPresented(const LliurexQuotaPipeline::Presentation &presentation)
+{
+    // computed against rows the caller has cleared since
+    if (presentation.generation < m_resetGeneration) {
+        return;
+    }
+    emit presented(presentation);
+}
+
+void LliurexQuotaPipeline::stateChanged(const QString &name, bool available, bool pushesUpdates)
+{
+    if (m_backendName != name || m_pushesUpdates != pushesUpdates) {
+        m_backendName = name;
+        m_pushesUpdates = pushesUpdates;
+        emit backendChanged();
+    }
+    if (m_available != available) {
+        m_available = available;
+        emit availableChanged();
+    }
+}
+
+#include "LliurexQuotaPipeline.moc"
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_PIPELINE_H
+#define PLASMA_LLIUREX_QUOTA_PIPELINE_H
+
+#include <QObject>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaListModel.h"
+
+class QThread;
+class LliurexQuotaPipelineWorker;
+class LliurexToolLocator;
+
+/**
+ * Runs the quota backend, the usage history, the formatting and the model
+ * diff on a thread of their own, off the plasmashell GUI thread.
+ *
+ * The GUI thread only starts polls and receives a Presentation: the quota
+ * entries, the tray numbers and the ChangeSet that turns the rows the
+ * LliurexQuotaListModel shows into the new ones. The worker keeps a copy
+ * of the rows it has sent, so every Presentation must be applied, in order,
+ * unless reset() was called in between.
+ *
+ * Every call gets a generation number. reset() forgets the rows on both
+ * sides: presentations of older generations that are still on their way
+ * are dropped, and so are backend answers to polls started before it.
+ */
+class LliurexQuotaPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Result of one step of the pipeline.
+     */
+    struct Presentation {
+        enum Kind {
+            Answer,     // the backend delivered new data
+            Unchanged,  // the backend delivered the same data as last time
+            Stale,      // data of the last session, see present()
+            Refresh     // the reclaimable space changed, see setReclaimable()
+        };
+
+        quint64 generation = 0;
+        Kind kind = Answer;
+        QVector<LliurexQuotaEntry> entries;
+        LliurexQuotaListModel::ChangeSet changes;
+
+        // highest usage in percent, and the usage the quota filling up
+        // the soonest is treated like
+        int maxQuota = 0;
+        int alertQuota = 0;
+
+        // forecast of that quota, if it raised alertQuota
+        QString forecast;
+
+        bool isFresh() const { return kind == Answer || kind == Unchanged; }
+    };
+
+    LliurexQuotaPipeline(LliurexToolLocator *locator, QObject *parent = nullptr);
+    ~LliurexQuotaPipeline() override;
+
+    /**
+     * Short name of the backend, e.g. "quotactl" or "process".
+     */
+    QString backendName() const;
+
+    /**
+     * Returns true if the backend is able to deliver quota data, as last
+     * reported by the worker thread.
+     */
+    bool isAvailable() const;
+
+    /**
+     * Returns true if the backend pushes changes by itself.
+     */
+    bool pushesUpdates() const;
+
+    /**
+     * Starts a backend query; the answer arrives as presented() or quotaFailed().
+     */
+    void requestQuota();
+
+    /**
+     * Asks the worker to check again whether the backend is available;
+     * availableChanged() is emitted if that changed.
+     */
+    void checkAvailable();
+
+    /**
+     * Presents @p entries, e.g. a snapshot of the last session, as stale data.
+     */
+    void present(const QVector<LliurexQuotaEntry> &entries);
+
+    /**
+     * Sets the space in bytes that emptying caches and trash would free in
+     * the home folder, shown with the quotas it counts against: those of
+     * the file system of the home folder, and those of lliurex-quota.
+     */
+    void setReclaimable(qint64 bytes);
+
+    /**
+     * Forgets the data shown; the caller clears its model at the same time.
+     */
+    void reset();
+
+Q_SIGNALS:
+    /**
+     * Emitted with the result of a step, on the GUI thread.
+     */
+    void presented(const LliurexQuotaPipeline::Presentation &presentation);
+
+    /**
+     * Emitted when the backend could not complete a query.
+     */
+    void quotaFailed(const QString &reason);
+
+    /**
+     * Emitted when isAvailable() changed.
+     */
+    void availableChanged();
+
+    /**
+     * Emitted when backendName() or pushesUpdates() changed.
+     */
+    void backendChanged();
+
+private Q_SLOTS:
+    void workerPresented(const LliurexQuotaPipeline::Presentation &presentation);
+    void stateChanged(const QString &name, bool available, bool pushesUpdates);
+
+private:
+    quint64 nextGeneration();
+
+    QThread *m_thread = nullptr;
+    LliurexQuotaPipelineWorker *m_worker = nullptr;
+    quint64 m_generation = 0;
+    quint64 m_resetGeneration = 0;
+    QString m_backendName;
+    bool m_available = false;
+    bool m_pushesUpdates = false;
+};
+
+Q_DECLARE_METATYPE(LliurexQuotaPipeline::Presentation)
+
+#endif // PLASMA_LLIUREX_QUOTA_PIPELINE_H
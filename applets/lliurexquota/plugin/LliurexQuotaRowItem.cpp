@@ -0,0 +1,514 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaRowItem.h"
+
+#include <QCache>
+#include <QFontMetricsF>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGSimpleRectNode>
+#include <QSGSimpleTextureNode>
+
+#include <cmath>
+
+namespace {
+    // part of the text color the dimmed texts keep, as the labels of ListDelegateItem
+    const qreal DimmedOpacity = 0.6;
+
+    /**
+     * Rendered texts and icons, shared by all rows. Only used on the GUI
+     * thread; the cost is in bytes.
+     */
+    QCache<QString, QImage> &imageCache()
+    {
+        static QCache<QString, QImage> cache(16 * 1024 * 1024);
+        return cache;
+    }
+
+    int imageCost(const QImage &image)
+    {
+        return qMax(1, image.width() * image.height() * 4);
+    }
+
+    qreal advance(const QFontMetricsF &metrics, const QString &text)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        return metrics.horizontalAdvance(text);
+#else
+        return metrics.width(text);
+#endif
+    }
+
+    QImage renderText(const QString &text, const QFont &font, const QColor &color, const QSizeF &size, qreal devicePixelRatio)
+    {
+        QImage image(int(std::ceil(size.width() * devicePixelRatio)), int(std::ceil(size.height() * devicePixelRatio)),
+                     QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(devicePixelRatio);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        painter.setFont(font);
+        painter.setPen(color);
+        painter.drawText(QRectF(QPointF(0, 0), size), Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, text);
+        return image;
+    }
+
+    QImage renderIcon(const QString &name, int size, qreal devicePixelRatio)
+    {
+        const int pixels = qRound(size * devicePixelRatio);
+        QImage image = QIcon::fromTheme(name).pixmap(QSize(pixels, pixels)).toImage();
+        image.setDevicePixelRatio(devicePixelRatio);
+        return image;
+    }
+
+    /**
+     * Shows @p image in @p node, which is created and removed as the image
+     * comes and goes: a texture node without texture cannot be drawn.
+     */
+    void updateTexture(QQuickWindow *window, QSGNode *parent, QSGSimpleTextureNode *&node, const QImage &image)
+    {
+        if (image.isNull()) {
+            if (node) {
+                parent->removeChildNode(node);
+                delete node;
+                node = nullptr;
+            }
+            return;
+        }
+
+        if (!node) {
+            node = new QSGSimpleTextureNode;
+            node->setOwnsTexture(true);
+            node->setFiltering(QSGTexture::Linear);
+            parent->appendChildNode(node);
+        }
+        // small images go into the atlas, so that the rows share a few textures
+        // and the renderer can batch them
+        node->setTexture(window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas));
+    }
+}
+
+/**
+ * Root node of a row; its children are the bar first, then the textures.
+ */
+class LliurexQuotaRowItem::Node : public QSGNode
+{
+public:
+    QSGSimpleRectNode *track = nullptr;
+    QSGSimpleRectNode *fill = nullptr;
+    QSGSimpleTextureNode *textures[SlotCount] = {};
+};
+
+LliurexQuotaRowItem::LliurexQuotaRowItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptHoverEvents(true);
+    updateImplicitHeight();
+    polish();
+}
+
+LliurexQuotaRowItem::~LliurexQuotaRowItem()
+{
+}
+
+QString LliurexQuotaRowItem::title() const
+{
+    return m_title;
+}
+
+void LliurexQuotaRowItem::setTitle(const QString &title)
+{
+    if (m_title != title) {
+        m_title = title;
+        invalidate(TextDirty);
+        emit titleChanged();
+    }
+}
+
+QString LliurexQuotaRowItem::note() const
+{
+    return m_note;
+}
+
+void LliurexQuotaRowItem::setNote(const QString &note)
+{
+    if (m_note != note) {
+        m_note = note;
+        invalidate(TextDirty);
+        emit noteChanged();
+    }
+}
+
+QString LliurexQuotaRowItem::subtitle() const
+{
+    return m_subtitle;
+}
+
+void LliurexQuotaRowItem::setSubtitle(const QString &subtitle)
+{
+    if (m_subtitle != subtitle) {
+        m_subtitle = subtitle;
+        invalidate(TextDirty);
+        emit subtitleChanged();
+    }
+}
+
+QString LliurexQuotaRowItem::forecast() const
+{
+    return m_forecast;
+}
+
+void LliurexQuotaRowItem::setForecast(const QString &forecast)
+{
+    if (m_forecast != forecast) {
+        m_forecast = forecast;
+        invalidate(TextDirty);
+        emit forecastChanged();
+    }
+}
+
+QString LliurexQuotaRowItem::iconName() const
+{
+    return m_iconName;
+}
+
+void LliurexQuotaRowItem::setIconName(const QString &iconName)
+{
+    if (m_iconName != iconName) {
+        m_iconName = iconName;
+        invalidate(IconDirty);
+        emit iconNameChanged();
+    }
+}
+
+int LliurexQuotaRowItem::usage() const
+{
+    return m_usage;
+}
+
+void LliurexQuotaRowItem::setUsage(int usage)
+{
+    if (m_usage != usage) {
+        m_usage = usage;
+        invalidate(BarDirty);
+        emit usageChanged();
+    }
+}
+
+int LliurexQuotaRowItem::iconSize() const
+{
+    return m_iconSize;
+}
+
+void LliurexQuotaRowItem::setIconSize(int iconSize)
+{
+    if (m_iconSize != iconSize) {
+        m_iconSize = iconSize;
+        invalidate(IconDirty | TextDirty | LayoutDirty);
+        updateImplicitHeight();
+        emit iconSizeChanged();
+    }
+}
+
+int LliurexQuotaRowItem::spacing() const
+{
+    return m_spacing;
+}
+
+void LliurexQuotaRowItem::setSpacing(int spacing)
+{
+    if (m_spacing != spacing) {
+        m_spacing = spacing;
+        invalidate(TextDirty | LayoutDirty);
+        updateImplicitHeight();
+        emit spacingChanged();
+    }
+}
+
+int LliurexQuotaRowItem::padding() const
+{
+    return m_padding;
+}
+
+void LliurexQuotaRowItem::setPadding(int padding)
+{
+    if (m_padding != padding) {
+        m_padding = padding;
+        invalidate(TextDirty | LayoutDirty);
+        updateImplicitHeight();
+        emit paddingChanged();
+    }
+}
+
+QFont LliurexQuotaRowItem::font() const
+{
+    return m_font;
+}
+
+void LliurexQuotaRowItem::setFont(const QFont &font)
+{
+    if (m_font != font) {
+        m_font = font;
+        invalidate(TextDirty | LayoutDirty);
+        updateImplicitHeight();
+        emit fontChanged();
+    }
+}
+
+QColor LliurexQuotaRowItem::textColor() const
+{
+    return m_textColor;
+}
+
+void LliurexQuotaRowItem::setTextColor(const QColor &color)
+{
+    if (m_textColor != color) {
+        m_textColor = color;
+        invalidate(TextDirty);
+        emit textColorChanged();
+    }
+}
+
+QColor LliurexQuotaRowItem::barColor() const
+{
+    return m_barColor;
+}
+
+void LliurexQuotaRowItem::setBarColor(const QColor &color)
+{
+    if (m_barColor != color) {
+        m_barColor = color;
+        invalidate(BarDirty);
+        emit barColorChanged();
+    }
+}
+
+QColor LliurexQuotaRowItem::trackColor() const
+{
+    return m_trackColor;
+}
+
+void LliurexQuotaRowItem::setTrackColor(const QColor &color)
+{
+    if (m_trackColor != color) {
+        m_trackColor = color;
+        invalidate(BarDirty);
+        emit trackColorChanged();
+    }
+}
+
+bool LliurexQuotaRowItem::containsMouse() const
+{
+    return m_containsMouse;
+}
+
+void LliurexQuotaRowItem::invalidate(int dirty)
+{
+    m_dirty |= dirty;
+    polish();
+    update();
+}
+
+void LliurexQuotaRowItem::updateImplicitHeight()
+{
+    const qreal lineHeight = std::ceil(QFontMetricsF(m_font).height());
+    const qreal barHeight = qMax<qreal>(4, std::round(lineHeight / 3));
+    setImplicitHeight(qMax<qreal>(m_iconSize, 2 * lineHeight + barHeight + m_spacing) + 2 * m_padding);
+}
+
+void LliurexQuotaRowItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+
+    // everything hangs from the top left corner, only the width matters
+    if (newGeometry.width() != oldGeometry.width()) {
+        invalidate(TextDirty | BarDirty | LayoutDirty);
+    }
+}
+
+void LliurexQuotaRowItem::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemDevicePixelRatioHasChanged || (change == ItemSceneChange && value.window)) {
+        invalidate(IconDirty | TextDirty);
+    }
+    QQuickItem::itemChange(change, value);
+}
+
+qreal LliurexQuotaRowItem::setText(Slot slot, const QString &text, const QColor &color, qreal x, qreal y, qreal maxWidth, Qt::Alignment alignment)
+{
+    Content &content = m_contents[slot];
+    const QFontMetricsF metrics(m_font);
+    const QString elided = maxWidth > 0 ? metrics.elidedText(text, Qt::ElideRight, maxWidth) : QString();
+
+    const QString key = elided.isEmpty() ? QString()
+        : elided + QLatin1Char('\x1f') + color.name(QColor::HexArgb) + QLatin1Char('\x1f')
+          + m_font.key() + QLatin1Char('\x1f') + QString::number(m_devicePixelRatio);
+
+    if (key != content.key) {
+        content.key = key;
+        content.textureDirty = true;
+        if (key.isEmpty()) {
+            content.image = QImage();
+        } else if (QImage *cached = imageCache().object(key)) {
+            content.image = *cached;
+        } else {
+            content.image = renderText(elided, m_font, color, QSizeF(advance(metrics, elided), std::ceil(metrics.height())), m_devicePixelRatio);
+            imageCache().insert(key, new QImage(content.image), imageCost(content.image));
+        }
+    }
+
+    const QSizeF size = content.image.isNull() ? QSizeF() : QSizeF(content.image.size()) / m_devicePixelRatio;
+    content.rect = QRectF(alignment & Qt::AlignRight ? x - size.width() : x, y, size.width(), size.height());
+    return size.width();
+}
+
+void LliurexQuotaRowItem::updatePolish()
+{
+    const qreal devicePixelRatio = window() ? window()->effectiveDevicePixelRatio() : qApp->devicePixelRatio();
+    if (devicePixelRatio != m_devicePixelRatio) {
+        m_devicePixelRatio = devicePixelRatio;
+        m_dirty |= IconDirty | TextDirty;
+    }
+
+    const qreal lineHeight = std::ceil(QFontMetricsF(m_font).height());
+    const qreal barHeight = qMax<qreal>(4, std::round(lineHeight / 3));
+    const qreal left = m_padding;
+    const qreal top = m_padding;
+    const qreal right = width() - m_padding;
+    const qreal textLeft = left + m_iconSize + m_spacing;
+    const qreal textWidth = qMax<qreal>(0, right - textLeft);
+    const qreal barTop = top + lineHeight + m_spacing / 2.0;
+    const qreal secondLine = barTop + barHeight + m_spacing / 2.0;
+
+    if (m_dirty & IconDirty) {
+        Content &content = m_contents[IconSlot];
+        const QString key = m_iconName.isEmpty() ? QString()
+            : m_iconName + QLatin1Char('\x1f') + QString::number(m_iconSize) + QLatin1Char('\x1f') + QString::number(m_devicePixelRatio);
+        if (key != content.key) {
+            content.key = key;
+            content.textureDirty = true;
+            if (key.isEmpty()) {
+                content.image = QImage();
+            } else if (QImage *cached = imageCache().object(key)) {
+                content.image = *cached;
+            } else {
+                content.image = renderIcon(m_iconName, m_iconSize, m_devicePixelRatio);
+                imageCache().insert(key, new QImage(content.image), imageCost(content.image));
+            }
+        }
+    }
+    m_contents[IconSlot].rect = QRectF(left, top, m_iconSize, m_iconSize);
+
+    if (m_dirty & (TextDirty | LayoutDirty)) {
+        QColor dimmed = m_textColor;
+        dimmed.setAlphaF(dimmed.alphaF() * DimmedOpacity);
+
+        // the texts on the right take what they need, up to half of the line
+        const qreal noteWidth = setText(NoteSlot, m_note, dimmed, right, top, textWidth / 2, Qt::AlignRight);
+        setText(TitleSlot, m_title, m_textColor, textLeft, top,
+                textWidth - (noteWidth > 0 ? noteWidth + m_spacing : 0), Qt::AlignLeft);
+
+        const qreal forecastWidth = setText(ForecastSlot, m_forecast, dimmed, right, secondLine, textWidth / 2, Qt::AlignRight);
+        setText(SubtitleSlot, m_subtitle, dimmed, textLeft, secondLine,
+                textWidth - (forecastWidth > 0 ? forecastWidth + m_spacing : 0), Qt::AlignLeft);
+    }
+
+    m_trackRect = QRectF(textLeft, barTop, textWidth, barHeight);
+    m_fillRect = QRectF(textLeft, barTop, textWidth * qBound(0, m_usage, 100) / 100.0, barHeight);
+
+    m_dirty = 0;
+}
+
+QSGNode *LliurexQuotaRowItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    Node *node = static_cast<Node *>(oldNode);
+    if (!node) {
+        node = new Node;
+        node->track = new QSGSimpleRectNode;
+        node->fill = new QSGSimpleRectNode;
+        node->appendChildNode(node->track);
+        node->appendChildNode(node->fill);
+        // the textures of a previous node went away with its window
+        for (Content &content : m_contents) {
+            content.textureDirty = true;
+        }
+    }
+
+    // setters of the nodes mark them dirty for the renderer even when the
+    // value did not change, so only changed values are passed on
+    if (node->track->rect() != m_trackRect) {
+        node->track->setRect(m_trackRect);
+    }
+    if (node->track->color() != m_trackColor) {
+        node->track->setColor(m_trackColor);
+    }
+    if (node->fill->rect() != m_fillRect) {
+        node->fill->setRect(m_fillRect);
+    }
+    if (node->fill->color() != m_barColor) {
+        node->fill->setColor(m_barColor);
+    }
+
+    for (int slot = 0; slot < SlotCount; ++slot) {
+        Content &content = m_contents[slot];
+        if (content.textureDirty) {
+            updateTexture(window(), node, node->textures[slot], content.image);
+            content.textureDirty = false;
+        }
+        QSGSimpleTextureNode *texture = node->textures[slot];
+        if (texture && texture->rect() != content.rect) {
+            texture->setRect(content.rect);
+        }
+    }
+
+    return node;
+}
+
+void LliurexQuotaRowItem::hoverEnterEvent(QHoverEvent *event)
+{
+    Q_UNUSED(event)
+    m_containsMouse = true;
+    emit containsMouseChanged();
+}
+
+void LliurexQuotaRowItem::hoverLeaveEvent(QHoverEvent *event)
+{
+    Q_UNUSED(event)
+    m_containsMouse = false;
+    emit containsMouseChanged();
+}
+
+void LliurexQuotaRowItem::mousePressEvent(QMouseEvent *event)
+{
+    // accepting the press is what brings the release here
+    event->accept();
+}
+
+void LliurexQuotaRowItem::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (contains(event->localPos())) {
+        emit clicked();
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_ROW_ITEM_H
+#define PLASMA_LLIUREX_QUOTA_ROW_ITEM_H
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QQuickItem>
+
+/**
+ * One quota row drawn with a handful of scene graph nodes: the icon, up to
+ * four lines of text and the usage bar.
+ *
+ * ListDelegateItem.qml builds a ListItem with layouts, labels, an icon item
+ * and a progress bar for every row, which is too heavy for the list of all
+ * users. This item renders each text once into an image on the GUI thread,
+ * elided to the space it has, and uploads it as a texture; images are
+ * shared between rows through a small cache, so the repeated notes and
+ * icons of a long list are rendered once. A changed property only marks
+ * its own node dirty: a new usage moves the bar and leaves the textures
+ * alone, a new width re-elides the texts but uploads only those whose
+ * elided text changed.
+ *
+ * The layout follows ListDelegateItem: the icon on the left; title and
+ * note above the bar, subtitle and forecast below it, the last three
+ * dimmed. Theme values are set from QML.
+ */
+class LliurexQuotaRowItem : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString title READ title WRITE setTitle NOTIFY titleChanged)
+    Q_PROPERTY(QString note READ note WRITE setNote NOTIFY noteChanged)
+    Q_PROPERTY(QString subtitle READ subtitle WRITE setSubtitle NOTIFY subtitleChanged)
+    Q_PROPERTY(QString forecast READ forecast WRITE setForecast NOTIFY forecastChanged)
+    Q_PROPERTY(QString iconName READ iconName WRITE setIconName NOTIFY iconNameChanged)
+    Q_PROPERTY(int usage READ usage WRITE setUsage NOTIFY usageChanged)
+    Q_PROPERTY(int iconSize READ iconSize WRITE setIconSize NOTIFY iconSizeChanged)
+    Q_PROPERTY(int spacing READ spacing WRITE setSpacing NOTIFY spacingChanged)
+    Q_PROPERTY(int padding READ padding WRITE setPadding NOTIFY paddingChanged)
+    Q_PROPERTY(QFont font READ font WRITE setFont NOTIFY fontChanged)
+    Q_PROPERTY(QColor textColor READ textColor WRITE setTextColor NOTIFY textColorChanged)
+    Q_PROPERTY(QColor barColor READ barColor WRITE setBarColor NOTIFY barColorChanged)
+    Q_PROPERTY(QColor trackColor READ trackColor WRITE setTrackColor NOTIFY trackColorChanged)
+    Q_PROPERTY(bool containsMouse READ containsMouse NOTIFY containsMouseChanged)
+
+public:
+    LliurexQuotaRowItem(QQuickItem *parent = nullptr);
+    ~LliurexQuotaRowItem() override;
+
+    QString title() const;
+    void setTitle(const QString &title);
+
+    /**
+     * Right of the title, dimmed.
+     */
+    QString note() const;
+    void setNote(const QString &note);
+
+    /**
+     * Below the bar, dimmed.
+     */
+    QString subtitle() const;
+    void setSubtitle(const QString &subtitle);
+
+    /**
+     * Right of the subtitle, dimmed.
+     */
+    QString forecast() const;
+    void setForecast(const QString &forecast);
+
+    QString iconName() const;
+    void setIconName(const QString &iconName);
+
+    /**
+     * Filled part of the bar in percent.
+     */
+    int usage() const;
+    void setUsage(int usage);
+
+    int iconSize() const;
+    void setIconSize(int iconSize);
+
+    /**
+     * Between the icon and the texts, and half of it around the bar.
+     */
+    int spacing() const;
+    void setSpacing(int spacing);
+
+    int padding() const;
+    void setPadding(int padding);
+
+    QFont font() const;
+    void setFont(const QFont &font);
+
+    QColor textColor() const;
+    void setTextColor(const QColor &color);
+
+    QColor barColor() const;
+    void setBarColor(const QColor &color);
+
+    QColor trackColor() const;
+    void setTrackColor(const QColor &color);
+
+    bool containsMouse() const;
+
+Q_SIGNALS:
+    void titleChanged();
+    void noteChanged();
+    void subtitleChanged();
+    void forecastChanged();
+    void iconNameChanged();
+    void usageChanged();
+    void iconSizeChanged();
+    void spacingChanged();
+    void paddingChanged();
+    void fontChanged();
+    void textColorChanged();
+    void barColorChanged();
+    void trackColorChanged();
+    void containsMouseChanged();
+    void clicked();
+
+protected:
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+    void hoverEnterEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    enum Slot {
+        IconSlot = 0,
+        TitleSlot,
+        NoteSlot,
+        SubtitleSlot,
+        ForecastSlot,
+        SlotCount
+    };
+
+    enum Dirty {
+        IconDirty = 0x1,
+        TextDirty = 0x2,        // texts, font, colors or width changed
+        BarDirty = 0x4,         // usage or bar colors changed
+        LayoutDirty = 0x8       // positions changed
+    };
+
+    /**
+     * What one texture node shows. Filled in updatePolish() on the GUI
+     * thread, read in updatePaintNode() while the GUI thread is blocked.
+     */
+    struct Content {
+        QString key;            // what the image was rendered from
+        QImage image;
+        QRectF rect;
+        bool textureDirty = false;
+    };
+
+    class Node;
+
+    void invalidate(int dirty);
+    void updateImplicitHeight();
+    qreal setText(Slot slot, const QString &text, const QColor &color, qreal x, qreal y, qreal maxWidth, Qt::Alignment alignment);
+
+    QString m_title;
+    QString m_note;
+    QString m_subtitle;
+    QString m_forecast;
+    QString m_iconName;
+    int m_usage = 0;
+    int m_iconSize = 32;
+    int m_spacing = 8;
+    int m_padding = 0;
+    QFont m_font;
+    QColor m_textColor = Qt::black;
+    QColor m_barColor = Qt::blue;
+    QColor m_trackColor = Qt::lightGray;
+    bool m_containsMouse = false;
+
+    int m_dirty = IconDirty | TextDirty | BarDirty | LayoutDirty;
+    qreal m_devicePixelRatio = 0;
+    Content m_contents[SlotCount];
+    QRectF m_trackRect;
+    QRectF m_fillRect;
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_ROW_ITEM_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaSnapshot.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+    const quint32 Magic = 0x4c51534e; // 'LQSN'
+    const quint32 Version = 2;
+
+    // far more than any user has; protects against a garbled count
+    const quint32 MaxEntries = 4096;
+
+    // older data tells more about the past than about the quota now
+    const qint64 MaxAge = 7 * 24 * 60 * 60;
+}
+
+QString LliurexQuotaSnapshot::defaultFileName()
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheDir.isEmpty()) {
+        return QString();
+    }
+    return cacheDir + QStringLiteral("/lliurexquota/snapshot");
+}
+
+bool LliurexQuotaSnapshot::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (fileName.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != Magic || version != Version) {
+        return false;
+    }
+
+    qint64 msecs = 0;
+    quint32 count = 0;
+    stream >> msecs >> count;
+    if (stream.status() != QDataStream::Ok || count > MaxEntries) {
+        return false;
+    }
+    const QDateTime saved = QDateTime::fromMSecsSinceEpoch(msecs);
+    if (saved.secsTo(QDateTime::currentDateTime()) > MaxAge) {
+        return false;
+    }
+
+    QVector<LliurexQuotaEntry> loaded;
+    loaded.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        LliurexQuotaEntry entry;
+        qint32 type = 0;
+        stream >> type >> entry.id >> entry.name >> entry.mountPoint
+               >> entry.used >> entry.softLimit >> entry.hardLimit
+               >> entry.inodesUsed >> entry.inodeSoftLimit >> entry.inodeHardLimit
+               >> entry.graceTime >> entry.group;
+        entry.type = type == LliurexQuotaEntry::GroupQuota ? LliurexQuotaEntry::GroupQuota : LliurexQuotaEntry::UserQuota;
+        loaded.append(entry);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    entries = loaded;
+    time = saved;
+    return true;
+}
+
+bool LliurexQuotaSnapshot::save(const QString &fileName) const
+{
+    if (fileName.isEmpty() || !QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        return false;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << Magic << Version << qint64(time.toMSecsSinceEpoch()) << quint32(entries.size());
+    for (const LliurexQuotaEntry &entry : entries) {
+        stream << qint32(entry.type) << entry.id << entry.name << entry.mountPoint
+               << entry.used << entry.softLimit << entry.hardLimit
+               << entry.inodesUsed << entry.inodeSoftLimit << entry.inodeHardLimit
+               << entry.graceTime << entry.group;
+    }
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
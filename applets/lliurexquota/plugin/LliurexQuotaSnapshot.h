@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_QUOTA_SNAPSHOT_H
+#define PLASMA_LLIUREX_QUOTA_SNAPSHOT_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * The last quota data read, persisted in a small binary file under
+ * $XDG_CACHE_HOME, so that the applet has something to show right after
+ * login without waiting for the first poll.
+ *
+ * The file starts with a magic number and a format version; files of
+ * another version are ignored, and so are snapshots older than a week,
+ * e.g. of a user who did not log in during the holidays.
+ */
+class LliurexQuotaSnapshot
+{
+public:
+    /**
+     * $XDG_CACHE_HOME/lliurexquota/snapshot
+     */
+    static QString defaultFileName();
+
+    /**
+     * Reads the snapshot from @p fileName. Returns false if there is none,
+     * it cannot be read or it expired, leaving entries and time untouched.
+     */
+    bool load(const QString &fileName = defaultFileName());
+
+    /**
+     * Atomically replaces @p fileName with this snapshot.
+     */
+    bool save(const QString &fileName = defaultFileName()) const;
+
+public:
+    QVector<LliurexQuotaEntry> entries;
+    QDateTime time;     // when the entries were read
+};
+
+#endif // PLASMA_LLIUREX_QUOTA_SNAPSHOT_H
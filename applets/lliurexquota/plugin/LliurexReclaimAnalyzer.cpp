@@ -0,0 +1,533 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexReclaimAnalyzer.h"
+#include "lliurexquota_debug.h"
+
+#include <QFile>
+#include <QRunnable>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <KLocalizedString>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * What the confirmation of a purge lists, one line each.
+     */
+    enum Category {
+        CacheCategory,
+        ThumbnailCategory,
+        BrowserCategory,
+        TrashCategory,
+        CategoryCount
+    };
+
+    /**
+     * A folder whose contents can go, relative to the home folder; a '*'
+     * stands for any one folder, e.g. a browser profile.
+     */
+    struct Location {
+        const char *pattern;
+        const char *const *excluded;    // names kept at the top level
+        Category category;
+        const char *lock;               // exists while the owner runs, which is then left alone
+    };
+
+    // ksycoca, the icon cache and plasma's own files are in use by
+    // plasmashell itself; the thumbnails and the browsers' disk caches
+    // are locations of their own
+    const char *const CacheExclusions[] = {
+        "lliurexquota", "thumbnails", "ksycoca5", "icon-cache.kcache", "plasma", "kwin",
+        "google-chrome", "chromium", nullptr
+    };
+
+    const Location Locations[] = {
+        {".cache", CacheExclusions, CacheCategory, nullptr},
+        {".cache/thumbnails", nullptr, ThumbnailCategory, nullptr},
+        {".thumbnails", nullptr, ThumbnailCategory, nullptr},
+        {".cache/google-chrome", nullptr, BrowserCategory, ".config/google-chrome/SingletonLock"},
+        {".cache/chromium", nullptr, BrowserCategory, ".config/chromium/SingletonLock"},
+        {".config/google-chrome/*/Service Worker/CacheStorage", nullptr, BrowserCategory, ".config/google-chrome/SingletonLock"},
+        {".config/google-chrome/*/Code Cache", nullptr, BrowserCategory, ".config/google-chrome/SingletonLock"},
+        {".config/chromium/*/Service Worker/CacheStorage", nullptr, BrowserCategory, ".config/chromium/SingletonLock"},
+        {".config/chromium/*/Code Cache", nullptr, BrowserCategory, ".config/chromium/SingletonLock"},
+        {".local/share/Trash/files", nullptr, TrashCategory, nullptr},
+        {".local/share/Trash/info", nullptr, TrashCategory, nullptr},
+        {".local/share/Trash/expunged", nullptr, TrashCategory, nullptr},
+    };
+
+    const int LocationCount = sizeof(Locations) / sizeof(Locations[0]);
+
+    // names read from a directory before they are removed
+    const int PurgeBatchSize = 1024;
+
+    // deeper trees are left alone rather than running out of descriptors
+    const int MaxDepth = 256;
+
+    const int UpdateInterval = 250;
+
+    // between two analyses started by refresh()
+    const qint64 RefreshInterval = 10 * 60 * 1000;
+
+    QThreadPool *reclaimPool()
+    {
+        static QThreadPool *pool = new QThreadPool();
+        return pool;
+    }
+
+    bool isDotOrDotDot(const char *name)
+    {
+        return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+    }
+
+    bool isExcluded(const char *name, const char *const *excluded)
+    {
+        for (; excluded && *excluded; ++excluded) {
+            if (std::strncmp(name, *excluded, std::strlen(*excluded)) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+/**
+ * One analysis or purge, shared by its tasks and the analyzer.
+ */
+class LliurexReclaimJob
+{
+public:
+    LliurexReclaimJob(const QByteArray &home, bool purge, bool purgeTrash)
+        : purge(purge)
+        , purgeTrash(purgeTrash)
+        , m_home(home)
+    {
+        for (std::atomic<qint64> &found : categoryBytes) {
+            found.store(0);
+        }
+    }
+
+    void run(int location);
+
+    const bool purge;
+    const bool purgeTrash;
+    std::atomic<bool> cancelled{false};
+    std::atomic<qint64> bytes{0};       // found, or removed
+    std::atomic<int> keptEntries{0};    // could not be removed
+    std::atomic<qint64> categoryBytes[CategoryCount];   // found
+    std::atomic<int> finishedTasks{0};
+
+private:
+    bool isLocked(const Location &location) const;
+    QVector<QByteArray> expand(const QByteArray &pattern) const;
+    qint64 measure(int fd, dev_t device, const char *const *excluded, int depth);
+    void empty(int fd, dev_t device, const char *const *excluded, int depth);
+
+    const QByteArray m_home;
+};
+
+bool LliurexReclaimJob::isLocked(const Location &location) const
+{
+    if (!location.lock) {
+        return false;
+    }
+    // Chrome's lock is a symbolic link to a host and process
+    const QByteArray lock = m_home + '/' + location.lock;
+    struct stat st;
+    return lstat(lock.constData(), &st) == 0;
+}
+
+QVector<QByteArray> LliurexReclaimJob::expand(const QByteArray &pattern) const
+{
+    QVector<QByteArray> paths{m_home};
+    const QList<QByteArray> components = pattern.split('/');
+    for (const QByteArray &component : components) {
+        QVector<QByteArray> next;
+        for (const QByteArray &path : qAsConst(paths)) {
+            if (component != "*") {
+                next.append(path + '/' + component);
+                continue;
+            }
+            DIR *dir = opendir(path.constData());
+            if (!dir) {
+                continue;
+            }
+            while (struct dirent *entry = readdir(dir)) {
+                if (!isDotOrDotDot(entry->d_name)) {
+                    next.append(path + '/' + entry->d_name);
+                }
+            }
+            closedir(dir);
+        }
+        paths = next;
+    }
+    return paths;
+}
+
+void LliurexReclaimJob::run(int location)
+{
+    const Location &l = Locations[location];
+    if (purge && (l.category == TrashCategory ? !purgeTrash : isLocked(l))) {
+        // the trash only when asked for, a browser's cache not under it
+        finishedTasks.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    // only what is on the file system of the home folder counts against its quota
+    struct stat home;
+    if (stat(m_home.constData(), &home) != 0) {
+        finishedTasks.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    const QVector<QByteArray> paths = expand(l.pattern);
+    for (const QByteArray &path : paths) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            break;
+        }
+        // symbolic links are not followed: a link named .cache must not
+        // empty what it points to
+        const int fd = open(path.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        // e.g. a tmpfs mounted on ~/.cache
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_dev != home.st_dev) {
+            close(fd);
+            continue;
+        }
+        if (purge) {
+            empty(fd, st.st_dev, l.excluded, 0);
+        } else {
+            categoryBytes[l.category].fetch_add(measure(fd, st.st_dev, l.excluded, 0), std::memory_order_relaxed);
+        }
+        close(fd);
+    }
+    finishedTasks.fetch_add(1, std::memory_order_release);
+}
+
+qint64 LliurexReclaimJob::measure(int fd, dev_t device, const char *const *excluded, int depth)
+{
+    const int dirFd = dup(fd);
+    DIR *dir = dirFd >= 0 ? fdopendir(dirFd) : nullptr;
+    if (!dir) {
+        if (dirFd >= 0) {
+            close(dirFd);
+        }
+        return 0;
+    }
+
+    qint64 total = 0;
+    std::vector<QByteArray> subdirectories;
+    while (struct dirent *entry = readdir(dir)) {
+        if (isDotOrDotDot(entry->d_name) || (depth == 0 && isExcluded(entry->d_name, excluded))) {
+            continue;
+        }
+        struct stat st;
+        // a file system mounted below, e.g. gvfs or a bind mount, is
+        // neither counted nor entered, like in LliurexDiskScanner
+        if (fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0 || st.st_dev != device) {
+            continue;
+        }
+        const qint64 size = qint64(st.st_blocks) * 512;
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        total += size;
+        if (S_ISDIR(st.st_mode) && depth < MaxDepth) {
+            subdirectories.push_back(QByteArray(entry->d_name));
+        }
+    }
+    // closed before descending, as in empty(): one descriptor per level
+    closedir(dir);
+
+    for (const QByteArray &name : subdirectories) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            break;
+        }
+        const int child = openat(fd, name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (child >= 0) {
+            total += measure(child, device, nullptr, depth + 1);
+            close(child);
+        }
+    }
+    return total;
+}
+
+void LliurexReclaimJob::empty(int fd, dev_t device, const char *const *excluded, int depth)
+{
+    struct Name {
+        QByteArray name;
+        bool directory;
+        qint64 size;
+    };
+
+    QSet<QByteArray> kept;
+    std::vector<Name> batch;
+    batch.reserve(PurgeBatchSize);
+    for (;;) {
+        // the removed names are gone when the directory is read again
+        const int dirFd = dup(fd);
+        DIR *dir = dirFd >= 0 ? fdopendir(dirFd) : nullptr;
+        if (!dir) {
+            if (dirFd >= 0) {
+                close(dirFd);
+            }
+            return;
+        }
+        batch.clear();
+        while (int(batch.size()) < PurgeBatchSize) {
+            struct dirent *entry = readdir(dir);
+            if (!entry) {
+                break;
+            }
+            const char *name = entry->d_name;
+            if (isDotOrDotDot(name) || (depth == 0 && isExcluded(name, excluded)) || kept.contains(QByteArray(name))) {
+                continue;
+            }
+            struct stat st;
+            if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            // nothing is removed through the mount point of another file system
+            if (st.st_dev != device) {
+                kept.insert(QByteArray(name));
+                keptEntries.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            batch.push_back(Name{QByteArray(name), S_ISDIR(st.st_mode), qint64(st.st_blocks) * 512});
+        }
+        closedir(dir);
+
+        if (batch.empty()) {
+            return;
+        }
+
+        for (const Name &entry : batch) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (entry.directory) {
+                const int child = depth < MaxDepth ? openat(fd, entry.name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC) : -1;
+                if (child >= 0) {
+                    empty(child, device, nullptr, depth + 1);
+                    close(child);
+                }
+            }
+            if (unlinkat(fd, entry.name.constData(), entry.directory ? AT_REMOVEDIR : 0) == 0) {
+                bytes.fetch_add(entry.size, std::memory_order_relaxed);
+            } else {
+                // e.g. a file of another user in a shared cache
+                kept.insert(entry.name);
+                keptEntries.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+namespace {
+    class ReclaimTask : public QRunnable
+    {
+    public:
+        ReclaimTask(const QSharedPointer<LliurexReclaimJob> &job, int location)
+            : m_job(job)
+            , m_location(location)
+        {
+        }
+
+        void run() override
+        {
+            m_job->run(m_location);
+        }
+
+    private:
+        QSharedPointer<LliurexReclaimJob> m_job;
+        int m_location;
+    };
+}
+
+LliurexReclaimAnalyzer::LliurexReclaimAnalyzer(const QString &homePath, QObject *parent)
+    : QObject(parent)
+    , m_homePath(homePath)
+    , m_updateTimer(new QTimer(this))
+{
+    m_updateTimer->setInterval(UpdateInterval);
+    connect(m_updateTimer, &QTimer::timeout, this, &LliurexReclaimAnalyzer::update);
+}
+
+LliurexReclaimAnalyzer::~LliurexReclaimAnalyzer()
+{
+    if (m_job) {
+        m_job->cancelled.store(true);
+    }
+}
+
+bool LliurexReclaimAnalyzer::running() const
+{
+    return !m_job.isNull();
+}
+
+bool LliurexReclaimAnalyzer::purging() const
+{
+    return m_job && m_job->purge;
+}
+
+qint64 LliurexReclaimAnalyzer::reclaimable() const
+{
+    return m_reclaimable;
+}
+
+QVariantList LliurexReclaimAnalyzer::locations() const
+{
+    QVariantList result;
+    for (int category = 0; category < m_categoryBytes.size(); ++category) {
+        const qint64 size = m_categoryBytes.at(category);
+        if (size <= 0) {
+            continue;
+        }
+
+        QString name;
+        switch (category) {
+            case CacheCategory:
+                name = i18n("Cached files of programs");
+                break;
+            case ThumbnailCategory:
+                name = i18n("Thumbnails of pictures and documents");
+                break;
+            case BrowserCategory:
+                name = i18n("Caches of Chrome and Chromium, unless they are running");
+                break;
+            case TrashCategory:
+                name = i18n("The files in the trash");
+                break;
+        }
+
+        QVariantMap location;
+        location[QStringLiteral("name")] = name;
+        location[QStringLiteral("size")] = size;
+        location[QStringLiteral("sizeString")] = m_formatter.formatByteSize(size);
+        location[QStringLiteral("trash")] = category == TrashCategory;
+        result.append(location);
+    }
+    return result;
+}
+
+int LliurexReclaimAnalyzer::purgeProgress() const
+{
+    if (!purging() || m_purgeTarget <= 0) {
+        return 0;
+    }
+    return int(qMin<qint64>(100, m_job->bytes.load(std::memory_order_relaxed) * 100 / m_purgeTarget));
+}
+
+void LliurexReclaimAnalyzer::refresh()
+{
+    if (!m_job && (!m_lastAnalysis.isValid() || m_lastAnalysis.hasExpired(RefreshInterval))) {
+        analyze();
+    }
+}
+
+void LliurexReclaimAnalyzer::analyze()
+{
+    if (!m_job) {
+        startJob(false);
+    }
+}
+
+void LliurexReclaimAnalyzer::purge(bool purgeTrash)
+{
+    // an analysis is cut short, the purge sizes the folders again anyway
+    if (m_job && m_job->purge) {
+        return;
+    }
+    if (m_job) {
+        m_job->cancelled.store(true);
+    }
+    startJob(true, purgeTrash);
+}
+
+void LliurexReclaimAnalyzer::startJob(bool purge, bool purgeTrash)
+{
+    qCDebug(LLIUREXQUOTA) << (purge ? "Purging" : "Sizing") << (purgeTrash ? "caches and trash below" : "caches below") << m_homePath;
+
+    m_purgeTarget = 0;
+    for (int category = 0; category < m_categoryBytes.size(); ++category) {
+        if (category != TrashCategory || purgeTrash) {
+            m_purgeTarget += m_categoryBytes.at(category);
+        }
+    }
+
+    m_job.reset(new LliurexReclaimJob(QFile::encodeName(m_homePath), purge, purgeTrash));
+    QThreadPool *pool = reclaimPool();
+    pool->setMaxThreadCount(qMax(pool->maxThreadCount(), LocationCount));
+    for (int i = 0; i < LocationCount; ++i) {
+        pool->start(new ReclaimTask(m_job, i));
+    }
+
+    m_updateTimer->start();
+    emit runningChanged();
+    emit progressChanged();
+}
+
+void LliurexReclaimAnalyzer::update()
+{
+    if (!m_job) {
+        return;
+    }
+    emit progressChanged();
+    if (m_job->finishedTasks.load(std::memory_order_acquire) != LocationCount) {
+        return;
+    }
+
+    const QSharedPointer<LliurexReclaimJob> job = m_job;
+    const bool purged = job->purge;
+    const qint64 bytes = job->bytes.load();
+    const int keptEntries = job->keptEntries.load();
+    m_job.clear();
+    m_updateTimer->stop();
+    emit runningChanged();
+
+    if (purged) {
+        qCDebug(LLIUREXQUOTA) << "Purged" << bytes << "bytes, kept" << keptEntries << "entries";
+        emit this->purged(bytes, keptEntries);
+        // whatever could not be removed is still reclaimable
+        analyze();
+        return;
+    }
+
+    QVector<qint64> categoryBytes(CategoryCount);
+    for (int category = 0; category < CategoryCount; ++category) {
+        categoryBytes[category] = job->categoryBytes[category].load();
+    }
+
+    m_lastAnalysis.start();
+    if (m_reclaimable != bytes || m_categoryBytes != categoryBytes) {
+        m_reclaimable = bytes;
+        m_categoryBytes = categoryBytes;
+        emit reclaimableChanged();
+    }
+}
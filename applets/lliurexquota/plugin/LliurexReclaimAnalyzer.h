@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PLASMA_LLIUREX_RECLAIM_ANALYZER_H
+#define PLASMA_LLIUREX_RECLAIM_ANALYZER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVariantList>
+#include <QVector>
+
+#include "LliurexQuotaFormatter.h"
+
+class QTimer;
+class LliurexReclaimJob;
+
+/**
+ * Sizes, and on request empties, the folders below the home folder whose
+ * contents can be removed without losing anything: ~/.cache (which
+ * programs fill again as needed), thumbnails, the caches of the web
+ * browsers' profiles, and the trash.
+ *
+ * Every folder is walked, or emptied, by its own task on a pool of
+ * threads. Emptying reads a directory in batches of names and removes
+ * them with unlinkat() relative to the directory, before it reads the
+ * next batch, so memory stays bounded however many files there are.
+ * The GUI thread only polls the progress, so removing hundreds of
+ * thousands of thumbnails never blocks it.
+ *
+ * Only the file system of the home folder is walked: a file system
+ * mounted below it, e.g. by gvfs, is neither counted nor emptied.
+ *
+ * Nothing is removed without the user's confirmation of what locations()
+ * lists. The trash is only emptied when that was asked for, and the
+ * caches of a browser are left alone while it runs.
+ */
+class LliurexReclaimAnalyzer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(bool purging READ purging NOTIFY runningChanged)
+    Q_PROPERTY(qint64 reclaimable READ reclaimable NOTIFY reclaimableChanged)
+    Q_PROPERTY(QVariantList locations READ locations NOTIFY reclaimableChanged)
+    Q_PROPERTY(int purgeProgress READ purgeProgress NOTIFY progressChanged)
+
+public:
+    explicit LliurexReclaimAnalyzer(const QString &homePath, QObject *parent = nullptr);
+    ~LliurexReclaimAnalyzer() override;
+
+    /**
+     * Returns true while sizing or emptying the folders.
+     */
+    bool running() const;
+    bool purging() const;
+
+    /**
+     * Bytes the last analysis found, 0 before the first one completed.
+     */
+    qint64 reclaimable() const;
+
+    /**
+     * What the last analysis found, one map per kind of folder with the
+     * keys "name", "size", "sizeString" and "trash", for the
+     * confirmation of a purge. Kinds without any bytes are left out.
+     */
+    QVariantList locations() const;
+
+    /**
+     * Percentage of the bytes to remove that the running purge removed.
+     */
+    int purgeProgress() const;
+
+public Q_SLOTS:
+    /**
+     * Sizes the folders again, unless that is running or was done less
+     * than a few minutes ago.
+     */
+    void refresh();
+
+    /**
+     * Sizes the folders again.
+     */
+    void analyze();
+
+    /**
+     * Empties the folders, the trash only if @p purgeTrash, then sizes
+     * them again.
+     */
+    void purge(bool purgeTrash = false);
+
+Q_SIGNALS:
+    void runningChanged();
+    void reclaimableChanged();
+    void progressChanged();
+
+    /**
+     * Emitted when a purge completed, with the bytes it removed and the
+     * number of entries it could not remove: those of other users or
+     * file systems, in read-only folders, or the folders holding them.
+     */
+    void purged(qint64 bytes, int keptEntries);
+
+private Q_SLOTS:
+    void update();
+
+private:
+    void startJob(bool purge, bool purgeTrash = false);
+
+    QString m_homePath;
+    QSharedPointer<LliurexReclaimJob> m_job;
+    QTimer *m_updateTimer = nullptr;
+    QElapsedTimer m_lastAnalysis;
+    qint64 m_reclaimable = 0;
+    QVector<qint64> m_categoryBytes;
+    qint64 m_purgeTarget = 0;
+    mutable LliurexQuotaFormatter m_formatter;
+};
+
+#endif // PLASMA_LLIUREX_RECLAIM_ANALYZER_H
@@ -18,6 +18,14 @@
 #include "plugin.h"
 #include "LliurexDiskQuota.h"
 #include "LliurexQuotaListModel.h"
+#include "LliurexQuotaRowItem.h"
+#include "LliurexAdminQuotaModel.h"
+#include "LliurexAdminStatistics.h"
+#include "LliurexDiskScanner.h"
+#include "LliurexDiskUsageModel.h"
+#include "LliurexDuplicateFinder.h"
+#include "LliurexDuplicateModel.h"
+#include "LliurexReclaimAnalyzer.h"
 
 #include <QtQml>
 
@@ -26,4 +34,14 @@ void LliurexDiskQuotaPlugin::registerTypes (const char *uri)
     Q_ASSERT(uri == QLatin1String("org.kde.plasma.private.lliurexquota"));
     qmlRegisterType<LliurexDiskQuota>(uri, 1, 0, "LliurexDiskQuota");
     qmlRegisterType<LliurexQuotaListModel>(uri, 1, 0, "LliurexQuotaListModel");
+    qmlRegisterType<LliurexQuotaRowItem>(uri, 1, 0, "LliurexQuotaRowItem");
+    qmlRegisterType<LliurexAdminQuotaModel>(uri, 1, 0, "LliurexAdminQuotaModel");
+    qmlRegisterUncreatableType<LliurexAdminStatistics>(uri, 1, 0, "LliurexAdminStatistics",
+                                                       QStringLiteral("Use LliurexDiskQuota.adminStatistics"));
+    qmlRegisterType<LliurexDiskScanner>(uri, 1, 0, "LliurexDiskScanner");
+    qmlRegisterType<LliurexDiskUsageModel>(uri, 1, 0, "LliurexDiskUsageModel");
+    qmlRegisterType<LliurexDuplicateFinder>(uri, 1, 0, "LliurexDuplicateFinder");
+    qmlRegisterType<LliurexDuplicateModel>(uri, 1, 0, "LliurexDuplicateModel");
+    qmlRegisterUncreatableType<LliurexReclaimAnalyzer>(uri, 1, 0, "LliurexReclaimAnalyzer",
+                                                       QStringLiteral("Use LliurexDiskQuota.reclaimAnalyzer"));
 }
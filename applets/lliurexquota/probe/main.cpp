@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexProcessQuotaBackend.h"
+#include "LliurexQuotactlBackend.h"
+#include "LliurexQuotaThresholds.h"
+#include "LliurexToolLocator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScopedPointer>
+#include <QSysInfo>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <grp.h>
+#include <pwd.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * What to query, from the command line.
+     */
+    struct Request {
+        bool all = false;
+        bool process = false;
+        uint uid = 0;
+        QVector<uint> gids;
+    };
+
+    /**
+     * Resolves @p user, a name or a numeric id, into its uid and groups.
+     */
+    bool lookUpUser(const QString &user, uint *uid, QVector<uint> *gids)
+    {
+        bool numeric = false;
+        const uint id = user.toUInt(&numeric);
+        const struct passwd *pw = numeric ? getpwuid(id) : getpwnam(user.toLocal8Bit().constData());
+        if (!pw) {
+            // an id without a passwd entry still may have a quota
+            *uid = id;
+            gids->clear();
+            return numeric;
+        }
+
+        *uid = pw->pw_uid;
+        int count = 32;
+        QVector<gid_t> groups(count);
+        while (getgrouplist(pw->pw_name, pw->pw_gid, groups.data(), &count) < 0) {
+            groups.resize(count);
+        }
+        groups.resize(count);
+
+        gids->clear();
+        for (gid_t gid : qAsConst(groups)) {
+            gids->append(gid);
+        }
+        return true;
+    }
+
+    /**
+     * Queries the quotas in-process, without an event loop.
+     */
+    bool queryQuotactl(const Request &request, QVector<LliurexQuotaEntry> *entries, QString *error)
+    {
+        const QVector<LliurexQuotactlBackend::Mount> mounts = LliurexQuotactlBackend::quotaMounts();
+        if (mounts.isEmpty()) {
+            *error = QStringLiteral("no file system with quotas is mounted");
+            return false;
+        }
+
+        if (request.all) {
+            *entries = LliurexQuotactlBackend::sweepQuota(mounts, LliurexQuotaEntry::UserQuota)
+                     + LliurexQuotactlBackend::sweepQuota(mounts, LliurexQuotaEntry::GroupQuota);
+        } else {
+            *entries = LliurexQuotactlBackend::queryQuota(mounts, request.uid, request.gids);
+        }
+        return true;
+    }
+
+    /**
+     * Runs 'lliurex-quota' through the backend of the applet.
+     */
+    bool queryProcess(LliurexQuotaBackend *backend, QVector<LliurexQuotaEntry> *entries, QString *error)
+    {
+        if (!backend->isAvailable()) {
+            *error = QStringLiteral("%1 is not installed").arg(LliurexProcessQuotaBackend::program());
+            return false;
+        }
+
+        bool ok = false;
+        QEventLoop loop;
+        QObject::connect(backend, &LliurexQuotaBackend::quotaReady, &loop,
+                         [&](const QVector<LliurexQuotaEntry> &result) {
+            *entries = result;
+            ok = true;
+            loop.quit();
+        });
+        QObject::connect(backend, &LliurexQuotaBackend::quotaFailed, &loop, [&](const QString &reason) {
+            *error = reason;
+            loop.quit();
+        });
+
+        // every run must deliver its entries
+        backend->forgetLastResult();
+        backend->requestQuota();
+        loop.exec();
+        return ok;
+    }
+
+    QString typeName(LliurexQuotaEntry::Type type)
+    {
+        return type == LliurexQuotaEntry::GroupQuota ? QStringLiteral("group") : QStringLiteral("user");
+    }
+
+    QString levelName(int usage)
+    {
+        switch (LliurexQuotaThresholds::level(usage)) {
+            case LliurexQuotaThresholds::NormalLevel: return QStringLiteral("normal");
+            case LliurexQuotaThresholds::HighLevel: return QStringLiteral("high");
+            case LliurexQuotaThresholds::CriticalLevel: return QStringLiteral("critical");
+        }
+        return QString();
+    }
+
+    QByteArray toJson(const QVector<LliurexQuotaEntry> &entries, const QString &host, qint64 time)
+    {
+        QJsonArray quotas;
+        for (const LliurexQuotaEntry &entry : entries) {
+            QJsonObject quota;
+            quota.insert(QStringLiteral("type"), typeName(entry.type));
+            quota.insert(QStringLiteral("id"), qint64(entry.id));
+            quota.insert(QStringLiteral("name"), entry.name);
+            quota.insert(QStringLiteral("mountPoint"), entry.mountPoint);
+            quota.insert(QStringLiteral("group"), entry.group);
+            quota.insert(QStringLiteral("used"), entry.used);
+            quota.insert(QStringLiteral("softLimit"), entry.softLimit);
+            quota.insert(QStringLiteral("hardLimit"), entry.hardLimit);
+            quota.insert(QStringLiteral("inodesUsed"), entry.inodesUsed);
+            quota.insert(QStringLiteral("inodeSoftLimit"), entry.inodeSoftLimit);
+            quota.insert(QStringLiteral("inodeHardLimit"), entry.inodeHardLimit);
+            quota.insert(QStringLiteral("graceTime"), entry.graceTime);
+            quota.insert(QStringLiteral("usage"), entry.usage());
+            quota.insert(QStringLiteral("level"), levelName(entry.usage()));
+            quotas.append(quota);
+        }
+
+        QJsonObject root;
+        root.insert(QStringLiteral("host"), host);
+        root.insert(QStringLiteral("time"), time / 1000);
+        root.insert(QStringLiteral("quotas"), quotas);
+        return QJsonDocument(root).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    /**
+     * Escapes commas, equal signs and spaces of a line protocol tag.
+     */
+    QByteArray escapeTag(const QString &text)
+    {
+        QByteArray escaped = text.toUtf8();
+        escaped.replace('\\', "\\\\");
+        escaped.replace(',', "\\,");
+        escaped.replace('=', "\\=");
+        escaped.replace(' ', "\\ ");
+        return escaped;
+    }
+
+    QByteArray toLineProtocol(const QVector<LliurexQuotaEntry> &entries, const QString &measurement,
+                              const QString &host, qint64 time)
+    {
+        // one line per quota, in InfluxDB line protocol with nanoseconds
+        const QByteArray timestamp = QByteArray::number(time) + "000000";
+        const QByteArray prefix = escapeTag(measurement) + ",host=" + escapeTag(host);
+
+        QByteArray text;
+        for (const LliurexQuotaEntry &entry : entries) {
+            text += prefix;
+            text += ",type=" + typeName(entry.type).toLatin1();
+            text += ",id=" + QByteArray::number(entry.id);
+            if (!entry.name.isEmpty()) {
+                text += ",name=" + escapeTag(entry.name);
+            }
+            if (!entry.mountPoint.isEmpty()) {
+                text += ",mount=" + escapeTag(entry.mountPoint);
+            }
+            if (!entry.group.isEmpty()) {
+                text += ",group=" + escapeTag(entry.group);
+            }
+            text += " used=" + QByteArray::number(entry.used) + 'i';
+            text += ",soft_limit=" + QByteArray::number(entry.softLimit) + 'i';
+            text += ",hard_limit=" + QByteArray::number(entry.hardLimit) + 'i';
+            text += ",inodes_used=" + QByteArray::number(entry.inodesUsed) + 'i';
+            text += ",inode_soft_limit=" + QByteArray::number(entry.inodeSoftLimit) + 'i';
+            text += ",inode_hard_limit=" + QByteArray::number(entry.inodeHardLimit) + 'i';
+            text += ",grace_time=" + QByteArray::number(entry.graceTime) + 'i';
+            text += ",usage=" + QByteArray::number(entry.usage()) + 'i';
+            text += ' ' + timestamp + '\n';
+        }
+        return text;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("lliurex-quota-probe"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Prints disk quotas for monitoring agents."));
+    parser.addHelpOption();
+    QCommandLineOption userOption(QStringLiteral("user"),
+                                  QStringLiteral("Print the quotas of <user>, a name or a uid (default: the caller)."),
+                                  QStringLiteral("user"));
+    QCommandLineOption allOption(QStringLiteral("all"),
+                                 QStringLiteral("Print the quotas of all users and groups (requires CAP_SYS_ADMIN)."));
+    QCommandLineOption formatOption(QStringLiteral("format"),
+                                    QStringLiteral("Output format: json or line (default: json)."),
+                                    QStringLiteral("format"), QStringLiteral("json"));
+    QCommandLineOption measurementOption(QStringLiteral("measurement"),
+                                         QStringLiteral("Measurement name of the line format (default: lliurex_quota)."),
+                                         QStringLiteral("name"), QStringLiteral("lliurex_quota"));
+    QCommandLineOption processOption(QStringLiteral("process"),
+                                     QStringLiteral("Run 'lliurex-quota' instead of calling quotactl(2); caller only."));
+    QCommandLineOption repeatOption(QStringLiteral("repeat"),
+                                    QStringLiteral("Query <n> times and print the query times to stderr (default: 1)."),
+                                    QStringLiteral("n"), QStringLiteral("1"));
+    parser.addOption(userOption);
+    parser.addOption(allOption);
+    parser.addOption(formatOption);
+    parser.addOption(measurementOption);
+    parser.addOption(processOption);
+    parser.addOption(repeatOption);
+    parser.process(app);
+
+    const QString format = parser.value(formatOption);
+    if (format != QLatin1String("json") && format != QLatin1String("line")) {
+        fprintf(stderr, "Unknown format '%s'\n", qPrintable(format));
+        return 2;
+    }
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    Request request;
+    request.all = parser.isSet(allOption);
+    request.process = parser.isSet(processOption);
+    const QString user = parser.isSet(userOption) ? parser.value(userOption) : QString::number(getuid());
+    if (!request.all && !lookUpUser(user, &request.uid, &request.gids)) {
+        fprintf(stderr, "Unknown user '%s'\n", qPrintable(user));
+        return 2;
+    }
+    if (request.process && (request.all || request.uid != getuid())) {
+        fprintf(stderr, "'lliurex-quota' only reports the quota of the caller\n");
+        return 2;
+    }
+
+    // the tool locator and its $PATH watches are only needed for the process
+    QScopedPointer<LliurexToolLocator> locator;
+    QScopedPointer<LliurexProcessQuotaBackend> backend;
+    if (request.process) {
+        locator.reset(new LliurexToolLocator({LliurexProcessQuotaBackend::program()}));
+        backend.reset(new LliurexProcessQuotaBackend(locator.data()));
+    }
+
+    QVector<LliurexQuotaEntry> entries;
+    QString error;
+    QVector<qint64> times;
+    times.reserve(repeat);
+    for (int i = 0; i < repeat; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = request.process ? queryProcess(backend.data(), &entries, &error)
+                                        : queryQuotactl(request, &entries, &error);
+        if (!ok) {
+            fprintf(stderr, "Quota query failed: %s\n", qPrintable(error));
+            return 1;
+        }
+        times.append(timer.nsecsElapsed() / 1000);
+    }
+
+    if (repeat > 1) {
+        std::sort(times.begin(), times.end());
+        fprintf(stderr, "%d queries, %d quotas: min %lld us, median %lld us, max %lld us\n",
+                repeat, entries.size(), times.first(), times.at(times.size() / 2), times.last());
+    }
+
+    const QString host = QSysInfo::machineHostName();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const QByteArray output = format == QLatin1String("json")
+        ? toJson(entries, host, now)
+        : toLineProtocol(entries, parser.value(measurementOption), host, now);
+    fwrite(output.constData(), 1, output.size(), stdout);
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaService.h"
+#include "LliurexQuotaDBus.h"
+
+#include <QCoreApplication>
+#include <QDBusConnectionInterface>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QSet>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <grp.h>
+#include <pwd.h>
+#include <sys/types.h>
+
+namespace {
+    // minimum time between two sweeps triggered by Refresh()
+    const qint64 MinRefreshInterval = 5 * 1000;
+
+    QString quotaId(const LliurexQuotaEntry &entry)
+    {
+        return (entry.type == LliurexQuotaEntry::GroupQuota ? QLatin1Char('g') : QLatin1Char('u'))
+             + QString::number(entry.id);
+    }
+
+    /**
+     * Returns the ids of user @p uid and all its groups.
+     */
+    QStringList idsOfUser(uint uid)
+    {
+        QStringList ids{QLatin1Char('u') + QString::number(uid)};
+
+        char buffer[4096];
+        struct passwd pwd;
+        struct passwd *user = nullptr;
+        if (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &user) != 0 || !user) {
+            return ids;
+        }
+
+        int count = 64;
+        QVector<gid_t> gids(count);
+        if (getgrouplist(user->pw_name, user->pw_gid, gids.data(), &count) < 0) {
+            // count now holds the real number of groups
+            gids.resize(count);
+            if (getgrouplist(user->pw_name, user->pw_gid, gids.data(), &count) < 0) {
+                count = 0;
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            ids.append(QLatin1Char('g') + QString::number(gids[i]));
+        }
+        return ids;
+    }
+}
+
+LliurexQuotaService::LliurexQuotaService(const QDBusConnection &bus, LliurexQuotaSource *source, int interval, QObject *parent)
+    : QObject(parent)
+    , m_source(source)
+    , m_timer(new QTimer(this))
+    , m_watcher(new QFutureWatcher<QVector<LliurexQuotaEntry>>(this))
+    , m_bus(bus)
+{
+    LliurexQuotaDBus::registerTypes();
+
+    m_timer->setTimerType(Qt::VeryCoarseTimer);
+    m_timer->setInterval(interval);
+    connect(m_timer, &QTimer::timeout, this, &LliurexQuotaService::poll);
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &LliurexQuotaService::sweepFinished);
+}
+
+LliurexQuotaService::~LliurexQuotaService()
+{
+    m_watcher->waitForFinished();
+}
+
+void LliurexQuotaService::start()
+{
+    m_timer->start();
+    poll();
+}
+
+void LliurexQuotaService::poll()
+{
+    // a sweep still running (e.g. on a hanging device) is not started twice
+    if (m_watcher->isRunning()) {
+        return;
+    }
+
+    LliurexQuotaSource *source = m_source.data();
+    bool *ok = &m_lastSweepOk;
+    m_watcher->setFuture(QtConcurrent::run([source, ok]() {
+        return source->sweep(ok);
+    }));
+}
+
+void LliurexQuotaService::sweepFinished()
+{
+    m_lastSweep.start();
+    if (!m_lastSweepOk) {
+        // keep the last good data, a failed sweep does not mean all quotas are gone
+        registerOnBus();
+        return;
+    }
+
+    QHash<QString, QVector<LliurexQuotaEntry>> quotas;
+    for (const LliurexQuotaEntry &entry : m_watcher->result()) {
+        quotas[quotaId(entry)].append(entry);
+    }
+
+    if (m_registered) {
+        QSet<QString> ids = QSet<QString>::fromList(m_quotas.keys());
+        ids.unite(QSet<QString>::fromList(quotas.keys()));
+        for (const QString &id : qAsConst(ids)) {
+            if (m_quotas.value(id) != quotas.value(id)) {
+                emit QuotaChanged(id);
+            }
+        }
+    }
+
+    m_quotas.swap(quotas);
+    registerOnBus();
+}
+
+void LliurexQuotaService::registerOnBus()
+{
+    if (m_registered) {
+        return;
+    }
+    m_registered = true;
+
+    m_bus.registerObject(LliurexQuotaDBus::objectPath, this,
+                         QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals);
+    if (!m_bus.registerService(LliurexQuotaDBus::serviceName)) {
+        qWarning("Cannot register %s: %s", qPrintable(QString(LliurexQuotaDBus::serviceName)),
+                 qPrintable(m_bus.lastError().message()));
+        QCoreApplication::exit(1);
+    }
+}
+
+void LliurexQuotaService::setAdminGroups(const QStringList &groupNames)
+{
+    m_adminIds.clear();
+    for (const QString &groupName : groupNames) {
+        char buffer[4096];
+        struct group grp;
+        struct group *result = nullptr;
+        if (getgrnam_r(groupName.toLocal8Bit().constData(), &grp, buffer, sizeof(buffer), &result) == 0 && result) {
+            m_adminIds.append(QLatin1Char('g') + QString::number(result->gr_gid));
+        }
+    }
+}
+
+bool LliurexQuotaService::callerUid(uint *uid)
+{
+    if (!calledFromDBus()) {
+        return false;
+    }
+
+    const QDBusReply<uint> reply = connection().interface()->serviceUid(message().service());
+    if (!reply.isValid()) {
+        sendErrorReply(QDBusError::AccessDenied, QStringLiteral("Cannot determine the caller's user id"));
+        return false;
+    }
+
+    *uid = reply.value();
+    return true;
+}
+
+bool LliurexQuotaService::isAdmin(uint uid) const
+{
+    if (uid == 0) {
+        return true;
+    }
+    for (const QString &id : idsOfUser(uid)) {
+        if (m_adminIds.contains(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QVector<LliurexQuotaEntry> LliurexQuotaService::GetQuota()
+{
+    QVector<LliurexQuotaEntry> entries;
+    uint uid = 0;
+    if (!callerUid(&uid)) {
+        return entries;
+    }
+
+    for (const QString &id : idsOfUser(uid)) {
+        entries += m_quotas.value(id);
+    }
+    return entries;
+}
+
+bool LliurexQuotaService::CanListAllQuotas()
+{
+    uint uid = 0;
+    return callerUid(&uid) && isAdmin(uid);
+}
+
+QVector<LliurexQuotaEntry> LliurexQuotaService::GetAllQuotas()
+{
+    QVector<LliurexQuotaEntry> entries;
+    uint uid = 0;
+    if (!callerUid(&uid)) {
+        return entries;
+    }
+
+    if (!isAdmin(uid)) {
+        sendErrorReply(QDBusError::AccessDenied, QStringLiteral("Only administrators may list all quotas"));
+        return entries;
+    }
+
+    for (auto it = m_quotas.constBegin(); it != m_quotas.constEnd(); ++it) {
+        if (it.key().startsWith(QLatin1Char('u'))) {
+            entries += it.value();
+        }
+    }
+    return entries;
+}
+
+void LliurexQuotaService::Refresh()
+{
+    if (m_lastSweep.isValid() && m_lastSweep.elapsed() < MinRefreshInterval) {
+        return;
+    }
+    poll();
+}
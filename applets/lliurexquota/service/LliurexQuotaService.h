@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef LLIUREX_QUOTA_SERVICE_H
+#define LLIUREX_QUOTA_SERVICE_H
+
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+
+#include "LliurexQuotaEntry.h"
+#include "LliurexQuotaSource.h"
+
+class QTimer;
+
+/**
+ * Per-host quota service 'net.lliurex.Quota'.
+ *
+ * Polls the quotas of all users and groups in one sweep per interval and
+ * announces every quota that changed with QuotaChanged("u<uid>") or
+ * QuotaChanged("g<gid>"). Clients add a match rule on the first argument
+ * for their own ids, so an applet is only woken up when its own quota
+ * changed, and then fetches it with GetQuota().
+ */
+class LliurexQuotaService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.lliurex.Quota")
+
+public:
+    /**
+     * Creates the service on @p bus polling @p source every @p interval
+     * milliseconds. Takes ownership of @p source.
+     */
+    LliurexQuotaService(const QDBusConnection &bus, LliurexQuotaSource *source, int interval, QObject *parent = nullptr);
+    ~LliurexQuotaService() override;
+
+    /**
+     * Starts polling. The object and service name are registered on the bus
+     * once the first sweep finished, so that early callers get real data.
+     */
+    void start();
+
+    /**
+     * Members of the groups @p groupNames may list the quotas of all users.
+     * root always may.
+     */
+    void setAdminGroups(const QStringList &groupNames);
+
+public Q_SLOTS: // D-Bus interface
+    /**
+     * Returns the user quota of the caller and the quotas of all its groups.
+     */
+    QVector<LliurexQuotaEntry> GetQuota();
+
+    /**
+     * Returns true if the caller may call GetAllQuotas().
+     */
+    bool CanListAllQuotas();
+
+    /**
+     * Returns the user quotas of all users. Only allowed for root and
+     * members of the admin groups.
+     */
+    QVector<LliurexQuotaEntry> GetAllQuotas();
+
+    /**
+     * Requests an immediate sweep, e.g. after a user freed space.
+     * Requests arriving less than a few seconds after a sweep are ignored.
+     */
+    void Refresh();
+
+Q_SIGNALS:
+    /**
+     * Emitted for each quota that changed, @p id is 'u<uid>' or 'g<gid>'.
+     */
+    void QuotaChanged(const QString &id);
+
+private Q_SLOTS:
+    void poll();
+    void sweepFinished();
+
+private:
+    void registerOnBus();
+    bool callerUid(uint *uid);
+    bool isAdmin(uint uid) const;
+
+    QScopedPointer<LliurexQuotaSource> m_source;
+    QTimer *m_timer = nullptr;
+    QFutureWatcher<QVector<LliurexQuotaEntry>> *m_watcher = nullptr;
+    QElapsedTimer m_lastSweep;
+    QDBusConnection m_bus;
+    bool m_registered = false;
+    bool m_lastSweepOk = true;
+
+    // quotas by id, 'u<uid>' or 'g<gid>'
+    QHash<QString, QVector<LliurexQuotaEntry>> m_quotas;
+
+    // ids 'g<gid>' of the admin groups
+    QStringList m_adminIds;
+};
+
+#endif // LLIUREX_QUOTA_SERVICE_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaSource.h"
+#include "LliurexQuotactlBackend.h"
+
+#include <QFile>
+
+LliurexQuotaSource::~LliurexQuotaSource()
+{
+}
+
+QVector<LliurexQuotaEntry> LliurexQuotactlSource::sweep(bool *ok)
+{
+    const QVector<LliurexQuotactlBackend::Mount> mounts = LliurexQuotactlBackend::quotaMounts();
+    *ok = true;
+    return LliurexQuotactlBackend::sweepQuota(mounts, LliurexQuotaEntry::UserQuota)
+         + LliurexQuotactlBackend::sweepQuota(mounts, LliurexQuotaEntry::GroupQuota);
+}
+
+LliurexFakeQuotaSource::LliurexFakeQuotaSource(const QString &fileName)
+    : m_fileName(fileName)
+{
+}
+
+QVector<LliurexQuotaEntry> LliurexFakeQuotaSource::sweep(bool *ok)
+{
+    QVector<LliurexQuotaEntry> entries;
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *ok = false;
+        return entries;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QList<QByteArray> parts = line.split(',');
+        if (parts.size() != 7 && parts.size() != 8) {
+            continue;
+        }
+
+        LliurexQuotaEntry entry;
+        entry.type = parts[0] == "g" ? LliurexQuotaEntry::GroupQuota : LliurexQuotaEntry::UserQuota;
+        entry.id = parts[1].toUInt();
+        entry.name = QString::fromUtf8(parts[2]);
+        entry.mountPoint = QString::fromUtf8(parts[3]);
+        entry.used = parts[4].toLongLong() * 1024;
+        entry.softLimit = parts[5].toLongLong() * 1024;
+        entry.hardLimit = parts[6].toLongLong() * 1024;
+        if (parts.size() == 8) {
+            entry.group = QString::fromUtf8(parts[7]);
+        } else if (entry.type == LliurexQuotaEntry::GroupQuota) {
+            entry.group = entry.name;
+        }
+        entries.append(entry);
+    }
+
+    *ok = true;
+    return entries;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef LLIUREX_QUOTA_SOURCE_H
+#define LLIUREX_QUOTA_SOURCE_H
+
+#include <QString>
+#include <QVector>
+
+#include "LliurexQuotaEntry.h"
+
+/**
+ * Source of the quotas of all users and groups of the host.
+ * sweep() is called on a worker thread, but never concurrently.
+ */
+class LliurexQuotaSource
+{
+public:
+    virtual ~LliurexQuotaSource();
+
+    /**
+     * Returns all user and group quotas in one pass.
+     * @p ok is set to false if the data could not be read.
+     */
+    virtual QVector<LliurexQuotaEntry> sweep(bool *ok) = 0;
+};
+
+/**
+ * Reads all quotas of the quota-enabled local file systems with
+ * Q_GETNEXTQUOTA, one sweep per file system and quota type.
+ */
+class LliurexQuotactlSource : public LliurexQuotaSource
+{
+public:
+    QVector<LliurexQuotaEntry> sweep(bool *ok) override;
+};
+
+/**
+ * Reads the quotas from a text file, to run the service without real
+ * quota file systems. Each line describes one quota:
+ *   <u|g>,<id>,<name>,<mount point>,<used KiB>,<soft limit KiB>,<hard limit KiB>[,<group>]
+ * The group of a group quota defaults to its name.
+ * Empty lines and lines starting with '#' are ignored. The file is read
+ * again on every sweep, so changes show up on the next poll.
+ */
+class LliurexFakeQuotaSource : public LliurexQuotaSource
+{
+public:
+    explicit LliurexFakeQuotaSource(const QString &fileName);
+
+    QVector<LliurexQuotaEntry> sweep(bool *ok) override;
+
+private:
+    QString m_fileName;
+};
+
+#endif // LLIUREX_QUOTA_SOURCE_H
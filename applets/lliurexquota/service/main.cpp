@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 LliureX Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "LliurexQuotaService.h"
+#include "LliurexQuotaSource.h"
+#include "LliurexQuotaDBus.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("lliurex-quota-service"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Polls the disk quotas of all users and publishes them on D-Bus."));
+    parser.addHelpOption();
+    QCommandLineOption sessionOption(QStringLiteral("session"),
+                                     QStringLiteral("Run on the session bus instead of the system bus."));
+    QCommandLineOption fakeOption(QStringLiteral("fake"),
+                                  QStringLiteral("Read the quotas from <file> instead of the file systems."),
+                                  QStringLiteral("file"));
+    QCommandLineOption intervalOption(QStringLiteral("interval"),
+                                      QStringLiteral("Poll interval in seconds (default: 60)."),
+                                      QStringLiteral("seconds"), QStringLiteral("60"));
+    QCommandLineOption adminGroupOption(QStringLiteral("admin-group"),
+                                        QStringLiteral("Members of <group> may list all quotas (default: sudo, admins)."),
+                                        QStringLiteral("group"));
+    parser.addOption(sessionOption);
+    parser.addOption(adminGroupOption);
+    parser.addOption(fakeOption);
+    parser.addOption(intervalOption);
+    parser.process(app);
+
+    const int interval = qMax(1, parser.value(intervalOption).toInt()) * 1000;
+
+    LliurexQuotaSource *source = nullptr;
+    if (parser.isSet(fakeOption)) {
+        source = new LliurexFakeQuotaSource(parser.value(fakeOption));
+    } else {
+        source = new LliurexQuotactlSource();
+    }
+
+    const QDBusConnection bus = parser.isSet(sessionOption) ? QDBusConnection::sessionBus()
+                                                            : QDBusConnection::systemBus();
+    if (!bus.isConnected()) {
+        qWarning("Cannot connect to the D-Bus %s bus", parser.isSet(sessionOption) ? "session" : "system");
+        return 1;
+    }
+
+    QStringList adminGroups = parser.values(adminGroupOption);
+    if (adminGroups.isEmpty()) {
+        adminGroups << QStringLiteral("sudo") << QStringLiteral("admins");
+    }
+
+    LliurexQuotaService service(bus, source, interval);
+    service.setAdminGroups(adminGroups);
+    service.start();
+
+    return app.exec();
+}
@@ -0,0 +1,4 @@
+[D-BUS Service]
+Name=net.lliurex.Quota
+Exec=@KDE_INSTALL_FULL_LIBEXECDIR@/lliurex-quota-service
+User=root